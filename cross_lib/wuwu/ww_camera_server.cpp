@@ -314,9 +314,7 @@ void CameraStreamServer::close_server_socket(void)
  ******************************************************************/
 uint64_t CameraStreamServer::now_ms(void)
 {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-               std::chrono::system_clock::now().time_since_epoch())
-        .count();
+    return time_wall_ms();
 }
 
 /*******************************************************************
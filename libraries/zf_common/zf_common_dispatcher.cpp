@@ -0,0 +1,229 @@
+#include "zf_common_dispatcher.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     构造函数
+// 参数说明     无
+// 返回参数     无
+// 使用示例     zf_common_dispatcher dispatcher;
+//-------------------------------------------------------------------------------------------------------------------
+zf_common_dispatcher::zf_common_dispatcher(void)
+    : worker_count(0),
+      running(false),
+      pending_count(0),
+      reject_count(0),
+      finish_count(0)
+{
+    memset(worker_thread, 0, sizeof(worker_thread));
+    memset(&worker_policy, 0, sizeof(worker_policy));
+    worker_policy.sched_policy = SCHED_OTHER;
+    sem_init(&task_sem, 0, 0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     析构函数
+// 参数说明     无
+// 返回参数     无
+// 使用示例     自动调用
+// 备注信息     自动停止所有工作线程
+//-------------------------------------------------------------------------------------------------------------------
+zf_common_dispatcher::~zf_common_dispatcher(void)
+{
+    stop();
+    sem_destroy(&task_sem);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     工作线程
+// 参数说明     arg             分发器对象指针
+// 返回参数     void*           固定返回NULL
+// 使用示例     内部调用
+// 备注信息     每个任务对应一次信号量释放 停止时额外为每个线程释放一次
+//              多个生产者同时写入时 先发布的任务可能排在尚未写完的槽位之后 暂时取不到 此时让出CPU后重试
+//              停止后只有待执行任务数为0时才退出 保证已提交的任务全部被执行
+//-------------------------------------------------------------------------------------------------------------------
+void *zf_common_dispatcher::worker_thread_entry(void *arg)
+{
+    zf_common_dispatcher *dispatcher = (zf_common_dispatcher *)arg;
+    dispatcher_task_struct task;
+    uint8 found;
+    int i;
+
+    prctl(PR_SET_NAME, "dispatcher");
+    if(SCHED_OTHER != dispatcher->worker_policy.sched_policy)
+    {
+        rt_thread_setup(&dispatcher->worker_policy);                            // 失败时已打印警告 以普通调度继续运行
+    }
+
+    while(1)
+    {
+        if(0 != sem_wait(&dispatcher->task_sem))
+        {
+            continue;                                                           // 被信号打断 EINTR
+        }
+
+        while(1)
+        {
+            found = 0;
+            for(i = 0; i < DISPATCHER_PRIORITY_COUNT; i ++)
+            {
+                if(dispatcher->task_queue[i].try_pop(task))
+                {
+                    found = 1;
+                    break;
+                }
+            }
+            if(found)
+            {
+                break;
+            }
+            // 与 submit 相反的顺序 先看 running 再看计数 均为 seq_cst
+            // submit 看到 running 为真时其计数已在 stop 之前生效 这里必然读到非0 不会丢下已接受的任务退出
+            if(!dispatcher->running.load() && 0 == dispatcher->pending_count.load())
+            {
+                return NULL;
+            }
+            sched_yield();
+        }
+
+        dispatcher->pending_count.fetch_sub(1, std::memory_order_acq_rel);
+        task.function(task.arg);
+        dispatcher->finish_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return NULL;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     启动工作线程
+// 参数说明     thread_count    工作线程数量 1 ~ DISPATCHER_WORKER_MAX
+// 参数说明     sched_priority  工作线程优先级 0-普通调度 1~99-SCHED_FIFO实时调度
+// 返回参数     int8            0-成功 -1-失败
+// 使用示例     dispatcher.init(2, 50);
+// 备注信息     实时优先级需要root权限 设置失败时打印警告并以普通调度运行
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_common_dispatcher::init(uint8 thread_count, int sched_priority)
+{
+    int8 return_state = -1;
+
+    do
+    {
+        if(running)
+        {
+            printf("dispatcher already running\r\n");
+            break;
+        }
+        if((0 == thread_count) || (DISPATCHER_WORKER_MAX < thread_count))
+        {
+            printf("dispatcher thread count %d out of range\r\n", thread_count);
+            break;
+        }
+
+        worker_policy.sched_policy      = (0 < sched_priority) ? SCHED_FIFO : SCHED_OTHER;
+        worker_policy.sched_priority    = sched_priority;
+        worker_policy.cpu               = RT_CPU_ANY;
+        worker_policy.stack_prefault    = RT_STACK_PREFAULT_DEFAULT;
+
+        running = true;
+        for(worker_count = 0; worker_count < thread_count; worker_count ++)
+        {
+            if(0 != pthread_create(&worker_thread[worker_count], NULL, worker_thread_entry, this))
+            {
+                perror("dispatcher pthread_create error");
+                break;
+            }
+        }
+
+        if(worker_count != thread_count)
+        {
+            stop();
+            break;
+        }
+        return_state = 0;
+    }while(0);
+
+    return return_state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     提交任务
+// 参数说明     function        任务函数
+// 参数说明     arg             任务参数 由调用者保证任务执行时仍然有效
+// 参数说明     priority        任务优先级
+// 返回参数     int8            0-成功 -1-队列已满或未启动
+// 使用示例     dispatcher.submit(save_image_task, &image_buffer, DISPATCHER_PRIORITY_LOW);
+// 备注信息     任意线程均可调用 不分配内存 不阻塞 可以在PIT回调中使用
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_common_dispatcher::submit(dispatcher_task_fun function, void *arg, dispatcher_priority_enum priority)
+{
+    dispatcher_task_struct task = {function, arg};
+
+    if((NULL == function) || (DISPATCHER_PRIORITY_COUNT <= priority))
+    {
+        return -1;
+    }
+    pending_count.fetch_add(1);                                                 // 先计数后入队 保证计数不小于队列中的任务数
+    if(!running.load())                                                         // 计数之后再检查 与 stop 之间不存在检查通过但工作线程已退出的窗口
+    {
+        pending_count.fetch_sub(1, std::memory_order_acq_rel);
+        return -1;
+    }
+    if(!task_queue[priority].try_push(task))
+    {
+        pending_count.fetch_sub(1, std::memory_order_acq_rel);
+        reject_count.fetch_add(1, std::memory_order_relaxed);
+        return -1;
+    }
+
+    sem_post(&task_sem);
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     停止工作线程
+// 参数说明     无
+// 返回参数     void
+// 使用示例     dispatcher.stop();
+// 备注信息     已提交的任务全部执行完成后工作线程才退出 可重复调用
+//-------------------------------------------------------------------------------------------------------------------
+void zf_common_dispatcher::stop(void)
+{
+    uint8 i;
+
+    if(!running.exchange(false))
+    {
+        return;
+    }
+
+    for(i = 0; i < worker_count; i ++)
+    {
+        sem_post(&task_sem);
+    }
+    for(i = 0; i < worker_count; i ++)
+    {
+        pthread_join(worker_thread[i], NULL);
+        worker_thread[i] = 0;
+    }
+    worker_count = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取被拒绝的任务数量
+// 参数说明     无
+// 返回参数     uint32          队列已满导致提交失败的次数
+// 使用示例     uint32 reject = dispatcher.get_reject_count();
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_common_dispatcher::get_reject_count(void)
+{
+    return reject_count.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取已完成的任务数量
+// 参数说明     无
+// 返回参数     uint32          已执行完成的任务数量
+// 使用示例     uint32 finish = dispatcher.get_finish_count();
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_common_dispatcher::get_finish_count(void)
+{
+    return finish_count.load(std::memory_order_relaxed);
+}
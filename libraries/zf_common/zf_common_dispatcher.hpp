@@ -0,0 +1,130 @@
+#ifndef _zf_common_dispatcher_h_
+#define _zf_common_dispatcher_h_
+
+#include "zf_common_typedef.hpp"
+#include "zf_common_mpmc_queue.hpp"
+#include "zf_common_rt.hpp"
+
+#include <semaphore.h>
+
+#define DISPATCHER_QUEUE_SIZE           ( 256 )                                 // 每个优先级的任务队列长度 必须为2的幂
+#define DISPATCHER_WORKER_MAX           ( 8 )                                   // 最大工作线程数量
+
+typedef void (*dispatcher_task_fun)(void *arg);
+
+// 任务优先级 工作线程总是先取高优先级队列中的任务
+typedef enum
+{
+    DISPATCHER_PRIORITY_HIGH,
+    DISPATCHER_PRIORITY_NORMAL,
+    DISPATCHER_PRIORITY_LOW,
+
+    DISPATCHER_PRIORITY_COUNT,
+}dispatcher_priority_enum;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 类名         zf_common_dispatcher
+// 说明         固定线程池任务分发器 用于PIT回调/摄像头线程/图传服务/主循环之间传递工作
+//              任务为 函数指针 + 参数指针 提交时只写入无锁队列并释放信号量 不分配内存 不加锁
+//              三个优先级各一个 MpmcQueue 工作线程按优先级从高到低取任务
+//-------------------------------------------------------------------------------------------------------------------
+class zf_common_dispatcher
+{
+private:
+    typedef struct
+    {
+        dispatcher_task_fun function;
+        void                *arg;
+    }dispatcher_task_struct;
+
+    MpmcQueue<dispatcher_task_struct, DISPATCHER_QUEUE_SIZE> task_queue[DISPATCHER_PRIORITY_COUNT];
+
+    sem_t               task_sem;                                               // 待执行任务数量
+    pthread_t           worker_thread[DISPATCHER_WORKER_MAX];
+    uint8               worker_count;
+    rt_thread_policy_struct worker_policy;                                      // 实时优先级工作线程的配置 在线程入口处应用
+    std::atomic<bool>   running;
+    std::atomic<uint32> pending_count;                                          // 已入队尚未取出的任务数量
+    std::atomic<uint32> reject_count;                                           // 队列已满被拒绝的任务数量
+    std::atomic<uint32> finish_count;                                           // 已执行完成的任务数量
+
+    zf_common_dispatcher(const zf_common_dispatcher&) = delete;
+    zf_common_dispatcher& operator=(const zf_common_dispatcher&) = delete;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     工作线程
+// 参数说明     arg             分发器对象指针
+// 返回参数     void*           固定返回NULL
+// 使用示例     内部调用
+// 备注信息     等待信号量 按优先级取任务执行 停止时执行完剩余任务后退出
+//-------------------------------------------------------------------------------------------------------------------
+    static void *worker_thread_entry(void *arg);
+
+public:
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     构造函数
+// 参数说明     无
+// 返回参数     无
+// 使用示例     zf_common_dispatcher dispatcher;
+//-------------------------------------------------------------------------------------------------------------------
+    zf_common_dispatcher(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     析构函数
+// 参数说明     无
+// 返回参数     无
+// 使用示例     自动调用
+// 备注信息     自动停止所有工作线程
+//-------------------------------------------------------------------------------------------------------------------
+    ~zf_common_dispatcher(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     启动工作线程
+// 参数说明     thread_count    工作线程数量 1 ~ DISPATCHER_WORKER_MAX
+// 参数说明     sched_priority  工作线程优先级 0-普通调度 1~99-SCHED_FIFO实时调度
+// 返回参数     int8            0-成功 -1-失败
+// 使用示例     dispatcher.init(2, 50);
+// 备注信息     实时优先级需要root权限 设置失败时打印警告并以普通调度运行
+//              使用实时优先级时工作线程与定时器线程一样锁定内存并预触碰栈
+//              工作线程优先级应低于PIT线程 避免抢占控制回调
+//-------------------------------------------------------------------------------------------------------------------
+    int8 init(uint8 thread_count, int sched_priority = 0);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     提交任务
+// 参数说明     function        任务函数
+// 参数说明     arg             任务参数 由调用者保证任务执行时仍然有效
+// 参数说明     priority        任务优先级
+// 返回参数     int8            0-成功 -1-队列已满或未启动
+// 使用示例     dispatcher.submit(save_image_task, &image_buffer, DISPATCHER_PRIORITY_LOW);
+// 备注信息     任意线程均可调用 不分配内存 不阻塞 可以在PIT回调中使用
+//-------------------------------------------------------------------------------------------------------------------
+    int8 submit(dispatcher_task_fun function, void *arg, dispatcher_priority_enum priority = DISPATCHER_PRIORITY_NORMAL);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     停止工作线程
+// 参数说明     无
+// 返回参数     void
+// 使用示例     dispatcher.stop();
+// 备注信息     已提交的任务全部执行完成后工作线程才退出 可重复调用
+//-------------------------------------------------------------------------------------------------------------------
+    void stop(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取被拒绝的任务数量
+// 参数说明     无
+// 返回参数     uint32          队列已满导致提交失败的次数
+// 使用示例     uint32 reject = dispatcher.get_reject_count();
+//-------------------------------------------------------------------------------------------------------------------
+    uint32 get_reject_count(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取已完成的任务数量
+// 参数说明     无
+// 返回参数     uint32          已执行完成的任务数量
+// 使用示例     uint32 finish = dispatcher.get_finish_count();
+//-------------------------------------------------------------------------------------------------------------------
+    uint32 get_finish_count(void);
+};
+
+#endif
@@ -1,39 +1,74 @@
 #include "zf_common_fifo.hpp"
 
+// 读写位置在 [0, 2*max) 范围内循环 与 SpscRing 的自由增长计数等价
+// 这样 head == end 表示空 相差 max 表示满 缓冲区可以全部用满 且 max 不要求是2的幂
+// 生产者以 release 写 head 消费者以 release 写 end 对方以 acquire 读取 保证先拷贝数据再更新位置
+
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     FIFO 头指针位移
-// 参数说明     *fifo               FIFO 对象指针
-// 参数说明     offset              偏移量
+// 函数简介     FIFO 读取对方位置
+// 参数说明     *index              head 或 end 地址
+// 返回参数     uint32              位置
+// 使用示例     uint32 end = fifo_index_acquire(&fifo->end);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//-------------------------------------------------------------------------------------------------------------------
+static inline uint32 fifo_index_acquire (const uint32 *index)
+{
+    return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     FIFO 发布自身位置
+// 参数说明     *index              head 或 end 地址
+// 参数说明     value               新位置
 // 返回参数     void
-// 使用示例     fifo_head_offset(fifo, 1);
+// 使用示例     fifo_index_release(&fifo->head, head);
 // 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
 //-------------------------------------------------------------------------------------------------------------------
-static void fifo_head_offset (fifo_struct *fifo, uint32 offset)
+static inline void fifo_index_release (uint32 *index, uint32 value)
 {
-    fifo->head += offset;
-    
-    while(fifo->max <= fifo->head)                                              // 如果范围超过则减缓冲区大小 直到小于最大缓冲区大小
-    {
-        fifo->head -= fifo->max;
-    }
+    __atomic_store_n(index, value, __ATOMIC_RELEASE);
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     FIFO 尾指针位移
+// 函数简介     FIFO 位置偏移
 // 参数说明     *fifo               FIFO 对象指针
-// 参数说明     offset              偏移量
-// 返回参数     void
-// 使用示例     fifo_end_offset(fifo, 1);
+// 参数说明     index               当前位置
+// 参数说明     offset              偏移量 不大于 max
+// 返回参数     uint32              偏移后的位置
+// 使用示例     head = fifo_index_offset(fifo, head, 1);
 // 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
 //-------------------------------------------------------------------------------------------------------------------
-static void fifo_end_offset (fifo_struct *fifo, uint32 offset)
+static inline uint32 fifo_index_offset (const fifo_struct *fifo, uint32 index, uint32 offset)
 {
-    fifo->end += offset;
-    
-    while(fifo->max <= fifo->end)                                               // 如果范围超过则减缓冲区大小 直到小于最大缓冲区大小
-    {
-        fifo->end -= fifo->max;
-    }
+    index += offset;
+    return (2 * fifo->max <= index) ? (index - 2 * fifo->max) : index;          // 偏移量不超过 max 一次比较即可回绕
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     FIFO 位置转换为缓冲区下标
+// 参数说明     *fifo               FIFO 对象指针
+// 参数说明     index               位置
+// 返回参数     uint32              缓冲区下标
+// 使用示例     uint32 pos = fifo_index_position(fifo, head);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//-------------------------------------------------------------------------------------------------------------------
+static inline uint32 fifo_index_position (const fifo_struct *fifo, uint32 index)
+{
+    return (fifo->max <= index) ? (index - fifo->max) : index;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     FIFO 计算两个位置之间的数据个数
+// 参数说明     *fifo               FIFO 对象指针
+// 参数说明     head                写入位置
+// 参数说明     end                 读取位置
+// 返回参数     uint32              数据个数
+// 使用示例     uint32 used = fifo_index_used(fifo, head, end);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//-------------------------------------------------------------------------------------------------------------------
+static inline uint32 fifo_index_used (const fifo_struct *fifo, uint32 head, uint32 end)
+{
+    return (head >= end) ? (head - end) : (head + 2 * fifo->max - end);
 }
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -41,7 +76,7 @@ static void fifo_end_offset (fifo_struct *fifo, uint32 offset)
 // 参数说明     *fifo               FIFO 对象指针
 // 返回参数     void
 // 使用示例     fifo_clear(fifo);
-// 备注信息     清空当前 FIFO 对象的内存
+// 备注信息     清空当前 FIFO 对象的内存 需要在没有其他线程读写时调用
 //-------------------------------------------------------------------------------------------------------------------
 fifo_state_enum fifo_clear (fifo_struct *fifo)
 {
@@ -49,22 +84,10 @@ fifo_state_enum fifo_clear (fifo_struct *fifo)
     fifo_state_enum return_state = FIFO_SUCCESS;                                // 操作结果初值
     do
     {
-//        if(FIFO_IDLE != fifo->execution)                                        // 判断是否当前 FIFO 是否空闲
-//        {
-//            return_state = FIFO_RESET_UNDO;                                     // 重置操作未完成
-//            break;
-//        }
-        fifo->execution |= FIFO_RESET;                                          // 重置操作置位
-        fifo->head      = 0;                                                    // 重置 FIFO 所有数值复位
-        fifo->end       = 0;                                                    // 重置 FIFO 所有数值复位
-        fifo->size      = fifo->max;                                            // 重置 FIFO 所有数值复位
-        switch(fifo->type)
-        {
-            case FIFO_DATA_8BIT:    memset(fifo->buffer, 0, fifo->max);     break;
-            case FIFO_DATA_16BIT:   memset(fifo->buffer, 0, fifo->max * 2); break;
-            case FIFO_DATA_32BIT:   memset(fifo->buffer, 0, fifo->max * 4); break;
-        }
-        fifo->execution = FIFO_IDLE;                                            // 操作状态复位
+        fifo->execution = FIFO_IDLE;
+        memset(fifo->buffer, 0, (size_t)fifo->max << fifo->type);               // 数据位宽 1/2/4 字节 对应左移 0/1/2
+        fifo_index_release(&fifo->end, 0);                                      // 重置 FIFO 所有数值复位
+        fifo_index_release(&fifo->head, 0);                                     // 重置 FIFO 所有数值复位
     }while(0);
     return return_state;
 }
@@ -74,12 +97,12 @@ fifo_state_enum fifo_clear (fifo_struct *fifo)
 // 参数说明     *fifo               FIFO 对象指针
 // 返回参数     uint32              已使用长度
 // 使用示例     uint32 len = fifo_used(fifo);
-// 备注信息     
+// 备注信息     生产者与消费者均可调用
 //-------------------------------------------------------------------------------------------------------------------
 uint32 fifo_used (fifo_struct *fifo)
 {
     // zf_assert(fifo != NULL);
-    return (fifo->max - fifo->size);                                            // 返回当前 FIFO 缓冲区中数据个数
+    return fifo_index_used(fifo, fifo_index_acquire(&fifo->head), fifo_index_acquire(&fifo->end));
 }
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -88,38 +111,31 @@ uint32 fifo_used (fifo_struct *fifo)
 // 参数说明     dat                 数据
 // 返回参数     fifo_state_enum     操作状态
 // 使用示例     zf_log(fifo_write_element(&fifo, data) == FIFO_SUCCESS, "fifo_write_byte error");
-// 备注信息     
+// 备注信息     只能由生产者调用
 //-------------------------------------------------------------------------------------------------------------------
 fifo_state_enum fifo_write_element (fifo_struct *fifo, uint32 dat)
 {
     // zf_assert(NULL != fifo);
     fifo_state_enum return_state = FIFO_SUCCESS;                                // 操作结果初值
+    uint32 head = fifo->head;
+    uint32 position;
 
     do
     {
-        if((FIFO_RESET | FIFO_WRITE) & fifo->execution)                         // 不在写入与重置状态 避免写入竞争与指向错误
+        if(fifo->max <= fifo_index_used(fifo, head, fifo_index_acquire(&fifo->end)))
         {
-            return_state = FIFO_WRITE_UNDO;                                     // 写入操作未完成
+            return_state = FIFO_SPACE_NO_ENOUGH;                                // 当前 FIFO 缓冲区满 不能再写入数据 返回空间不足
             break;
         }
-        fifo->execution |= FIFO_WRITE;                                          // 写入操作置位
 
-        if(1 <= fifo->size)                                                     // 剩余空间足够装下本次数据
+        position = fifo_index_position(fifo, head);
+        switch(fifo->type)
         {
-            switch(fifo->type)
-            {
-                case FIFO_DATA_8BIT:    ((uint8 *)fifo->buffer)[fifo->head]  = dat;  break;
-                case FIFO_DATA_16BIT:   ((uint16 *)fifo->buffer)[fifo->head] = dat; break;
-                case FIFO_DATA_32BIT:   ((uint32 *)fifo->buffer)[fifo->head] = dat; break;
-            }
-            fifo_head_offset(fifo, 1);                                          // 头指针偏移
-            fifo->size -= 1;                                                    // 缓冲区剩余长度减小
+            case FIFO_DATA_8BIT:    ((uint8 *)fifo->buffer)[position]  = dat;   break;
+            case FIFO_DATA_16BIT:   ((uint16 *)fifo->buffer)[position] = dat;   break;
+            case FIFO_DATA_32BIT:   ((uint32 *)fifo->buffer)[position] = dat;   break;
         }
-        else
-        {
-            return_state = FIFO_SPACE_NO_ENOUGH;                                // 当前 FIFO 缓冲区满 不能再写入数据 返回空间不足
-        }
-        fifo->execution &= ~FIFO_WRITE;                                         // 写入操作复位
+        fifo_index_release(&fifo->head, fifo_index_offset(fifo, head, 1));     // 数据写入完成后再发布头指针
     }while(0);
 
     return return_state;
@@ -132,14 +148,14 @@ fifo_state_enum fifo_write_element (fifo_struct *fifo, uint32 dat)
 // 参数说明     length              需要写入的数据长度
 // 返回参数     fifo_state_enum     操作状态
 // 使用示例     zf_log(fifo_write_buffer(&fifo, data, 32) == FIFO_SUCCESS, "fifo_write_buffer error");
-// 备注信息     
+// 备注信息     只能由生产者调用 空间不足时不写入任何数据
 //-------------------------------------------------------------------------------------------------------------------
 fifo_state_enum fifo_write_buffer (fifo_struct *fifo, void *dat, uint32 length)
 {
     // zf_assert(NULL != fifo);
     fifo_state_enum return_state = FIFO_SUCCESS;                                // 操作结果初值
-    uint32 temp_length = 0;
-    
+    uint32 head = fifo->head;
+
     do
     {
         if(NULL == dat)
@@ -147,94 +163,20 @@ fifo_state_enum fifo_write_buffer (fifo_struct *fifo, void *dat, uint32 length)
             return_state = FIFO_BUFFER_NULL;                                    // 用户缓冲区异常
             break;
         }
-        if((FIFO_RESET | FIFO_WRITE) & fifo->execution)                         // 不在写入与重置状态 避免写入竞争与指向错误
+        if(fifo->max - fifo_index_used(fifo, head, fifo_index_acquire(&fifo->end)) < length)
         {
-            return_state = FIFO_WRITE_UNDO;                                     // 写入操作未完成
+            return_state = FIFO_SPACE_NO_ENOUGH;                                // 当前 FIFO 缓冲区满 不能再写入数据 返回空间不足
             break;
         }
-        fifo->execution |= FIFO_WRITE;                                          // 写入操作置位
 
-        if(length <= fifo->size)                                                // 剩余空间足够装下本次数据
-        {
-            temp_length = fifo->max - fifo->head;                               // 计算头指针距离缓冲区尾还有多少空间
-
-            if(length > temp_length)                                            // 距离缓冲区尾长度不足写入数据 环形缓冲区分段操作
-            {
-                switch(fifo->type)
-                {
-                    case FIFO_DATA_8BIT:
-                    {
-                        memcpy(
-                            &(((uint8 *)fifo->buffer)[fifo->head]),
-                            dat, temp_length);                                  // 拷贝第一段数据
-                        fifo_head_offset(fifo, temp_length);                    // 头指针偏移
-                        memcpy(
-                            &(((uint8 *)fifo->buffer)[fifo->head]), 
-                            &(((uint8 *)dat)[temp_length]),
-                            length - temp_length);                              // 拷贝第二段数据
-                        fifo_head_offset(fifo, length - temp_length);           // 头指针偏移
-                    }break;
-                    case FIFO_DATA_16BIT:
-                    {
-                        memcpy(
-                            &(((uint16 *)fifo->buffer)[fifo->head]),
-                            dat, temp_length * 2);                              // 拷贝第一段数据
-                        fifo_head_offset(fifo, temp_length);                    // 头指针偏移
-                        memcpy(
-                            &(((uint16 *)fifo->buffer)[fifo->head]),
-                            &(((uint16 *)dat)[temp_length]),
-                            (length - temp_length) * 2);                        // 拷贝第二段数据
-                        fifo_head_offset(fifo, length - temp_length);           // 头指针偏移
-                    }break;
-                    case FIFO_DATA_32BIT:
-                    {
-                        memcpy(
-                            &(((uint32 *)fifo->buffer)[fifo->head]),
-                            dat, temp_length * 4);                              // 拷贝第一段数据
-                        fifo_head_offset(fifo, temp_length);                    // 头指针偏移
-                        memcpy(
-                            &(((uint32 *)fifo->buffer)[fifo->head]),
-                            &(((uint32 *)dat)[temp_length]),
-                            (length - temp_length) * 4);                        // 拷贝第二段数据
-                        fifo_head_offset(fifo, length - temp_length);           // 头指针偏移
-                    }break;
-                }
-            }
-            else
-            {
-                switch(fifo->type)
-                {
-                    case FIFO_DATA_8BIT:
-                    {
-                        memcpy(
-                            &(((uint8 *)fifo->buffer)[fifo->head]),
-                            dat, length);                                       // 一次完整写入
-                        fifo_head_offset(fifo, length);                         // 头指针偏移
-                    }break;
-                    case FIFO_DATA_16BIT:
-                    {
-                        memcpy(
-                            &(((uint16 *)fifo->buffer)[fifo->head]),
-                            dat, length * 2);                                   // 一次完整写入
-                        fifo_head_offset(fifo, length);                         // 头指针偏移
-                    }break;
-                    case FIFO_DATA_32BIT:
-                    {
-                        memcpy(
-                            &(((uint32 *)fifo->buffer)[fifo->head]),
-                            dat, length * 4);                                   // 一次完整写入
-                        fifo_head_offset(fifo, length);                         // 头指针偏移
-                    }break;
-                }
-            }
-
-            fifo->size -= length;                                               // 缓冲区剩余长度减小
-        }
-        else
-        {
-            return_state = FIFO_SPACE_NO_ENOUGH;                                // 当前 FIFO 缓冲区满 不能再写入数据 返回空间不足
-        }
-        fifo->execution &= ~FIFO_WRITE;                                         // 写入操作复位
+        // 按字节分段拷贝 数据位宽只影响下标换算 不再按类型分支
+        spsc_ring_copy_in(
+            (uint8 *)fifo->buffer,
+            (size_t)fifo->max << fifo->type,
+            (size_t)fifo_index_position(fifo, head) << fifo->type,
+            (const uint8 *)dat,
+            (size_t)length << fifo->type);
+        fifo_index_release(&fifo->head, fifo_index_offset(fifo, head, length)); // 数据写入完成后再发布头指针
     }while(0);
 
     return return_state;
@@ -247,54 +189,39 @@ fifo_state_enum fifo_write_buffer (fifo_struct *fifo, void *dat, uint32 length)
 // 参数说明     flag                是否变更 FIFO 状态 可选择是否清空读取的数据
 // 返回参数     fifo_state_enum     操作状态
 // 使用示例     zf_log(fifo_read_element(&fifo, data, FIFO_READ_ONLY) == FIFO_SUCCESS, "fifo_read_byte error");
-// 备注信息     
+// 备注信息     只能由消费者调用
 //-------------------------------------------------------------------------------------------------------------------
 fifo_state_enum fifo_read_element (fifo_struct *fifo, void *dat, fifo_operation_enum flag)
 {
     // zf_assert(NULL != fifo);
     fifo_state_enum return_state = FIFO_SUCCESS;                                // 操作结果初值
+    uint32 end = fifo->end;
+    uint32 position;
 
     do
     {
         if(NULL == dat)
         {
             return_state = FIFO_BUFFER_NULL;                                    // 用户缓冲区异常
+            break;
         }
-        else
+        if(0 == fifo_index_used(fifo, fifo_index_acquire(&fifo->head), end))
         {
-            if((FIFO_RESET | FIFO_CLEAR) & fifo->execution)                     // 判断是否当前 FIFO 是否在执行清空或重置操作
-            {
-                return_state = FIFO_READ_UNDO;                                  // 读取操作未完成
-                break;
-            }
-
-            if(1 > fifo_used(fifo))
-            {
-                return_state = FIFO_DATA_NO_ENOUGH;                             // 缓冲区没有数据 返回数据长度不足
-                break;                                                          // 直接退出操作
-            }
+            return_state = FIFO_DATA_NO_ENOUGH;                                 // 缓冲区没有数据 返回数据长度不足
+            break;
+        }
 
-            fifo->execution |= FIFO_READ;                                       // 读操作置位
-            switch(fifo->type)
-            {
-                case FIFO_DATA_8BIT:    *((uint8 *)dat) = ((uint8 *)fifo->buffer)[fifo->end];   break;
-                case FIFO_DATA_16BIT:   *((uint16 *)dat) = ((uint16 *)fifo->buffer)[fifo->end]; break;
-                case FIFO_DATA_32BIT:   *((uint32 *)dat) = ((uint32 *)fifo->buffer)[fifo->end]; break;
-            }
-            fifo->execution &= ~FIFO_READ;                                      // 读操作复位
+        position = fifo_index_position(fifo, end);
+        switch(fifo->type)
+        {
+            case FIFO_DATA_8BIT:    *((uint8 *)dat)  = ((uint8 *)fifo->buffer)[position];   break;
+            case FIFO_DATA_16BIT:   *((uint16 *)dat) = ((uint16 *)fifo->buffer)[position];  break;
+            case FIFO_DATA_32BIT:   *((uint32 *)dat) = ((uint32 *)fifo->buffer)[position];  break;
         }
-        
+
         if(FIFO_READ_AND_CLEAN == flag)                                         // 如果选择读取并更改 FIFO 状态
         {
-            if((FIFO_RESET | FIFO_CLEAR | FIFO_READ) == fifo->execution)        // 不在 重置 清空 读取 状态 避免异常
-            {
-                return_state = FIFO_CLEAR_UNDO;                                 // 清空操作未完成
-                break;
-            }
-            fifo->execution |= FIFO_CLEAR;                                      // 清空作置位
-            fifo_end_offset(fifo, 1);                                           // 移动 FIFO 头指针
-            fifo->size += 1;                                                    // 释放对应长度空间
-            fifo->execution &= ~FIFO_CLEAR;                                     // 清空作复位
+            fifo_index_release(&fifo->end, fifo_index_offset(fifo, end, 1));   // 数据读出后再释放空间
         }
     }while(0);
 
@@ -309,14 +236,14 @@ fifo_state_enum fifo_read_element (fifo_struct *fifo, void *dat, fifo_operation_
 // 参数说明     flag                是否变更 FIFO 状态 可选择是否清空读取的数据
 // 返回参数     fifo_state_enum     操作状态
 // 使用示例     zf_log(fifo_read_buffer(&fifo, data, &length, FIFO_READ_ONLY) == FIFO_SUCCESS, "fifo_read_buffer error");
-// 备注信息     
+// 备注信息     只能由消费者调用
 //-------------------------------------------------------------------------------------------------------------------
 fifo_state_enum fifo_read_buffer (fifo_struct *fifo, void *dat, uint32 *length, fifo_operation_enum flag)
 {
     // zf_assert(NULL != fifo);
     // zf_assert(NULL != length);
     fifo_state_enum return_state = FIFO_SUCCESS;                                // 操作结果初值
-    uint32 temp_length = 0;
+    uint32 end = fifo->end;
     uint32 fifo_data_length = 0;
 
     do
@@ -324,74 +251,30 @@ fifo_state_enum fifo_read_buffer (fifo_struct *fifo, void *dat, uint32 *length,
         if(NULL == dat)
         {
             return_state = FIFO_BUFFER_NULL;
+            break;
         }
-        else
+
+        fifo_data_length = fifo_index_used(fifo, fifo_index_acquire(&fifo->head), end);
+        if(*length > fifo_data_length)                                          // 判断长度是否足够
         {
-            if((FIFO_RESET | FIFO_CLEAR) & fifo->execution)                     // 判断是否当前 FIFO 是否在执行清空或重置操作
+            *length = fifo_data_length;                                         // 纠正读取的长度
+            return_state = FIFO_DATA_NO_ENOUGH;                                 // 标志数据不够
+            if(0 == fifo_data_length)                                           // 如果没有数据 就直接退出
             {
-                *length = fifo_data_length;                                     // 纠正读取的长度
-                return_state = FIFO_READ_UNDO;                                  // 读取操作未完成
                 break;
             }
+        }
 
-            fifo_data_length = fifo_used(fifo);                                 // 获取当前数据有多少
-            if(*length > fifo_data_length)                                      // 判断长度是否足够
-            {
-                *length = fifo_data_length;                                     // 纠正读取的长度
-                return_state = FIFO_DATA_NO_ENOUGH;                             // 标志数据不够
-                if(0 == fifo_data_length)                                       // 如果没有数据 就直接退出
-                {
-                    fifo->execution &= ~FIFO_READ;                              // 读操作复位
-                    break;
-                }
-            }
+        spsc_ring_copy_out(
+            (const uint8 *)fifo->buffer,
+            (size_t)fifo->max << fifo->type,
+            (size_t)fifo_index_position(fifo, end) << fifo->type,
+            (uint8 *)dat,
+            (size_t)*length << fifo->type);
 
-            fifo->execution |= FIFO_READ;                                       // 读操作置位
-            temp_length = fifo->max - fifo->end;                                // 计算尾指针距离缓冲区尾还有多少空间
-            if(*length <= temp_length)                                          // 足够一次性读取完毕
-            {
-                switch(fifo->type)
-                {
-                    case FIFO_DATA_8BIT:    memcpy(dat, &(((uint8 *)fifo->buffer)[fifo->end]), *length);        break;
-                    case FIFO_DATA_16BIT:   memcpy(dat, &(((uint16 *)fifo->buffer)[fifo->end]), *length * 2);   break;
-                    case FIFO_DATA_32BIT:   memcpy(dat, &(((uint32 *)fifo->buffer)[fifo->end]), *length * 4);   break;
-                }
-            }
-            else
-            {
-                switch(fifo->type)
-                {
-                    case FIFO_DATA_8BIT:
-                    {
-                        memcpy(dat, &(((uint8 *)fifo->buffer)[fifo->end]), temp_length);
-                        memcpy(&(((uint8 *)dat)[temp_length]), fifo->buffer, *length - temp_length);
-                    }break;
-                    case FIFO_DATA_16BIT:
-                    {
-                        memcpy(dat, &(((uint16 *)fifo->buffer)[fifo->end]), temp_length * 2);
-                        memcpy(&(((uint16 *)dat)[temp_length]), fifo->buffer, (*length - temp_length) * 2);
-                    }break;
-                    case FIFO_DATA_32BIT:
-                    {
-                        memcpy(dat, &(((uint32 *)fifo->buffer)[fifo->end]), temp_length * 4);
-                        memcpy(&(((uint32 *)dat)[temp_length]), fifo->buffer, (*length - temp_length) * 4);
-                    }break;
-                }
-            }
-            fifo->execution &= ~FIFO_READ;                                      // 读操作复位
-        }
-        
         if(FIFO_READ_AND_CLEAN == flag)                                         // 如果选择读取并更改 FIFO 状态
         {
-            if((FIFO_RESET | FIFO_CLEAR | FIFO_READ) == fifo->execution)        // 不在 重置 清空 读取 状态 避免异常
-            {
-                return_state = FIFO_CLEAR_UNDO;                                 // 清空操作未完成
-                break;
-            }
-            fifo->execution |= FIFO_CLEAR;                                      // 清空作置位
-            fifo_end_offset(fifo, *length);                                     // 移动 FIFO 头指针
-            fifo->size += *length;                                              // 释放对应长度空间
-            fifo->execution &= ~FIFO_CLEAR;                                     // 清空作复位
+            fifo_index_release(&fifo->end, fifo_index_offset(fifo, end, *length));
         }
     }while(0);
 
@@ -406,16 +289,16 @@ fifo_state_enum fifo_read_buffer (fifo_struct *fifo, void *dat, uint32 *length,
 // 参数说明     flag                是否变更 FIFO 状态 可选择是否清空读取的数据
 // 返回参数     fifo_state_enum     操作状态
 // 使用示例     zf_log(fifo_read_tail_buffer(&fifo, data, &length, FIFO_READ_ONLY) == FIFO_SUCCESS, "fifo_read_buffer error");
-// 备注信息     如果使用 FIFO_READ_AND_CLEAN 操作 将会丢弃所有数据并清空整个 FIFO
-//              如果使用 FIFO_READ_AND_CLEAN 操作 将会丢弃所有数据并清空整个 FIFO
-//              如果使用 FIFO_READ_AND_CLEAN 操作 将会丢弃所有数据并清空整个 FIFO
+// 备注信息     只能由消费者调用 读取的是调用瞬间最新写入的 *length 个数据
+//              如果使用 FIFO_READ_AND_CLEAN 操作 将会丢弃读取瞬间 FIFO 中的所有数据
 //-------------------------------------------------------------------------------------------------------------------
 fifo_state_enum fifo_read_tail_buffer (fifo_struct *fifo, void *dat, uint32 *length, fifo_operation_enum flag)
 {
     // zf_assert(NULL != fifo);
     // zf_assert(NULL != length);
     fifo_state_enum return_state = FIFO_SUCCESS;                                // 操作结果初值
-    uint32 temp_length = 0;
+    uint32 head = fifo_index_acquire(&fifo->head);
+    uint32 start;
     uint32 fifo_data_length = 0;
 
     do
@@ -423,71 +306,31 @@ fifo_state_enum fifo_read_tail_buffer (fifo_struct *fifo, void *dat, uint32 *len
         if(NULL == dat)
         {
             return_state = FIFO_BUFFER_NULL;
+            break;
         }
-        else
+
+        fifo_data_length = fifo_index_used(fifo, head, fifo->end);
+        if(*length > fifo_data_length)                                          // 判断长度是否足够
         {
-            if((FIFO_RESET | FIFO_CLEAR | FIFO_WRITE) & fifo->execution)        // 判断是否当前 FIFO 是否在执行清空或重置操作
+            *length = fifo_data_length;                                         // 纠正读取的长度
+            return_state = FIFO_DATA_NO_ENOUGH;                                 // 标志数据不够
+            if(0 == fifo_data_length)                                           // 如果没有数据 就直接退出
             {
-                *length = fifo_data_length;                                     // 纠正读取的长度
-                return_state = FIFO_READ_UNDO;                                  // 读取操作未完成
                 break;
             }
+        }
 
-            fifo_data_length = fifo_used(fifo);                                 // 获取当前数据有多少
-            if(*length > fifo_data_length)                                      // 判断长度是否足够
-            {
-                *length = fifo_data_length;                                     // 纠正读取的长度
-                return_state = FIFO_DATA_NO_ENOUGH;                             // 标志数据不够
-                if(0 == fifo_data_length)                                       // 如果没有数据 就直接退出
-                {
-                    fifo->execution &= ~FIFO_READ;                              // 读操作复位
-                    break;
-                }
-            }
+        start = (head >= *length) ? (head - *length) : (head + 2 * fifo->max - *length);
+        spsc_ring_copy_out(
+            (const uint8 *)fifo->buffer,
+            (size_t)fifo->max << fifo->type,
+            (size_t)fifo_index_position(fifo, start) << fifo->type,
+            (uint8 *)dat,
+            (size_t)*length << fifo->type);
 
-            fifo->execution |= FIFO_READ;                                       // 读操作置位
-            if((fifo->head > fifo->end) || (fifo->head >= *length))
-            {
-                switch(fifo->type)
-                {
-                    case FIFO_DATA_8BIT:    memcpy(dat, &(((uint8 *)fifo->buffer)[fifo->head - *length]), *length);     break;
-                    case FIFO_DATA_16BIT:   memcpy(dat, &(((uint16 *)fifo->buffer)[fifo->head - *length]), *length * 2);break;
-                    case FIFO_DATA_32BIT:   memcpy(dat, &(((uint32 *)fifo->buffer)[fifo->head - *length]), *length * 4);break;
-                }
-            }
-            else
-            {
-                temp_length = *length - fifo->head;                             // 计算尾指针距离缓冲区尾还有多少空间
-                switch(fifo->type)
-                {
-                    case FIFO_DATA_8BIT:
-                    {
-                        memcpy(dat, &(((uint8 *)fifo->buffer)[fifo->max - temp_length]), temp_length);
-                        memcpy(&(((uint8 *)dat)[temp_length]), &(((uint8 *)fifo->buffer)[fifo->head - *length]), (*length - temp_length));
-                    }break;
-                    case FIFO_DATA_16BIT:
-                    {
-                        memcpy(dat, &(((uint16 *)fifo->buffer)[fifo->max - temp_length]), temp_length * 2);
-                        memcpy(&(((uint16 *)dat)[temp_length]), &(((uint16 *)fifo->buffer)[fifo->head - *length]), (*length - temp_length) * 2);
-                    }break;
-                    case FIFO_DATA_32BIT:
-                    {
-                        memcpy(dat, &(((uint32 *)fifo->buffer)[fifo->max - temp_length]), temp_length * 4);
-                        memcpy(&(((uint32 *)dat)[temp_length]), &(((uint32 *)fifo->buffer)[fifo->head - *length]), (*length - temp_length) * 4);
-                    }break;
-                }
-            }
-            fifo->execution &= ~FIFO_READ;                                      // 读操作复位
-        }
-        
         if(FIFO_READ_AND_CLEAN == flag)                                         // 如果选择读取并更改 FIFO 状态
         {
-            if((FIFO_RESET | FIFO_CLEAR | FIFO_READ) == fifo->execution)        // 不在 重置 清空 读取 状态 避免异常
-            {
-                return_state = FIFO_CLEAR_UNDO;                                 // 清空操作未完成
-                break;
-            }
-            fifo_clear(fifo);
+            fifo_index_release(&fifo->end, head);                               // 丢弃读取瞬间之前写入的全部数据
         }
     }while(0);
 
@@ -502,7 +345,7 @@ fifo_state_enum fifo_read_tail_buffer (fifo_struct *fifo, void *dat, uint32 *len
 // 参数说明     size                缓冲区大小
 // 返回参数     fifo_state_enum     操作状态
 // 使用示例     fifo_init(&user_fifo, user_buffer, 64);
-// 备注信息     
+// 备注信息
 //-------------------------------------------------------------------------------------------------------------------
 fifo_state_enum fifo_init (fifo_struct *fifo, fifo_data_type_enum type, void *buffer_addr, uint32 size)
 {
@@ -515,7 +358,6 @@ fifo_state_enum fifo_init (fifo_struct *fifo, fifo_data_type_enum type, void *bu
         fifo->type      = type;
         fifo->head      = 0;
         fifo->end       = 0;
-        fifo->size      = size;
         fifo->max       = size;
     }while(0);
     return return_state;
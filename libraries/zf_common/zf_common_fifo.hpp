@@ -2,6 +2,7 @@
 #define _zf_common_fifo_h_
 
 #include "zf_common_typedef.hpp"
+#include "zf_common_spsc_ring.hpp"
 
 typedef enum
 {
@@ -17,12 +18,11 @@ typedef enum
 }fifo_state_enum;                                                               // FIFO 操作结果
 
 // 操作逻辑
-// 整体重置操作   将会强制清空 FIFO 谨慎使用
-// 数据写入操作   不能在重置以及写入操作时进行
-// 顺序读取操作   不能在清空和重置操作时进行
-// 尾部读取操作   不能在清空和重置以及写入操作时进行
-// 读取清空操作   不能在清空和重置以及读取操作时进行
-// 这是为了防止中断嵌套导致数据混乱
+// FIFO 按 SpscRing 的单生产者单消费者协议实现 一个线程写入 另一个线程读取无需加锁
+// 数据写入操作   fifo_write_element / fifo_write_buffer 只能由同一个生产者线程调用
+// 数据读取操作   fifo_read_element / fifo_read_buffer / fifo_read_tail_buffer 只能由同一个消费者线程调用
+// 整体重置操作   fifo_clear / fifo_init 将会强制清空 FIFO 只能在没有其他线程访问时调用
+// 多个线程写入或多个线程读取时 需要在同一侧自行加锁
 typedef enum
 {
     FIFO_IDLE       = 0x00,                                                     // 空闲状态
@@ -31,7 +31,7 @@ typedef enum
     FIFO_CLEAR      = 0x02,                                                     // 正在执行清空缓冲区
     FIFO_WRITE      = 0x04,                                                     // 正在执行写入缓冲区
     FIFO_READ       = 0x08,                                                     // 正在执行读取缓冲区
-}fifo_execution_enum;                                                           // FIFO 操作状态 为嵌套使用预留 无法完全避免误操作
+}fifo_execution_enum;                                                           // FIFO 操作状态 保留兼容 同步改由读写指针的原子操作完成
 
 typedef enum
 {
@@ -46,18 +46,16 @@ typedef enum
     FIFO_DATA_32BIT,                                                            // FIFO 数据位宽 32bit
 }fifo_data_type_enum;
 
-_Pragma("pack(push,1)")
+// 不再使用单字节对齐 保证 head/end 自然对齐 原子读写有效
 typedef struct
 {
-    uint8               execution;                                              // 执行步骤
+    uint8               execution;                                              // 执行步骤 保留兼容
     fifo_data_type_enum type;                                                   // 数据类型
     void                *buffer;                                                // 缓存指针
-    uint32              head;                                                   // 缓存头指针 总是指向空的缓存
-    uint32              end;                                                    // 缓存尾指针 总是指向非空缓存（缓存全空除外）
-    uint32              size;                                                   // 缓存剩余大小
+    uint32              head;                                                   // 写入位置 取值 [0, 2*max) 仅生产者修改
+    uint32              end;                                                    // 读取位置 取值 [0, 2*max) 仅消费者修改 与 head 相等表示为空 相差 max 表示已满
     uint32              max;                                                    // 缓存总大小
 }fifo_struct;
-_Pragma("pack(pop)")
 
 fifo_state_enum fifo_clear              (fifo_struct *fifo);
 uint32          fifo_used               (fifo_struct *fifo);
@@ -1,4 +1,5 @@
 #include "zf_common_function.hpp"
+#include <cmath>
 
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介     获取整型数的最大公约数 九章算术之更相减损术
@@ -37,62 +38,481 @@ void func_soft_delay (volatile long t)
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     字符串转整形数字 数据范围是 [-32768,32767]
-// 参数说明     *str            传入字符串 可带符号
-// 返回参数     int32           转换后的数据          
-// 使用示例     int32 dat = func_str_to_int("-100");
-// 备注信息     
+// 函数简介     两位十进制数字表 第 n 项为 n 的两位字符 00~99
+// 备注信息     每次查表写出两位数字 除法次数减半
 //-------------------------------------------------------------------------------------------------------------------
-int32 func_str_to_int (char *str)
+static const char func_digit_pair[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint32 func_power10[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     计算十进制位数
+// 参数说明     number          传入的数据
+// 返回参数     uint8           位数 0 也算1位
+// 使用示例     uint8 length = func_digit_count(300);                           // 返回 3
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//-------------------------------------------------------------------------------------------------------------------
+static inline uint8 func_digit_count (uint32 number)
 {
-    //zf_assert(str != NULL);
-    uint8 sign = 0;                                                             // 标记符号 0-正数 1-负数
-    int32 temp = 0;                                                             // 临时计算变量
-    do
+    uint8 length = 1;
+    while(length < 10 && number >= func_power10[length])
     {
-        if(NULL == str)
+        length ++;
+    }
+    return length;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     无符号数转为固定位数的十进制字符 不足时高位补0
+// 参数说明     *str            字符串指针
+// 参数说明     number          传入的数据 必须小于 10^length
+// 参数说明     length          位数
+// 返回参数     void
+// 使用示例     func_format_digits(str, 5, 3);                                  // 结果输出 str = "005"
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//              从低位向高位每次写两位 不需要倒序
+//-------------------------------------------------------------------------------------------------------------------
+static inline void func_format_digits (char *str, uint32 number, uint8 length)
+{
+    char *p = str + length;
+    while(2 <= length)
+    {
+        uint32 quotient = number / 100;
+        p -= 2;
+        memcpy(p, &func_digit_pair[(number - quotient * 100) * 2], 2);
+        number = quotient;
+        length -= 2;
+    }
+    if(length)
+    {
+        *(-- p) = (char)('0' + number);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     无符号数转为十进制字符
+// 参数说明     *str            字符串指针
+// 参数说明     number          传入的数据
+// 返回参数     uint8           写入的字符数 不写入结束符
+// 使用示例     uint8 length = func_format_uint32(str, 300);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//-------------------------------------------------------------------------------------------------------------------
+static inline uint8 func_format_uint32 (char *str, uint32 number)
+{
+    uint8 length = func_digit_count(number);
+    func_format_digits(str, number, length);
+    return length;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     64位无符号数转为十进制字符
+// 参数说明     *str            字符串指针
+// 参数说明     number          传入的数据
+// 返回参数     uint8           写入的字符数 不写入结束符
+// 使用示例     uint8 length = func_format_uint64(str, value);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//              按10^9拆分为若干段 低位段补足9位
+//-------------------------------------------------------------------------------------------------------------------
+static uint8 func_format_uint64 (char *str, uint64_t number)
+{
+    uint8 length = 0;
+
+    if(number <= 0xFFFFFFFFu)
+    {
+        return func_format_uint32(str, (uint32)number);
+    }
+    length = func_format_uint64(str, number / 1000000000u);
+    func_format_digits(str + length, (uint32)(number % 1000000000u), 9);
+    return length + 9;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     浮点数转为定点小数字符串
+// 参数说明     *str            字符串指针
+// 参数说明     number          传入的数据
+// 参数说明     point_bit       小数位数 超过 FUNC_POINT_BIT_MAX 时按 FUNC_POINT_BIT_MAX 处理
+// 返回参数     uint8           写入的字符数 不写入结束符
+// 使用示例     uint8 length = func_format_double(str, 3.1415, 2);             // 结果输出 str = "3.14"
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//              整数部分与小数部分拆开后分别按整数转换 小数部分乘以 10^point_bit 后舍入
+//              乘积恰好落在 .5 上时用 fma 求出乘法的舍入误差判断真实值在哪一侧 真正的 .5 按四舍六入五成双处理
+//              结果与 snprintf("%.*f") 逐字符相同 绝对值不小于 1e19 时按 snprintf("%.*e") 输出
+//-------------------------------------------------------------------------------------------------------------------
+static uint8 func_format_double (char *str, double number, uint8 point_bit)
+{
+    char *p = str;
+    double int_part = 0;
+    double product = 0;
+    double rounded = 0;
+    uint64_t int_value = 0;
+    uint32 point_value = 0;
+
+    if(FUNC_POINT_BIT_MAX < point_bit)
+    {
+        point_bit = FUNC_POINT_BIT_MAX;
+    }
+    if(std::signbit(number))
+    {
+        *p ++ = '-';
+        number = -number;
+    }
+    if(!(1e19 > number))
+    {
+        char temp[32];
+        int length = (number != number) ? snprintf(temp, sizeof(temp), "nan") :
+                     (number == (double)INFINITY) ? snprintf(temp, sizeof(temp), "inf") :
+                     snprintf(temp, sizeof(temp), "%.*e", point_bit, number);
+        memcpy(p, temp, (size_t)length);
+        return (uint8)(p - str + length);
+    }
+
+    if(0 == point_bit)
+    {
+        int_value = (uint64_t)std::nearbyint(number);                          // 默认舍入模式即为五成双
+    }
+    else
+    {
+        int_part = std::trunc(number);
+        int_value = (uint64_t)int_part;
+        product = (number - int_part) * func_power10[point_bit];               // 减法没有误差 乘法可能有
+        rounded = std::nearbyint(product);
+        if(0.5 == product - std::floor(product))
         {
-            break;
+            double error = std::fma(number - int_part, (double)func_power10[point_bit], -product);
+            if(0 != error)
+            {
+                rounded = (0 < error) ? std::floor(product) + 1 : std::floor(product);
+            }
+        }
+        point_value = (uint32)rounded;
+        if(func_power10[point_bit] <= point_value)                             // 小数部分进位
+        {
+            point_value -= func_power10[point_bit];
+            int_value ++;
+        }
+    }
+
+    p += func_format_uint64(p, int_value);
+    if(point_bit)
+    {
+        *p ++ = '.';
+        func_format_digits(p, point_value, point_bit);
+        p += point_bit;
+    }
+    return (uint8)(p - str);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     无符号数转为十六进制或八进制字符
+// 参数说明     *str            字符串指针
+// 参数说明     number          传入的数据
+// 参数说明     shift           每位的比特数 4-十六进制 3-八进制
+// 参数说明     upper           1-使用大写字母
+// 返回参数     uint8           写入的字符数 不写入结束符
+// 使用示例     uint8 length = func_format_radix(str, 0x1F, 4, 1);            // 结果输出 str = "1F"
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//-------------------------------------------------------------------------------------------------------------------
+static uint8 func_format_radix (char *str, uint64_t number, uint8 shift, uint8 upper)
+{
+    const char *digit = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    uint64_t mask = (1u << shift) - 1;
+    uint8 length = 1;
+
+    while(length * shift < 64 && (number >> (length * shift)))
+    {
+        length ++;
+    }
+    for(uint8 i = length; 0 < i; i --)
+    {
+        str[i - 1] = digit[number & mask];
+        number >>= shift;
+    }
+    return length;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     double 可精确表示的10的整数次方 10^0~10^22
+// 备注信息     有效数字不超过 2^53 且指数在此范围内时 一次乘除即得到正确舍入的结果
+//-------------------------------------------------------------------------------------------------------------------
+static const double func_double_power10[23] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define FUNC_DECIMAL_DIGIT_MAX      ( 19 )                                      // uint64 能容纳的十进制有效数字位数
+#define FUNC_EXPONENT_LIMIT         ( 100000 )                                  // 指数部分的累加上限 远超 double 范围 防止溢出
+
+// 十进制数字的中间结果 数值为 mantissa * 10^exponent
+typedef struct
+{
+    const char  *text;                                                          // 符号之后的数字文本起始位置
+    uint64_t    mantissa;                                                       // 前 FUNC_DECIMAL_DIGIT_MAX 位有效数字
+    int32       exponent;
+    uint8       negative;
+    uint8       truncated;                                                      // 1-有效数字之后还有被丢弃的非0数字
+    uint8       special;                                                        // 0-普通数字 1-inf 2-nan
+}func_decimal_struct;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     累加连续的十进制数字
+// 参数说明     *p              起始位置
+// 参数说明     *end            结束位置 该位置不读取
+// 参数说明     limit           允许的最大值 不超过 2^32
+// 参数说明     *number         累加结果 大于 limit 表示超出范围
+// 返回参数     const char *    第一个非数字字符的位置 没有数字时等于 p
+// 使用示例     p = func_scan_digits(p, end, 0xFFFFFFFF, &number);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//              无符号减法把非数字字符映射到大于9的值 每个字符只有一次比较
+//              超出 limit 后不再累加 但继续跳过剩余数字 与 std::from_chars 相同
+//-------------------------------------------------------------------------------------------------------------------
+static inline const char *func_scan_digits (const char *p, const char *end, uint64_t limit, uint64_t *number)
+{
+    uint64_t result = 0;
+    uint32 digit = 0;
+
+    while(p < end && 10 > (digit = (uint32)((uint8)*p - '0')))
+    {
+        if(result <= limit)
+        {
+            result = result * 10 + digit;
+        }
+        p ++;
+    }
+    *number = result;
+    return p;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     不区分大小写匹配单词
+// 参数说明     *p              起始位置
+// 参数说明     *end            结束位置
+// 参数说明     *word           小写单词
+// 返回参数     uint8           匹配的长度 不匹配返回0
+// 使用示例     p += func_match_word(p, end, "inf");
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//-------------------------------------------------------------------------------------------------------------------
+static uint8 func_match_word (const char *p, const char *end, const char *word)
+{
+    uint8 length = 0;
+
+    for(; 0 != word[length]; length ++)
+    {
+        if(p + length >= end || word[length] != (p[length] | 0x20))
+        {
+            return 0;
+        }
+    }
+    return length;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     扫描十进制浮点数文本
+// 参数说明     *p              起始位置
+// 参数说明     *end            结束位置
+// 参数说明     *decimal        扫描结果
+// 返回参数     const char *    第一个未使用的字符位置 没有数字时返回 NULL
+// 使用示例     p = func_scan_decimal(str, str + length, &decimal);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//              格式为 [+-] 数字 [. 数字] [e|E [+-] 数字] 或 inf infinity nan 整数与小数部分至少有一位数字
+//              数字只做整数累加 小数点与指数只改变 exponent 最后由调用方一次缩放
+//-------------------------------------------------------------------------------------------------------------------
+static const char *func_scan_decimal (const char *p, const char *end, func_decimal_struct *decimal)
+{
+    uint64_t mantissa = 0;
+    int32 exponent = 0;
+    uint32 digit = 0;
+    uint8 count = 0;                                                            // 已记录的有效数字位数 前导0不计
+    uint8 truncated = 0;
+    uint8 found = 0;
+    uint8 length = 0;
+
+    memset(decimal, 0, sizeof(func_decimal_struct));
+    if(p < end && ('-' == *p || '+' == *p))
+    {
+        decimal->negative = ('-' == *p);
+        p ++;
+    }
+    decimal->text = p;
+
+    if(p < end && ('i' == (*p | 0x20) || 'n' == (*p | 0x20)))
+    {
+        if(0 != (length = func_match_word(p, end, "infinity")) || 0 != (length = func_match_word(p, end, "inf")))
+        {
+            decimal->special = 1;
         }
+        else if(0 != (length = func_match_word(p, end, "nan")))
+        {
+            decimal->special = 2;
+        }
+        return length ? p + length : NULL;
+    }
+
+    while(p < end && 10 > (digit = (uint32)((uint8)*p - '0')))
+    {
+        if(FUNC_DECIMAL_DIGIT_MAX > count)
+        {
+            mantissa = mantissa * 10 + digit;
+            count += (0 != mantissa);
+        }
+        else
+        {
+            exponent ++;
+            truncated |= (0 != digit);
+        }
+        found = 1;
+        p ++;
+    }
+    if(p < end && '.' == *p)
+    {
+        p ++;
+        while(p < end && 10 > (digit = (uint32)((uint8)*p - '0')))
+        {
+            if(FUNC_DECIMAL_DIGIT_MAX > count)
+            {
+                mantissa = mantissa * 10 + digit;
+                count += (0 != mantissa);
+                exponent --;
+            }
+            else
+            {
+                truncated |= (0 != digit);
+            }
+            found = 1;
+            p ++;
+        }
+    }
+    if(!found)
+    {
+        return NULL;
+    }
+
+    if(p < end && 'e' == (*p | 0x20))                                          // 'e' 之后没有数字时不属于本数字
+    {
+        const char *exponent_text = p + 1;
+        const char *exponent_end = NULL;
+        uint64_t exponent_value = 0;
+        uint8 exponent_negative = 0;
 
-        if('-' == *str)                                                         // 如果第一个字符是负号
+        if(exponent_text < end && ('-' == *exponent_text || '+' == *exponent_text))
         {
-            sign = 1;                                                           // 标记负数
-            str ++;
+            exponent_negative = ('-' == *exponent_text);
+            exponent_text ++;
         }
-        else if('+' == *str)                                                    // 如果第一个字符是正号
+        exponent_end = func_scan_digits(exponent_text, end, FUNC_EXPONENT_LIMIT, &exponent_value);
+        if(exponent_end != exponent_text)
         {
-            str ++;
+            if(FUNC_EXPONENT_LIMIT < exponent_value)
+            {
+                exponent_value = FUNC_EXPONENT_LIMIT;
+            }
+            exponent += exponent_negative ? -(int32)exponent_value : (int32)exponent_value;
+            p = exponent_end;
         }
+    }
+
+    decimal->mantissa = mantissa;
+    decimal->exponent = exponent;
+    decimal->truncated = truncated;
+    return p;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     把扫描过的数字文本整理为以'\0'结尾的字符串 供 strtod/strtof 使用
+// 参数说明     *buffer         输出缓冲区 FUNC_PARSE_TOKEN_MAX 字节
+// 参数说明     *decimal        扫描结果
+// 参数说明     *end            数字文本结束位置
+// 返回参数     void
+// 使用示例     func_decimal_text(buffer, &decimal, p);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//              文本放得下时原样拷贝 结果与 strtod 完全相同
+//              放不下时用前19位有效数字重建 有丢弃的非0数字时补一位1 极少数情况下末位与 strtod 相差1ulp
+//-------------------------------------------------------------------------------------------------------------------
+static void func_decimal_text (char *buffer, const func_decimal_struct *decimal, const char *end)
+{
+    size_t length = (size_t)(end - decimal->text);
+
+    if(FUNC_PARSE_TOKEN_MAX > length)
+    {
+        memcpy(buffer, decimal->text, length);
+        buffer[length] = '\0';
+    }
+    else
+    {
+        snprintf(buffer, FUNC_PARSE_TOKEN_MAX, "%llu%se%d", (unsigned long long)decimal->mantissa,
+                 decimal->truncated ? "1" : "", (int)(decimal->exponent - decimal->truncated));
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     十进制扫描结果转 double 不含符号
+// 参数说明     *decimal        扫描结果 special 必须为0
+// 参数说明     *end            数字文本结束位置
+// 返回参数     double          正确舍入的绝对值 上溢为 inf 下溢为 0
+// 使用示例     double value = func_decimal_to_double(&decimal, p);
+// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+//              有效数字不超过 2^53 且指数在 ±22 以内时两个操作数都是精确值 一次乘除的结果就是正确舍入
+//              sysfs 属性与日常数值几乎都落在这个范围 其余情况把文本拷贝到栈上交给 strtod
+//-------------------------------------------------------------------------------------------------------------------
+static double func_decimal_to_double (const func_decimal_struct *decimal, const char *end)
+{
+    char buffer[FUNC_PARSE_TOKEN_MAX];
 
-        while(('0' <= *str) && ('9' >= *str))                                   // 确定这是个数字
+    if(0 == decimal->mantissa)
+    {
+        return 0.0;
+    }
+    if(!decimal->truncated && (1ULL << 53) >= decimal->mantissa && -22 <= decimal->exponent && 22 >= decimal->exponent)
+    {
+        return (0 > decimal->exponent) ? (double)decimal->mantissa / func_double_power10[-decimal->exponent] :
+                                         (double)decimal->mantissa * func_double_power10[decimal->exponent];
+    }
+    func_decimal_text(buffer, decimal, end);
+    return strtod(buffer, NULL);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     字符串转整形数字 数据范围是 [-2147483648,2147483647]
+// 参数说明     *str            传入字符串 可带符号
+// 返回参数     int32           转换后的数据 没有数字返回0 超出范围返回边界值
+// 使用示例     int32 dat = func_str_to_int("-100");
+// 备注信息     以'\0'结尾的字符串 长度已知时直接使用 func_parse_int
+//-------------------------------------------------------------------------------------------------------------------
+int32 func_str_to_int (char *str)
+{
+    //zf_assert(str != NULL);
+    int32 temp = 0;                                                             // 临时计算变量
+
+    do
+    {
+        if(NULL == str)
         {
-            temp = temp * 10 + ((uint8)(*str) - 0x30);                          // 计算数值
-            str ++;
+            break;
         }
 
-        if(sign)
+        if(FUNC_PARSE_RANGE == func_parse_int(str, strlen(str), &temp).error)
         {
-            temp = -temp;
+            temp = ('-' == *str) ? INT32_MIN : INT32_MAX;
         }
     }while(0);
     return temp;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     整形数字转字符串 数据范围是 [-32768,32767]
-// 参数说明     *str            字符串指针
+// 函数简介     整形数字转字符串
+// 参数说明     *str            字符串指针 至少11字节
 // 参数说明     number          传入的数据
 // 返回参数     void
 // 使用示例     func_int_to_str(data_buffer, -300);
-// 备注信息     
+// 备注信息     不写入结束符 与 snprintf("%d") 输出相同
 //-------------------------------------------------------------------------------------------------------------------
 void func_int_to_str (char *str, int32 number)
 {
     //zf_assert(str != NULL);
-    uint8 data_temp[16];                                                        // 缓冲区
-    uint8 bit = 0;                                                              // 数字位数
-    int32 number_temp = 0;
+    uint32 magnitude = (uint32)number;
 
     do
     {
@@ -104,34 +524,18 @@ void func_int_to_str (char *str, int32 number)
         if(0 > number)                                                          // 负数
         {
             *str ++ = '-';
-            number = -number;
-        }
-        else if(0 == number)                                                    // 或者这是个 0
-        {
-            *str = '0';
-            break;
-        }
-
-        while(0 != number)                                                      // 循环直到数值归零
-        {
-            number_temp = number % 10;
-            data_temp[bit ++] = func_abs(number_temp);                          // 倒序将数值提取出来
-            number /= 10;                                                       // 削减被提取的个位数
-        }
-        while(0 != bit)                                                         // 提取的数字个数递减处理
-        {
-            *str ++ = (data_temp[bit - 1] + 0x30);                              // 将数字从倒序数组中倒序取出 变成正序放入字符串
-            bit --;
+            magnitude = 0u - magnitude;                                         // 无符号取反 -2147483648 也不会溢出
         }
+        func_format_uint32(str, magnitude);
     }while(0);
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     字符串转整形数字 数据范围是 [0,65535]
+// 函数简介     字符串转整形数字 数据范围是 [0,4294967295]
 // 参数说明     *str            传入字符串 无符号
-// 返回参数     uint32          转换后的数据          
+// 返回参数     uint32          转换后的数据 没有数字返回0 超出范围返回最大值
 // 使用示例     uint32 dat = func_str_to_uint("100");
-// 备注信息     
+// 备注信息     以'\0'结尾的字符串 长度已知时直接使用 func_parse_uint
 //-------------------------------------------------------------------------------------------------------------------
 uint32 func_str_to_uint (char *str)
 {
@@ -145,10 +549,9 @@ uint32 func_str_to_uint (char *str)
             break;
         }
 
-        while(('0' <= *str) && ('9' >= *str))                                  // 确定这是个数字
+        if(FUNC_PARSE_RANGE == func_parse_uint(str, strlen(str), &temp).error)
         {
-            temp = temp * 10 + ((uint8)(*str) - 0x30);                         // 计算数值
-            str ++;
+            temp = UINT32_MAX;
         }
     }while(0);
 
@@ -156,19 +559,16 @@ uint32 func_str_to_uint (char *str)
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     整形数字转字符串 数据范围是 [0,65535]
-// 参数说明     *str            字符串指针
+// 函数简介     整形数字转字符串
+// 参数说明     *str            字符串指针 至少10字节
 // 参数说明     number          传入的数据
 // 返回参数     void
 // 使用示例     func_uint_to_str(data_buffer, 300);
-// 备注信息     
+// 备注信息     不写入结束符 与 snprintf("%u") 输出相同
 //-------------------------------------------------------------------------------------------------------------------
 void func_uint_to_str (char *str, uint32 number)
 {
     //zf_assert(str != NULL);
-    int8 data_temp[16];                                                         // 缓冲区
-    uint8 bit = 0;                                                              // 数字位数
-
     do
     {
         if(NULL == str)
@@ -176,39 +576,22 @@ void func_uint_to_str (char *str, uint32 number)
             break;
         }
 
-        if(0 == number)                                                         // 这是个 0
-        {
-            *str = '0';
-            break;
-        }
-
-        while(0 != number)                                                      // 循环直到数值归零
-        {
-            data_temp[bit ++] = (number % 10);                                  // 倒序将数值提取出来
-            number /= 10;                                                       // 削减被提取的个位数
-        }
-        while(0 != bit)                                                         // 提取的数字个数递减处理
-        {
-            *str ++ = (data_temp[bit - 1] + 0x30);                              // 将数字从倒序数组中倒序取出 变成正序放入字符串
-            bit --;
-        }
+        func_format_uint32(str, number);
     }while(0);
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     字符串转浮点数 有效累计精度为小数点后六位
-// 参数说明     *str            传入字符串 可带符号
-// 返回参数     float           转换后的数据          
+// 函数简介     字符串转浮点数
+// 参数说明     *str            传入字符串 可带符号 支持指数形式与 inf nan
+// 返回参数     float           转换后的数据 没有数字返回0
 // 使用示例     float dat = func_str_to_float("-100.2");
-// 备注信息     
+// 备注信息     以'\0'结尾的字符串 长度已知时直接使用 func_parse_float
+//              结果为正确舍入 超出范围时与 strtof 相同 返回 ±inf 或 0
 //-------------------------------------------------------------------------------------------------------------------
 float func_str_to_float (char *str)
 {
     //zf_assert(str != NULL);
-    uint8 sign = 0;                                                             // 标记符号 0-正数 1-负数
-    float temp = 0.0;                                                           // 临时计算变量 整数部分
-    float temp_point = 0.0;                                                     // 临时计算变量 小数部分
-    float point_bit = 1;                                                        // 小数累计除数
+    float temp = 0.0;                                                           // 临时计算变量
 
     do
     {
@@ -217,38 +600,9 @@ float func_str_to_float (char *str)
             break;
         }
 
-        if('-' == *str)                                                         // 负数
-        {
-            sign = 1;                                                           // 标记负数
-            str ++;
-        }
-        else if('+' == *str)                                                    // 如果第一个字符是正号
-        {
-            str ++;
-        }
-
-        // 提取整数部分
-        while(('0' <= *str) && ('9' >= *str))                                   // 确定这是个数字
+        if(FUNC_PARSE_RANGE == func_parse_float(str, strlen(str), &temp).error)
         {
-            temp = temp * 10 + ((uint8)(*str) - 0x30);                          // 将数值提取出来
-            str ++;
-        }
-        if('.' == *str)
-        {
-            str ++;
-            while(('0' <= *str) && ('9' >= *str) && point_bit < 1000000.0)      // 确认这是个数字 并且精度控制还没到六位
-            {
-                temp_point = temp_point * 10 + ((uint8)(*str) - 0x30);          // 提取小数部分数值
-                point_bit *= 10;                                                // 计算这部分小数的除数
-                str ++;
-            }
-            temp_point /= point_bit;                                            // 计算小数
-        }
-        temp += temp_point;                                                     // 将数值拼合
-
-        if(sign)
-        {
-            temp = -temp;
+            temp = strtof(str, NULL);
         }
     }while(0);
     return temp;
@@ -258,20 +612,15 @@ float func_str_to_float (char *str)
 // 函数简介     浮点数字转字符串
 // 参数说明     *str            字符串指针
 // 参数说明     number          传入的数据
-// 参数说明     point_bit       小数点精度
+// 参数说明     point_bit       小数点精度 最高 FUNC_POINT_BIT_MAX 位 为0时不输出小数点
 // 返回参数     void
 // 使用示例     func_float_to_str(data_buffer, 3.1415, 2);                      // 结果输出 data_buffer = "3.14"
-// 备注信息     
+// 备注信息     不写入结束符 按 point_bit 位四舍五入 与 snprintf("%.*f") 输出相同
+//              float 转为 double 后处理 小数部分乘以 10^point_bit 在 6 位以内没有误差
 //-------------------------------------------------------------------------------------------------------------------
 void func_float_to_str (char *str, float number, uint8 point_bit)
 {
     //zf_assert(str != NULL);
-    int data_int = 0;                                                           // 整数部分
-    int data_float = 0.0;                                                       // 小数部分
-    int data_temp[8];                                                           // 整数字符缓冲
-    int data_temp_point[6];                                                     // 小数字符缓冲
-    uint8 bit = point_bit;                                                      // 转换精度位数
-
     do
     {
         if(NULL == str)
@@ -279,82 +628,72 @@ void func_float_to_str (char *str, float number, uint8 point_bit)
             break;
         }
 
-        // 提取整数部分
-        data_int = (int)number;                                                 // 直接强制转换为 int
-        if(0 > number)                                                          // 判断源数据是正数还是负数
-        {
-            *str ++ = '-';
-        }
-        else if(0.0 == number)                                                  // 如果是个 0
-        {
-            *str ++ = '0';
-            *str ++ = '.';
-            *str = '0';
-            break;
-        }
+        func_format_double(str, (double)number, point_bit);
+    }while(0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     字符串转浮点数
+// 参数说明     str             传入字符串 可带符号 支持指数形式与 inf nan
+// 返回参数     double          转换后的数据 没有数字返回0
+// 使用示例     double dat = func_str_to_double("-100.2");
+// 备注信息     以'\0'结尾的字符串 长度已知时直接使用 func_parse_double
+//              结果为正确舍入 超出范围时与 strtod 相同 返回 ±inf 或 0
+//-------------------------------------------------------------------------------------------------------------------
+double func_str_to_double (char *str)
+{
+    //zf_assert(str != NULL);
+    double temp = 0.0;                                                          // 临时计算变量
 
-        // 提取小数部分
-        number = number - data_int;                                             // 减去整数部分即可
-        while(bit --)
+    do
+    {
+        if(NULL == str)
         {
-            number = number * 10;                                               // 将需要的小数位数提取到整数部分
+            break;
         }
-        data_float = (int)number;                                               // 获取这部分数值
 
-        // 整数部分转为字符串
-        bit = 0;
-        do
+        if(FUNC_PARSE_RANGE == func_parse_double(str, strlen(str), &temp).error)
         {
-            data_temp[bit ++] = data_int % 10;                                  // 将整数部分倒序写入字符缓冲区
-            data_int /= 10;
-        }while(0 != data_int);
-        while(0 != bit)
-        {
-            *str ++ = (func_abs(data_temp[bit - 1]) + 0x30);                    // 再倒序将倒序的数值写入字符串 得到正序数值
-            bit --;
+            temp = strtod(str, NULL);
         }
+    }while(0);
+    return temp;
+}
 
-        // 小数部分转为字符串
-        if(point_bit != 0)
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     浮点数字转字符串
+// 参数说明     *str            字符串指针
+// 参数说明     number          传入的数据
+// 参数说明     point_bit       小数点精度 最高 FUNC_POINT_BIT_MAX 位 为0时不输出小数点
+// 返回参数     void
+// 使用示例     func_double_to_str(data_buffer, 3.1415, 2);                     // 结果输出 data_buffer = "3.14"
+// 备注信息     不写入结束符 按 point_bit 位四舍五入 与 snprintf("%.*f") 输出相同
+//-------------------------------------------------------------------------------------------------------------------
+void func_double_to_str (char *str, double number, uint8 point_bit)
+{
+    //zf_assert(str != NULL);
+    do
+    {
+        if(NULL == str)
         {
-            bit = 0;
-            *str ++ = '.';
-            if(0 == data_float)
-            {
-                *str = '0';
-            }
-            else
-            {
-                while(0 != point_bit)                                           // 判断有效位数
-                {
-                    data_temp_point[bit ++] = data_float % 10;                  // 倒序写入字符缓冲区
-                    data_float /= 10;
-                    point_bit --;                                                
-                }
-                while(0 != bit)
-                {
-                    *str ++ = (func_abs(data_temp_point[bit - 1]) + 0x30);      // 再倒序将倒序的数值写入字符串 得到正序数值
-                    bit --;
-                }
-            }
+            break;
         }
+
+        func_format_double(str, number, point_bit);
     }while(0);
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     字符串转浮点数 有效累计精度为小数点后九位
-// 参数说明     str             传入字符串 可带符号
-// 返回参数     double          转换后的数据          
-// 使用示例     double dat = func_str_to_double("-100.2");
-// 备注信息     
+// 函数简介     字符串转 Hex
+// 参数说明     str             传入字符串 无符号 可带 0x 前缀
+// 返回参数     uint32          转换后的数据 没有数字返回0 超出范围返回最大值
+// 使用示例     uint32 dat = func_str_to_hex("0x11");
+// 备注信息     以'\0'结尾的字符串 长度已知时直接使用 func_parse_hex
 //-------------------------------------------------------------------------------------------------------------------
-double func_str_to_double (char *str)
+uint32 func_str_to_hex (char *str)
 {
     //zf_assert(str != NULL);
-    uint8 sign = 0;                                                             // 标记符号 0-正数 1-负数
-    double temp = 0.0;                                                          // 临时计算变量 整数部分
-    double temp_point = 0.0;                                                    // 临时计算变量 小数部分
-    double point_bit = 1;                                                       // 小数累计除数
+    uint32 result_data = 0;                                                     // 结果缓存
 
     do
     {
@@ -363,62 +702,26 @@ double func_str_to_double (char *str)
             break;
         }
 
-        if('-' == *str)                                                         // 负数
-        {
-            sign = 1;                                                           // 标记负数
-            str ++;
-        }
-        else if('+' == *str)                                                    // 如果第一个字符是正号
+        if(FUNC_PARSE_RANGE == func_parse_hex(str, strlen(str), &result_data).error)
         {
-            str ++;
-        }
-
-        // 提取整数部分
-        while(('0' <= *str) && ('9' >= *str))                                   // 确定这是个数字
-        {
-            temp = temp * 10 + ((uint8)(*str) - 0x30);                          // 将数值提取出来
-            str ++;
-        }
-        if('.' == *str)
-        {
-            str ++;
-            while(('0' <= *str) && ('9' >= *str) && point_bit < 1000000000.0)   // 确认这是个数字 并且精度控制还没到九位
-            {
-                temp_point = temp_point * 10 + ((uint8)(*str) - 0x30);          // 提取小数部分数值
-                point_bit *= 10;                                                // 计算这部分小数的除数
-                str ++;
-            }
-            temp_point /= point_bit;                                            // 计算小数
-        }
-        temp += temp_point;                                                     // 将数值拼合
-
-        if(sign)
-        {
-            temp = -temp;
+            result_data = UINT32_MAX;
         }
     }while(0);
-    return temp;
 
+    return result_data;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     浮点数字转字符串
+// 函数简介     Hex 转字符串
 // 参数说明     *str            字符串指针
 // 参数说明     number          传入的数据
-// 参数说明     point_bit       小数点精度
 // 返回参数     void
-// 使用示例     func_double_to_str(data_buffer, 3.1415, 2);                     // 结果输出 data_buffer = "3.14"
-// 备注信息     
+// 使用示例     func_hex_to_str(data_buffer, 0x11);                             // 结果输出 data_buffer = "0x11"
+// 备注信息     不写入结束符 字母为大写
 //-------------------------------------------------------------------------------------------------------------------
-void func_double_to_str (char *str, double number, uint8 point_bit)
+void func_hex_to_str (char *str, uint32 number)
 {
     //zf_assert(str != NULL);
-    int data_int = 0;                                                           // 整数部分
-    int data_float = 0.0;                                                       // 小数部分
-    int data_temp[12];                                                          // 整数字符缓冲
-    int data_temp_point[9];                                                     // 小数字符缓冲
-    uint8 bit = point_bit;                                                      // 转换精度位数
-
     do
     {
         if(NULL == str)
@@ -426,446 +729,410 @@ void func_double_to_str (char *str, double number, uint8 point_bit)
             break;
         }
 
-        // 提取整数部分
-        data_int = (int)number;                                                 // 直接强制转换为 int
-        if(0 > number)                                                          // 判断源数据是正数还是负数
-        {
-            *str ++ = '-';
-        }
-        else if(0.0 == number)                                                  // 如果是个 0
-        {
-            *str ++ = '0';
-            *str ++ = '.';
-            *str = '0';
-            break;
-        }
+        *str ++ = '0';
+        *str ++ = 'x';
+        func_format_radix(str, number, 4, 1);
+    }while(0);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     sprintf 函数实现
+// 参数说明     *buff           缓冲区
+// 参数说明     *format         源字符串
+// 参数说明     ...             可变参数列表
+// 返回参数     uint32          处理后数据长 不含结束符
+// 使用示例     zf_sprintf(buff, "Data : %d", 100);
+// 备注信息     支持 %c %d %i %u %o %x %X %s %p %% 与 %f %F 其中 %f 可以用 %.3f 指定小数位数 默认6位
+//              数字输出与 snprintf 相同 缓冲区需要比返回值多1字节用于结束符
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_sprintf (int8 *buff, const int8 *format, ...)
+{
+    char *out = (char *)buff;
+    va_list arg;
+    va_start(arg, format);
 
-        // 提取小数部分
-        number = number - data_int;                                             // 减去整数部分即可
-        while(bit --)
+    while (*format)
+    {
+        if ('%' != *format)
         {
-            number = number * 10;                                               // 将需要的小数位数提取到整数部分
+            *out ++ = (char)(*format ++);
+            continue;
         }
-        data_float = (int)number;                                               // 获取这部分数值
 
-        // 整数部分转为字符串
-        bit = 0;
-        do
-        {
-            data_temp[bit ++] = data_int % 10;                                  // 将整数部分倒序写入字符缓冲区
-            data_int /= 10;
-        }while(0 != data_int);
-        while(0 != bit)
+        uint8 point_bit = 6;
+        format ++;
+        if ('.' == *format)                                                     // 小数位数
         {
-            *str ++ = (func_abs(data_temp[bit - 1]) + 0x30);                    // 再倒序将倒序的数值写入字符串 得到正序数值
-            bit --;
+            point_bit = 0;
+            format ++;
+            while (('0' <= *format) && ('9' >= *format))
+            {
+                point_bit = (uint8)(point_bit * 10 + (*format - '0'));
+                format ++;
+            }
         }
 
-        // 小数部分转为字符串
-        if(point_bit != 0)
+        switch (*format)
         {
-            bit = 0;
-            *str ++ = '.';
-            if(0 == data_float)
-                *str = '0';
-            else
-            {
-                while(0 != point_bit)                                           // 判断有效位数
+            case 'a':// 十六进制p计数法输出浮点数 暂未实现
+                break;
+
+            case 'c':// 一个字符
+                *out ++ = (char)va_arg(arg, int);
+                break;
+
+            case 'd':
+            case 'i':// 有符号十进制整数
+                {
+                    int32 ival = (int32)va_arg(arg, int32);
+                    uint32 magnitude = (uint32)ival;
+                    if (0 > ival)
+                    {
+                        *out ++ = '-';
+                        magnitude = 0u - magnitude;
+                    }
+                    out += func_format_uint32(out, magnitude);
+                }
+                break;
+
+            case 'f':// 浮点数 默认输出小数点后六位
+            case 'F':
+                out += func_format_double(out, (double)va_arg(arg, double), point_bit);
+                break;
+
+            case 'u':// 无符号十进制整数
+                out += func_format_uint32(out, (uint32)va_arg(arg, uint32));
+                break;
+
+            case 'o':// 无符号八进制整数
+                out += func_format_radix(out, (uint32)va_arg(arg, uint32), 3, 0);
+                break;
+
+            case 'x':// 无符号十六进制整数
+            case 'X':
+                out += func_format_radix(out, (uint32)va_arg(arg, uint32), 4, 'X' == *format);
+                break;
+
+            case 's':// 字符串
                 {
-                    data_temp_point[bit ++] = data_float % 10;                  // 倒序写入字符缓冲区
-                    data_float /= 10;
-                    point_bit --;                                                
+                    const char *pc = (const char *)va_arg(arg, int8 *);
+                    size_t length = strlen(pc);
+                    memcpy(out, pc, length);
+                    out += length;
                 }
-                while(0 != bit)
+                break;
+
+            case 'p':// 以16进制形式输出指针 固定为指针宽度的位数
                 {
-                    *str ++ = (func_abs(data_temp_point[bit - 1]) + 0x30);      // 再倒序将倒序的数值写入字符串 得到正序数值
-                    bit --;
+                    uint64_t ival = (uint64_t)(uintptr_t)va_arg(arg, void *);
+                    uint8 length = sizeof(void *) * 2;
+                    for (uint8 i = length; 0 < i; i --)
+                    {
+                        out[i - 1] = "0123456789ABCDEF"[ival & 0xF];
+                        ival >>= 4;
+                    }
+                    out += length;
                 }
-            }
+                break;
+
+            case '%':// 输出字符%
+                *out ++ = '%';
+                break;
+
+            case '\0':// 格式串以单独的%结尾
+                format --;
+                break;
+
+            default:
+                break;
         }
-    }while(0);
+        format ++;
+    }
+    va_end(arg);
+    *out = '\0';
+
+    return (uint32)(out - (char *)buff);
 }
 
+
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     字符串转 Hex
-// 参数说明     str             传入字符串 无符号
-// 返回参数     uint32          转换后的数据
-// 使用示例     uint32 dat = func_str_to_hex("0x11");
-// 备注信息     
+// 函数简介     按长度解析整形数字 数据范围是 [-2147483648,2147483647]
+// 参数说明     *str            起始位置 不要求以'\0'结尾
+// 参数说明     length          最多读取的字节数
+// 参数说明     *value          解析结果 失败时不修改
+// 返回参数     func_parse_result_struct    ptr 为第一个未解析的字符 error 为错误码
+// 使用示例     int32 raw; if(FUNC_PARSE_OK == func_parse_int(buffer, read_length, &raw).error) { ... }
+// 备注信息     格式为 [+-] 数字 不跳过前导空白 数字之后的内容(换行等)不读取 由调用方通过 ptr 判断
+//              可以直接解析 pread 读到的缓冲区 不需要补结束符 也不需要提前清零
 //-------------------------------------------------------------------------------------------------------------------
-uint32 func_str_to_hex (char *str)
+func_parse_result_struct func_parse_int (const char *str, size_t length, int32 *value)
 {
-    //zf_assert(str != NULL);
-    uint32 str_len = strlen(str);                                               // 字符串长
-    uint32 result_data = 0;                                                     // 结果缓存
-    uint8 temp = 0;                                                             // 计算变量
-    uint8 flag = 0;                                                             // 标志位
+    func_parse_result_struct result = {str, FUNC_PARSE_INVALID};
+    const char *p = str;
+    const char *end = NULL;
+    uint64_t number = 0;
+    uint64_t limit = 0x7FFFFFFF;
+    uint8 negative = 0;
 
     do
     {
-        if(NULL == str)
+        if(NULL == str || NULL == value)
         {
             break;
         }
 
-        if(flag)
+        end = str + length;
+        if(p < end && ('-' == *p || '+' == *p))
         {
-            if(('a' <= *str) && ('f' >= *str))
-            {
-                temp = (*str - 87);
-            }
-            else if(('A' <= *str) && ('F' >= *str))
-            {
-                temp = (*str - 55);
-            }
-            else if(('0' <= *str) && ('9' >= *str))
-            {
-                temp = (*str - 48);
-            }
-            else
-            {
-                break;
-            }
-            result_data = ((result_data << 4) | (temp & 0x0F));
+            negative = ('-' == *p);
+            limit += negative;                                                  // 负数多一个 -2147483648
+            p ++;
         }
-        else
+        end = func_scan_digits(p, end, limit, &number);
+        if(end == p)
         {
-//            if(strncmp("0x", str, 2))
-            if((*str == '0') && (*(str + 1) == 'x'))
-            {
-                str ++;
-                flag = 1;
-            }
+            break;
         }
-        str ++;
-    }while(str_len --);
 
-    return result_data;
+        result.ptr = end;
+        if(limit < number)
+        {
+            result.error = FUNC_PARSE_RANGE;
+            break;
+        }
+        *value = negative ? (int32)(0u - (uint32)number) : (int32)number;
+        result.error = FUNC_PARSE_OK;
+    }while(0);
+    return result;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     Hex 转字符串
-// 参数说明     *str            字符串指针
-// 参数说明     number          传入的数据
-// 返回参数     void
-// 使用示例     func_hex_to_str(data_buffer, 0x11);                             // 结果输出 data_buffer = "0x11"
-// 备注信息     
+// 函数简介     按长度解析无符号整形数字 数据范围是 [0,4294967295]
+// 参数说明     *str            起始位置 不要求以'\0'结尾
+// 参数说明     length          最多读取的字节数
+// 参数说明     *value          解析结果 失败时不修改
+// 返回参数     func_parse_result_struct    ptr 为第一个未解析的字符 error 为错误码
+// 使用示例     uint32 dat; func_parse_uint(buffer, read_length, &dat);
+// 备注信息     格式为 [+] 数字 负号视为无效
 //-------------------------------------------------------------------------------------------------------------------
-void func_hex_to_str (char *str, uint32 number)
+func_parse_result_struct func_parse_uint (const char *str, size_t length, uint32 *value)
 {
-    //zf_assert(str != NULL);
-    const char hex_index[16] = {
-        '0', '1', '2', '3',
-        '4', '5', '6', '7',
-        '8', '9', 'A', 'B',
-        'C', 'D', 'E', 'F'};
-    int8 data_temp[12];                                                         // 缓冲区
-    uint8 bit = 0;                                                              // 数字位数
-
-    *str++ = '0';
-    *str++ = 'x';
+    func_parse_result_struct result = {str, FUNC_PARSE_INVALID};
+    const char *p = str;
+    const char *end = NULL;
+    uint64_t number = 0;
+
     do
     {
-        if(NULL == str)
+        if(NULL == str || NULL == value)
         {
             break;
         }
 
-        if(0 == number)                                                         // 这是个 0
+        end = str + length;
+        if(p < end && '+' == *p)
         {
-            *str = '0';
-            break;
+            p ++;
         }
-
-        while(0 != number)                                                      // 循环直到数值归零
+        end = func_scan_digits(p, end, 0xFFFFFFFF, &number);
+        if(end == p)
         {
-            data_temp[bit ++] = (number & 0xF);                                 // 倒序将数值提取出来
-            number >>= 4;                                                       // 削减被提取的个位数
+            break;
         }
-        while(0 != bit)                                                         // 提取的数字个数递减处理
+
+        result.ptr = end;
+        if(0xFFFFFFFF < number)
         {
-            *str ++ = hex_index[data_temp[bit - 1]];                            // 将数字从倒序数组中倒序取出 变成正序放入字符串
-            bit --;
+            result.error = FUNC_PARSE_RANGE;
+            break;
         }
+        *value = (uint32)number;
+        result.error = FUNC_PARSE_OK;
     }while(0);
+    return result;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     数字转换为 ASCII 值
-// 参数说明     dat             传入的数据
-// 参数说明     *p              数据缓冲
-// 参数说明     neg_type        数据类型
-// 参数说明     radix           进制
-// 返回参数     uint8           数据
-// 使用示例     number_conversion_ascii((uint32)ival, vstr, 1, 10);
-// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+// 函数简介     按长度解析十六进制数字 数据范围是 [0,0xFFFFFFFF]
+// 参数说明     *str            起始位置 不要求以'\0'结尾
+// 参数说明     length          最多读取的字节数
+// 参数说明     *value          解析结果 失败时不修改
+// 返回参数     func_parse_result_struct    ptr 为第一个未解析的字符 error 为错误码
+// 使用示例     uint32 dat; func_parse_hex("0x1F", 4, &dat);                    // dat = 0x1F
+// 备注信息     格式为 [0x|0X] 十六进制数字 字母不区分大小写
+//              "0x" 之后没有十六进制数字时只解析开头的 "0" 与 std::strtoul 相同
 //-------------------------------------------------------------------------------------------------------------------
-static uint8 number_conversion_ascii (uint32 dat, int8 *p, uint8 neg_type, uint8 radix)
+func_parse_result_struct func_parse_hex (const char *str, size_t length, uint32 *value)
 {
-    int32   neg_dat;
-    uint32  pos_dat;
-    uint8   temp_data = 0;
-    uint8   valid_num = 0;
+    func_parse_result_struct result = {str, FUNC_PARSE_INVALID};
+    const char *p = str;
+    const char *end = NULL;
+    const char *digit_start = NULL;
+    uint64_t number = 0;
+    uint32 digit = 0;
 
-    if(neg_type)
+    do
     {
-        neg_dat = (int32)dat;
-        if(0 > neg_dat)
+        if(NULL == str || NULL == value)
         {
-            neg_dat = -neg_dat;
+            break;
         }
-        while(1)
-        {
-            *p = neg_dat%radix + '0';
-            neg_dat = neg_dat/radix;
-            valid_num ++;
 
-            if(!neg_dat)
+        end = str + length;
+        if(2 < end - p && '0' == p[0] && 'x' == (p[1] | 0x20))
+        {
+            digit = (uint32)((uint8)p[2] - '0');
+            if(10 > digit || 6 > (uint32)((uint8)(p[2] | 0x20) - 'a'))
             {
-                break;
+                p += 2;
             }
-            p ++;
         }
-    }
-    else
-    {
-        pos_dat = dat;
-        while(1)
+        digit_start = p;
+        while(p < end)
         {
-            temp_data = pos_dat%radix;
-            if(10 <= temp_data)
+            digit = (uint32)((uint8)*p - '0');
+            if(10 <= digit)
             {
-                temp_data += 'A'-10;
-            }
-            else
-            {
-                temp_data += '0';
+                digit = (uint32)((uint8)(*p | 0x20) - 'a');
+                if(6 <= digit)
+                {
+                    break;
+                }
+                digit += 10;
             }
-
-            *p = temp_data;
-
-            pos_dat = pos_dat/radix;
-            valid_num ++;
-
-            if(!pos_dat)
+            if(0xFFFFFFFF >= number)
             {
-                break;
+                number = (number << 4) | digit;
             }
             p ++;
         }
-    }
-    return valid_num;
-}
+        if(digit_start == p)
+        {
+            break;
+        }
 
-//-------------------------------------------------------------------------------------------------------------------
-// 函数简介     printf 显示转换
-// 参数说明     *d_buff         缓冲区
-// 参数说明     len             长度
-// 返回参数     void
-// 使用示例     printf_reverse_order(vstr, vlen);
-// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
-//-------------------------------------------------------------------------------------------------------------------
-static void printf_reverse_order (int8 *d_buff, uint32 len)
-{
-    uint32 i;
-    int8  temp_data;
-    for(i = 0; len / 2 > i; i ++)
-    {
-        temp_data = d_buff[len - 1 - i];
-        d_buff[len - 1 -i ] = d_buff[i];
-        d_buff[i] = temp_data; 
-    }
+        result.ptr = p;
+        if(0xFFFFFFFF < number)
+        {
+            result.error = FUNC_PARSE_RANGE;
+            break;
+        }
+        *value = (uint32)number;
+        result.error = FUNC_PARSE_OK;
+    }while(0);
+    return result;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介     sprintf 函数实现
-// 参数说明     *buff           缓冲区
-// 参数说明     *format         源字符串
-// 参数说明     ...             可变参数列表
-// 返回参数     uint32          处理后数据长
-// 使用示例     zf_sprintf(buff, "Data : %d", 100);
-// 备注信息     本函数在文件内部调用 用户不用关注 也不可修改
+// 函数简介     按长度解析浮点数
+// 参数说明     *str            起始位置 不要求以'\0'结尾
+// 参数说明     length          最多读取的字节数
+// 参数说明     *value          解析结果 失败时不修改
+// 返回参数     func_parse_result_struct    ptr 为第一个未解析的字符 error 为错误码
+// 使用示例     float scale; func_parse_float(buffer, read_length, &scale);
+// 备注信息     格式见 func_parse_double 结果为正确舍入 与 strtof 相同
+//              先按 double 转换 double 结果恰好落在两个相邻 float 的中点时 再按原文本用 strtof 舍入 避免两次舍入的误差
+//              超出 float 范围(上溢为 inf 或非0值下溢为0)时返回 FUNC_PARSE_RANGE
 //-------------------------------------------------------------------------------------------------------------------
-uint32 zf_sprintf (int8 *buff, const int8 *format, ...)
+func_parse_result_struct func_parse_float (const char *str, size_t length, float *value)
 {
-    uint32 buff_len = 0;
-	va_list arg;
-	va_start(arg, format);
+    func_parse_result_struct result = {str, FUNC_PARSE_INVALID};
+    func_decimal_struct decimal;
+    const char *end = NULL;
+    double wide = 0;
+    float narrow = 0;
 
-    while (*format)
+    do
     {
-        int8 ret = *format;
-        if ('%' == ret)
+        if(NULL == str || NULL == value)
         {
-            switch (*++ format)
-            {
-                case 'a':// 十六进制p计数法输出浮点数 暂未实现
-                    {
-                    }
-                    break;
-
-                case 'c':// 一个字符
-                    {
-                        int8 ch = (int8)va_arg(arg, uint32);
-                        *buff = ch;
-                        buff ++;
-                        buff_len ++;
-                    }
-                    break;
+            break;
+        }
 
-                case 'd':
-                case 'i':// 有符号十进制整数
-                    {
-                        int8 vstr[33];
-                        int32 ival = (int32)va_arg(arg, int32);
-                        uint8 vlen = number_conversion_ascii((uint32)ival, vstr, 1, 10);
-
-                        if(0 > ival)  
-                        {
-                            vstr[vlen] = '-';
-                            vlen ++;
-                        }
-                        printf_reverse_order(vstr, vlen);
-                        memcpy(buff, vstr, vlen);
-                        buff += vlen;
-                        buff_len += vlen;
-                    }
-                    break;
+        end = func_scan_decimal(str, str + length, &decimal);
+        if(NULL == end)
+        {
+            break;
+        }
 
-                case 'f':// 浮点数，输出小数点后六位  不能指定输出精度
-                case 'F':// 浮点数，输出小数点后六位  不能指定输出精度
+        result.ptr = end;
+        if(decimal.special)
+        {
+            narrow = (1 == decimal.special) ? INFINITY : NAN;
+        }
+        else
+        {
+            wide = func_decimal_to_double(&decimal, end);
+            narrow = (float)wide;
+            if((double)narrow != wide)
+            {
+                float other = std::nextafter(narrow, (wide > (double)narrow) ? INFINITY : -INFINITY);
+                if(((double)narrow + (double)other) * 0.5 == wide)
                 {
-                    int8 vstr[33];
-                    double ival = (double)va_arg(arg, double);
-                    uint8 vlen = number_conversion_ascii((uint32)(int32)ival, vstr, 1, 10);
-
-                    if(0 > ival)  
-                    {
-                        vstr[vlen] = '-';
-                        vlen ++;
-                    }
-                    printf_reverse_order(vstr, vlen);
-                    memcpy(buff, vstr, vlen);
-                    buff += vlen;
-                    buff_len += vlen;
-
-                    ival = ((double)ival - (int32)ival)*1000000;
-                    if(ival)
-                    {
-                        vlen = number_conversion_ascii((uint32)(int32)ival, vstr, 1, 10);
-                    }
-                    else
-                    {
-                        vstr[0] = vstr[1] = vstr[2] = vstr[3] = vstr[4] = vstr[5] = '0';
-                        vlen = 6;
-                    }
-
-                    while(6 > vlen)
-                    {
-                        vstr[vlen] = '0';
-                        vlen ++;
-                    }
-
-                    vstr[vlen] = '.';
-                    vlen ++;
-
-                    printf_reverse_order(vstr, vlen);
-                    memcpy(buff, vstr, vlen);
-                    buff += vlen;
-                    buff_len += vlen;
+                    char buffer[FUNC_PARSE_TOKEN_MAX];
+                    func_decimal_text(buffer, &decimal, end);
+                    narrow = strtof(buffer, NULL);
                 }
+            }
+            if(std::isinf(narrow) || (0 == narrow && 0 != decimal.mantissa))
+            {
+                result.error = FUNC_PARSE_RANGE;
                 break;
+            }
+        }
+        *value = decimal.negative ? -narrow : narrow;
+        result.error = FUNC_PARSE_OK;
+    }while(0);
+    return result;
+}
 
-                case 'u':// 无符号十进制整数
-                    {
-                        int8 vstr[33];
-                        uint32 ival = (uint32)va_arg(arg, uint32);
-                        uint8 vlen = number_conversion_ascii(ival, vstr, 0, 10);
-
-                        printf_reverse_order(vstr, vlen);
-                        memcpy(buff, vstr, vlen);
-                        buff += vlen;
-                        buff_len += vlen;
-                    }
-                    break;
-
-                case 'o':// 无符号八进制整数 
-                    {
-                        int8 vstr[33];
-                        uint32 ival = (uint32)va_arg(arg, uint32);
-                        uint8 vlen = number_conversion_ascii(ival, vstr, 0, 8);
-
-                        printf_reverse_order(vstr, vlen);
-                        memcpy(buff, vstr, vlen);
-                        buff += vlen;
-                        buff_len += vlen;
-
-                    }
-                    break;
-
-                case 'x':// 无符号十六进制整数
-                case 'X':// 无符号十六进制整数
-                    {
-                        int8 vstr[33];
-                        uint32 ival = (uint32)va_arg(arg, uint32);
-                        uint8 vlen = number_conversion_ascii(ival, vstr, 0, 16);
-
-                        printf_reverse_order(vstr, vlen);
-                        memcpy(buff, vstr, vlen);
-                        buff += vlen;
-                        buff_len += vlen;
-                    }
-                    break;
-
-                case 's':// 字符串
-                    {
-                        int8 *pc = va_arg(arg, int8 *);
-                        while (*pc)
-                        {
-                            *buff = *pc;
-                            buff ++;
-                            buff_len ++;
-                            pc ++;
-                        }
-                    }
-                    break;
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     按长度解析浮点数
+// 参数说明     *str            起始位置 不要求以'\0'结尾
+// 参数说明     length          最多读取的字节数
+// 参数说明     *value          解析结果 失败时不修改
+// 返回参数     func_parse_result_struct    ptr 为第一个未解析的字符 error 为错误码
+// 使用示例     double dat; func_parse_double("-1.25e3\n", 8, &dat);            // dat = -1250 ptr 指向 '\n'
+// 备注信息     格式为 [+-] 数字 [. 数字] [e|E [+-] 数字] 或 inf infinity nan(不区分大小写) 不跳过前导空白 不支持十六进制浮点
+//              数字累加为64位整数 小数点与指数只记录十进制指数 最后一次缩放 结果为正确舍入 与 strtod 相同
+//              超出 double 范围(上溢为 inf 或非0值下溢为0)时返回 FUNC_PARSE_RANGE
+//-------------------------------------------------------------------------------------------------------------------
+func_parse_result_struct func_parse_double (const char *str, size_t length, double *value)
+{
+    func_parse_result_struct result = {str, FUNC_PARSE_INVALID};
+    func_decimal_struct decimal;
+    const char *end = NULL;
+    double temp = 0;
 
-                case 'p':// 以16进制形式输出指针
-                    {
-                        int8 vstr[33];
-                        uint32 ival = (uint32)va_arg(arg, uint32);
-                        //uint8 vlen = number_conversion_ascii(ival, vstr, 0, 16);
-                        number_conversion_ascii(ival, vstr, 0, 16);
-                        printf_reverse_order(vstr, 8);
-                        memcpy(buff, vstr, 8);
-                        buff += 8;
-                        buff_len += 8;
-                    }
-                    break;
+    do
+    {
+        if(NULL == str || NULL == value)
+        {
+            break;
+        }
 
-                case '%':// 输出字符% 
-                    {
-                        *buff = '%';
-                        buff ++;
-                        buff_len ++;
-                    }
-                    break;
+        end = func_scan_decimal(str, str + length, &decimal);
+        if(NULL == end)
+        {
+            break;
+        }
 
-                default:
-                    break;
-            }
+        result.ptr = end;
+        if(decimal.special)
+        {
+            temp = (1 == decimal.special) ? INFINITY : NAN;
         }
         else
         {
-            *buff = (int8)(*format);
-            buff ++;
-            buff_len ++;
+            temp = func_decimal_to_double(&decimal, end);
+            if(std::isinf(temp) || (0 == temp && 0 != decimal.mantissa))
+            {
+                result.error = FUNC_PARSE_RANGE;
+                break;
+            }
         }
-        format ++;
-    }
-    va_end(arg);
-
-    return buff_len;
+        *value = decimal.negative ? -temp : temp;
+        result.error = FUNC_PARSE_OK;
+    }while(0);
+    return result;
 }
-
-
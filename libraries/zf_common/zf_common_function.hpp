@@ -40,6 +40,24 @@
 
 //====================================================宏定义函数区====================================================
 
+#define     FUNC_POINT_BIT_MAX      ( 9 )                                       // 浮点数转字符串的最大小数位数
+#define     FUNC_PARSE_TOKEN_MAX    ( 64 )                                      // 浮点解析慢速路径的栈上拷贝长度 更长的数字按19位有效数字近似
+
+// func_parse_* 的错误码 与 std::from_chars 的 std::errc 对应
+typedef enum
+{
+    FUNC_PARSE_OK = 0,                                                          // 成功
+    FUNC_PARSE_INVALID,                                                         // 开头不是数字 对应 std::errc::invalid_argument
+    FUNC_PARSE_RANGE,                                                           // 超出类型范围 对应 std::errc::result_out_of_range
+}func_parse_error_enum;
+
+// func_parse_* 的返回值 与 std::from_chars_result 对应
+typedef struct
+{
+    const char              *ptr;                                               // 第一个未解析的字符 失败(INVALID)时等于传入的 str
+    func_parse_error_enum   error;                                              // 失败时 value 不被修改
+}func_parse_result_struct;
+
 //=====================================================常规函数区=====================================================
 uint32      func_get_greatest_common_divisor    (uint32 num1, uint32 num2);
 
@@ -57,6 +75,12 @@ uint32      func_str_to_hex                     (char *str);
 void        func_hex_to_str                     (char *str, uint32 number);
 
 uint32      zf_sprintf                          (int8 *buff, const int8 *format, ...);
+
+func_parse_result_struct func_parse_int         (const char *str, size_t length, int32 *value);
+func_parse_result_struct func_parse_uint        (const char *str, size_t length, uint32 *value);
+func_parse_result_struct func_parse_hex         (const char *str, size_t length, uint32 *value);
+func_parse_result_struct func_parse_float       (const char *str, size_t length, float *value);
+func_parse_result_struct func_parse_double      (const char *str, size_t length, double *value);
 //=====================================================常规函数区=====================================================
 
 #endif
@@ -43,6 +43,12 @@
 #include "zf_common_font.hpp"
 #include "zf_common_function.hpp"
 #include "zf_common_fifo.hpp"
+#include "zf_common_spsc_ring.hpp"
+#include "zf_common_mpmc_queue.hpp"
+#include "zf_common_dispatcher.hpp"
+#include "zf_common_histogram.hpp"
+#include "zf_common_rt.hpp"
+#include "zf_common_time.hpp"
 #include "zf_common_typedef.hpp"
 //====================================================开源库公共层====================================================
 
@@ -50,10 +56,12 @@
 #include "zf_driver_delay.hpp"
 #include "zf_driver_file_string.hpp"
 #include "zf_driver_file_buffer.hpp"
+#include "zf_driver_sysfs_attr.hpp"
 #include "zf_driver_encoder.hpp"
 #include "zf_driver_gpio.hpp"
 #include "zf_driver_pwm.hpp"
 #include "zf_driver_pit.hpp"
+#include "zf_driver_pit_scheduler.hpp"
 #include "zf_driver_adc.hpp"
 #include "zf_driver_udp.hpp"
 #include "zf_driver_tcp_client.hpp"
@@ -69,7 +77,13 @@
 //===================================================应用组件层===================================================
 #include "seekfree_assistant.hpp"
 #include "seekfree_assistant_interface.hpp"
+#include "seekfree_assistant_transport.hpp"
 #include "ww_camera_server.hpp"
+#include "zf_components_ahrs.hpp"
+#include "zf_components_bringup.hpp"
+#include "zf_components_display.hpp"
+#include "zf_components_encoder.hpp"
+#include "zf_components_sensor_hub.hpp"
 //===================================================应用组件层===================================================
 
 //===================================================用户自定义文件===================================================
@@ -0,0 +1,178 @@
+#ifndef _zf_common_histogram_h_
+#define _zf_common_histogram_h_
+
+#include "zf_common_typedef.hpp"
+
+// 对数-线性分桶 每个2的幂区间再均分为 2^HISTOGRAM_SUB_BUCKET_BITS 个桶 相对误差不超过 1/8
+// 小于 2^HISTOGRAM_SUB_BUCKET_BITS 的数值每个值独占一个桶 覆盖整个 uint64 范围
+#define HISTOGRAM_SUB_BUCKET_BITS       ( 3 )
+#define HISTOGRAM_SUB_BUCKET_COUNT      ( 1 << HISTOGRAM_SUB_BUCKET_BITS )
+#define HISTOGRAM_BUCKET_COUNT          ( (64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKET_COUNT )
+
+//-------------------------------------------------------------------------------------------------------------------
+// 类名         zf_common_histogram
+// 说明         无锁直方图 用于在实时线程中记录延迟/耗时分布 其他线程随时查询
+//              记录只做几次 relaxed 原子加 不加锁 不分配内存 固定约 2KB
+//              查询得到的是调用瞬间的近似快照 百分位数返回所在桶的上界
+//-------------------------------------------------------------------------------------------------------------------
+class zf_common_histogram
+{
+private:
+    std::atomic<uint32>     bucket[HISTOGRAM_BUCKET_COUNT];
+    std::atomic<uint64_t>   count;
+    std::atomic<uint64_t>   sum;
+    std::atomic<uint64_t>   min;
+    std::atomic<uint64_t>   max;
+
+    zf_common_histogram(const zf_common_histogram&) = delete;
+    zf_common_histogram& operator=(const zf_common_histogram&) = delete;
+
+public:
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     数值对应的桶编号
+// 参数说明     value           数值
+// 返回参数     uint32          桶编号
+// 使用示例     uint32 index = zf_common_histogram::bucket_index(1000);
+//-------------------------------------------------------------------------------------------------------------------
+    static uint32 bucket_index (uint64_t value)
+    {
+        uint32 exponent;
+
+        if(HISTOGRAM_SUB_BUCKET_COUNT > value)
+        {
+            return (uint32)value;
+        }
+        exponent = 63 - __builtin_clzll(value);                                 // 最高位位置 不小于 HISTOGRAM_SUB_BUCKET_BITS
+        return (exponent - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKET_COUNT
+             + (uint32)((value >> (exponent - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKET_COUNT - 1));
+    }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     桶能表示的最大数值
+// 参数说明     index           桶编号
+// 返回参数     uint64_t        该桶上界 (包含)
+// 使用示例     uint64_t upper = zf_common_histogram::bucket_upper(index);
+//-------------------------------------------------------------------------------------------------------------------
+    static uint64_t bucket_upper (uint32 index)
+    {
+        uint32 shift;
+
+        if(HISTOGRAM_SUB_BUCKET_COUNT > index)
+        {
+            return index;
+        }
+        shift = index / HISTOGRAM_SUB_BUCKET_COUNT - 1;
+        return (((uint64_t)(HISTOGRAM_SUB_BUCKET_COUNT + index % HISTOGRAM_SUB_BUCKET_COUNT) + 1) << shift) - 1;
+    }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     构造函数
+// 参数说明     无
+// 返回参数     无
+// 使用示例     zf_common_histogram latency;
+//-------------------------------------------------------------------------------------------------------------------
+    zf_common_histogram (void)
+    {
+        reset();
+    }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     记录一个数值
+// 参数说明     value           数值 单位由调用者决定 库内统一使用纳秒
+// 返回参数     void
+// 使用示例     latency.record(now_ns - deadline_ns);
+// 备注信息     任意线程均可调用 多个线程同时记录也不会丢失计数
+//-------------------------------------------------------------------------------------------------------------------
+    void record (uint64_t value)
+    {
+        uint64_t old_value;
+
+        bucket[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+
+        old_value = min.load(std::memory_order_relaxed);
+        while(value < old_value && !min.compare_exchange_weak(old_value, value, std::memory_order_relaxed));
+        old_value = max.load(std::memory_order_relaxed);
+        while(value > old_value && !max.compare_exchange_weak(old_value, value, std::memory_order_relaxed));
+    }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     清空统计
+// 参数说明     无
+// 返回参数     void
+// 使用示例     latency.reset();
+// 备注信息     与 record 同时进行时 可能残留少量计数
+//-------------------------------------------------------------------------------------------------------------------
+    void reset (void)
+    {
+        for(uint32 i = 0; i < HISTOGRAM_BUCKET_COUNT; i ++)
+        {
+            bucket[i].store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+        sum.store(0, std::memory_order_relaxed);
+        min.store(UINT64_MAX, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t get_count  (void) const { return count.load(std::memory_order_relaxed); }
+    uint64_t get_max    (void) const { return max.load(std::memory_order_relaxed); }
+    uint64_t get_min    (void) const { return get_count() ? min.load(std::memory_order_relaxed) : 0; }
+    uint64_t get_mean   (void) const { return get_count() ? sum.load(std::memory_order_relaxed) / get_count() : 0; }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     查询百分位数
+// 参数说明     percent         百分比 0 ~ 100
+// 返回参数     uint64_t        不小于该比例样本的数值 取所在桶上界且不超过最大值 没有样本时返回0
+// 使用示例     uint64_t p99 = latency.get_percentile(99);
+//-------------------------------------------------------------------------------------------------------------------
+    uint64_t get_percentile (double percent) const
+    {
+        uint64_t total = 0;
+        uint64_t target, seen = 0;
+        uint64_t upper;
+
+        for(uint32 i = 0; i < HISTOGRAM_BUCKET_COUNT; i ++)
+        {
+            total += bucket[i].load(std::memory_order_relaxed);
+        }
+        if(0 == total)
+        {
+            return 0;
+        }
+
+        target = (uint64_t)(percent / 100.0 * total + 0.5);
+        if(1 > target)
+        {
+            target = 1;
+        }
+        for(uint32 i = 0; i < HISTOGRAM_BUCKET_COUNT; i ++)
+        {
+            seen += bucket[i].load(std::memory_order_relaxed);
+            if(seen >= target)
+            {
+                upper = bucket_upper(i);
+                return (upper < get_max()) ? upper : get_max();
+            }
+        }
+        return get_max();
+    }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     打印统计摘要
+// 参数说明     name            名称
+// 参数说明     scale           显示时除以的倍数 例如纳秒转微秒传入 1000
+// 返回参数     void
+// 使用示例     latency.print("pit latency(us)", 1000);
+// 备注信息     使用printf输出 不要在实时任务中调用
+//-------------------------------------------------------------------------------------------------------------------
+    void print (const char *name, double scale = 1.0) const
+    {
+        printf("%s: count %" PRIu64 ", min %.1f, mean %.1f, p50 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\r\n",
+               name, get_count(), get_min() / scale, get_mean() / scale, get_percentile(50) / scale,
+               get_percentile(99) / scale, get_percentile(99.9) / scale, get_max() / scale);
+    }
+};
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef _zf_common_mpmc_queue_h_
+#define _zf_common_mpmc_queue_h_
+
+#include "zf_common_typedef.hpp"
+#include "zf_common_spsc_ring.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+//-------------------------------------------------------------------------------------------------------------------
+// 有界多生产者多消费者无锁队列 (Vyukov 序号槽位算法)
+// T                元素类型 需要可默认构造和拷贝赋值
+// N                容量 必须为2的幂
+// 每个槽位带一个序号 生产者抢占写入位置后写入数据再把序号改为 pos+1 通知消费者
+// 消费者抢占读取位置后读出数据再把序号改为 pos+N 通知下一轮生产者
+// 写入位置与读取位置各自独占缓存行 生产者之间只竞争写入位置 消费者之间只竞争读取位置
+// 任何操作都不分配内存 不加锁 可在PIT回调等实时线程中调用
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T, size_t N>
+class MpmcQueue
+{
+    static_assert(2 <= N && 0 == (N & (N - 1)), "MpmcQueue capacity must be a power of two");
+    static_assert(std::is_default_constructible<T>::value, "MpmcQueue element must be default constructible");
+
+public:
+    MpmcQueue (void) : enqueue_pos(0), dequeue_pos(0)
+    {
+        for(size_t i = 0; i < N; i ++)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue (const MpmcQueue&) = delete;
+    MpmcQueue& operator= (const MpmcQueue&) = delete;
+
+    static constexpr size_t capacity (void) { return N; }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     写入一个元素
+    // 参数说明     value               元素
+    // 返回参数     bool                true-成功 false-队列已满
+    // 备注信息     任意线程均可调用 不会阻塞
+    //---------------------------------------------------------------------------------------------------------------
+    bool try_push (const T &value)
+    {
+        cell_struct *cell;
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+        while(1)
+        {
+            cell = &cells[pos & (N - 1)];
+            const size_t   sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff     = (intptr_t)sequence - (intptr_t)pos;
+            if(0 == diff)
+            {
+                // 槽位空闲 抢占写入位置 失败时 pos 被更新为最新值后重试
+                if(enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(0 > diff)
+            {
+                return false;                                                   // 槽位仍被上一轮数据占用 队列已满
+            }
+            else
+            {
+                pos = enqueue_pos.load(std::memory_order_relaxed);              // 其他生产者已经抢先 重新读取位置
+            }
+        }
+
+        cell->data = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     读取一个元素
+    // 参数说明     &value              读取结果
+    // 返回参数     bool                true-成功 false-队列为空
+    // 备注信息     任意线程均可调用 不会阻塞
+    //---------------------------------------------------------------------------------------------------------------
+    bool try_pop (T &value)
+    {
+        cell_struct *cell;
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+
+        while(1)
+        {
+            cell = &cells[pos & (N - 1)];
+            const size_t   sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff     = (intptr_t)sequence - (intptr_t)(pos + 1);
+            if(0 == diff)
+            {
+                if(dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(0 > diff)
+            {
+                return false;                                                   // 槽位尚未写入 队列为空
+            }
+            else
+            {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = cell->data;
+        cell->sequence.store(pos + N, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     查询元素个数
+    // 返回参数     size_t              调用瞬间的近似值 仅用于统计显示
+    //---------------------------------------------------------------------------------------------------------------
+    size_t size_approx (void) const
+    {
+        const size_t head = enqueue_pos.load(std::memory_order_relaxed);
+        const size_t tail = dequeue_pos.load(std::memory_order_relaxed);
+        return (head > tail) ? (head - tail) : 0;
+    }
+
+private:
+    struct cell_struct
+    {
+        std::atomic<size_t> sequence;
+        T                   data;
+    };
+
+    alignas(ZF_CACHE_LINE_SIZE) cell_struct         cells[N];
+    alignas(ZF_CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos;                // 写入位置 生产者之间竞争
+    alignas(ZF_CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos;                // 读取位置 消费者之间竞争
+};
+
+#endif
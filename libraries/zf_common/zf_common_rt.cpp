@@ -0,0 +1,302 @@
+#include "zf_common_rt.hpp"
+
+#include <alloca.h>
+
+#define RT_STACK_RESERVE                ( 16 * 1024 )                           // 预触碰栈时保留的余量 包含线程入口已使用的栈
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     执行mlockall
+// 参数说明     无
+// 返回参数     int8            0-成功 -1-失败
+// 使用示例     内部调用
+//-------------------------------------------------------------------------------------------------------------------
+static int8 rt_memory_lock_once (void)
+{
+    if(0 != mlockall(MCL_CURRENT | MCL_FUTURE))
+    {
+        perror("rt warning: mlockall error");
+        printf("rt warning: 请用sudo运行程序，否则实时线程可能因缺页产生毫秒级延迟！\r\n");
+        return -1;
+    }
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     预先触碰当前线程的栈
+// 参数说明     size            触碰的大小 字节 超过线程栈大小时自动缩小
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     在栈上分配一块内存并逐页写入 函数返回后栈页保持已分配 回调中首次使用深层栈时不再缺页
+//              必须禁止内联 否则alloca分配的空间要到调用者返回时才释放
+//-------------------------------------------------------------------------------------------------------------------
+__attribute__((noinline)) static void rt_stack_prefault (uint32 size)
+{
+    pthread_attr_t attr;
+    void *stack_addr = NULL;
+    size_t stack_size = 0;
+    long page_size = sysconf(_SC_PAGESIZE);
+    volatile uint8 *stack = NULL;
+
+    if(0 == pthread_getattr_np(pthread_self(), &attr))
+    {
+        pthread_attr_getstack(&attr, &stack_addr, &stack_size);
+        pthread_attr_destroy(&attr);
+    }
+    if(RT_STACK_RESERVE < stack_size && stack_size - RT_STACK_RESERVE < size)
+    {
+        size = stack_size - RT_STACK_RESERVE;
+    }
+    if(0 == size || 0 >= page_size)
+    {
+        return;
+    }
+
+    stack = (volatile uint8 *)alloca(size);
+    for(uint32 i = 0; i < size; i += page_size)
+    {
+        stack[i] = 0;
+    }
+    stack[size - 1] = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     锁定进程全部内存
+// 参数说明     无
+// 返回参数     int8            0-成功 -1-失败
+// 使用示例     rt_memory_lock();
+// 备注信息     通过局部静态变量保证只执行一次 多个线程同时调用也是安全的
+//-------------------------------------------------------------------------------------------------------------------
+int8 rt_memory_lock (void)
+{
+    static const int8 lock_state = rt_memory_lock_once();
+    return lock_state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     按配置设置当前线程
+// 参数说明     policy          线程配置
+// 返回参数     int8            0-全部成功 -1-有设置项失败
+// 使用示例     rt_thread_setup(&policy);
+// 备注信息     锁定内存需要在预触碰栈之前 否则触碰过的页仍可能被换出 SCHED_OTHER 不锁定内存
+//-------------------------------------------------------------------------------------------------------------------
+int8 rt_thread_setup (const rt_thread_policy_struct *policy)
+{
+    struct sched_param sched_param;
+    cpu_set_t cpu_set;
+    int8 return_state = 0;
+
+    do
+    {
+        if(NULL == policy)
+        {
+            return_state = -1;
+            break;
+        }
+
+        // 普通调度的线程(显示 轮询等)不锁定内存 避免把 OpenCV ncnn 等大块缓冲整个进程锁住
+        if((SCHED_OTHER != policy->sched_policy) && (0 != rt_memory_lock()))
+        {
+            return_state = -1;
+        }
+
+        if(RT_CPU_ANY != policy->cpu)
+        {
+            CPU_ZERO(&cpu_set);
+            CPU_SET(policy->cpu, &cpu_set);
+            if(0 != pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set))
+            {
+                printf("rt warning: bind thread to cpu %d failed\r\n", policy->cpu);
+                return_state = -1;
+            }
+        }
+
+        memset(&sched_param, 0, sizeof(sched_param));
+        if(SCHED_OTHER != policy->sched_policy)
+        {
+            sched_param.sched_priority = policy->sched_priority;
+        }
+        if(0 != pthread_setschedparam(pthread_self(), policy->sched_policy, &sched_param))
+        {
+            printf("rt warning: 请用sudo运行程序，否则无法设置实时优先级！\r\n");
+            return_state = -1;
+        }
+
+        rt_stack_prefault(policy->stack_prefault);
+    }while(0);
+
+    return return_state;
+}
+
+#if defined(ZF_RT_DEBUG)
+//-------------------------------------------------------------------------------------------------------------------
+// 调试模式 替换内存分配与常见阻塞调用 检查是否在实时区间内被调用
+// 内存分配转发到glibc导出的 __libc_* 实现 阻塞调用通过 dlsym(RTLD_NEXT) 找到原函数
+// 违规时只做原子计数 不调用printf等可能再次违规的函数 统计由 rt_debug_print 在实时区间外输出
+//-------------------------------------------------------------------------------------------------------------------
+#include <dlfcn.h>
+#include <poll.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+
+extern "C" void *__libc_malloc  (size_t size);
+extern "C" void *__libc_calloc  (size_t count, size_t size);
+extern "C" void *__libc_realloc (void *ptr, size_t size);
+extern "C" void  __libc_free    (void *ptr);
+
+thread_local uint32 rt_section_depth = 0;
+
+static std::atomic<uint32>          rt_violation_count(0);
+static std::atomic<const char *>    rt_violation_first(NULL);                   // 第一次违规的调用名称
+static std::atomic<bool>            rt_violation_abort(false);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     记录一次违规
+// 参数说明     name            违规调用名称 必须为常量字符串
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     abort模式下直接使用write系统调用输出 绕过被替换的write
+//-------------------------------------------------------------------------------------------------------------------
+static void rt_violation (const char *name)
+{
+    const char *expected = NULL;
+    const char prefix[] = "rt violation: ";
+    const char suffix[] = " called inside rt section\n";
+
+    rt_violation_count.fetch_add(1, std::memory_order_relaxed);
+    rt_violation_first.compare_exchange_strong(expected, name, std::memory_order_relaxed);
+
+    if(rt_violation_abort.load(std::memory_order_relaxed))
+    {
+        syscall(SYS_write, STDERR_FILENO, prefix, sizeof(prefix) - 1);
+        syscall(SYS_write, STDERR_FILENO, name, strlen(name));
+        syscall(SYS_write, STDERR_FILENO, suffix, sizeof(suffix) - 1);
+        abort();
+    }
+}
+
+#define RT_CHECK(name)                  do{ if(0 != rt_section_depth) rt_violation(name); }while(0)
+
+// 取得被替换函数的原始实现 局部静态变量只在第一次调用时查找
+#define RT_REAL(type, name)             static auto real_##name = (type)dlsym(RTLD_NEXT, #name)
+
+extern "C"
+{
+void *malloc (size_t size) __THROW
+{
+    RT_CHECK("malloc");
+    return __libc_malloc(size);
+}
+
+void *calloc (size_t count, size_t size) __THROW
+{
+    RT_CHECK("calloc");
+    return __libc_calloc(count, size);
+}
+
+void *realloc (void *ptr, size_t size) __THROW
+{
+    RT_CHECK("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void free (void *ptr) __THROW
+{
+    if(NULL != ptr)
+    {
+        RT_CHECK("free");
+    }
+    __libc_free(ptr);
+}
+
+int nanosleep (const struct timespec *request, struct timespec *remain)
+{
+    RT_REAL(int (*)(const struct timespec *, struct timespec *), nanosleep);
+    RT_CHECK("nanosleep");
+    return real_nanosleep(request, remain);
+}
+
+int clock_nanosleep (clockid_t clock_id, int flags, const struct timespec *request, struct timespec *remain)
+{
+    RT_REAL(int (*)(clockid_t, int, const struct timespec *, struct timespec *), clock_nanosleep);
+    RT_CHECK("clock_nanosleep");
+    return real_clock_nanosleep(clock_id, flags, request, remain);
+}
+
+int usleep (useconds_t usec)
+{
+    RT_REAL(int (*)(useconds_t), usleep);
+    RT_CHECK("usleep");
+    return real_usleep(usec);
+}
+
+ssize_t read (int fd, void *buf, size_t count)
+{
+    RT_REAL(ssize_t (*)(int, void *, size_t), read);
+    RT_CHECK("read");
+    return real_read(fd, buf, count);
+}
+
+ssize_t write (int fd, const void *buf, size_t count)
+{
+    RT_REAL(ssize_t (*)(int, const void *, size_t), write);
+    RT_CHECK("write");
+    return real_write(fd, buf, count);
+}
+
+int poll (struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    RT_REAL(int (*)(struct pollfd *, nfds_t, int), poll);
+    RT_CHECK("poll");
+    return real_poll(fds, nfds, timeout);
+}
+
+int pthread_mutex_lock (pthread_mutex_t *mutex) __THROWNL
+{
+    RT_REAL(int (*)(pthread_mutex_t *), pthread_mutex_lock);
+    RT_CHECK("pthread_mutex_lock");
+    return real_pthread_mutex_lock(mutex);
+}
+
+int sem_wait (sem_t *sem)
+{
+    RT_REAL(int (*)(sem_t *), sem_wait);
+    RT_CHECK("sem_wait");
+    return real_sem_wait(sem);
+}
+}
+
+void rt_debug_set_abort (uint8 enable)
+{
+    rt_violation_abort.store(0 != enable, std::memory_order_relaxed);
+}
+
+uint32 rt_debug_get_violation_count (void)
+{
+    return rt_violation_count.load(std::memory_order_relaxed);
+}
+
+void rt_debug_print (void)
+{
+    const char *first = rt_violation_first.load(std::memory_order_relaxed);
+    printf("rt debug: %u violation(s) inside rt section, first: %s\r\n",
+           rt_debug_get_violation_count(), (NULL == first) ? "none" : first);
+}
+
+#else
+
+void rt_debug_set_abort (uint8 enable)
+{
+    (void)enable;
+}
+
+uint32 rt_debug_get_violation_count (void)
+{
+    return 0;
+}
+
+void rt_debug_print (void)
+{
+    printf("rt debug: disabled, rebuild with ZF_RT_DEBUG to check rt sections\r\n");
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef _zf_common_rt_h_
+#define _zf_common_rt_h_
+
+#include "zf_common_typedef.hpp"
+
+#define RT_CPU_ANY                      ( -1 )                                  // 不绑定CPU
+#define RT_STACK_PREFAULT_DEFAULT       ( 64 * 1024 )                           // 默认预先触碰的栈大小 字节
+
+// 实时线程配置 由各定时器/驱动线程在线程入口处调用 rt_thread_setup 应用
+typedef struct
+{
+    int         sched_policy;                                                   // SCHED_FIFO / SCHED_RR / SCHED_OTHER
+    int         sched_priority;                                                 // 1~99 SCHED_OTHER时忽略
+    int         cpu;                                                            // 绑定的CPU编号 RT_CPU_ANY表示不绑定
+    uint32      stack_prefault;                                                 // 预先触碰的栈大小 字节 0表示不预触碰
+}rt_thread_policy_struct;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     锁定进程全部内存
+// 参数说明     无
+// 返回参数     int8            0-成功 -1-失败
+// 使用示例     rt_memory_lock();
+// 备注信息     mlockall(MCL_CURRENT | MCL_FUTURE) 进程内只执行一次 重复调用直接返回第一次的结果
+//              锁定后新映射的内存(包括新线程的栈)在映射时即全部分配 实时线程运行中不再产生缺页
+//              需要root权限或足够的 RLIMIT_MEMLOCK 失败时打印一次警告
+//-------------------------------------------------------------------------------------------------------------------
+int8    rt_memory_lock          (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     按配置设置当前线程
+// 参数说明     policy          线程配置
+// 返回参数     int8            0-全部成功 -1-有设置项失败 失败项打印警告后继续
+// 使用示例     rt_thread_policy_struct policy = {SCHED_FIFO, 99, RT_CPU_ANY, RT_STACK_PREFAULT_DEFAULT};
+//              rt_thread_setup(&policy);
+// 备注信息     必须在目标线程内部调用 依次执行 锁定内存 绑定CPU 设置调度策略 预触碰栈
+//              sched_policy 为 SCHED_OTHER 时跳过锁定内存 需要时由调用者自行调用 rt_memory_lock
+//-------------------------------------------------------------------------------------------------------------------
+int8    rt_thread_setup         (const rt_thread_policy_struct *policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 实时区间检查
+// 定时器在调用用户回调前后分别调用 rt_section_enter / rt_section_exit
+// 编译时定义 ZF_RT_DEBUG 后 库替换 malloc/free 及常见阻塞调用 当前线程处于实时区间内时记录违规
+// 未定义 ZF_RT_DEBUG 时以下函数均为空函数 不产生任何开销
+//-------------------------------------------------------------------------------------------------------------------
+#if defined(ZF_RT_DEBUG)
+extern thread_local uint32 rt_section_depth;
+
+static inline void rt_section_enter (void) { rt_section_depth ++; }
+static inline void rt_section_exit  (void) { rt_section_depth --; }
+#else
+static inline void rt_section_enter (void) {}
+static inline void rt_section_exit  (void) {}
+#endif
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     设置发现违规时是否立即终止程序
+// 参数说明     enable          0-只记录 1-向stderr输出违规调用名称后abort 便于在调试器中定位调用栈
+// 返回参数     void
+// 使用示例     rt_debug_set_abort(1);
+// 备注信息     未定义 ZF_RT_DEBUG 时无效果
+//-------------------------------------------------------------------------------------------------------------------
+void    rt_debug_set_abort      (uint8 enable);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取实时区间内的违规调用次数
+// 参数说明     无
+// 返回参数     uint32          违规次数 未定义 ZF_RT_DEBUG 时固定为0
+// 使用示例     if(rt_debug_get_violation_count()) rt_debug_print();
+//-------------------------------------------------------------------------------------------------------------------
+uint32  rt_debug_get_violation_count (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     打印违规统计
+// 参数说明     无
+// 返回参数     void
+// 使用示例     rt_debug_print();
+// 备注信息     输出违规次数与第一次违规的调用名称 不要在实时区间内调用
+//-------------------------------------------------------------------------------------------------------------------
+void    rt_debug_print          (void);
+
+#endif
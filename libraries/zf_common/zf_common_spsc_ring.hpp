@@ -0,0 +1,296 @@
+#ifndef _zf_common_spsc_ring_h_
+#define _zf_common_spsc_ring_h_
+
+#include "zf_common_typedef.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+// 缓存行大小 读写指针分别放在独立缓存行 避免生产者与消费者线程互相使缓存失效
+#define ZF_CACHE_LINE_SIZE          ( 64 )
+
+//-------------------------------------------------------------------------------------------------------------------
+// 环形缓冲区连续数据段
+// 一次 peek_contiguous()/reserve() 最多返回两段 第二段从缓冲区起始位置开始 不跨越缓冲区末尾时第二段长度为0
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T>
+struct SpscRingSegments
+{
+    T       *first;                                                             // 第一段起始地址
+    size_t  first_length;                                                       // 第一段元素个数
+    T       *second;                                                            // 第二段起始地址
+    size_t  second_length;                                                      // 第二段元素个数
+
+    size_t total (void) const { return first_length + second_length; }
+};
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     环形缓冲区分段拷贝 写入
+// 参数说明     *buffer             缓冲区首地址
+// 参数说明     capacity            缓冲区元素个数
+// 参数说明     index               写入起始下标 必须小于 capacity
+// 参数说明     *src                数据来源
+// 参数说明     count               元素个数 必须不大于 capacity
+// 返回参数     void
+// 使用示例     spsc_ring_copy_in(buffer, 64, 60, data, 8);                 // 写入 60-63 与 0-3
+// 备注信息     SpscRing 与 fifo_* 兼容层共用 最多两次 memcpy
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T>
+inline void spsc_ring_copy_in (T *buffer, size_t capacity, size_t index, const T *src, size_t count)
+{
+    size_t first = capacity - index;
+    if(first > count)
+    {
+        first = count;
+    }
+    memcpy(buffer + index, src, first * sizeof(T));
+    memcpy(buffer, src + first, (count - first) * sizeof(T));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     环形缓冲区分段拷贝 读出
+// 参数说明     *buffer             缓冲区首地址
+// 参数说明     capacity            缓冲区元素个数
+// 参数说明     index               读取起始下标 必须小于 capacity
+// 参数说明     *dst                目标地址
+// 参数说明     count               元素个数 必须不大于 capacity
+// 返回参数     void
+// 使用示例     spsc_ring_copy_out(buffer, 64, 60, data, 8);
+// 备注信息     SpscRing 与 fifo_* 兼容层共用 最多两次 memcpy
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T>
+inline void spsc_ring_copy_out (const T *buffer, size_t capacity, size_t index, T *dst, size_t count)
+{
+    size_t first = capacity - index;
+    if(first > count)
+    {
+        first = count;
+    }
+    memcpy(dst, buffer + index, first * sizeof(T));
+    memcpy(dst + first, buffer, (count - first) * sizeof(T));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 单生产者单消费者无锁环形缓冲区
+// T                元素类型 必须可平凡拷贝 批量读写直接使用 memcpy
+// N                容量 必须为2的幂 下标通过掩码计算 不需要取模或循环相减
+// 读写计数自由增长 (head - tail) 即为已使用数量 满与空无需额外标志
+// 生产者只写 head 消费者只写 tail 通过 release 发布 acquire 获取 保证数据先于下标可见
+// 各自缓存对方下标的最近一次读取值 只有缓存值显示空间/数据不足时才访问对方缓存行
+//
+// 使用规则 同一时刻只能有一个线程调用写入类接口(push/write/write_all/reserve/publish)
+//          同一时刻只能有一个线程调用读取类接口(pop/read/peek_contiguous/commit/discard)
+//          多生产者场景需要在生产者一侧自行加锁
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(0 < N && 0 == (N & (N - 1)), "SpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing element must be trivially copyable");
+
+public:
+    SpscRing (void) : head(0), tail_cache(0), tail(0), head_cache(0) {}
+
+    SpscRing (const SpscRing&) = delete;
+    SpscRing& operator= (const SpscRing&) = delete;
+
+    static constexpr size_t capacity (void) { return N; }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     查询已使用元素个数
+    // 返回参数     size_t              已使用个数
+    // 备注信息     任意线程均可调用 返回的是调用瞬间的近似值
+    //---------------------------------------------------------------------------------------------------------------
+    size_t size (void) const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    bool   empty      (void) const { return 0 == size(); }
+    size_t free_space (void) const { return N - size(); }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     写入单个元素
+    // 参数说明     value               元素
+    // 返回参数     bool                true-成功 false-已满
+    //---------------------------------------------------------------------------------------------------------------
+    bool push (const T &value)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if(N == h - tail_cache)
+        {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if(N == h - tail_cache)
+            {
+                return false;
+            }
+        }
+        buffer[h & (N - 1)] = value;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     读取单个元素
+    // 参数说明     &value              读取结果
+    // 返回参数     bool                true-成功 false-为空
+    //---------------------------------------------------------------------------------------------------------------
+    bool pop (T &value)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if(t == head_cache)
+        {
+            head_cache = head.load(std::memory_order_acquire);
+            if(t == head_cache)
+            {
+                return false;
+            }
+        }
+        value = buffer[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     批量写入
+    // 参数说明     *data               数据来源
+    // 参数说明     count               元素个数
+    // 返回参数     size_t              实际写入个数 空间不足时只写入能容纳的部分
+    //---------------------------------------------------------------------------------------------------------------
+    size_t write (const T *data, size_t count)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        size_t space = N - (h - tail_cache);
+        if(space < count)
+        {
+            tail_cache = tail.load(std::memory_order_acquire);
+            space = N - (h - tail_cache);
+        }
+        if(count > space)
+        {
+            count = space;
+        }
+        spsc_ring_copy_in(buffer, N, h & (N - 1), data, count);
+        head.store(h + count, std::memory_order_release);
+        return count;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     整块写入
+    // 参数说明     *data               数据来源
+    // 参数说明     count               元素个数
+    // 返回参数     bool                true-全部写入 false-空间不足 未写入任何数据
+    // 备注信息     用于协议包等不能被截断的数据
+    //---------------------------------------------------------------------------------------------------------------
+    bool write_all (const T *data, size_t count)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        if(N - (h - tail_cache) < count)
+        {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if(N - (h - tail_cache) < count)
+            {
+                return false;
+            }
+        }
+        spsc_ring_copy_in(buffer, N, h & (N - 1), data, count);
+        head.store(h + count, std::memory_order_release);
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     批量读取
+    // 参数说明     *data               目标地址
+    // 参数说明     count               最多读取个数
+    // 返回参数     size_t              实际读取个数
+    //---------------------------------------------------------------------------------------------------------------
+    size_t read (T *data, size_t count)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        size_t used = head_cache - t;
+        if(used < count)
+        {
+            head_cache = head.load(std::memory_order_acquire);
+            used = head_cache - t;
+        }
+        if(count > used)
+        {
+            count = used;
+        }
+        spsc_ring_copy_out(buffer, N, t & (N - 1), data, count);
+        tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     零拷贝读取 获取当前可读数据所在的连续段
+    // 返回参数     SpscRingSegments    最多两段 调用者直接使用其中数据 (例如作为 sendmsg 的 iovec)
+    // 备注信息     数据处理完成后调用 commit() 释放 未 commit 前这些数据不会被生产者覆盖
+    //---------------------------------------------------------------------------------------------------------------
+    SpscRingSegments<const T> peek_contiguous (void)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        head_cache = head.load(std::memory_order_acquire);
+        return segments<const T>(buffer, t, head_cache - t);
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     零拷贝读取 释放已处理的数据
+    // 参数说明     count               释放个数 不能超过 peek_contiguous() 返回的总长度
+    //---------------------------------------------------------------------------------------------------------------
+    void commit (size_t count)
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     丢弃当前全部可读数据
+    // 返回参数     size_t              丢弃个数
+    // 备注信息     属于读取类接口 只能由消费者调用
+    //---------------------------------------------------------------------------------------------------------------
+    size_t discard (void)
+    {
+        const size_t t = tail.load(std::memory_order_relaxed);
+        head_cache = head.load(std::memory_order_acquire);
+        tail.store(head_cache, std::memory_order_release);
+        return head_cache - t;
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     零拷贝写入 获取当前可写空间所在的连续段
+    // 返回参数     SpscRingSegments    最多两段 调用者直接向其中填充数据 (例如作为 recvmsg/read 的目标)
+    // 备注信息     填充完成后调用 publish() 发布
+    //---------------------------------------------------------------------------------------------------------------
+    SpscRingSegments<T> reserve (void)
+    {
+        const size_t h = head.load(std::memory_order_relaxed);
+        tail_cache = tail.load(std::memory_order_acquire);
+        return segments<T>(buffer, h, N - (h - tail_cache));
+    }
+
+    //---------------------------------------------------------------------------------------------------------------
+    // 函数简介     零拷贝写入 发布已填充的数据
+    // 参数说明     count               发布个数 不能超过 reserve() 返回的总长度
+    //---------------------------------------------------------------------------------------------------------------
+    void publish (size_t count)
+    {
+        head.store(head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+private:
+    template <typename U>
+    static SpscRingSegments<U> segments (U *base, size_t position, size_t length)
+    {
+        const size_t index = position & (N - 1);
+        const size_t first = (N - index < length) ? (N - index) : length;
+        return SpscRingSegments<U>{base + index, first, base, length - first};
+    }
+
+    alignas(ZF_CACHE_LINE_SIZE) std::atomic<size_t> head;                       // 写入计数 生产者独占写
+    size_t                                          tail_cache;                 // 生产者缓存的读取计数
+    alignas(ZF_CACHE_LINE_SIZE) std::atomic<size_t> tail;                       // 读取计数 消费者独占写
+    size_t                                          head_cache;                 // 消费者缓存的写入计数
+    alignas(ZF_CACHE_LINE_SIZE) T                   buffer[N];
+};
+
+#endif
@@ -0,0 +1,279 @@
+#include "zf_common_time.hpp"
+
+typedef struct
+{
+    time_sim_timer_fun  fun;
+    void                *arg;
+    uint64_t            next_ns;                                                // 下一次到期的虚拟时刻
+    uint64_t            period_ns;
+    uint8               active;
+}time_sim_timer_struct;
+
+static std::atomic<time_source_enum>    time_source(TIME_SOURCE_REAL);
+static std::atomic<uint64_t>            time_sim_now_ns(0);
+static uint64_t                         time_sim_wall_start_ms = 0;
+
+static pthread_mutex_t                  time_sim_mutex  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t                   time_sim_cond   = PTHREAD_COND_INITIALIZER; // 虚拟时间前进或回调执行结束时广播
+static time_sim_timer_struct            time_sim_timer[TIME_SIM_TIMER_MAX];
+static int                              time_sim_running_id = -1;               // 正在执行回调的定时器编号
+static thread_local uint8               time_sim_in_callback = 0;               // 当前线程正在执行仿真定时器回调
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取当前时间源
+// 参数说明     无
+// 返回参数     time_source_enum 当前时间源
+// 使用示例     time_source_enum source = time_get_source();
+//-------------------------------------------------------------------------------------------------------------------
+time_source_enum time_get_source (void)
+{
+    return time_source.load(std::memory_order_acquire);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取单调时间
+// 参数说明     无
+// 返回参数     uint64_t        单位ns
+// 使用示例     uint64_t begin = time_now_ns();
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_now_ns (void)
+{
+    struct timespec ts;
+
+    if(TIME_SOURCE_SIM == time_get_source())
+    {
+        return time_sim_now_ns.load(std::memory_order_acquire);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取单调时间 毫秒
+// 参数说明     无
+// 返回参数     uint64_t        单位ms
+// 使用示例     uint64_t now = time_now_ms();
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_now_ms (void)
+{
+    return time_now_ns() / 1000000ULL;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取日历时间 毫秒
+// 参数说明     无
+// 返回参数     uint64_t        自1970年起的毫秒数
+// 使用示例     uint64_t timestamp = time_wall_ms();
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_wall_ms (void)
+{
+    struct timespec ts;
+
+    if(TIME_SOURCE_SIM == time_get_source())
+    {
+        return time_sim_wall_start_ms + time_now_ms();
+    }
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     延时到指定时刻
+// 参数说明     deadline_ns     目标时刻
+// 返回参数     void
+// 使用示例     time_sleep_until_ns(next_ns);
+//-------------------------------------------------------------------------------------------------------------------
+void time_sleep_until_ns (uint64_t deadline_ns)
+{
+    struct timespec ts;
+
+    if(TIME_SOURCE_SIM == time_get_source())
+    {
+        if(time_sim_in_callback)
+        {
+            return;
+        }
+        pthread_mutex_lock(&time_sim_mutex);
+        while(time_sim_now_ns.load(std::memory_order_acquire) < deadline_ns)
+        {
+            pthread_cond_wait(&time_sim_cond, &time_sim_mutex);
+        }
+        pthread_mutex_unlock(&time_sim_mutex);
+        return;
+    }
+
+    ts.tv_sec  = deadline_ns / 1000000000ULL;
+    ts.tv_nsec = deadline_ns % 1000000000ULL;
+    while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     延时
+// 参数说明     ns              延时时间 单位ns
+// 返回参数     void
+// 使用示例     time_sleep_ns(1000000);
+//-------------------------------------------------------------------------------------------------------------------
+void time_sleep_ns (uint64_t ns)
+{
+    time_sleep_until_ns(time_now_ns() + ns);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     切换到仿真时钟
+// 参数说明     wall_start_ms   仿真起点对应的日历时间 单位ms
+// 返回参数     int8            0-成功 -1-已经是仿真时钟
+// 使用示例     time_sim_enable(0);
+//-------------------------------------------------------------------------------------------------------------------
+int8 time_sim_enable (uint64_t wall_start_ms)
+{
+    int8 return_state = -1;
+
+    pthread_mutex_lock(&time_sim_mutex);
+    if(TIME_SOURCE_SIM != time_get_source())
+    {
+        memset(time_sim_timer, 0, sizeof(time_sim_timer));
+        time_sim_wall_start_ms = wall_start_ms;
+        time_sim_now_ns.store(0, std::memory_order_release);
+        time_source.store(TIME_SOURCE_SIM, std::memory_order_release);
+        return_state = 0;
+    }
+    pthread_mutex_unlock(&time_sim_mutex);
+
+    return return_state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     注册仿真定时器
+// 参数说明     fun             到期回调
+// 参数说明     arg             回调参数
+// 参数说明     first_ns        第一次到期的虚拟时刻
+// 参数说明     period_ns       周期 0表示只执行一次
+// 返回参数     int             成功返回定时器编号 失败返回-1
+// 使用示例     int id = time_sim_timer_add(control_tick, NULL, time_now_ns(), 1000000);
+//-------------------------------------------------------------------------------------------------------------------
+int time_sim_timer_add (time_sim_timer_fun fun, void *arg, uint64_t first_ns, uint64_t period_ns)
+{
+    int id = -1;
+
+    if(NULL == fun || TIME_SOURCE_SIM != time_get_source())
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&time_sim_mutex);
+    for(int i = 0; i < TIME_SIM_TIMER_MAX; i ++)
+    {
+        if(!time_sim_timer[i].active)
+        {
+            time_sim_timer[i].fun       = fun;
+            time_sim_timer[i].arg       = arg;
+            time_sim_timer[i].next_ns   = first_ns;
+            time_sim_timer[i].period_ns = period_ns;
+            time_sim_timer[i].active    = 1;
+            id = i;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&time_sim_mutex);
+
+    if(0 > id)
+    {
+        printf("time_sim error: too many timers, max %d\r\n", TIME_SIM_TIMER_MAX);
+    }
+    return id;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     注销仿真定时器
+// 参数说明     id              定时器编号
+// 返回参数     void
+// 使用示例     time_sim_timer_remove(id);
+// 备注信息     在自身回调中注销时不等待 否则会等待自己而死锁
+//-------------------------------------------------------------------------------------------------------------------
+void time_sim_timer_remove (int id)
+{
+    if(0 > id || TIME_SIM_TIMER_MAX <= id)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&time_sim_mutex);
+    time_sim_timer[id].active = 0;
+    while(id == time_sim_running_id && !time_sim_in_callback)
+    {
+        pthread_cond_wait(&time_sim_cond, &time_sim_mutex);
+    }
+    pthread_mutex_unlock(&time_sim_mutex);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     推进虚拟时间
+// 参数说明     ns              推进的时长 单位ns
+// 返回参数     uint64_t        本次推进中执行的定时器回调次数
+// 使用示例     time_sim_advance_ns(1000000);
+// 备注信息     编号小的定时器注册得早 到期时刻相同时先执行
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_sim_advance_ns (uint64_t ns)
+{
+    uint64_t target_ns = 0;
+    uint64_t fire_count = 0;
+    time_sim_timer_fun fun = NULL;
+    void *arg = NULL;
+    int id = -1;
+
+    if(TIME_SOURCE_SIM != time_get_source())
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&time_sim_mutex);
+    target_ns = time_sim_now_ns.load(std::memory_order_relaxed) + ns;
+    while(1)
+    {
+        id = -1;
+        for(int i = 0; i < TIME_SIM_TIMER_MAX; i ++)
+        {
+            if(time_sim_timer[i].active && target_ns >= time_sim_timer[i].next_ns &&
+               (0 > id || time_sim_timer[i].next_ns < time_sim_timer[id].next_ns))
+            {
+                id = i;
+            }
+        }
+        if(0 > id)
+        {
+            break;
+        }
+
+        if(time_sim_timer[id].next_ns > time_sim_now_ns.load(std::memory_order_relaxed))
+        {
+            time_sim_now_ns.store(time_sim_timer[id].next_ns, std::memory_order_release);
+        }
+        fun = time_sim_timer[id].fun;
+        arg = time_sim_timer[id].arg;
+        if(0 == time_sim_timer[id].period_ns)
+        {
+            time_sim_timer[id].active = 0;
+        }
+        else
+        {
+            time_sim_timer[id].next_ns += time_sim_timer[id].period_ns;
+        }
+        time_sim_running_id = id;
+        pthread_cond_broadcast(&time_sim_cond);                                 // 唤醒已到期的延时等待者
+        pthread_mutex_unlock(&time_sim_mutex);
+
+        time_sim_in_callback = 1;
+        fun(arg);
+        time_sim_in_callback = 0;
+        fire_count ++;
+
+        pthread_mutex_lock(&time_sim_mutex);
+        time_sim_running_id = -1;
+        pthread_cond_broadcast(&time_sim_cond);                                 // 唤醒等待回调结束的注销者
+    }
+    time_sim_now_ns.store(target_ns, std::memory_order_release);
+    pthread_cond_broadcast(&time_sim_cond);
+    pthread_mutex_unlock(&time_sim_mutex);
+
+    return fire_count;
+}
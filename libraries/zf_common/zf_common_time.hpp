@@ -0,0 +1,119 @@
+#ifndef _zf_common_time_h_
+#define _zf_common_time_h_
+
+#include "zf_common_typedef.hpp"
+
+#define TIME_SIM_TIMER_MAX              ( 32 )                                  // 仿真时钟最多同时存在的定时器数量
+
+// 时间源 默认使用真实时钟 调用 time_sim_enable 后整个进程切换为仿真时钟
+typedef enum
+{
+    TIME_SOURCE_REAL = 0,                                                       // CLOCK_MONOTONIC 与系统时间
+    TIME_SOURCE_SIM,                                                            // 虚拟时间 只在 time_sim_advance_ns 时前进
+}time_source_enum;
+
+typedef void (*time_sim_timer_fun)(void *arg);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 说明         时间源抽象
+//              库内的定时器(zf_driver_pit / timer_fd / zf_driver_pit_scheduler) 延时函数 system_delay_ms
+//              以及时间戳统一从这里取时间 不再直接读取系统时钟
+//              真实时钟下行为与直接调用 clock_gettime / clock_nanosleep 相同
+//              仿真时钟下定时器不创建线程 而是注册为仿真定时器 由测试程序调用 time_sim_advance_ns 推进虚拟时间
+//              推进过程中按到期时刻从早到晚依次在调用者线程中执行到期的定时器回调 到期时刻相同时按定时器编号从小到大执行
+//              因此控制回调的执行顺序完全确定 且可以远快于真实时间运行
+//-------------------------------------------------------------------------------------------------------------------
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取当前时间源
+// 参数说明     无
+// 返回参数     time_source_enum 当前时间源
+// 使用示例     if(TIME_SOURCE_SIM == time_get_source()) { ... }
+//-------------------------------------------------------------------------------------------------------------------
+time_source_enum time_get_source (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取单调时间
+// 参数说明     无
+// 返回参数     uint64_t        单位ns 真实时钟为 CLOCK_MONOTONIC 仿真时钟为虚拟时间
+// 使用示例     uint64_t begin = time_now_ns();
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_now_ns            (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取单调时间 毫秒
+// 参数说明     无
+// 返回参数     uint64_t        单位ms
+// 使用示例     uint64_t now = time_now_ms();
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_now_ms            (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取日历时间 毫秒
+// 参数说明     无
+// 返回参数     uint64_t        自1970年起的毫秒数 仿真时钟下为 time_sim_enable 传入的起点加上虚拟时间
+// 使用示例     uint64_t timestamp = time_wall_ms();
+// 备注信息     用于需要和其他设备对时的时间戳 计算时间间隔请使用 time_now_ns
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_wall_ms           (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     延时
+// 参数说明     ns              延时时间 单位ns
+// 返回参数     void
+// 使用示例     time_sleep_ns(1000000);
+// 备注信息     仿真时钟下阻塞到虚拟时间推进到目标时刻 在仿真定时器回调中调用时立即返回 (否则推进线程会死锁)
+//-------------------------------------------------------------------------------------------------------------------
+void    time_sleep_ns           (uint64_t ns);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     延时到指定时刻
+// 参数说明     deadline_ns     目标时刻 time_now_ns 的时间基准
+// 返回参数     void
+// 使用示例     time_sleep_until_ns(next_ns);
+// 备注信息     使用绝对时间 循环中反复调用不会累积误差
+//-------------------------------------------------------------------------------------------------------------------
+void    time_sleep_until_ns     (uint64_t deadline_ns);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     切换到仿真时钟
+// 参数说明     wall_start_ms   仿真起点对应的日历时间 单位ms 传0表示从1970年开始
+// 返回参数     int8            0-成功 -1-已经是仿真时钟
+// 使用示例     time_sim_enable(0);
+// 备注信息     必须在启动任何定时器之前调用 虚拟时间从0开始
+//-------------------------------------------------------------------------------------------------------------------
+int8    time_sim_enable         (uint64_t wall_start_ms);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     注册仿真定时器
+// 参数说明     fun             到期回调
+// 参数说明     arg             回调参数
+// 参数说明     first_ns        第一次到期的虚拟时刻 不晚于当前时刻时在下一次推进时立即执行
+// 参数说明     period_ns       周期 0表示只执行一次
+// 返回参数     int             成功返回定时器编号 失败返回-1
+// 使用示例     int id = time_sim_timer_add(control_tick, NULL, time_now_ns(), 1000000);
+// 备注信息     由库内定时器在仿真时钟下自动调用 一般无需手动调用
+//-------------------------------------------------------------------------------------------------------------------
+int     time_sim_timer_add      (time_sim_timer_fun fun, void *arg, uint64_t first_ns, uint64_t period_ns);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     注销仿真定时器
+// 参数说明     id              time_sim_timer_add 的返回值
+// 返回参数     void
+// 使用示例     time_sim_timer_remove(id);
+// 备注信息     该定时器的回调正在其他线程中执行时 等待执行结束后返回 返回后回调不会再被调用
+//-------------------------------------------------------------------------------------------------------------------
+void    time_sim_timer_remove   (int id);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     推进虚拟时间
+// 参数说明     ns              推进的时长 单位ns
+// 返回参数     uint64_t        本次推进中执行的定时器回调次数
+// 使用示例     time_sim_advance_ns(10ULL * 1000000000);                        // 仿真10秒
+// 备注信息     在调用者线程中按到期顺序执行所有到期回调 执行每个回调前虚拟时间先跳到其到期时刻
+//              推进结束后唤醒所有到期的 time_sleep_ns 等待者 等待者在其他线程中异步继续运行
+//              同一时间只应有一个线程推进时间
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t time_sim_advance_ns    (uint64_t ns);
+
+#endif
@@ -14,7 +14,6 @@ static fifo_struct  seekfree_assistant_fifo =
     .buffer    = seekfree_assistant_buffer, 
     .head      = 0, 
     .end       = 0, 
-    .size      = SEEKFREE_ASSISTANT_BUFFER_SIZE,    
     .max       = SEEKFREE_ASSISTANT_BUFFER_SIZE    
 };  
 #endif
@@ -0,0 +1,656 @@
+/*********************************************************************************************************************
+* 逐飞助手网络传输后端
+* 发送: 控制循环调用发送函数时只把数据整块拷贝进发送队列 由IO线程负责真正的网络发送
+*       发送队列为 SpscRing 多个发送线程之间加锁 IO线程作为唯一消费者零拷贝取数据 无需加锁
+*       UDP 把队列中的连续数据按MTU切分为数据报 一次sendmmsg批量发出
+*       TCP 一次sendmsg发送队列中的两段数据 处理部分写入与EAGAIN 断线后自动重连
+* 接收: IO线程把收到的数据写入接收队列 seekfree_assistant_data_analysis从接收队列中取数据
+********************************************************************************************************************/
+#include "zf_common_typedef.hpp"
+#include "zf_common_function.hpp"
+#include "zf_common_spsc_ring.hpp"
+
+#include "seekfree_assistant.hpp"
+#include "seekfree_assistant_interface.hpp"
+#include "seekfree_assistant_transport.hpp"
+
+#include <mutex>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <netinet/tcp.h>
+
+extern uint32 seekfree_assistant_transfer       (const uint8 *buff, uint32 length);
+extern uint32 seekfree_assistant_receive        (uint8 *buff, uint32 length);
+
+static SpscRing<uint8, SEEKFREE_ASSISTANT_TRANSPORT_TX_BUFFER_SIZE>  transport_tx;     // 生产者 发送线程(加锁) 消费者 IO线程
+static SpscRing<uint8, SEEKFREE_ASSISTANT_TRANSPORT_RX_BUFFER_SIZE>  transport_rx;     // 生产者 IO线程 消费者 数据解析线程
+static std::mutex               transport_tx_mutex;                             // 多个发送线程之间互斥
+static bool                     transport_tx_idle   = false;                    // IO线程已发空队列并准备休眠 受 transport_tx_mutex 保护
+
+static seekfree_assistant_transport_type_enum   transport_type;
+static struct sockaddr_in       transport_addr;
+static int                      transport_socket    = -1;
+static int                      transport_event_fd  = -1;                       // 唤醒IO线程
+static std::thread              transport_thread;
+static std::atomic<bool>        transport_running   {false};
+static std::atomic<bool>        transport_connected {false};
+
+static std::atomic<uint32>      stat_tx_bytes       {0};
+static std::atomic<uint32>      stat_tx_packets     {0};
+static std::atomic<uint32>      stat_tx_drop_bytes  {0};
+static std::atomic<uint32>      stat_rx_bytes       {0};
+static std::atomic<uint32>      stat_rx_drop_bytes  {0};
+static std::atomic<uint32>      stat_reconnect      {0};
+static std::atomic<uint32>      stat_error          {0};
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取单调时钟毫秒数
+// 参数说明     void
+// 返回参数     int64_t         毫秒
+// 使用示例     内部调用
+//-------------------------------------------------------------------------------------------------------------------
+static int64_t transport_now_ms (void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     唤醒IO线程
+// 参数说明     void
+// 返回参数     void
+// 使用示例     内部调用
+//-------------------------------------------------------------------------------------------------------------------
+static void transport_wakeup (void)
+{
+    uint64_t one = 1;
+    if(0 > write(transport_event_fd, &one, sizeof(one)))
+    {
+        // eventfd计数溢出之前IO线程必然已被唤醒 忽略错误
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取发送队列中待发送的数据
+// 参数说明     void
+// 返回参数     SpscRingSegments    待发送数据段 总长度为0表示队列已空
+// 使用示例     内部调用
+// 备注信息     队列为空时在锁内再确认一次并标记IO线程空闲 之后写入数据的发送线程负责唤醒IO线程 不会丢失唤醒
+//-------------------------------------------------------------------------------------------------------------------
+static SpscRingSegments<const uint8> transport_tx_pending (void)
+{
+    SpscRingSegments<const uint8> segments = transport_tx.peek_contiguous();
+
+    if(0 == segments.total())
+    {
+        std::lock_guard<std::mutex> lock(transport_tx_mutex);
+        segments = transport_tx.peek_contiguous();
+        transport_tx_idle = (0 == segments.total());
+    }
+    return segments;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     关闭当前连接
+// 参数说明     void
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     TCP断线后清空发送队列 避免新连接从半个协议包开始发送
+//-------------------------------------------------------------------------------------------------------------------
+static void transport_close (void)
+{
+    if(0 <= transport_socket)
+    {
+        close(transport_socket);
+        transport_socket = -1;
+    }
+    transport_connected = false;
+    transport_tx.discard();
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     创建套接字并发起连接
+// 参数说明     void
+// 返回参数     int8            0-已连接 1-连接中 -1-失败
+// 使用示例     内部调用
+// 备注信息     非阻塞connect 不会阻塞IO线程 连接结果在套接字可写时通过SO_ERROR获取
+//-------------------------------------------------------------------------------------------------------------------
+static int8 transport_open (void)
+{
+    int8 state = -1;
+    int  flag  = 1;
+
+    do
+    {
+        transport_socket = socket(AF_INET, (SEEKFREE_ASSISTANT_TRANSPORT_UDP == transport_type ? SOCK_DGRAM : SOCK_STREAM) | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if(0 > transport_socket)
+        {
+            break;
+        }
+
+        if(SEEKFREE_ASSISTANT_TRANSPORT_TCP == transport_type)
+        {
+            // 关闭Nagle 协议包小而频繁 需要尽快发出
+            setsockopt(transport_socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+        }
+
+        // UDP同样connect 之后可直接send/recv 并且只接收上位机的数据
+        if(0 == connect(transport_socket, (struct sockaddr *)&transport_addr, sizeof(transport_addr)))
+        {
+            state = 0;
+        }
+        else if(EINPROGRESS == errno)
+        {
+            state = 1;
+        }
+        else
+        {
+            close(transport_socket);
+            transport_socket = -1;
+        }
+    }while(0);
+
+    return state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     UDP发送队列中的数据
+// 参数说明     void
+// 返回参数     int8            0-队列已发空 1-套接字缓冲区已满需要等待可写
+// 使用示例     内部调用
+// 备注信息     每个数据报最多SEEKFREE_ASSISTANT_TRANSPORT_UDP_PAYLOAD_MAX字节 跨越队列末尾时使用两段iovec
+//-------------------------------------------------------------------------------------------------------------------
+static int8 transport_udp_flush (void)
+{
+    struct mmsghdr  msg[SEEKFREE_ASSISTANT_TRANSPORT_UDP_BATCH_MAX];
+    struct iovec    iov[SEEKFREE_ASSISTANT_TRANSPORT_UDP_BATCH_MAX][2];
+    uint32          msg_length[SEEKFREE_ASSISTANT_TRANSPORT_UDP_BATCH_MAX];
+    uint32          length, first, sent_length;
+    int             msg_count, sent, i;
+    SpscRingSegments<const uint8> pending;
+
+    while(1)
+    {
+        pending = transport_tx_pending();
+        if(0 == pending.total())
+        {
+            return 0;
+        }
+
+        // 数据报按队列顺序依次切分 跨越第一段末尾的数据报使用两段iovec
+        for(msg_count = 0; (SEEKFREE_ASSISTANT_TRANSPORT_UDP_BATCH_MAX > msg_count) && (0 != pending.total()); msg_count ++)
+        {
+            length = (uint32)pending.total();
+            if(SEEKFREE_ASSISTANT_TRANSPORT_UDP_PAYLOAD_MAX < length)
+            {
+                length = SEEKFREE_ASSISTANT_TRANSPORT_UDP_PAYLOAD_MAX;
+            }
+            first = (uint32)pending.first_length;
+            if(first > length)
+            {
+                first = length;
+            }
+
+            iov[msg_count][0].iov_base = (void *)pending.first;
+            iov[msg_count][0].iov_len  = first;
+            iov[msg_count][1].iov_base = (void *)pending.second;
+            iov[msg_count][1].iov_len  = length - first;
+
+            memset(&msg[msg_count], 0, sizeof(msg[msg_count]));
+            msg[msg_count].msg_hdr.msg_iov    = iov[msg_count];
+            msg[msg_count].msg_hdr.msg_iovlen = (length == first) ? 1 : 2;
+            msg_length[msg_count] = length;
+
+            if(first < pending.first_length)
+            {
+                pending.first        += first;
+                pending.first_length -= first;
+            }
+            else
+            {
+                // 第一段已用完 剩余数据全部在第二段
+                pending.first         = pending.second + (length - first);
+                pending.first_length  = pending.second_length - (length - first);
+                pending.second_length = 0;
+            }
+        }
+
+        sent = sendmmsg(transport_socket, msg, msg_count, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(0 > sent)
+        {
+            if((EAGAIN == errno) || (EWOULDBLOCK == errno) || (ENOBUFS == errno))
+            {
+                return 1;
+            }
+            if(EINTR == errno)
+            {
+                continue;
+            }
+            // 上位机端口未打开时会收到ECONNREFUSED 丢弃第一个数据报继续 不让队列卡死
+            stat_error ++;
+            stat_tx_drop_bytes += msg_length[0];
+            sent = 1;
+            sent_length = msg_length[0];
+        }
+        else
+        {
+            sent_length = 0;
+            for(i = 0; i < sent; i ++)
+            {
+                sent_length += msg_length[i];
+            }
+            stat_tx_bytes   += sent_length;
+            stat_tx_packets += sent;
+        }
+
+        transport_tx.commit(sent_length);
+
+        if(sent < msg_count)
+        {
+            return 1;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     TCP发送队列中的数据
+// 参数说明     void
+// 返回参数     int8            0-队列已发空 1-套接字缓冲区已满需要等待可写 -1-连接断开
+// 使用示例     内部调用
+// 备注信息     send可能只写入一部分 只按实际写入的字节数推进队列 剩余数据等待下次可写继续发送
+//-------------------------------------------------------------------------------------------------------------------
+static int8 transport_tcp_flush (void)
+{
+    struct msghdr   msg;
+    struct iovec    iov[2];
+    ssize_t         sent;
+    SpscRingSegments<const uint8> pending;
+
+    while(1)
+    {
+        pending = transport_tx_pending();
+        if(0 == pending.total())
+        {
+            return 0;
+        }
+
+        iov[0].iov_base = (void *)pending.first;
+        iov[0].iov_len  = pending.first_length;
+        iov[1].iov_base = (void *)pending.second;
+        iov[1].iov_len  = pending.second_length;
+
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov     = iov;
+        msg.msg_iovlen  = (0 == pending.second_length) ? 1 : 2;
+
+        sent = sendmsg(transport_socket, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(0 > sent)
+        {
+            if((EAGAIN == errno) || (EWOULDBLOCK == errno))
+            {
+                return 1;
+            }
+            if(EINTR == errno)
+            {
+                continue;
+            }
+            stat_error ++;
+            return -1;
+        }
+
+        stat_tx_bytes   += (uint32)sent;
+        stat_tx_packets ++;
+        transport_tx.commit((size_t)sent);
+
+        if((size_t)sent < pending.total())
+        {
+            // 部分写入 说明套接字发送缓冲区已满
+            return 1;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     读取套接字中的数据写入接收队列
+// 参数说明     void
+// 返回参数     int8            0-正常 -1-连接断开
+// 使用示例     内部调用
+//-------------------------------------------------------------------------------------------------------------------
+static int8 transport_read (void)
+{
+    uint8   temp_buffer[SEEKFREE_ASSISTANT_TRANSPORT_UDP_PAYLOAD_MAX];
+    uint32  written;
+    ssize_t length;
+
+    while(1)
+    {
+        length = recv(transport_socket, temp_buffer, sizeof(temp_buffer), MSG_DONTWAIT);
+        if(0 > length)
+        {
+            if((EAGAIN == errno) || (EWOULDBLOCK == errno))
+            {
+                return 0;
+            }
+            if(EINTR == errno)
+            {
+                continue;
+            }
+            if(SEEKFREE_ASSISTANT_TRANSPORT_UDP == transport_type)
+            {
+                // UDP上的ICMP错误不影响后续收发
+                return 0;
+            }
+            stat_error ++;
+            return -1;
+        }
+        if((0 == length) && (SEEKFREE_ASSISTANT_TRANSPORT_TCP == transport_type))
+        {
+            // 对端关闭连接
+            return -1;
+        }
+
+        written = (uint32)transport_rx.write(temp_buffer, (size_t)length);
+        stat_rx_bytes      += written;
+        stat_rx_drop_bytes += (uint32)length - written;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     IO线程
+// 参数说明     void
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     poll等待唤醒事件/套接字可读/套接字可写 TCP未连接时按退避间隔重连
+//-------------------------------------------------------------------------------------------------------------------
+static void transport_thread_entry (void)
+{
+    struct pollfd   fds[2];
+    uint64_t        event_count;
+    int64_t         reconnect_time  = 0;
+    int64_t         connect_timeout = 0;
+    int32           reconnect_delay = SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MIN_MS;
+    int8            connecting      = 0;                                        // 非阻塞connect进行中
+    int8            tx_blocked      = 0;                                        // 等待套接字可写
+    int8            state;
+    int             timeout, error;
+    socklen_t       error_length;
+
+    prctl(PR_SET_NAME, "sa_transport");
+
+    while(transport_running)
+    {
+        // TCP断线重连
+        if((0 > transport_socket) && (transport_now_ms() >= reconnect_time))
+        {
+            state = transport_open();
+            if(0 > state)
+            {
+                reconnect_time  = transport_now_ms() + reconnect_delay;
+                reconnect_delay = func_limit_ab(reconnect_delay * 2, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MIN_MS, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MAX_MS);
+            }
+            else
+            {
+                connecting      = state;
+                connect_timeout = transport_now_ms() + SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MAX_MS;
+                tx_blocked      = 0;
+                if(0 == state)
+                {
+                    reconnect_delay     = SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MIN_MS;
+                    transport_connected = true;
+                    stat_reconnect ++;
+                }
+            }
+        }
+
+        fds[0].fd       = transport_event_fd;
+        fds[0].events   = POLLIN;
+        fds[0].revents  = 0;
+        fds[1].fd       = transport_socket;
+        fds[1].events   = (0 > transport_socket) ? 0 : (POLLIN | ((connecting || tx_blocked) ? POLLOUT : 0));
+        fds[1].revents  = 0;
+
+        timeout = -1;
+        if(0 > transport_socket)
+        {
+            timeout = (int)func_limit_ab(reconnect_time - transport_now_ms(), 0, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MAX_MS);
+        }
+        else if(connecting)
+        {
+            timeout = (int)func_limit_ab(connect_timeout - transport_now_ms(), 0, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MAX_MS);
+        }
+
+        if(0 > poll(fds, 2, timeout))
+        {
+            continue;
+        }
+
+        if(fds[0].revents & POLLIN)
+        {
+            if(0 > read(transport_event_fd, &event_count, sizeof(event_count)))
+            {
+                // 非阻塞eventfd 无事件时返回EAGAIN
+            }
+        }
+        if(0 > transport_socket)
+        {
+            continue;
+        }
+
+        if(connecting)
+        {
+            if(0 == (fds[1].revents & (POLLOUT | POLLERR | POLLHUP)))
+            {
+                if(transport_now_ms() >= connect_timeout)
+                {
+                    // 连接超时
+                    transport_close();
+                    reconnect_time  = transport_now_ms() + reconnect_delay;
+                    reconnect_delay = func_limit_ab(reconnect_delay * 2, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MIN_MS, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MAX_MS);
+                }
+                continue;
+            }
+            error = 0;
+            error_length = sizeof(error);
+            getsockopt(transport_socket, SOL_SOCKET, SO_ERROR, &error, &error_length);
+            if(0 != error)
+            {
+                transport_close();
+                reconnect_time  = transport_now_ms() + reconnect_delay;
+                reconnect_delay = func_limit_ab(reconnect_delay * 2, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MIN_MS, SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MAX_MS);
+                continue;
+            }
+            connecting          = 0;
+            reconnect_delay     = SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MIN_MS;
+            transport_connected = true;
+            stat_reconnect ++;
+        }
+
+        state = 0;
+        if(fds[1].revents & (POLLIN | POLLERR | POLLHUP))
+        {
+            state = transport_read();
+        }
+        if(0 == state)
+        {
+            state = (SEEKFREE_ASSISTANT_TRANSPORT_UDP == transport_type) ? transport_udp_flush() : transport_tcp_flush();
+            tx_blocked = (1 == state);
+        }
+        if(0 > state)
+        {
+            transport_close();
+            tx_blocked     = 0;
+            reconnect_time = transport_now_ms() + reconnect_delay;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 发送函数
+// 参数说明     *buff           需要发送的数据地址
+// 参数说明     length          需要发送的长度
+// 返回参数     uint32          剩余未发送数据长度 0-全部写入发送队列 length-队列空间不足或未连接 数据被丢弃
+// 使用示例     由seekfree_assistant内部通过回调调用
+// 备注信息     数据整块写入发送队列 不会只写入一部分 保证上位机收到的协议包完整
+//              只有IO线程已发空队列准备休眠时才唤醒 其余情况IO线程必然处于发送中或等待可写
+//-------------------------------------------------------------------------------------------------------------------
+uint32 seekfree_assistant_transport_send (const uint8 *buff, uint32 length)
+{
+    uint32 remain = length;
+    uint8  need_wakeup = 0;
+
+    if(transport_connected && (0 < length))
+    {
+        std::lock_guard<std::mutex> lock(transport_tx_mutex);
+        if(transport_tx.write_all(buff, length))
+        {
+            need_wakeup       = transport_tx_idle;
+            transport_tx_idle = false;
+            remain            = 0;
+        }
+    }
+
+    if(remain)
+    {
+        stat_tx_drop_bytes += remain;
+    }
+    else if(need_wakeup)
+    {
+        transport_wakeup();
+    }
+    return remain;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 接收函数
+// 参数说明     *buff           需要接收的数据地址
+// 参数说明     length          要接收的数据最大长度
+// 返回参数     uint32          接收到的数据长度
+// 使用示例     由seekfree_assistant_data_analysis内部通过回调调用
+// 备注信息     只从接收队列中取数据 不会阻塞 接收队列为单消费者 只能在同一个线程中调用
+//-------------------------------------------------------------------------------------------------------------------
+uint32 seekfree_assistant_transport_receive (uint8 *buff, uint32 length)
+{
+    return (uint32)transport_rx.read(buff, length);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 初始化
+// 参数说明     type            传输方式 SEEKFREE_ASSISTANT_TRANSPORT_UDP / SEEKFREE_ASSISTANT_TRANSPORT_TCP
+// 参数说明     ip_addr         上位机IP地址字符串
+// 参数说明     port            上位机端口号
+// 返回参数     int8            0-成功 -1-失败
+// 使用示例     seekfree_assistant_transport_init(SEEKFREE_ASSISTANT_TRANSPORT_TCP, "192.168.1.100", 8086);
+// 备注信息     初始化成功后自动调用seekfree_assistant_interface_init注册收发函数
+//-------------------------------------------------------------------------------------------------------------------
+int8 seekfree_assistant_transport_init (seekfree_assistant_transport_type_enum type, const char *ip_addr, uint32 port)
+{
+    int8 return_state = -1;
+
+    do
+    {
+        if(transport_running)
+        {
+            printf("seekfree assistant transport already running\r\n");
+            break;
+        }
+
+        memset(&transport_addr, 0, sizeof(transport_addr));
+        transport_addr.sin_family = AF_INET;
+        transport_addr.sin_port   = htons(port);
+        if(0 == inet_aton(ip_addr, &transport_addr.sin_addr))
+        {
+            printf("seekfree assistant transport invalid ip %s\r\n", ip_addr);
+            break;
+        }
+
+        transport_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(0 > transport_event_fd)
+        {
+            perror("eventfd");
+            break;
+        }
+
+        transport_type    = type;
+        transport_tx_idle = true;
+        transport_tx.discard();
+        transport_rx.discard();
+
+        // UDP套接字立即创建 创建失败直接返回错误 TCP连接交给IO线程
+        if(SEEKFREE_ASSISTANT_TRANSPORT_UDP == type)
+        {
+            if(0 != transport_open())
+            {
+                perror("seekfree assistant transport udp");
+                close(transport_event_fd);
+                transport_event_fd = -1;
+                break;
+            }
+            transport_connected = true;
+        }
+
+        transport_running = true;
+        transport_thread  = std::thread(transport_thread_entry);
+
+        seekfree_assistant_interface_init(seekfree_assistant_transport_send, seekfree_assistant_transport_receive);
+        return_state = 0;
+    }while(0);
+
+    return return_state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 注销
+// 参数说明     void
+// 返回参数     void
+// 使用示例     seekfree_assistant_transport_deinit();
+// 备注信息     停止IO线程并关闭套接字 收发函数恢复为默认的弱函数
+//-------------------------------------------------------------------------------------------------------------------
+void seekfree_assistant_transport_deinit (void)
+{
+    if(!transport_running)
+    {
+        return;
+    }
+
+    seekfree_assistant_interface_init(seekfree_assistant_transfer, seekfree_assistant_receive);
+
+    transport_running = false;
+    transport_wakeup();
+    if(transport_thread.joinable())
+    {
+        transport_thread.join();
+    }
+
+    transport_close();
+    close(transport_event_fd);
+    transport_event_fd = -1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 获取连接状态
+// 参数说明     void
+// 返回参数     uint8           1-已连接(UDP初始化成功即视为已连接) 0-未连接
+// 使用示例     if(seekfree_assistant_transport_is_connected())
+//-------------------------------------------------------------------------------------------------------------------
+uint8 seekfree_assistant_transport_is_connected (void)
+{
+    return transport_connected ? 1 : 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 获取统计信息
+// 参数说明     *stat           统计信息输出地址
+// 返回参数     void
+// 使用示例     seekfree_assistant_transport_stat_struct stat; seekfree_assistant_transport_get_stat(&stat);
+//-------------------------------------------------------------------------------------------------------------------
+void seekfree_assistant_transport_get_stat (seekfree_assistant_transport_stat_struct *stat)
+{
+    stat->tx_bytes          = stat_tx_bytes;
+    stat->tx_packets        = stat_tx_packets;
+    stat->tx_drop_bytes     = stat_tx_drop_bytes;
+    stat->rx_bytes          = stat_rx_bytes;
+    stat->rx_drop_bytes     = stat_rx_drop_bytes;
+    stat->reconnect_count   = stat_reconnect;
+    stat->error_count       = stat_error;
+}
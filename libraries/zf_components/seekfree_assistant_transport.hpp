@@ -0,0 +1,99 @@
+#ifndef _seekfree_assistant_transport_h_
+#define _seekfree_assistant_transport_h_
+
+#include "zf_common_typedef.hpp"
+
+// 发送队列大小 必须为2的幂 需要能容纳至少一帧图像数据 默认256KB
+#define SEEKFREE_ASSISTANT_TRANSPORT_TX_BUFFER_SIZE     ( 0x40000 )
+
+// 接收队列大小 必须为2的幂
+#define SEEKFREE_ASSISTANT_TRANSPORT_RX_BUFFER_SIZE     ( 0x1000 )
+
+// UDP单个数据报最大负载 以太网MTU(1500) - IP头(20) - UDP头(8) 避免IP分片
+#define SEEKFREE_ASSISTANT_TRANSPORT_UDP_PAYLOAD_MAX    ( 1472 )
+
+// 单次sendmmsg最多批量发送的数据报数量
+#define SEEKFREE_ASSISTANT_TRANSPORT_UDP_BATCH_MAX      ( 16 )
+
+// TCP断线重连最小/最大间隔 单位毫秒 每次失败间隔翻倍
+#define SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MIN_MS   ( 100 )
+#define SEEKFREE_ASSISTANT_TRANSPORT_RECONNECT_MAX_MS   ( 2000 )
+
+// 传输方式枚举
+typedef enum
+{
+    SEEKFREE_ASSISTANT_TRANSPORT_UDP,   // UDP 按MTU切分数据报 sendmmsg批量发送
+    SEEKFREE_ASSISTANT_TRANSPORT_TCP,   // TCP 有界发送队列 处理部分写入与EAGAIN 自动重连
+}seekfree_assistant_transport_type_enum;
+
+// 传输统计信息
+typedef struct
+{
+    uint32  tx_bytes;                   // 已发送字节数
+    uint32  tx_packets;                 // 已发送数据报数(UDP)或发送系统调用次数(TCP)
+    uint32  tx_drop_bytes;              // 因发送队列已满或未连接而丢弃的字节数
+    uint32  rx_bytes;                   // 已接收字节数
+    uint32  rx_drop_bytes;              // 因接收队列已满而丢弃的字节数
+    uint32  reconnect_count;            // TCP连接建立次数 含首次连接
+    uint32  error_count;                // 发送/接收错误次数
+}seekfree_assistant_transport_stat_struct;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 初始化
+// 参数说明     type            传输方式 SEEKFREE_ASSISTANT_TRANSPORT_UDP / SEEKFREE_ASSISTANT_TRANSPORT_TCP
+// 参数说明     ip_addr         上位机IP地址字符串
+// 参数说明     port            上位机端口号
+// 返回参数     int8            0-成功 -1-失败
+// 使用示例     seekfree_assistant_transport_init(SEEKFREE_ASSISTANT_TRANSPORT_TCP, "192.168.1.100", 8086);
+// 备注信息     初始化成功后自动调用seekfree_assistant_interface_init注册收发函数
+//              网络收发全部在独立IO线程中完成 控制循环中调用发送函数只做内存拷贝 不会阻塞
+//              TCP方式初始化时不等待连接建立 连接与断线重连均由IO线程在后台完成
+//-------------------------------------------------------------------------------------------------------------------
+int8    seekfree_assistant_transport_init       (seekfree_assistant_transport_type_enum type, const char *ip_addr, uint32 port);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 注销
+// 参数说明     void
+// 返回参数     void
+// 使用示例     seekfree_assistant_transport_deinit();
+// 备注信息     停止IO线程并关闭套接字 收发函数恢复为默认的弱函数
+//-------------------------------------------------------------------------------------------------------------------
+void    seekfree_assistant_transport_deinit     (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 发送函数
+// 参数说明     *buff           需要发送的数据地址
+// 参数说明     length          需要发送的长度
+// 返回参数     uint32          剩余未发送数据长度 0-全部写入发送队列 length-队列空间不足或未连接 数据被丢弃
+// 使用示例     由seekfree_assistant内部通过回调调用
+// 备注信息     数据整块写入发送队列 不会只写入一部分 保证上位机收到的协议包完整
+//-------------------------------------------------------------------------------------------------------------------
+uint32  seekfree_assistant_transport_send       (const uint8 *buff, uint32 length);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 接收函数
+// 参数说明     *buff           需要接收的数据地址
+// 参数说明     length          要接收的数据最大长度
+// 返回参数     uint32          接收到的数据长度
+// 使用示例     由seekfree_assistant_data_analysis内部通过回调调用
+// 备注信息     只从接收队列中取数据 不会阻塞
+//-------------------------------------------------------------------------------------------------------------------
+uint32  seekfree_assistant_transport_receive    (uint8 *buff, uint32 length);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 获取连接状态
+// 参数说明     void
+// 返回参数     uint8           1-已连接(UDP初始化成功即视为已连接) 0-未连接
+// 使用示例     if(seekfree_assistant_transport_is_connected())
+//-------------------------------------------------------------------------------------------------------------------
+uint8   seekfree_assistant_transport_is_connected (void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     逐飞助手网络传输 获取统计信息
+// 参数说明     *stat           统计信息输出地址
+// 返回参数     void
+// 使用示例     seekfree_assistant_transport_stat_struct stat; seekfree_assistant_transport_get_stat(&stat);
+//-------------------------------------------------------------------------------------------------------------------
+void    seekfree_assistant_transport_get_stat   (seekfree_assistant_transport_stat_struct *stat);
+
+#endif
@@ -0,0 +1,471 @@
+#include "zf_components_ahrs.hpp"
+
+#include <cmath>
+
+#define AHRS_DEG_TO_RAD                 ( (ahrs_real)0.017453292519943295 )
+#define AHRS_RAD_TO_DEG                 ( (ahrs_real)57.29577951308232 )
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     平方根倒数
+// 参数说明     x               输入 必须大于0
+// 返回参数     ahrs_real       1/sqrt(x)
+// 使用示例     内部调用
+// 备注信息     直接使用硬件开方 LA264带浮点单元 比查表或牛顿迭代的近似算法更快且更准
+//-------------------------------------------------------------------------------------------------------------------
+static inline ahrs_real ahrs_inv_sqrt (ahrs_real x)
+{
+    return (ahrs_real)1 / std::sqrt(x);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     三维向量归一化
+// 参数说明     v               向量
+// 返回参数     uint8           0-零向量 未修改 1-成功
+// 使用示例     内部调用
+//-------------------------------------------------------------------------------------------------------------------
+static inline uint8 ahrs_normalize3 (ahrs_real v[3])
+{
+    ahrs_real norm = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    if((ahrs_real)0 >= norm)
+    {
+        return 0;
+    }
+    norm = ahrs_inv_sqrt(norm);
+    for(int i = 0; i < 3; i ++)
+    {
+        v[i] *= norm;
+    }
+    return 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     四元数归一化
+// 参数说明     q               四元数
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     四个分量写成定长循环 便于编译器生成向量指令
+//-------------------------------------------------------------------------------------------------------------------
+static inline void ahrs_normalize4 (ahrs_real q[4])
+{
+    ahrs_real norm = 0;
+    for(int i = 0; i < 4; i ++)
+    {
+        norm += q[i] * q[i];
+    }
+    norm = ahrs_inv_sqrt(norm);
+    for(int i = 0; i < 4; i ++)
+    {
+        q[i] *= norm;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     由加速度与磁场直接计算姿态
+// 参数说明     ahrs            解算实例
+// 参数说明     acc             归一化的加速度
+// 参数说明     mag             归一化的磁场 NULL表示航向取0
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     避免从单位四元数开始需要数秒才能收敛到真实姿态
+//-------------------------------------------------------------------------------------------------------------------
+static void ahrs_init_attitude (ahrs_struct *ahrs, const ahrs_real acc[3], const ahrs_real mag[3])
+{
+    ahrs_real roll  = std::atan2(acc[1], acc[2]);
+    ahrs_real pitch = std::atan2(-acc[0], std::sqrt(acc[1] * acc[1] + acc[2] * acc[2]));
+    ahrs_real yaw   = 0;
+
+    if(NULL != mag)
+    {
+        // 倾斜补偿后磁场在水平面内的投影
+        ahrs_real hx = mag[0] * std::cos(pitch) + mag[1] * std::sin(roll) * std::sin(pitch) + mag[2] * std::cos(roll) * std::sin(pitch);
+        ahrs_real hy = mag[1] * std::cos(roll) - mag[2] * std::sin(roll);
+        yaw = std::atan2(-hy, hx);
+    }
+
+    ahrs_real cr = std::cos(roll * (ahrs_real)0.5),  sr = std::sin(roll * (ahrs_real)0.5);
+    ahrs_real cp = std::cos(pitch * (ahrs_real)0.5), sp = std::sin(pitch * (ahrs_real)0.5);
+    ahrs_real cy = std::cos(yaw * (ahrs_real)0.5),   sy = std::sin(yaw * (ahrs_real)0.5);
+
+    ahrs->q[0] = cr * cp * cy + sr * sp * sy;
+    ahrs->q[1] = sr * cp * cy - cr * sp * sy;
+    ahrs->q[2] = cr * sp * cy + sr * cp * sy;
+    ahrs->q[3] = cr * cp * sy - sr * sp * cy;
+    ahrs_normalize4(ahrs->q);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     Mahony 更新
+// 参数说明     ahrs            解算实例
+// 参数说明     g               角速度 rad/s
+// 参数说明     a               归一化的加速度 NULL表示不修正
+// 参数说明     m               归一化的磁场 NULL表示不使用
+// 参数说明     dt              时间间隔 s
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     用估计的重力/磁场方向与测量值的叉积作为误差 经PI控制器修正角速度后积分
+//-------------------------------------------------------------------------------------------------------------------
+static void ahrs_mahony_update (ahrs_struct *ahrs, ahrs_real g[3], const ahrs_real *a, const ahrs_real *m, ahrs_real dt)
+{
+    ahrs_real *q = ahrs->q;
+    ahrs_real e[3] = {0, 0, 0};
+
+    if(NULL != a)
+    {
+        ahrs_real q0q0 = q[0] * q[0], q0q1 = q[0] * q[1], q0q2 = q[0] * q[2], q0q3 = q[0] * q[3];
+        ahrs_real q1q1 = q[1] * q[1], q1q2 = q[1] * q[2], q1q3 = q[1] * q[3];
+        ahrs_real q2q2 = q[2] * q[2], q2q3 = q[2] * q[3], q3q3 = q[3] * q[3];
+
+        // 估计的重力方向(机体系) 取一半避免乘2
+        ahrs_real vx = q1q3 - q0q2;
+        ahrs_real vy = q0q1 + q2q3;
+        ahrs_real vz = q0q0 - (ahrs_real)0.5 + q3q3;
+
+        e[0] = a[1] * vz - a[2] * vy;
+        e[1] = a[2] * vx - a[0] * vz;
+        e[2] = a[0] * vy - a[1] * vx;
+
+        if(NULL != m)
+        {
+            // 磁场转到地理系 水平分量合并到x轴得到参考磁场 再转回机体系
+            ahrs_real hx = 2 * (m[0] * ((ahrs_real)0.5 - q2q2 - q3q3) + m[1] * (q1q2 - q0q3) + m[2] * (q1q3 + q0q2));
+            ahrs_real hy = 2 * (m[0] * (q1q2 + q0q3) + m[1] * ((ahrs_real)0.5 - q1q1 - q3q3) + m[2] * (q2q3 - q0q1));
+            ahrs_real bx = std::sqrt(hx * hx + hy * hy);
+            ahrs_real bz = 2 * (m[0] * (q1q3 - q0q2) + m[1] * (q2q3 + q0q1) + m[2] * ((ahrs_real)0.5 - q1q1 - q2q2));
+
+            ahrs_real wx = bx * ((ahrs_real)0.5 - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+            ahrs_real wy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+            ahrs_real wz = bx * (q0q2 + q1q3) + bz * ((ahrs_real)0.5 - q1q1 - q2q2);
+
+            e[0] += m[1] * wz - m[2] * wy;
+            e[1] += m[2] * wx - m[0] * wz;
+            e[2] += m[0] * wy - m[1] * wx;
+        }
+
+        for(int i = 0; i < 3; i ++)
+        {
+            if((ahrs_real)0 < ahrs->config.ki)
+            {
+                ahrs->integral[i] += 2 * ahrs->config.ki * e[i] * dt;
+                g[i] += ahrs->integral[i];
+            }
+            g[i] += 2 * ahrs->config.kp * e[i];
+        }
+    }
+
+    for(int i = 0; i < 3; i ++)
+    {
+        g[i] *= (ahrs_real)0.5 * dt;
+    }
+    ahrs_real qa = q[0], qb = q[1], qc = q[2];
+    q[0] += -qb * g[0] - qc * g[1] - q[3] * g[2];
+    q[1] +=  qa * g[0] + qc * g[2] - q[3] * g[1];
+    q[2] +=  qa * g[1] - qb * g[2] + q[3] * g[0];
+    q[3] +=  qa * g[2] + qb * g[1] - qc * g[0];
+    ahrs_normalize4(q);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     Madgwick 更新
+// 参数说明     ahrs            解算实例
+// 参数说明     g               角速度 rad/s
+// 参数说明     a               归一化的加速度 NULL表示不修正
+// 参数说明     m               归一化的磁场 NULL表示不使用
+// 参数说明     dt              时间间隔 s
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     四元数微分减去 beta 倍的目标函数归一化梯度
+//-------------------------------------------------------------------------------------------------------------------
+static void ahrs_madgwick_update (ahrs_struct *ahrs, const ahrs_real g[3], const ahrs_real *a, const ahrs_real *m, ahrs_real dt)
+{
+    ahrs_real *q = ahrs->q;
+    ahrs_real q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+    ahrs_real s[4] = {0, 0, 0, 0};
+    ahrs_real dq[4];
+
+    dq[0] = (ahrs_real)0.5 * (-q1 * g[0] - q2 * g[1] - q3 * g[2]);
+    dq[1] = (ahrs_real)0.5 * ( q0 * g[0] + q2 * g[2] - q3 * g[1]);
+    dq[2] = (ahrs_real)0.5 * ( q0 * g[1] - q1 * g[2] + q3 * g[0]);
+    dq[3] = (ahrs_real)0.5 * ( q0 * g[2] + q1 * g[1] - q2 * g[0]);
+
+    if(NULL != a && NULL == m)
+    {
+        ahrs_real _2q0 = 2 * q0, _2q1 = 2 * q1, _2q2 = 2 * q2, _2q3 = 2 * q3;
+        ahrs_real _4q0 = 4 * q0, _4q1 = 4 * q1, _4q2 = 4 * q2;
+        ahrs_real _8q1 = 8 * q1, _8q2 = 8 * q2;
+        ahrs_real q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        s[0] = _4q0 * q2q2 + _2q2 * a[0] + _4q0 * q1q1 - _2q1 * a[1];
+        s[1] = _4q1 * q3q3 - _2q3 * a[0] + 4 * q0q0 * q1 - _2q0 * a[1] - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * a[2];
+        s[2] = 4 * q0q0 * q2 + _2q0 * a[0] + _4q2 * q3q3 - _2q3 * a[1] - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * a[2];
+        s[3] = 4 * q1q1 * q3 - _2q1 * a[0] + 4 * q2q2 * q3 - _2q2 * a[1];
+    }
+    else if(NULL != a)
+    {
+        ahrs_real _2q0mx = 2 * q0 * m[0], _2q0my = 2 * q0 * m[1], _2q0mz = 2 * q0 * m[2], _2q1mx = 2 * q1 * m[0];
+        ahrs_real _2q0 = 2 * q0, _2q1 = 2 * q1, _2q2 = 2 * q2, _2q3 = 2 * q3;
+        ahrs_real _2q0q2 = 2 * q0 * q2, _2q2q3 = 2 * q2 * q3;
+        ahrs_real q0q0 = q0 * q0, q0q1 = q0 * q1, q0q2 = q0 * q2, q0q3 = q0 * q3;
+        ahrs_real q1q1 = q1 * q1, q1q2 = q1 * q2, q1q3 = q1 * q3;
+        ahrs_real q2q2 = q2 * q2, q2q3 = q2 * q3, q3q3 = q3 * q3;
+
+        // 参考磁场方向 地理系水平分量 _2bx 与竖直分量 _2bz
+        ahrs_real hx = m[0] * q0q0 - _2q0my * q3 + _2q0mz * q2 + m[0] * q1q1 + _2q1 * m[1] * q2 + _2q1 * m[2] * q3 - m[0] * q2q2 - m[0] * q3q3;
+        ahrs_real hy = _2q0mx * q3 + m[1] * q0q0 - _2q0mz * q1 + _2q1mx * q2 - m[1] * q1q1 + m[1] * q2q2 + _2q2 * m[2] * q3 - m[1] * q3q3;
+        ahrs_real _2bx = std::sqrt(hx * hx + hy * hy);
+        ahrs_real _2bz = -_2q0mx * q2 + _2q0my * q1 + m[2] * q0q0 + _2q1mx * q3 - m[2] * q1q1 + _2q2 * m[1] * q3 - m[2] * q2q2 + m[2] * q3q3;
+        ahrs_real _4bx = 2 * _2bx, _4bz = 2 * _2bz;
+
+        // 目标函数各分量 重力3项 磁场3项
+        ahrs_real fa0 = 2 * q1q3 - _2q0q2 - a[0];
+        ahrs_real fa1 = 2 * q0q1 + _2q2q3 - a[1];
+        ahrs_real fa2 = 1 - 2 * q1q1 - 2 * q2q2 - a[2];
+        ahrs_real fm0 = _2bx * ((ahrs_real)0.5 - q2q2 - q3q3) + _2bz * (q1q3 - q0q2) - m[0];
+        ahrs_real fm1 = _2bx * (q1q2 - q0q3) + _2bz * (q0q1 + q2q3) - m[1];
+        ahrs_real fm2 = _2bx * (q0q2 + q1q3) + _2bz * ((ahrs_real)0.5 - q1q1 - q2q2) - m[2];
+
+        s[0] = -_2q2 * fa0 + _2q1 * fa1 - _2bz * q2 * fm0 + (-_2bx * q3 + _2bz * q1) * fm1 + _2bx * q2 * fm2;
+        s[1] =  _2q3 * fa0 + _2q0 * fa1 - 4 * q1 * fa2 + _2bz * q3 * fm0 + (_2bx * q2 + _2bz * q0) * fm1 + (_2bx * q3 - _4bz * q1) * fm2;
+        s[2] = -_2q0 * fa0 + _2q3 * fa1 - 4 * q2 * fa2 + (-_4bx * q2 - _2bz * q0) * fm0 + (_2bx * q1 + _2bz * q3) * fm1 + (_2bx * q0 - _4bz * q2) * fm2;
+        s[3] =  _2q1 * fa0 + _2q2 * fa1 + (-_4bx * q3 + _2bz * q1) * fm0 + (-_2bx * q0 + _2bz * q2) * fm1 + _2bx * q1 * fm2;
+    }
+
+    ahrs_real norm = s[0] * s[0] + s[1] * s[1] + s[2] * s[2] + s[3] * s[3];
+    if((ahrs_real)0 < norm)
+    {
+        norm = ahrs->config.beta * ahrs_inv_sqrt(norm);
+        for(int i = 0; i < 4; i ++)
+        {
+            dq[i] -= norm * s[i];
+        }
+    }
+
+    for(int i = 0; i < 4; i ++)
+    {
+        q[i] += dq[i] * dt;
+    }
+    ahrs_normalize4(q);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     静止检测与陀螺仪零偏标定
+// 参数说明     ahrs            解算实例
+// 参数说明     sample          原始样本
+// 参数说明     dt              时间间隔 s
+// 返回参数     void
+// 使用示例     内部调用
+// 备注信息     静止窗口内任一样本不满足条件即重新计时 窗口满后以窗口均值替换零偏并开始下一个窗口
+//-------------------------------------------------------------------------------------------------------------------
+static void ahrs_still_update (ahrs_struct *ahrs, const imu_sample_struct *sample, ahrs_real dt)
+{
+    const ahrs_config_struct *config = &ahrs->config;
+    ahrs_real acc_norm = std::sqrt(ahrs->acc[0] * ahrs->acc[0] + ahrs->acc[1] * ahrs->acc[1] + ahrs->acc[2] * ahrs->acc[2]);
+    uint8 still = (std::fabs(acc_norm - 1) < config->still_acc);
+
+    for(int i = 0; i < 3; i ++)
+    {
+        still &= (std::fabs(ahrs->gyro[i]) < config->still_gyro);
+    }
+    if(!still)
+    {
+        ahrs->still_sum[0] = ahrs->still_sum[1] = ahrs->still_sum[2] = 0;
+        ahrs->still_duration = 0;
+        ahrs->still_count = 0;
+        return;
+    }
+
+    for(int i = 0; i < 3; i ++)
+    {
+        ahrs->still_sum[i] += sample->gyro[i];
+    }
+    ahrs->still_count ++;
+    ahrs->still_duration += dt;
+    if(ahrs->still_duration >= config->still_time)
+    {
+        for(int i = 0; i < 3; i ++)
+        {
+            ahrs->config.calibration.gyro_bias[i] = ahrs->still_sum[i] / (ahrs_real)ahrs->still_count;
+            ahrs->still_sum[i] = 0;
+        }
+        ahrs->still_duration = 0;
+        ahrs->still_count = 0;
+        ahrs->gyro_bias_valid = 1;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取默认配置
+// 参数说明     config          配置
+// 返回参数     void
+// 使用示例     ahrs_config_default(&config);
+//-------------------------------------------------------------------------------------------------------------------
+void ahrs_config_default (ahrs_config_struct *config)
+{
+    memset(config, 0, sizeof(ahrs_config_struct));
+    config->algorithm       = AHRS_MAHONY;
+    config->kp              = (ahrs_real)1.0;
+    config->ki              = (ahrs_real)0.02;
+    config->beta            = (ahrs_real)0.1;
+    config->sample_period   = (ahrs_real)0.001;
+    config->use_mag         = 1;
+    config->auto_gyro_bias  = 1;
+    config->still_gyro      = (ahrs_real)AHRS_STILL_GYRO_DEFAULT;
+    config->still_acc       = (ahrs_real)AHRS_STILL_ACC_DEFAULT;
+    config->still_time      = (ahrs_real)AHRS_STILL_TIME_DEFAULT;
+    for(int i = 0; i < 3; i ++)
+    {
+        config->calibration.acc_scale[i]  = (ahrs_real)AHRS_ACC_SCALE_DEFAULT;
+        config->calibration.gyro_scale[i] = (ahrs_real)AHRS_GYRO_SCALE_DEFAULT;
+        config->calibration.mag_scale[i]  = (ahrs_real)AHRS_MAG_SCALE_DEFAULT;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     初始化
+// 参数说明     ahrs            解算实例
+// 参数说明     config          配置 NULL表示使用默认配置
+// 返回参数     void
+// 使用示例     ahrs_init(&ahrs, &config);
+//-------------------------------------------------------------------------------------------------------------------
+void ahrs_init (ahrs_struct *ahrs, const ahrs_config_struct *config)
+{
+    memset(ahrs, 0, sizeof(ahrs_struct));
+    if(NULL == config)
+    {
+        ahrs_config_default(&ahrs->config);
+    }
+    else
+    {
+        ahrs->config = *config;
+    }
+    for(int i = 0; i < 3; i ++)
+    {
+        ahrs->gyro_k[i] = ahrs->config.calibration.gyro_scale[i] * AHRS_DEG_TO_RAD;
+    }
+    ahrs_reset(ahrs);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     复位姿态
+// 参数说明     ahrs            解算实例
+// 返回参数     void
+// 使用示例     ahrs_reset(&ahrs);
+//-------------------------------------------------------------------------------------------------------------------
+void ahrs_reset (ahrs_struct *ahrs)
+{
+    ahrs->q[0] = 1;
+    ahrs->q[1] = ahrs->q[2] = ahrs->q[3] = 0;
+    ahrs->integral[0] = ahrs->integral[1] = ahrs->integral[2] = 0;
+    ahrs->yaw_rate = 0;
+    ahrs->last_timestamp_ns = 0;
+    ahrs->initialized = 0;
+    ahrs->still_sum[0] = ahrs->still_sum[1] = ahrs->still_sum[2] = 0;
+    ahrs->still_duration = 0;
+    ahrs->still_count = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     输入一个样本并更新姿态
+// 参数说明     ahrs            解算实例
+// 参数说明     sample          IMU样本
+// 返回参数     void
+// 使用示例     ahrs_update(&ahrs, &sample);
+//-------------------------------------------------------------------------------------------------------------------
+void ahrs_update (ahrs_struct *ahrs, const imu_sample_struct *sample)
+{
+    const ahrs_calibration_struct *cal = &ahrs->config.calibration;
+    ahrs_real dt = ahrs->config.sample_period;
+    ahrs_real g[3], a[3], m[3];
+    uint8 acc_valid = 0, mag_valid = 0;
+
+    if(0 != ahrs->last_timestamp_ns && sample->timestamp_ns > ahrs->last_timestamp_ns)
+    {
+        ahrs_real interval = (ahrs_real)(sample->timestamp_ns - ahrs->last_timestamp_ns) * (ahrs_real)1e-9;
+        if(interval <= (ahrs_real)AHRS_DT_MAX)
+        {
+            dt = interval;
+        }
+    }
+    ahrs->last_timestamp_ns = sample->timestamp_ns;
+
+    // 校准 各轴独立 定长循环便于向量化
+    for(int i = 0; i < 3; i ++)
+    {
+        ahrs->acc[i]  = ((ahrs_real)sample->acc[i] - cal->acc_bias[i]) * cal->acc_scale[i];
+        ahrs->gyro[i] = ((ahrs_real)sample->gyro[i] - cal->gyro_bias[i]) * cal->gyro_scale[i];
+        g[i]          = ((ahrs_real)sample->gyro[i] - cal->gyro_bias[i]) * ahrs->gyro_k[i];
+        a[i]          = ahrs->acc[i];
+        m[i]          = ((ahrs_real)sample->mag[i] - cal->mag_bias[i]) * cal->mag_scale[i];
+    }
+
+    if(ahrs->config.auto_gyro_bias)
+    {
+        ahrs_still_update(ahrs, sample, dt);
+    }
+
+    acc_valid = ahrs_normalize3(a);
+    if(ahrs->config.use_mag && (0 != sample->mag[0] || 0 != sample->mag[1] || 0 != sample->mag[2]))
+    {
+        mag_valid = ahrs_normalize3(m);
+    }
+
+    if(!ahrs->initialized && acc_valid)
+    {
+        ahrs_init_attitude(ahrs, a, mag_valid ? m : NULL);
+        ahrs->initialized = 1;
+    }
+    else if(AHRS_MADGWICK == ahrs->config.algorithm)
+    {
+        ahrs_madgwick_update(ahrs, g, acc_valid ? a : NULL, (acc_valid && mag_valid) ? m : NULL, dt);
+    }
+    else
+    {
+        ahrs_mahony_update(ahrs, g, acc_valid ? a : NULL, (acc_valid && mag_valid) ? m : NULL, dt);
+    }
+
+    // 机体角速度投影到地理系Z轴 旋转矩阵第三行
+    const ahrs_real *q = ahrs->q;
+    ahrs->yaw_rate = 2 * (q[1] * q[3] - q[0] * q[2]) * ahrs->gyro[0]
+                   + 2 * (q[2] * q[3] + q[0] * q[1]) * ahrs->gyro[1]
+                   + (1 - 2 * (q[1] * q[1] + q[2] * q[2])) * ahrs->gyro[2];
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     计算欧拉角
+// 参数说明     ahrs            解算实例
+// 参数说明     euler           欧拉角 单位°
+// 返回参数     void
+// 使用示例     ahrs_get_euler(&ahrs, &euler);
+//-------------------------------------------------------------------------------------------------------------------
+void ahrs_get_euler (const ahrs_struct *ahrs, ahrs_euler_struct *euler)
+{
+    const ahrs_real *q = ahrs->q;
+    ahrs_real sin_pitch = 2 * (q[0] * q[2] - q[1] * q[3]);
+
+    if(sin_pitch > 1)  sin_pitch = 1;
+    if(sin_pitch < -1) sin_pitch = -1;
+    euler->roll  = std::atan2(2 * (q[0] * q[1] + q[2] * q[3]), 1 - 2 * (q[1] * q[1] + q[2] * q[2])) * AHRS_RAD_TO_DEG;
+    euler->pitch = std::asin(sin_pitch) * AHRS_RAD_TO_DEG;
+    euler->yaw   = std::atan2(2 * (q[0] * q[3] + q[1] * q[2]), 1 - 2 * (q[2] * q[2] + q[3] * q[3])) * AHRS_RAD_TO_DEG;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取航向角速度
+// 参数说明     ahrs            解算实例
+// 返回参数     ahrs_real       °/s
+// 使用示例     ahrs_get_yaw_rate(&ahrs);
+//-------------------------------------------------------------------------------------------------------------------
+ahrs_real ahrs_get_yaw_rate (const ahrs_struct *ahrs)
+{
+    return ahrs->yaw_rate;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     陀螺仪零偏是否已标定
+// 参数说明     ahrs            解算实例
+// 返回参数     uint8           1-已标定
+// 使用示例     ahrs_gyro_bias_ready(&ahrs);
+//-------------------------------------------------------------------------------------------------------------------
+uint8 ahrs_gyro_bias_ready (const ahrs_struct *ahrs)
+{
+    return ahrs->gyro_bias_valid;
+}
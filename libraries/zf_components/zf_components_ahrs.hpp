@@ -0,0 +1,161 @@
+#ifndef _zf_components_ahrs_h_
+#define _zf_components_ahrs_h_
+
+#include "zf_common_typedef.hpp"
+#include "zf_device_imu.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 说明         姿态航向解算 (AHRS)
+//              输入 zf_device_imu 的 imu_sample_struct 样本(原始计数 + 时间戳) 输出四元数 欧拉角 与航向角速度
+//              原始值按 (raw - bias) * scale 校准 陀螺仪零偏可在静止时自动标定
+//              支持 Mahony(互补滤波 PI 修正) 与 Madgwick(梯度下降) 两种算法 磁力计通道有效时自动使用9轴融合
+//              结构体内保存全部状态 不申请内存 多个实例互不影响 同一实例不可多线程同时调用
+//
+//              每次 ahrs_update 的运算量(不含欧拉角 欧拉角在 ahrs_get_euler 中按需计算 另需2次atan2与1次asin)
+//              Mahony  6轴   约 70 次乘加  2 次开方
+//              Mahony  9轴   约 130 次乘加 4 次开方
+//              Madgwick 6轴  约 110 次乘加 3 次开方
+//              Madgwick 9轴  约 280 次乘加 4 次开方
+//              主机实测耗时见 zf_benchmark 的 ahrs/* 测试项 板端请在目标机上运行同一测试
+//-------------------------------------------------------------------------------------------------------------------
+
+// 定义 AHRS_USE_DOUBLE 后以双精度计算 默认单精度
+#if defined(AHRS_USE_DOUBLE)
+typedef double ahrs_real;
+#else
+typedef float ahrs_real;
+#endif
+
+#define AHRS_ACC_SCALE_DEFAULT          ( 1.0 / 4096.0 )                        // 加速度 g/LSB 对应 ±8g 量程
+#define AHRS_GYRO_SCALE_DEFAULT         ( 1.0 / 16.4 )                          // 角速度 (°/s)/LSB 对应 ±2000°/s 量程
+#define AHRS_MAG_SCALE_DEFAULT          ( 1.0 / 3000.0 )                        // 磁场 Gauss/LSB IMU963RA ±8G 量程
+
+#define AHRS_DT_MAX                     ( 0.1 )                                 // 相邻样本最大间隔 s 超出时按 sample_period 计算
+#define AHRS_STILL_GYRO_DEFAULT         ( 2.0 )                                 // 静止判定 各轴去零偏后的角速度上限 °/s
+#define AHRS_STILL_ACC_DEFAULT          ( 0.05 )                                // 静止判定 加速度模长与1g之差上限 g
+#define AHRS_STILL_TIME_DEFAULT         ( 1.0 )                                 // 静止判定 持续时间 s 满足后更新一次陀螺仪零偏
+
+typedef enum
+{
+    AHRS_MAHONY = 0,                                                            // 互补滤波 运算量小 参数 kp ki
+    AHRS_MADGWICK,                                                              // 梯度下降 参数 beta
+}ahrs_algorithm_enum;
+
+// 各轴校准参数 物理量 = (原始值 - bias) * scale
+typedef struct
+{
+    ahrs_real   acc_scale[3];                                                   // g/LSB
+    ahrs_real   acc_bias[3];                                                    // LSB
+    ahrs_real   gyro_scale[3];                                                  // (°/s)/LSB
+    ahrs_real   gyro_bias[3];                                                   // LSB 自动标定会更新此值
+    ahrs_real   mag_scale[3];                                                   // 任意单位/LSB 只使用方向 软磁校正可在此按轴缩放
+    ahrs_real   mag_bias[3];                                                    // LSB 硬磁偏移
+}ahrs_calibration_struct;
+
+typedef struct
+{
+    ahrs_algorithm_enum     algorithm;
+    ahrs_real               kp;                                                 // Mahony 比例增益
+    ahrs_real               ki;                                                 // Mahony 积分增益 0表示不积分
+    ahrs_real               beta;                                               // Madgwick 增益
+    ahrs_real               sample_period;                                      // 名义采样周期 s 时间戳无效时使用
+    uint8                   use_mag;                                            // 1-样本中磁力计非零时使用9轴融合
+    uint8                   auto_gyro_bias;                                     // 1-静止时自动标定陀螺仪零偏
+    ahrs_real               still_gyro;                                         // 静止判定 °/s
+    ahrs_real               still_acc;                                          // 静止判定 g
+    ahrs_real               still_time;                                         // 静止判定 s
+    ahrs_calibration_struct calibration;
+}ahrs_config_struct;
+
+typedef struct
+{
+    ahrs_real   roll;                                                           // 横滚角 °  绕X轴 范围 ±180
+    ahrs_real   pitch;                                                          // 俯仰角 °  绕Y轴 范围 ±90
+    ahrs_real   yaw;                                                            // 航向角 °  绕Z轴 范围 ±180
+}ahrs_euler_struct;
+
+typedef struct
+{
+    ahrs_config_struct  config;
+
+    ahrs_real   q[4];                                                           // 姿态四元数 w x y z 机体系到地理系
+    ahrs_real   integral[3];                                                    // Mahony 积分项 rad/s
+    ahrs_real   yaw_rate;                                                       // 地理系Z轴角速度 °/s
+    ahrs_real   gyro[3];                                                        // 最近一次校准后的角速度 °/s
+    ahrs_real   acc[3];                                                         // 最近一次校准后的加速度 g
+    int64_t     last_timestamp_ns;
+    uint8       initialized;                                                    // 0-下一次更新用加速度/磁力计直接确定初始姿态
+
+    ahrs_real   gyro_k[3];                                                      // gyro_scale 换算到 rad/s
+    ahrs_real   still_sum[3];                                                   // 静止窗口内陀螺仪原始值累加
+    ahrs_real   still_duration;                                                 // 静止窗口已持续时间 s
+    uint32      still_count;                                                    // 静止窗口样本数
+    uint8       gyro_bias_valid;                                                // 1-已完成至少一次零偏标定
+}ahrs_struct;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取默认配置
+// 参数说明     config          配置
+// 返回参数     void
+// 使用示例     ahrs_config_struct config; ahrs_config_default(&config);
+// 备注信息     Mahony kp=1 ki=0.02 采样周期1ms 使用磁力计 开启零偏自动标定 校准系数为默认量程
+//-------------------------------------------------------------------------------------------------------------------
+void    ahrs_config_default     (ahrs_config_struct *config);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     初始化
+// 参数说明     ahrs            解算实例
+// 参数说明     config          配置 NULL表示使用默认配置
+// 返回参数     void
+// 使用示例     ahrs_struct ahrs; ahrs_init(&ahrs, &config);
+// 备注信息     配置被复制到实例中 之后修改原配置不影响实例
+//-------------------------------------------------------------------------------------------------------------------
+void    ahrs_init               (ahrs_struct *ahrs, const ahrs_config_struct *config);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     复位姿态
+// 参数说明     ahrs            解算实例
+// 返回参数     void
+// 使用示例     ahrs_reset(&ahrs);
+// 备注信息     保留配置与陀螺仪零偏 下一次更新重新由加速度/磁力计确定初始姿态
+//-------------------------------------------------------------------------------------------------------------------
+void    ahrs_reset              (ahrs_struct *ahrs);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     输入一个样本并更新姿态
+// 参数说明     ahrs            解算实例
+// 参数说明     sample          IMU样本 时间戳单位ns
+// 返回参数     void
+// 使用示例     imu_dev.read_sample(&sample, -1); ahrs_update(&ahrs, &sample);
+// 备注信息     时间间隔由相邻样本时间戳计算 无效时按 sample_period 计算
+//              加速度为零(自由落体或未采样)时只积分陀螺仪
+//-------------------------------------------------------------------------------------------------------------------
+void    ahrs_update             (ahrs_struct *ahrs, const imu_sample_struct *sample);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     计算欧拉角
+// 参数说明     ahrs            解算实例
+// 参数说明     euler           欧拉角 单位°  Z-Y-X 顺序
+// 返回参数     void
+// 使用示例     ahrs_euler_struct euler; ahrs_get_euler(&ahrs, &euler);
+// 备注信息     按需调用 不需要欧拉角时不产生三角函数开销
+//-------------------------------------------------------------------------------------------------------------------
+void    ahrs_get_euler          (const ahrs_struct *ahrs, ahrs_euler_struct *euler);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     获取航向角速度
+// 参数说明     ahrs            解算实例
+// 返回参数     ahrs_real       地理系Z轴角速度 °/s 车身倾斜时仍是绕竖直轴的转速
+// 使用示例     ahrs_real yaw_rate = ahrs_get_yaw_rate(&ahrs);
+//-------------------------------------------------------------------------------------------------------------------
+ahrs_real ahrs_get_yaw_rate     (const ahrs_struct *ahrs);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介     陀螺仪零偏是否已标定
+// 参数说明     ahrs            解算实例
+// 返回参数     uint8           1-已完成至少一次静止标定
+// 使用示例     while(!ahrs_gyro_bias_ready(&ahrs)) { ... }
+//-------------------------------------------------------------------------------------------------------------------
+uint8   ahrs_gyro_bias_ready    (const ahrs_struct *ahrs);
+
+#endif
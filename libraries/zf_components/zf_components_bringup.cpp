@@ -0,0 +1,329 @@
+#include "zf_components_bringup.hpp"
+
+#include <thread>
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_bringup bringup;
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+zf_components_bringup::zf_components_bringup(void)
+    : task_count(0), total_ns(0)
+{
+    memset(record, 0, sizeof(record));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记任务
+// 参数说明 name       任务名
+// 参数说明 function   任务函数
+// 参数说明 timeout_ms 超时
+// 返回参数 int        任务编号 失败返回-1
+// 使用示例 bringup.add_task("display", [](){ return DisplayIps200::init(); });
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_bringup::add_task(const char *name, const std::function<int(void)> &function, uint32 timeout_ms)
+{
+    if(NULL == name || !function || BRINGUP_TASK_MAX <= task_count) return -1;
+
+    bringup_task_struct *t = &task[task_count];
+    strncpy(t->name, name, BRINGUP_NAME_MAX - 1);
+    t->name[BRINGUP_NAME_MAX - 1] = '\0';
+    t->function = function;
+    t->timeout_ms = timeout_ms;
+    t->depend_mask = 0;
+
+    memset(&record[task_count], 0, sizeof(bringup_record_struct));
+    record[task_count].name = t->name;
+    return task_count ++;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 声明依赖
+// 参数说明 index      任务编号
+// 参数说明 depends_on 依赖的任务编号
+// 返回参数 int8       0-成功 -1-失败
+// 使用示例 bringup.add_dependency(server, camera);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_bringup::add_dependency(int index, int depends_on)
+{
+    if(0 > index || task_count <= index || 0 > depends_on || task_count <= depends_on || index == depends_on) return -1;
+    task[index].depend_mask |= (1u << depends_on);
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 在新线程中执行任务
+// 参数说明 shared 共享结果
+// 参数说明 index  任务编号
+// 参数说明 origin run 开始时刻
+// 返回参数 int8   0-成功 -1-失败
+// 使用示例 内部调用
+// 备注信息 线程持有任务函数的拷贝与共享结果的引用 不访问本对象
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_bringup::launch(const std::shared_ptr<bringup_shared_struct> &shared, uint8 index, std::chrono::steady_clock::time_point origin)
+{
+    std::function<int(void)> function = task[index].function;
+    char name[16];
+
+    // 线程名最长15个字符
+    snprintf(name, sizeof(name), "bu_%s", task[index].name);
+    try
+    {
+        std::thread([shared, function, index, origin, name]()
+        {
+            prctl(PR_SET_NAME, name);
+            int result = function();
+            uint64_t end_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+
+            std::lock_guard<std::mutex> guard(shared->lock);
+            shared->result[index] = result;
+            shared->end_ns[index] = end_ns;
+            shared->finish_mask |= (1u << index);
+            shared->finished.notify_all();
+        }).detach();
+    }
+    catch(const std::system_error &)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 执行全部任务
+// 参数说明 max_parallel 同时执行的最大任务数
+// 返回参数 int          未成功完成的任务数量
+// 使用示例 bringup.run();
+// 备注信息 调度循环 收集已完成的任务 -> 判定超时 -> 跳过依赖未成功的任务 -> 启动依赖已完成的任务 -> 等待下一个事件
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_bringup::run(uint8 max_parallel)
+{
+    std::shared_ptr<bringup_shared_struct> shared = std::make_shared<bringup_shared_struct>();
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point deadline[BRINGUP_TASK_MAX];
+    uint32 running_mask = 0;                                                    // 正在执行
+    uint32 done_mask = 0;                                                       // 成功完成
+    uint32 closed_mask = 0;                                                     // 已结束 含失败 超时 跳过
+    uint32 overdue_mask = 0;                                                    // 已判定超时 线程尚未返回 仍占用并行名额
+    uint32 all_mask = (BRINGUP_TASK_MAX <= task_count) ? 0xFFFFFFFFu : ((1u << task_count) - 1);
+    uint32 running_count = 0;
+    int fail_count = 0;
+
+    if(0 == max_parallel) max_parallel = BRINGUP_TASK_MAX;
+    shared->finish_mask = 0;
+    for(uint8 i = 0; i < task_count; i ++)
+    {
+        record[i].state = BRINGUP_STATE_WAITING;
+        record[i].result = 0;
+        record[i].start_ns = 0;
+        record[i].end_ns = 0;
+    }
+
+    std::unique_lock<std::mutex> lock(shared->lock);
+    while(closed_mask != all_mask)
+    {
+        uint64_t now_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+        bool changed = true;
+        bool ready = false;                                                     // 有任务依赖已完成 只是在等待并行名额
+        bool launch_failed = false;
+
+        for(uint8 i = 0; i < task_count; i ++)
+        {
+            uint32 bit = 1u << i;
+            if((overdue_mask & bit) && (shared->finish_mask & bit))
+            {
+                overdue_mask &= ~bit;                                           // 超时的线程终于返回 释放名额 结果仍被忽略
+                running_count --;
+                continue;
+            }
+            if(!(running_mask & bit)) continue;
+
+            if(shared->finish_mask & bit)
+            {
+                record[i].result = shared->result[i];
+                record[i].end_ns = shared->end_ns[i];
+                record[i].state = (0 == shared->result[i]) ? BRINGUP_STATE_DONE : BRINGUP_STATE_FAILED;
+                if(0 == shared->result[i]) done_mask |= bit;
+            }
+            else if(0 != task[i].timeout_ms && std::chrono::steady_clock::now() >= deadline[i])
+            {
+                record[i].end_ns = now_ns;
+                record[i].state = BRINGUP_STATE_TIMEOUT;
+                printf("bringup warning: %s timeout after %u ms!\r\n", task[i].name, task[i].timeout_ms);
+                running_mask &= ~bit;
+                closed_mask |= bit;
+                overdue_mask |= bit;
+                continue;
+            }
+            else
+            {
+                continue;
+            }
+            running_mask &= ~bit;
+            closed_mask |= bit;
+            running_count --;
+        }
+
+        // 依赖未成功的任务逐级跳过
+        while(changed)
+        {
+            changed = false;
+            for(uint8 i = 0; i < task_count; i ++)
+            {
+                uint32 bit = 1u << i;
+                if(BRINGUP_STATE_WAITING != record[i].state || !(task[i].depend_mask & closed_mask & ~done_mask)) continue;
+
+                record[i].state = BRINGUP_STATE_SKIPPED;
+                record[i].start_ns = record[i].end_ns = now_ns;
+                closed_mask |= bit;
+                changed = true;
+            }
+        }
+
+        for(uint8 i = 0; i < task_count; i ++)
+        {
+            uint32 bit = 1u << i;
+            if(BRINGUP_STATE_WAITING != record[i].state || (task[i].depend_mask & ~done_mask)) continue;
+
+            if(running_count >= max_parallel)
+            {
+                ready = true;
+                break;
+            }
+            record[i].start_ns = now_ns;
+            deadline[i] = origin + std::chrono::nanoseconds(now_ns) + std::chrono::milliseconds(task[i].timeout_ms);
+            if(0 != launch(shared, i, origin))
+            {
+                record[i].end_ns = now_ns;
+                record[i].state = BRINGUP_STATE_FAILED;
+                record[i].result = -1;
+                closed_mask |= bit;
+                printf("bringup error: can not create thread for %s!\r\n", task[i].name);
+                launch_failed = true;
+                continue;
+            }
+            record[i].state = BRINGUP_STATE_RUNNING;
+            running_mask |= bit;
+            running_count ++;
+        }
+
+        if(closed_mask == all_mask)
+        {
+            break;
+        }
+        if(launch_failed)
+        {
+            continue;                                                           // 先跳过依赖它的任务 再判断是否循环依赖
+        }
+        if(0 == running_mask && !ready)
+        {
+            // 仍有任务在等待 但没有任务在执行 也没有任务只是在等待名额 等待中的任务互相依赖
+            for(uint8 i = 0; i < task_count; i ++)
+            {
+                if(BRINGUP_STATE_WAITING != record[i].state) continue;
+                record[i].state = BRINGUP_STATE_FAILED;
+                record[i].result = -1;
+                record[i].start_ns = record[i].end_ns = now_ns;
+                closed_mask |= (1u << i);
+                printf("bringup error: dependencies of %s can never be satisfied (circular)!\r\n", task[i].name);
+            }
+            continue;
+        }
+
+        // 等待任务结束或最早的超时时刻
+        std::chrono::steady_clock::time_point wake = std::chrono::steady_clock::time_point::max();
+        for(uint8 i = 0; i < task_count; i ++)
+        {
+            if((running_mask & (1u << i)) && 0 != task[i].timeout_ms && deadline[i] < wake) wake = deadline[i];
+        }
+        uint32 finish_mask = shared->finish_mask;
+        shared->finished.wait_until(lock, wake, [&](){ return shared->finish_mask != finish_mask; });
+    }
+
+    total_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    for(uint8 i = 0; i < task_count; i ++)
+    {
+        if(BRINGUP_STATE_DONE != record[i].state) fail_count ++;
+    }
+    return fail_count;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取任务状态
+// 参数说明 index 任务编号
+// 返回参数 bringup_state_enum 任务状态
+// 使用示例 bringup.get_state(dl1x);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+bringup_state_enum zf_components_bringup::get_state(int index) const
+{
+    if(0 > index || task_count <= index) return BRINGUP_STATE_SKIPPED;
+    return record[index].state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取任务执行记录
+// 参数说明 index 任务编号
+// 返回参数 const bringup_record_struct* 执行记录
+// 使用示例 bringup.get_record(camera);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+const bringup_record_struct *zf_components_bringup::get_record(int index) const
+{
+    if(0 > index || task_count <= index) return NULL;
+    return &record[index];
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取最近一次run的总耗时
+// 参数说明 无
+// 返回参数 uint64_t 纳秒
+// 使用示例 bringup.get_total_ns();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t zf_components_bringup::get_total_ns(void) const
+{
+    return total_ns;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 打印启动时间线
+// 参数说明 无
+// 返回参数 无
+// 使用示例 bringup.print_timeline();
+// 备注信息 区间图中 # 表示任务执行的时间段
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_bringup::print_timeline(void) const
+{
+    static const char *state_name[] = {"waiting", "running", "done", "failed", "timeout", "skipped"};
+    uint64_t total = (0 < total_ns) ? total_ns : 1;
+    char bar[BRINGUP_TIMELINE_WIDTH + 1];
+
+    printf("bringup: %u tasks, total %.1f ms\r\n", task_count, total_ns / 1e6);
+    printf("%-*s %9s %9s %9s  %-8s\r\n", BRINGUP_NAME_MAX - 1, "task", "start", "end", "ms", "state");
+    for(uint8 i = 0; i < task_count; i ++)
+    {
+        const bringup_record_struct *r = &record[i];
+        uint32 begin = (uint32)(r->start_ns * BRINGUP_TIMELINE_WIDTH / total);
+        uint32 end = (uint32)((r->end_ns * BRINGUP_TIMELINE_WIDTH + total - 1) / total);
+
+        if(BRINGUP_TIMELINE_WIDTH < end) end = BRINGUP_TIMELINE_WIDTH;
+        for(uint32 j = 0; j < BRINGUP_TIMELINE_WIDTH; j ++)
+        {
+            bar[j] = (j >= begin && j < end) ? '#' : '.';
+        }
+        bar[BRINGUP_TIMELINE_WIDTH] = '\0';
+
+        printf("%-*s %9.1f %9.1f %9.1f  %-8s |%s|", BRINGUP_NAME_MAX - 1, r->name,
+               r->start_ns / 1e6, r->end_ns / 1e6, (r->end_ns - r->start_ns) / 1e6, state_name[r->state], bar);
+        if(BRINGUP_STATE_FAILED == r->state)
+        {
+            printf(" result %d", r->result);
+        }
+        printf("\r\n");
+    }
+}
@@ -0,0 +1,164 @@
+#ifndef _zf_components_bringup_h_
+#define _zf_components_bringup_h_
+
+#include "zf_common_typedef.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+//-------------------------------------------------------------------------------------------------------------------
+// 说明         设备并行启动
+//              每个设备的初始化登记为一个任务 任务之间可以声明依赖 没有依赖关系的任务在各自的线程中同时执行
+//              屏幕加载驱动 摄像头配置 IMU DL1X 初始化大多在等待硬件 并行后总启动时间接近最慢的一条依赖链
+//              每个任务有单独的超时 超时或失败的任务不影响无关的任务 依赖它的任务被跳过
+//              运行结束后可以打印启动时间线 查看每个任务的开始 结束时刻与耗时
+//-------------------------------------------------------------------------------------------------------------------
+
+#define BRINGUP_TASK_MAX                ( 32 )                                  // 最多登记的任务数量 依赖关系按位保存
+#define BRINGUP_NAME_MAX                ( 24 )                                  // 任务名最大长度 含结束符
+#define BRINGUP_TIMEOUT_DEFAULT_MS      ( 3000 )                                // 任务默认超时
+#define BRINGUP_TIMELINE_WIDTH          ( 40 )                                  // 时间线图的字符宽度
+
+typedef enum
+{
+    BRINGUP_STATE_WAITING = 0,                                                  // 尚未开始 等待依赖完成
+    BRINGUP_STATE_RUNNING,                                                      // 正在执行
+    BRINGUP_STATE_DONE,                                                         // 返回0
+    BRINGUP_STATE_FAILED,                                                       // 返回非0 或线程创建失败 或处于循环依赖中
+    BRINGUP_STATE_TIMEOUT,                                                      // 超时未返回 任务线程仍在后台运行 结果被忽略
+    BRINGUP_STATE_SKIPPED,                                                      // 依赖的任务未成功 没有执行
+}bringup_state_enum;
+
+// 一个任务的执行记录 时刻以 run 开始为0
+typedef struct
+{
+    const char          *name;
+    bringup_state_enum  state;
+    int                 result;                                                 // 任务返回值 仅 DONE 与 FAILED 时有效
+    uint64_t            start_ns;
+    uint64_t            end_ns;                                                 // 超时的任务为判定超时的时刻
+}bringup_record_struct;
+
+class zf_components_bringup
+{
+private:
+    typedef struct
+    {
+        char                        name[BRINGUP_NAME_MAX];
+        std::function<int(void)>    function;
+        uint32                      timeout_ms;                                 // 0表示不限时
+        uint32                      depend_mask;                                // 位n为1表示依赖第n个任务
+    }bringup_task_struct;
+
+    // 任务线程完成后写入的结果 超时的任务线程可能在run返回后甚至对象析构后才结束
+    // 因此单独分配 由调度方与各任务线程共同持有
+    typedef struct
+    {
+        std::mutex                  lock;
+        std::condition_variable     finished;
+        uint32                      finish_mask;                                // 位n为1表示第n个任务已返回
+        int                         result[BRINGUP_TASK_MAX];
+        uint64_t                    end_ns[BRINGUP_TASK_MAX];
+    }bringup_shared_struct;
+
+    bringup_task_struct     task[BRINGUP_TASK_MAX];
+    bringup_record_struct   record[BRINGUP_TASK_MAX];
+    uint8                   task_count;
+    uint64_t                total_ns;                                           // 最近一次run的总耗时
+
+    zf_components_bringup(const zf_components_bringup&) = delete;
+    zf_components_bringup& operator=(const zf_components_bringup&) = delete;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 在新线程中执行任务
+// 参数说明 shared 共享结果
+// 参数说明 index  任务编号
+// 参数说明 origin run 开始时刻
+// 返回参数 int8   0-成功 -1-线程创建失败
+// 使用示例 内部调用
+// 备注信息 线程分离运行 结束时写入结果并唤醒调度方
+//-------------------------------------------------------------------------------------------------------------------
+    int8 launch(const std::shared_ptr<bringup_shared_struct> &shared, uint8 index, std::chrono::steady_clock::time_point origin);
+
+public:
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_bringup bringup;
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    zf_components_bringup(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记任务
+// 参数说明 name       任务名 超出 BRINGUP_NAME_MAX-1 的部分被截断
+// 参数说明 function   任务函数 返回0表示成功
+// 参数说明 timeout_ms 超时 0表示不限时
+// 返回参数 int        任务编号 已满返回-1
+// 使用示例 int imu = bringup.add_task("imu", [&](){ return (DEV_NO_FIND != imu_dev.init()) ? 0 : -1; });
+// 备注信息 任务函数在单独的线程中执行 捕获的对象需在任务结束前保持有效
+//          超时的任务无法被终止 其捕获的对象最好是全局或静态对象
+//-------------------------------------------------------------------------------------------------------------------
+    int add_task(const char *name, const std::function<int(void)> &function, uint32 timeout_ms = BRINGUP_TIMEOUT_DEFAULT_MS);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 声明依赖
+// 参数说明 index      任务编号
+// 参数说明 depends_on 必须先成功完成的任务编号
+// 返回参数 int8       0-成功 -1-编号无效
+// 使用示例 bringup.add_dependency(server, camera);
+// 备注信息 可以多次调用声明多个依赖 形成循环的任务在run时被判定为失败
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_dependency(int index, int depends_on);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 执行全部任务
+// 参数说明 max_parallel 同时执行的最大任务数 0表示不限制
+// 返回参数 int          未成功完成的任务数量 0表示全部成功
+// 使用示例 if(0 != bringup.run()) bringup.print_timeline();
+// 备注信息 阻塞到全部任务完成 失败 超时或被跳过为止 依赖都已完成的任务按登记顺序开始
+//          超时的任务线程在实际返回前仍占用 max_parallel 名额 名额被占满时其余任务等待其返回
+//          可以重复调用 每次重新执行全部任务
+//-------------------------------------------------------------------------------------------------------------------
+    int run(uint8 max_parallel = 0);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取任务状态
+// 参数说明 index 任务编号
+// 返回参数 bringup_state_enum 编号无效时返回 BRINGUP_STATE_SKIPPED
+// 使用示例 if(BRINGUP_STATE_DONE == bringup.get_state(dl1x)) dl1x_dev.start_poll();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    bringup_state_enum get_state(int index) const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取任务执行记录
+// 参数说明 index 任务编号
+// 返回参数 const bringup_record_struct* 编号无效返回NULL
+// 使用示例 uint64_t camera_ns = bringup.get_record(camera)->end_ns;
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    const bringup_record_struct *get_record(int index) const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取最近一次run的总耗时
+// 参数说明 无
+// 返回参数 uint64_t 纳秒
+// 使用示例 printf("%llu\r\n", bringup.get_total_ns() / 1000000);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    uint64_t get_total_ns(void) const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 打印启动时间线
+// 参数说明 无
+// 返回参数 无
+// 使用示例 bringup.print_timeline();
+// 备注信息 每个任务一行 开始 结束时刻 耗时 状态 以及按总耗时缩放的区间图
+//-------------------------------------------------------------------------------------------------------------------
+    void print_timeline(void) const;
+};
+
+#endif
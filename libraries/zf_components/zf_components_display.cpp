@@ -0,0 +1,512 @@
+#include "zf_components_display.hpp"
+#include "zf_common_function.hpp"
+#include "zf_common_time.hpp"
+
+#define DISPLAY_SLOT_MASK               ( 0x03 )                                // display_latest 中的帧下标
+#define DISPLAY_SLOT_NEW                ( 0x80 )                                // display_latest 中的帧尚未被渲染线程取走
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_display display_service;
+// 备注信息 三份帧描述分别归生产者 最新提交 渲染线程所有
+//-------------------------------------------------------------------------------------------------------------------
+zf_components_display::zf_components_display(void)
+    : display_write_index(0), display_read_index(1), display_latest(2), display_sequence(0), display_drop_mask(0),
+      display_timer(NULL), display_rt_policy{SCHED_OTHER, 0, RT_CPU_ANY, 0},
+      display_done(0), display_rendered(0), display_dropped(0), display_compose_ns(0)
+{
+    memset(display_frame, 0, sizeof(display_frame));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 析构函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 自动调用，无需手动调用
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+zf_components_display::~zf_components_display(void)
+{
+    stop();
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置渲染线程的调度配置
+// 参数说明 policy 线程配置
+// 返回参数 无
+// 使用示例 display_service.set_rt_policy(&policy);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_display::set_rt_policy(const rt_thread_policy_struct *policy)
+{
+    if(NULL != display_timer || NULL == policy) return;
+    display_rt_policy = *policy;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 启动渲染线程
+// 参数说明 fps 帧率上限
+// 返回参数 int 0-成功 -1-失败
+// 使用示例 display_service.start(30);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_display::start(uint32 fps)
+{
+    if(NULL != display_timer || 0 == fps) return -1;
+    if(0 >= DisplayIps200::getWidth() || 0 != DisplayIps200::enableBackBuffer())
+    {
+        printf("display error: screen not initialized or back buffer allocation failed!\r\n");
+        return -1;
+    }
+
+    display_timer = new timer_fd(std::chrono::nanoseconds(1000000000ULL / fps), [this](){ render(); });
+    display_timer->set_overrun_policy(PIT_OVERRUN_SKIP);
+    display_timer->set_rt_policy(&display_rt_policy);
+    display_timer->start();
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 停止渲染线程
+// 参数说明 无
+// 返回参数 无
+// 使用示例 display_service.stop();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_display::stop(void)
+{
+    if(NULL == display_timer) return;
+    display_timer->stop();
+    delete display_timer;
+    display_timer = NULL;
+    render();
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 开始填写新的一帧
+// 参数说明 无
+// 返回参数 display_frame_struct* 帧描述
+// 使用示例 display_service.begin_frame();
+// 备注信息 只重置计数 不清零数组 耗时与帧内容无关
+//-------------------------------------------------------------------------------------------------------------------
+display_frame_struct *zf_components_display::begin_frame(void)
+{
+    display_frame_struct *frame = &display_frame[display_write_index];
+
+    frame->clear = 0;
+    frame->background = DEFAULT_BGCOLOR;
+    frame->image.format = DISPLAY_IMAGE_NONE;
+    frame->overlay_count = 0;
+    frame->text_count = 0;
+    return frame;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置当前帧的图像
+// 参数说明 data   图像数据
+// 参数说明 format 像素格式
+// 参数说明 width  源图像宽度
+// 参数说明 height 源图像高度
+// 参数说明 x      屏幕位置x
+// 参数说明 y      屏幕位置y
+// 参数说明 w      显示宽度
+// 参数说明 h      显示高度
+// 参数说明 scale  缩放方式
+// 参数说明 stride 源图像行跨度
+// 返回参数 无
+// 使用示例 display_service.set_image(image, DISPLAY_IMAGE_GRAY, 160, 120, 0, 0, 240, 180);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_display::set_image(const void *data, display_image_format_enum format, uint16 width, uint16 height,
+                                      int16 x, int16 y, uint16 w, uint16 h, ips200_scale_enum scale, int stride)
+{
+    display_image_struct *image = &display_frame[display_write_index].image;
+
+    image->data   = data;
+    image->format = (NULL == data) ? DISPLAY_IMAGE_NONE : format;
+    image->width  = width;
+    image->height = height;
+    image->stride = stride;
+    image->x      = x;
+    image->y      = y;
+    image->w      = (0 == w) ? width : w;
+    image->h      = (0 == h) ? height : h;
+    image->scale  = scale;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 占用当前帧的一个叠加图形
+// 参数说明 type  类型
+// 参数说明 color 颜色
+// 返回参数 display_overlay_struct* 已满返回NULL
+// 使用示例 内部调用
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+display_overlay_struct *zf_components_display::add_overlay(display_overlay_type_enum type, uint16 color)
+{
+    display_frame_struct *frame = &display_frame[display_write_index];
+    display_overlay_struct *overlay = NULL;
+
+    if(DISPLAY_OVERLAY_MAX <= frame->overlay_count) return NULL;
+    overlay = &frame->overlay[frame->overlay_count ++];
+    overlay->type  = type;
+    overlay->color = color;
+    return overlay;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加点
+// 参数说明 x     坐标x
+// 参数说明 y     坐标y
+// 参数说明 color 颜色
+// 返回参数 int8  0-成功 -1-已满
+// 使用示例 display_service.add_point(120, 90, RGB565_RED);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_point(int16 x, int16 y, uint16 color)
+{
+    display_overlay_struct *overlay = add_overlay(DISPLAY_OVERLAY_POINT, color);
+    if(NULL == overlay) return -1;
+    overlay->x0 = x;
+    overlay->y0 = y;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加线段
+// 参数说明 x_start 起点x
+// 参数说明 y_start 起点y
+// 参数说明 x_end   终点x
+// 参数说明 y_end   终点y
+// 参数说明 color   颜色
+// 返回参数 int8    0-成功 -1-已满
+// 使用示例 display_service.add_line(0, 90, 239, 90, RGB565_GREEN);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_line(int16 x_start, int16 y_start, int16 x_end, int16 y_end, uint16 color)
+{
+    display_overlay_struct *overlay = add_overlay(DISPLAY_OVERLAY_LINE, color);
+    if(NULL == overlay) return -1;
+    overlay->x0 = x_start;
+    overlay->y0 = y_start;
+    overlay->x1 = x_end;
+    overlay->y1 = y_end;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加矩形
+// 参数说明 x     左上角x
+// 参数说明 y     左上角y
+// 参数说明 w     宽度
+// 参数说明 h     高度
+// 参数说明 color 颜色
+// 参数说明 fill  0-边框 1-实心
+// 返回参数 int8  0-成功 -1-已满
+// 使用示例 display_service.add_rect(box_x, box_y, box_w, box_h, RGB565_YELLOW);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_rect(int16 x, int16 y, int16 w, int16 h, uint16 color, uint8 fill)
+{
+    display_overlay_struct *overlay = add_overlay(fill ? DISPLAY_OVERLAY_FILL_RECT : DISPLAY_OVERLAY_RECT, color);
+    if(NULL == overlay) return -1;
+    overlay->x0 = x;
+    overlay->y0 = y;
+    overlay->x1 = w;
+    overlay->y1 = h;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加圆
+// 参数说明 x      圆心x
+// 参数说明 y      圆心y
+// 参数说明 radius 半径
+// 参数说明 color  颜色
+// 参数说明 fill   0-圆周 1-实心
+// 返回参数 int8   0-成功 -1-已满
+// 使用示例 display_service.add_circle(target_x, target_y, 6, RGB565_RED);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_circle(int16 x, int16 y, int16 radius, uint16 color, uint8 fill)
+{
+    display_overlay_struct *overlay = add_overlay(fill ? DISPLAY_OVERLAY_FILL_CIRCLE : DISPLAY_OVERLAY_CIRCLE, color);
+    if(NULL == overlay) return -1;
+    overlay->x0 = x;
+    overlay->y0 = y;
+    overlay->x1 = radius;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加折线
+// 参数说明 x_offset 整体偏移x
+// 参数说明 y_offset 整体偏移y
+// 参数说明 x        各点x坐标 NULL表示取点的序号
+// 参数说明 y        各点y坐标 NULL表示取点的序号
+// 参数说明 count    点数
+// 参数说明 color    颜色
+// 返回参数 int8     0-成功 -1-已满
+// 使用示例 display_service.add_polyline(0, 0, left_boundary, NULL, MT9V03X_H, RGB565_RED);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_polyline(int16 x_offset, int16 y_offset, const uint8 *x, const uint8 *y, uint16 count, uint16 color)
+{
+    display_overlay_struct *overlay = NULL;
+
+    if(0 == count) return 0;
+    overlay = add_overlay(DISPLAY_OVERLAY_POLYLINE, color);
+    if(NULL == overlay) return -1;
+    overlay->x0    = x_offset;
+    overlay->y0    = y_offset;
+    overlay->x     = x;
+    overlay->y     = y;
+    overlay->count = count;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加文字
+// 参数说明 x    坐标x
+// 参数说明 y    坐标y
+// 参数说明 text 字符串
+// 参数说明 pen  文字颜色
+// 参数说明 bg   背景颜色
+// 参数说明 font 字体
+// 返回参数 int8 0-成功 -1-已满
+// 使用示例 display_service.add_text(0, 200, "speed", RGB565_WHITE, RGB565_BLACK);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_text(uint16 x, uint16 y, const char *text, uint16 pen, uint16 bg, ips200_font_size_enum font)
+{
+    display_frame_struct *frame = &display_frame[display_write_index];
+    display_text_struct *item = NULL;
+    uint8 length = 0;
+
+    if(NULL == text) return 0;
+    if(DISPLAY_TEXT_MAX <= frame->text_count) return -1;
+    item = &frame->text[frame->text_count ++];
+    item->x    = x;
+    item->y    = y;
+    item->pen  = pen;
+    item->bg   = bg;
+    item->font = font;
+    while(DISPLAY_TEXT_LENGTH > length && '\0' != text[length])
+    {
+        item->text[length] = text[length];
+        length ++;
+    }
+    item->text[length] = '\0';
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加整数
+// 参数说明 x     坐标x
+// 参数说明 y     坐标y
+// 参数说明 value 数值
+// 参数说明 pen   文字颜色
+// 参数说明 bg    背景颜色
+// 返回参数 int8  0-成功 -1-已满
+// 使用示例 display_service.add_int(48, 200, error, RGB565_WHITE, RGB565_BLACK);
+// 备注信息 func_int_to_str 不写结束符 先清零缓冲
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_int(uint16 x, uint16 y, int32 value, uint16 pen, uint16 bg)
+{
+    char text[12] = {0};
+    func_int_to_str(text, value);
+    return add_text(x, y, text, pen, bg);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加浮点数
+// 参数说明 x         坐标x
+// 参数说明 y         坐标y
+// 参数说明 value     数值
+// 参数说明 point_bit 小数位数
+// 参数说明 pen       文字颜色
+// 参数说明 bg        背景颜色
+// 返回参数 int8      0-成功 -1-已满
+// 使用示例 display_service.add_float(48, 216, speed, 2, RGB565_WHITE, RGB565_BLACK);
+// 备注信息 超出 DISPLAY_TEXT_LENGTH 的部分截断
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_display::add_float(uint16 x, uint16 y, double value, uint8 point_bit, uint16 pen, uint16 bg)
+{
+    char text[48] = {0};
+    func_double_to_str(text, value, point_bit);
+    return add_text(x, y, text, pen, bg);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 提交当前帧
+// 参数说明 无
+// 返回参数 uint32 本帧序号
+// 使用示例 display_service.submit();
+// 备注信息 交换得到的旧帧若仍带 DISPLAY_SLOT_NEW 说明渲染线程没有取走 即被丢弃
+//          acq_rel 保证本帧内容对渲染线程可见 且渲染线程对换回帧的读取已经结束
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_components_display::submit(void)
+{
+    uint32 sequence = display_sequence.load(std::memory_order_relaxed) + 1;
+    uint8 previous = 0;
+
+    display_frame[display_write_index].sequence = sequence;
+    previous = display_latest.exchange((uint8)(display_write_index | DISPLAY_SLOT_NEW), std::memory_order_acq_rel);
+    display_write_index = previous & DISPLAY_SLOT_MASK;
+    display_drop_mask <<= 1;
+    if(previous & DISPLAY_SLOT_NEW)
+    {
+        display_drop_mask |= 1;
+        display_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    display_sequence.store(sequence, std::memory_order_relaxed);
+    return sequence;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 合成一帧
+// 参数说明 frame 帧描述
+// 返回参数 无
+// 使用示例 内部调用
+// 备注信息 颜色与字体只在和上一项不同时设置 避免重复重建字模缓存
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_display::compose(const display_frame_struct *frame)
+{
+    const display_image_struct *image = &frame->image;
+
+    if(frame->clear)
+    {
+        DisplayIps200::full(frame->background);
+    }
+
+    switch(image->format)
+    {
+        case DISPLAY_IMAGE_GRAY:
+            DisplayIps200::blitGray(image->x, image->y, image->w, image->h, (const uint8 *)image->data,
+                                    image->width, image->height, image->stride, image->scale);
+            break;
+        case DISPLAY_IMAGE_BGR:
+            DisplayIps200::blitBgr(image->x, image->y, image->w, image->h, (const uint8 *)image->data,
+                                   image->width, image->height, image->stride, image->scale);
+            break;
+        case DISPLAY_IMAGE_RGB565:
+            DisplayIps200::copyRect(image->x, image->y, (const uint16 *)image->data, image->width, image->height, image->stride);
+            break;
+        default:
+            break;
+    }
+
+    for(uint8 i = 0; i < frame->overlay_count; i ++)
+    {
+        const display_overlay_struct *overlay = &frame->overlay[i];
+        switch(overlay->type)
+        {
+            case DISPLAY_OVERLAY_POINT:
+                if(0 <= overlay->x0 && 0 <= overlay->y0)
+                {
+                    DisplayIps200::drawPoint((uint16)overlay->x0, (uint16)overlay->y0, overlay->color);
+                }
+                break;
+            case DISPLAY_OVERLAY_LINE:
+                DisplayIps200::drawLine(overlay->x0, overlay->y0, overlay->x1, overlay->y1, overlay->color);
+                break;
+            case DISPLAY_OVERLAY_RECT:
+                DisplayIps200::drawRect(overlay->x0, overlay->y0, overlay->x1, overlay->y1, overlay->color);
+                break;
+            case DISPLAY_OVERLAY_FILL_RECT:
+                DisplayIps200::fillRect(overlay->x0, overlay->y0, overlay->x1, overlay->y1, overlay->color);
+                break;
+            case DISPLAY_OVERLAY_CIRCLE:
+                DisplayIps200::drawCircle(overlay->x0, overlay->y0, overlay->x1, overlay->color);
+                break;
+            case DISPLAY_OVERLAY_FILL_CIRCLE:
+                DisplayIps200::fillCircle(overlay->x0, overlay->y0, overlay->x1, overlay->color);
+                break;
+            case DISPLAY_OVERLAY_POLYLINE:
+                DisplayIps200::drawPolyline(overlay->x0, overlay->y0, overlay->x, overlay->y, overlay->count, overlay->color);
+                break;
+            default:
+                break;
+        }
+    }
+
+    for(uint8 i = 0; i < frame->text_count; i ++)
+    {
+        const display_text_struct *item = &frame->text[i];
+        if(0 == i || item->pen != frame->text[i - 1].pen || item->bg != frame->text[i - 1].bg)
+        {
+            DisplayIps200::setColor(item->pen, item->bg);
+        }
+        if(0 == i || item->font != frame->text[i - 1].font)
+        {
+            DisplayIps200::setFont(item->font);
+        }
+        DisplayIps200::showString(item->x, item->y, item->text);
+    }
+
+    DisplayIps200::present();
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 渲染最新提交的一帧
+// 参数说明 无
+// 返回参数 uint32 渲染的帧序号 没有新帧返回0
+// 使用示例 display_service.render();
+// 备注信息 先用relaxed读取判断有无新帧 没有新帧时不做原子写 空闲周期开销只有一次读取
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_components_display::render(void)
+{
+    const display_frame_struct *frame = NULL;
+    uint64_t begin_ns = 0;
+    uint8 latest = 0;
+
+    if(!(display_latest.load(std::memory_order_relaxed) & DISPLAY_SLOT_NEW)) return 0;
+
+    latest = display_latest.exchange(display_read_index, std::memory_order_acq_rel);
+    display_read_index = latest & DISPLAY_SLOT_MASK;
+    frame = &display_frame[display_read_index];
+
+    begin_ns = time_now_ns();
+    compose(frame);
+    display_compose_ns.store((uint32)(time_now_ns() - begin_ns), std::memory_order_relaxed);
+    display_rendered.fetch_add(1, std::memory_order_relaxed);
+    display_done.store(frame->sequence, std::memory_order_release);
+    return frame->sequence;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 查询某一帧引用的数据是否仍可能被读取
+// 参数说明 sequence 帧序号
+// 返回参数 bool     true-仍可能被读取
+// 使用示例 display_service.is_frame_busy(last_sequence);
+// 备注信息 渲染线程按序号递增取帧 被取走的帧在 display_done 达到其序号后不再被读取
+//          丢弃与否在生产者下一次 submit 的交换中确定 超出 display_drop_mask 记录范围的旧帧按未丢弃处理 结果偏保守
+//-------------------------------------------------------------------------------------------------------------------
+bool zf_components_display::is_frame_busy(uint32 sequence) const
+{
+    uint32 latest = display_sequence.load(std::memory_order_relaxed);
+    uint32 age = 0;
+
+    if(0 == sequence || latest < sequence) return false;
+    age = latest - sequence;                                                    // 之后又提交的帧数
+    if(0 < age && 32 >= age && (display_drop_mask & (1u << (age - 1)))) return false;
+    return display_done.load(std::memory_order_acquire) < sequence;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取统计
+// 参数说明 stats 统计输出
+// 返回参数 无
+// 使用示例 display_service.get_stats(&stats);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_display::get_stats(display_stats_struct *stats) const
+{
+    if(NULL == stats) return;
+    stats->submitted  = display_sequence.load(std::memory_order_relaxed);
+    stats->rendered   = display_rendered.load(std::memory_order_relaxed);
+    stats->dropped    = display_dropped.load(std::memory_order_relaxed);
+    stats->compose_ns = display_compose_ns.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,365 @@
+#ifndef _zf_components_display_h_
+#define _zf_components_display_h_
+
+#include "zf_common_typedef.hpp"
+#include "zf_common_font.hpp"
+#include "zf_common_rt.hpp"
+#include "zf_driver_pit_fd.hpp"
+#include "zf_device_ips200_fb.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 说明         屏幕显示服务
+//              生产者(通常是视觉循环)在服务提供的帧描述中填写图像引用 叠加图形与文字 然后提交
+//              提交只交换一个原子下标 不拷贝 不申请内存 也不等待屏幕
+//              低优先级的渲染线程按帧率上限取最新提交的一帧 在后台缓冲中合成后写入显存
+//              两次渲染之间的多次提交只保留最后一次 其余直接丢弃
+//              帧描述三缓冲 生产者写入 最新已提交 渲染线程读取 各占一份 互不等待
+//              启动后只有渲染线程绘制屏幕 其他线程不应再直接调用 DisplayIps200 的绘图函数
+//-------------------------------------------------------------------------------------------------------------------
+
+#define DISPLAY_OVERLAY_MAX             ( 32 )                                  // 每帧最多的叠加图形数
+#define DISPLAY_TEXT_MAX                ( 16 )                                  // 每帧最多的文字项数
+#define DISPLAY_TEXT_LENGTH             ( 24 )                                  // 每个文字项最多的字符数 超出截断
+#define DISPLAY_FPS_DEFAULT             ( 30 )                                  // 默认帧率上限
+#define DISPLAY_FRAME_SLOT              ( 3 )                                   // 帧描述份数 三缓冲
+
+typedef enum
+{
+    DISPLAY_IMAGE_NONE = 0,                                                     // 不显示图像
+    DISPLAY_IMAGE_GRAY,                                                         // 8位灰度 经 blitGray 缩放
+    DISPLAY_IMAGE_BGR,                                                          // BGR888 经 blitBgr 缩放
+    DISPLAY_IMAGE_RGB565,                                                       // RGB565 经 copyRect 原尺寸显示
+}display_image_format_enum;
+
+typedef enum
+{
+    DISPLAY_OVERLAY_POINT = 0,                                                  // 点 (x0, y0)
+    DISPLAY_OVERLAY_LINE,                                                       // 线段 (x0, y0)-(x1, y1)
+    DISPLAY_OVERLAY_RECT,                                                       // 矩形边框 左上角 (x0, y0) 宽 x1 高 y1
+    DISPLAY_OVERLAY_FILL_RECT,                                                  // 实心矩形 参数同 RECT
+    DISPLAY_OVERLAY_CIRCLE,                                                     // 圆 圆心 (x0, y0) 半径 x1
+    DISPLAY_OVERLAY_FILL_CIRCLE,                                                // 实心圆 参数同 CIRCLE
+    DISPLAY_OVERLAY_POLYLINE,                                                   // 折线 偏移 (x0, y0) 第 i 点为 (x[i], y[i])
+}display_overlay_type_enum;
+
+// 图像引用 只保存指针 渲染线程合成时才读取像素
+typedef struct
+{
+    const void                  *data;
+    display_image_format_enum   format;
+    uint16                      width;                                          // 源图像宽度
+    uint16                      height;                                         // 源图像高度
+    int                         stride;                                         // 源图像每行字节数(GRAY/BGR)或像素数(RGB565) 0表示紧密排列
+    int16                       x;                                              // 屏幕位置
+    int16                       y;
+    uint16                      w;                                              // 显示尺寸 与源尺寸不同时缩放 RGB565 忽略
+    uint16                      h;
+    ips200_scale_enum           scale;
+}display_image_struct;
+
+typedef struct
+{
+    display_overlay_type_enum   type;
+    uint16                      color;                                          // RGB565
+    int16                       x0;                                             // 各类型的含义见 display_overlay_type_enum
+    int16                       y0;
+    int16                       x1;
+    int16                       y1;
+    const uint8                 *x;                                             // 折线坐标数组 只保存指针
+    const uint8                 *y;
+    uint16                      count;                                          // 折线点数
+}display_overlay_struct;
+
+typedef struct
+{
+    uint16                      x;
+    uint16                      y;
+    uint16                      pen;                                            // 文字颜色
+    uint16                      bg;                                             // 背景颜色
+    ips200_font_size_enum       font;
+    char                        text[DISPLAY_TEXT_LENGTH + 1];
+}display_text_struct;
+
+// 一帧的完整描述 按 背景 图像 叠加图形 文字 的顺序合成
+typedef struct
+{
+    uint32                      sequence;                                       // submit 时写入 从1开始
+    uint8                       clear;                                          // 1-合成前用 background 填充整屏 0-保留上一帧未被覆盖的内容
+    uint16                      background;
+    display_image_struct        image;
+    uint8                       overlay_count;
+    uint8                       text_count;
+    display_overlay_struct      overlay[DISPLAY_OVERLAY_MAX];
+    display_text_struct         text[DISPLAY_TEXT_MAX];
+}display_frame_struct;
+
+typedef struct
+{
+    uint32                      submitted;                                      // 提交的帧数
+    uint32                      rendered;                                       // 合成并写入显存的帧数
+    uint32                      dropped;                                        // 未被渲染就被下一帧覆盖的帧数
+    uint32                      compose_ns;                                     // 最近一帧合成加写入显存的耗时
+}display_stats_struct;
+
+class zf_components_display
+{
+private:
+    display_frame_struct        display_frame[DISPLAY_FRAME_SLOT];
+    uint8                       display_write_index;                            // 生产者正在填写的帧 生产者线程专用
+    uint8                       display_read_index;                             // 渲染线程正在合成的帧 渲染线程专用
+    std::atomic<uint8>          display_latest;                                 // 最新提交的帧 低位为下标 DISPLAY_SLOT_NEW 表示尚未渲染
+    std::atomic<uint32>         display_sequence;                               // 最近一次提交的序号 只由生产者写入
+    uint32                      display_drop_mask;                              // 位i为1表示第 display_sequence-1-i 帧被丢弃 生产者线程专用
+
+    timer_fd                    *display_timer;                                 // 渲染线程 运行中非NULL
+    rt_thread_policy_struct     display_rt_policy;
+
+    std::atomic<uint32>         display_done;                                   // 最近合成完成的帧序号 渲染按序号递增进行
+    std::atomic<uint32>         display_rendered;
+    std::atomic<uint32>         display_dropped;
+    std::atomic<uint32>         display_compose_ns;
+
+    zf_components_display(const zf_components_display&) = delete;
+    zf_components_display& operator=(const zf_components_display&) = delete;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 合成一帧
+// 参数说明 frame 帧描述
+// 返回参数 无
+// 使用示例 内部调用，由渲染线程调用
+// 备注信息 绘制到后台缓冲后 present 只写入变化的区域
+//-------------------------------------------------------------------------------------------------------------------
+    void compose(const display_frame_struct *frame);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 占用当前帧的一个叠加图形
+// 参数说明 type 类型
+// 参数说明 color 颜色
+// 返回参数 display_overlay_struct* 已满返回NULL
+// 使用示例 内部调用
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    display_overlay_struct *add_overlay(display_overlay_type_enum type, uint16 color);
+
+public:
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_display display_service;
+// 备注信息 渲染线程默认 SCHED_OTHER 不绑定CPU 不与控制和视觉线程争抢
+//-------------------------------------------------------------------------------------------------------------------
+    zf_components_display(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 析构函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 自动调用，无需手动调用
+// 备注信息 停止渲染线程
+//-------------------------------------------------------------------------------------------------------------------
+    ~zf_components_display(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置渲染线程的调度配置
+// 参数说明 policy 线程配置
+// 返回参数 无
+// 使用示例 rt_thread_policy_struct policy = {SCHED_OTHER, 0, 3, 0}; display_service.set_rt_policy(&policy);
+// 备注信息 渲染已启动时调用无效果
+//-------------------------------------------------------------------------------------------------------------------
+    void set_rt_policy(const rt_thread_policy_struct *policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 启动渲染线程
+// 参数说明 fps 帧率上限 一般不超过屏幕刷新率
+// 返回参数 int 0-成功 -1-已启动 屏幕未初始化或后台缓冲申请失败
+// 使用示例 DisplayIps200::init(); display_service.start(30);
+// 备注信息 自动启用 DisplayIps200 后台缓冲 错过的周期直接跳过
+//-------------------------------------------------------------------------------------------------------------------
+    int start(uint32 fps = DISPLAY_FPS_DEFAULT);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 停止渲染线程
+// 参数说明 无
+// 返回参数 无
+// 使用示例 display_service.stop();
+// 备注信息 等待线程退出 已提交但尚未渲染的帧立即渲染
+//-------------------------------------------------------------------------------------------------------------------
+    void stop(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 开始填写新的一帧
+// 参数说明 无
+// 返回参数 display_frame_struct* 生产者专用的帧描述 提交前可以直接修改其中的字段
+// 使用示例 display_service.begin_frame();
+// 备注信息 清空图像 叠加图形与文字 clear 置0 background 为 DEFAULT_BGCOLOR
+//          begin_frame 添加函数 submit 应在同一个生产者线程中调用
+//-------------------------------------------------------------------------------------------------------------------
+    display_frame_struct *begin_frame(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置当前帧的图像
+// 参数说明 data   图像数据 只保存指针
+// 参数说明 format 像素格式
+// 参数说明 width  源图像宽度
+// 参数说明 height 源图像高度
+// 参数说明 x      屏幕位置x
+// 参数说明 y      屏幕位置y
+// 参数说明 w      显示宽度 0表示与源图像相同
+// 参数说明 h      显示高度 0表示与源图像相同
+// 参数说明 scale  缩放方式
+// 参数说明 stride 源图像每行字节数(GRAY/BGR)或像素数(RGB565) 0表示紧密排列
+// 返回参数 无
+// 使用示例 display_service.set_image(image, DISPLAY_IMAGE_GRAY, 160, 120, 0, 0, 240, 180);
+// 备注信息 图像在渲染线程合成时才被读取 is_frame_busy 返回false之前不能改写
+//          摄像头多缓冲轮换时通常不需要额外处理
+//-------------------------------------------------------------------------------------------------------------------
+    void set_image(const void *data, display_image_format_enum format, uint16 width, uint16 height,
+                   int16 x, int16 y, uint16 w = 0, uint16 h = 0, ips200_scale_enum scale = IPS200_SCALE_NEAREST, int stride = 0);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加点
+// 参数说明 x     坐标x
+// 参数说明 y     坐标y
+// 参数说明 color 颜色
+// 返回参数 int8  0-成功 -1-叠加图形已满 以下添加函数相同
+// 使用示例 display_service.add_point(120, 90, RGB565_RED);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_point(int16 x, int16 y, uint16 color);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加线段
+// 参数说明 x_start 起点x
+// 参数说明 y_start 起点y
+// 参数说明 x_end   终点x
+// 参数说明 y_end   终点y
+// 参数说明 color   颜色
+// 返回参数 int8    0-成功 -1-已满
+// 使用示例 display_service.add_line(0, 90, 239, 90, RGB565_GREEN);
+// 备注信息 超出屏幕的部分被裁剪
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_line(int16 x_start, int16 y_start, int16 x_end, int16 y_end, uint16 color);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加矩形
+// 参数说明 x     左上角x
+// 参数说明 y     左上角y
+// 参数说明 w     宽度
+// 参数说明 h     高度
+// 参数说明 color 颜色
+// 参数说明 fill  0-边框 1-实心
+// 返回参数 int8  0-成功 -1-已满
+// 使用示例 display_service.add_rect(box_x, box_y, box_w, box_h, RGB565_YELLOW);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_rect(int16 x, int16 y, int16 w, int16 h, uint16 color, uint8 fill = 0);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加圆
+// 参数说明 x      圆心x
+// 参数说明 y      圆心y
+// 参数说明 radius 半径
+// 参数说明 color  颜色
+// 参数说明 fill   0-圆周 1-实心
+// 返回参数 int8   0-成功 -1-已满
+// 使用示例 display_service.add_circle(target_x, target_y, 6, RGB565_RED);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_circle(int16 x, int16 y, int16 radius, uint16 color, uint8 fill = 0);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加折线
+// 参数说明 x_offset 整体偏移x 一般为图像的显示位置
+// 参数说明 y_offset 整体偏移y
+// 参数说明 x        各点x坐标 只保存指针 NULL表示取点的序号
+// 参数说明 y        各点y坐标 只保存指针 NULL表示取点的序号
+// 参数说明 count    点数
+// 参数说明 color    颜色
+// 返回参数 int8     0-成功 -1-已满
+// 使用示例 display_service.add_polyline(0, 0, left_boundary, NULL, MT9V03X_H, RGB565_RED);
+// 备注信息 坐标数组与图像相同 在渲染线程合成时才被读取
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_polyline(int16 x_offset, int16 y_offset, const uint8 *x, const uint8 *y, uint16 count, uint16 color);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加文字
+// 参数说明 x    坐标x
+// 参数说明 y    坐标y
+// 参数说明 text 字符串 拷贝进帧描述 超出 DISPLAY_TEXT_LENGTH 的部分截断
+// 参数说明 pen  文字颜色
+// 参数说明 bg   背景颜色
+// 参数说明 font 字体
+// 返回参数 int8 0-成功 -1-文字项已满
+// 使用示例 display_service.add_text(0, 200, "speed", RGB565_WHITE, RGB565_BLACK);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_text(uint16 x, uint16 y, const char *text, uint16 pen = DEFAULT_PENCOLOR, uint16 bg = DEFAULT_BGCOLOR, ips200_font_size_enum font = IPS200_8X16_FONT);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加整数
+// 参数说明 x     坐标x
+// 参数说明 y     坐标y
+// 参数说明 value 数值
+// 参数说明 pen   文字颜色
+// 参数说明 bg    背景颜色
+// 返回参数 int8  0-成功 -1-文字项已满
+// 使用示例 display_service.add_int(48, 200, error, RGB565_WHITE, RGB565_BLACK);
+// 备注信息 用 func_int_to_str 在生产者线程中格式化 不经过 printf
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_int(uint16 x, uint16 y, int32 value, uint16 pen = DEFAULT_PENCOLOR, uint16 bg = DEFAULT_BGCOLOR);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 添加浮点数
+// 参数说明 x         坐标x
+// 参数说明 y         坐标y
+// 参数说明 value     数值
+// 参数说明 point_bit 小数位数 最多 FUNC_POINT_BIT_MAX
+// 参数说明 pen       文字颜色
+// 参数说明 bg        背景颜色
+// 返回参数 int8      0-成功 -1-文字项已满
+// 使用示例 display_service.add_float(48, 216, speed, 2, RGB565_WHITE, RGB565_BLACK);
+// 备注信息 用 func_double_to_str 格式化 四舍五入
+//-------------------------------------------------------------------------------------------------------------------
+    int8 add_float(uint16 x, uint16 y, double value, uint8 point_bit, uint16 pen = DEFAULT_PENCOLOR, uint16 bg = DEFAULT_BGCOLOR);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 提交当前帧
+// 参数说明 无
+// 返回参数 uint32 本帧序号
+// 使用示例 display_service.submit();
+// 备注信息 一次原子交换 不拷贝 不申请内存 不等待渲染线程
+//          上一次提交尚未渲染时被本帧替换 计入 dropped
+//          提交后 begin_frame 返回的指针失效 下一帧需重新调用 begin_frame
+//-------------------------------------------------------------------------------------------------------------------
+    uint32 submit(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 渲染最新提交的一帧
+// 参数说明 无
+// 返回参数 uint32 渲染的帧序号 没有新帧返回0
+// 使用示例 display_service.render();
+// 备注信息 渲染线程每周期调用 未启动渲染线程时可以在任意单一线程中手动调用
+//-------------------------------------------------------------------------------------------------------------------
+    uint32 render(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 查询某一帧引用的图像与坐标数组是否仍可能被读取
+// 参数说明 sequence submit 返回的序号
+// 返回参数 bool     true-该帧已提交尚未渲染 或正在合成
+// 使用示例 if(!display_service.is_frame_busy(last_sequence)) { 复用图像缓冲 }
+// 备注信息 在生产者线程中调用 被丢弃或已渲染完成的帧返回false
+//-------------------------------------------------------------------------------------------------------------------
+    bool is_frame_busy(uint32 sequence) const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取统计
+// 参数说明 stats 统计输出
+// 返回参数 无
+// 使用示例 display_stats_struct stats; display_service.get_stats(&stats);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    void get_stats(display_stats_struct *stats) const;
+};
+
+#endif
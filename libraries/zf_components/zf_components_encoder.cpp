@@ -0,0 +1,248 @@
+#include "zf_components_encoder.hpp"
+#include "zf_common_time.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_encoder encoder_service;
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+zf_components_encoder::zf_components_encoder(void)
+    : encoder_count(0), config{ENCODER_ESTIMATOR_MT, ENCODER_WINDOW_DEFAULT, ENCODER_MT_MIN_COUNTS_DEFAULT}
+{
+    for(uint8 i = 0; i < ENCODER_SERVICE_MAX; i ++)
+    {
+        encoder[i] = NULL;
+        direction[i] = 1;
+        started[i] = 0;
+        history_count[i] = 0;
+    }
+    memset(state, 0, sizeof(state));
+    memset(history, 0, sizeof(history));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记编码器
+// 参数说明 encoder   编码器对象
+// 参数说明 direction 1-正向 -1-反向
+// 返回参数 int       编码器编号 失败返回-1
+// 使用示例 encoder_service.add_encoder(&encoder_left, 1);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_encoder::add_encoder(zf_driver_encoder *encoder, int8 direction)
+{
+    if(NULL == encoder || ENCODER_SERVICE_MAX <= encoder_count) return -1;
+    this->encoder[encoder_count] = encoder;
+    set_direction(encoder_count, direction);
+    return encoder_count ++;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置方向
+// 参数说明 index     编码器编号
+// 参数说明 direction 1-正向 -1-反向
+// 返回参数 无
+// 使用示例 encoder_service.set_direction(right, -1);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_encoder::set_direction(uint8 index, int8 direction)
+{
+    if(ENCODER_SERVICE_MAX <= index) return;
+    this->direction[index] = (0 > direction) ? -1 : 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置速度估计方法
+// 参数说明 config 估计方法配置
+// 返回参数 无
+// 使用示例 encoder_service.set_estimator(&config);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_encoder::set_estimator(const encoder_estimator_config_struct *config)
+{
+    if(NULL == config) return;
+    this->config = *config;
+    if(2 > this->config.window)                    this->config.window = 2;
+    if(ENCODER_HISTORY_SIZE < this->config.window) this->config.window = ENCODER_HISTORY_SIZE;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取全部登记的编码器并更新位置与速度
+// 参数说明 无
+// 返回参数 uint8 读取成功的编码器数量
+// 使用示例 encoder_service.update();
+// 备注信息 read前后各取一次时间 时间戳取中点 误差不超过半次read耗时
+//-------------------------------------------------------------------------------------------------------------------
+uint8 zf_components_encoder::update(void)
+{
+    uint64_t begin_ns, end_ns;
+    uint8 success = 0;
+    int16 raw = 0;
+
+    for(uint8 i = 0; i < encoder_count; i ++)
+    {
+        begin_ns = time_now_ns();
+        if(0 != encoder[i]->read_count(&raw))
+        {
+            state[i].valid = 0;
+            continue;
+        }
+        end_ns = time_now_ns();
+        input(i, raw, begin_ns + (end_ns - begin_ns) / 2);
+        success ++;
+    }
+    return success;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 输入一次外部读取的计数
+// 参数说明 index        编码器编号
+// 参数说明 raw          原始计数
+// 参数说明 timestamp_ns 读取时刻
+// 返回参数 无
+// 使用示例 encoder_service.input(0, raw, timestamp_ns);
+// 备注信息 相邻两次读数之差按int16回绕处理 两次读取之间的脉冲数必须小于32768
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_encoder::input(uint8 index, int16 raw, uint64_t timestamp_ns)
+{
+    encoder_state_struct *s = NULL;
+
+    if(ENCODER_SERVICE_MAX <= index) return;
+    s = &state[index];
+
+    if(started[index])
+    {
+        if(timestamp_ns <= s->timestamp_ns) return;
+        int16 delta = (int16)(uint16)((uint16)raw - (uint16)s->raw);
+        s->position += (int64_t)direction[index] * delta;
+    }
+    started[index] = 1;
+    s->raw = raw;
+    s->timestamp_ns = timestamp_ns;
+    s->valid = 1;
+
+    encoder_history_struct *h = &history[index][history_count[index] & (ENCODER_HISTORY_SIZE - 1)];
+    h->position = s->position;
+    h->timestamp_ns = timestamp_ns;
+    history_count[index] ++;
+
+    s->velocity = estimate(index);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 按当前估计方法计算速度
+// 参数说明 index 编码器编号
+// 返回参数 float 脉冲/秒
+// 使用示例 内部调用
+// 备注信息 k 表示从最新采样向前数的第k个采样
+//-------------------------------------------------------------------------------------------------------------------
+float zf_components_encoder::estimate(uint8 index)
+{
+    const encoder_history_struct *h = history[index];
+    uint32 newest = history_count[index] - 1;
+    uint32 available = (history_count[index] < ENCODER_HISTORY_SIZE) ? history_count[index] : ENCODER_HISTORY_SIZE;
+    uint32 window = (config.window < available) ? config.window : available;
+    const encoder_history_struct *h0 = &h[newest & (ENCODER_HISTORY_SIZE - 1)];
+    const encoder_history_struct *hk = NULL;
+
+    if(2 > window) return 0;
+
+    switch(config.estimator)
+    {
+        case ENCODER_ESTIMATOR_LSQ:
+        {
+            // 以最新采样为原点 避免64位位置与纳秒时间戳在浮点中丢失精度
+            double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+            for(uint32 k = 0; k < window; k ++)
+            {
+                hk = &h[(newest - k) & (ENCODER_HISTORY_SIZE - 1)];
+                double x = -(double)(h0->timestamp_ns - hk->timestamp_ns) * 1e-9;
+                double y = (double)(hk->position - h0->position);
+                sum_x  += x;
+                sum_y  += y;
+                sum_xx += x * x;
+                sum_xy += x * y;
+            }
+            double denominator = window * sum_xx - sum_x * sum_x;
+            if(0 >= denominator) return 0;
+            return (float)((window * sum_xy - sum_x * sum_y) / denominator);
+        }
+
+        case ENCODER_ESTIMATOR_MT:
+        {
+            uint32 k = 1;
+            for(; k < window - 1; k ++)
+            {
+                hk = &h[(newest - k) & (ENCODER_HISTORY_SIZE - 1)];
+                int64_t counts = h0->position - hk->position;
+                if((int64_t)config.min_counts <= ((0 > counts) ? -counts : counts)) break;
+            }
+            hk = &h[(newest - k) & (ENCODER_HISTORY_SIZE - 1)];
+            break;
+        }
+
+        default:
+        {
+            hk = &h[(newest - 1) & (ENCODER_HISTORY_SIZE - 1)];
+            break;
+        }
+    }
+
+    if(h0->timestamp_ns <= hk->timestamp_ns) return 0;
+    return (float)((double)(h0->position - hk->position) * 1e9 / (double)(h0->timestamp_ns - hk->timestamp_ns));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取最新状态
+// 参数说明 index 编码器编号
+// 返回参数 const encoder_state_struct& 最新状态
+// 使用示例 encoder_service.get_state(left);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+const encoder_state_struct &zf_components_encoder::get_state(uint8 index) const
+{
+    return state[(ENCODER_SERVICE_MAX > index) ? index : 0];
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取累计位置
+// 参数说明 index 编码器编号
+// 返回参数 int64_t 脉冲数
+// 使用示例 encoder_service.get_position(left);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int64_t zf_components_encoder::get_position(uint8 index) const
+{
+    return get_state(index).position;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取速度
+// 参数说明 index 编码器编号
+// 返回参数 float 脉冲/秒
+// 使用示例 encoder_service.get_velocity(left);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+float zf_components_encoder::get_velocity(uint8 index) const
+{
+    return get_state(index).velocity;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 位置清零
+// 参数说明 index 编码器编号
+// 返回参数 无
+// 使用示例 encoder_service.reset_position(left);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_encoder::reset_position(uint8 index)
+{
+    if(ENCODER_SERVICE_MAX <= index) return;
+    int64_t offset = state[index].position;
+    state[index].position = 0;
+    for(uint32 i = 0; i < ENCODER_HISTORY_SIZE; i ++)
+    {
+        history[index][i].position -= offset;
+    }
+}
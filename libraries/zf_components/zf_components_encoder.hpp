@@ -0,0 +1,171 @@
+#ifndef _zf_components_encoder_h_
+#define _zf_components_encoder_h_
+
+#include "zf_common_typedef.hpp"
+#include "zf_driver_encoder.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 说明         编码器测速服务
+//              只读取不清零 16位计数的回绕累加为64位位置 读取前不再需要clear_count 不会丢失读清之间的脉冲
+//              每次读取记录时间戳(该次read前后时刻的中点) 速度按实际时间间隔计算 不受定时器抖动影响
+//              同一次 update 中登记的编码器依次紧接读取 左右轮的采样时刻只相差一次read的耗时
+//              update 与各查询函数应在同一线程(通常是控制回调)中调用
+//-------------------------------------------------------------------------------------------------------------------
+
+#define ENCODER_SERVICE_MAX             ( 2 )                                   // 最多登记的编码器数量 对应 ZF_ENCODER_QUAD_1/2
+#define ENCODER_HISTORY_SIZE            ( 64 )                                  // 每个编码器保存的历史采样数 必须为2的幂
+#define ENCODER_MT_MIN_COUNTS_DEFAULT   ( 4 )                                   // M/T法默认最少累计脉冲数
+#define ENCODER_WINDOW_DEFAULT          ( 8 )                                   // 默认窗口长度 采样数
+
+typedef enum
+{
+    ENCODER_ESTIMATOR_DIFF = 0,                                                 // 相邻两次采样的位置差 / 实际时间差 延迟最小 低速时量化噪声大
+    ENCODER_ESTIMATOR_MT,                                                       // M/T法 向前扩展窗口直到累计 min_counts 个脉冲或到达 window 上限 低速更准
+    ENCODER_ESTIMATOR_LSQ,                                                      // 最近 window 个采样的位置对时间最小二乘斜率 噪声小 延迟约 window/2 个周期
+}encoder_estimator_enum;
+
+typedef struct
+{
+    encoder_estimator_enum  estimator;
+    uint32                  window;                                             // MT 最多回看的采样数 LSQ 参与拟合的采样数 范围 2~ENCODER_HISTORY_SIZE
+    uint32                  min_counts;                                         // MT 最少累计脉冲数
+}encoder_estimator_config_struct;
+
+// 单个编码器的最新状态
+typedef struct
+{
+    int64_t     position;                                                       // 累计位置 脉冲数 已按方向修正
+    uint64_t    timestamp_ns;                                                   // 本次读取时刻 time_now_ns
+    float       velocity;                                                       // 速度 脉冲/秒
+    int16       raw;                                                            // 本次读取的原始计数
+    uint8       valid;                                                          // 1-本次读取成功 0-读取失败 位置与速度保持上次的值
+}encoder_state_struct;
+
+class zf_components_encoder
+{
+private:
+    typedef struct
+    {
+        int64_t     position;
+        uint64_t    timestamp_ns;
+    }encoder_history_struct;
+
+    zf_driver_encoder               *encoder[ENCODER_SERVICE_MAX];
+    int8                            direction[ENCODER_SERVICE_MAX];             // 1 或 -1 左右轮镜像安装时其中一个取-1
+    uint8                           encoder_count;
+    encoder_estimator_config_struct config;
+
+    encoder_state_struct            state[ENCODER_SERVICE_MAX];
+    uint8                           started[ENCODER_SERVICE_MAX];               // 0-尚未取得第一次读数 下一次读数只作为基准
+    encoder_history_struct          history[ENCODER_SERVICE_MAX][ENCODER_HISTORY_SIZE];
+    uint32                          history_count[ENCODER_SERVICE_MAX];         // 已写入的历史数 超过ENCODER_HISTORY_SIZE后继续递增
+
+    zf_components_encoder(const zf_components_encoder&) = delete;
+    zf_components_encoder& operator=(const zf_components_encoder&) = delete;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 按当前估计方法计算速度
+// 参数说明 index 编码器编号
+// 返回参数 float 脉冲/秒
+// 使用示例 内部调用
+// 备注信息 历史不足两个采样或时间差为0时返回0
+//-------------------------------------------------------------------------------------------------------------------
+    float estimate(uint8 index);
+
+public:
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_encoder encoder_service;
+// 备注信息 默认使用M/T法 window=ENCODER_WINDOW_DEFAULT min_counts=ENCODER_MT_MIN_COUNTS_DEFAULT
+//-------------------------------------------------------------------------------------------------------------------
+    zf_components_encoder(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记编码器
+// 参数说明 encoder   编码器对象 生命周期需长于测速服务 不能再调用其 clear_count
+// 参数说明 direction 1-正向 -1-反向
+// 返回参数 int       编码器编号 已满返回-1
+// 使用示例 int left = encoder_service.add_encoder(&encoder_left, 1);
+// 备注信息 可以不登记设备 直接用 input 输入计数(仿真或采集中心的快照)
+//-------------------------------------------------------------------------------------------------------------------
+    int add_encoder(zf_driver_encoder *encoder, int8 direction = 1);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置方向
+// 参数说明 index     编码器编号
+// 参数说明 direction 1-正向 -1-反向
+// 返回参数 无
+// 使用示例 encoder_service.set_direction(right, -1);
+// 备注信息 用于 input 方式输入的编码器
+//-------------------------------------------------------------------------------------------------------------------
+    void set_direction(uint8 index, int8 direction);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置速度估计方法
+// 参数说明 config 估计方法配置
+// 返回参数 无
+// 使用示例 encoder_estimator_config_struct config = {ENCODER_ESTIMATOR_LSQ, 16, 0}; encoder_service.set_estimator(&config);
+// 备注信息 window 超出范围时截断 下一次 update 生效
+//-------------------------------------------------------------------------------------------------------------------
+    void set_estimator(const encoder_estimator_config_struct *config);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取全部登记的编码器并更新位置与速度
+// 参数说明 无
+// 返回参数 uint8 读取成功的编码器数量
+// 使用示例 encoder_service.update();
+// 备注信息 在控制回调开头调用 每个编码器一次read 不再写清零
+//-------------------------------------------------------------------------------------------------------------------
+    uint8 update(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 输入一次外部读取的计数
+// 参数说明 index        编码器编号 0~ENCODER_SERVICE_MAX-1
+// 参数说明 raw          原始计数 与 get_count 返回值相同 不清零的自由计数
+// 参数说明 timestamp_ns 读取时刻
+// 返回参数 无
+// 使用示例 encoder_service.input(0, snapshot.encoder[0], snapshot.timestamp_ns);
+// 备注信息 用于采集中心快照或仿真数据 时间戳不递增的输入被忽略
+//-------------------------------------------------------------------------------------------------------------------
+    void input(uint8 index, int16 raw, uint64_t timestamp_ns);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取最新状态
+// 参数说明 index 编码器编号
+// 返回参数 const encoder_state_struct& 编号无效时返回第0个
+// 使用示例 float speed = encoder_service.get_state(left).velocity;
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    const encoder_state_struct &get_state(uint8 index) const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取累计位置
+// 参数说明 index 编码器编号
+// 返回参数 int64_t 脉冲数
+// 使用示例 int64_t distance = encoder_service.get_position(left);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int64_t get_position(uint8 index) const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取速度
+// 参数说明 index 编码器编号
+// 返回参数 float 脉冲/秒
+// 使用示例 float speed = encoder_service.get_velocity(left);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    float get_velocity(uint8 index) const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 位置清零
+// 参数说明 index 编码器编号
+// 返回参数 无
+// 使用示例 encoder_service.reset_position(left);
+// 备注信息 只修改软件累计值 历史同步平移 速度不受影响
+//-------------------------------------------------------------------------------------------------------------------
+    void reset_position(uint8 index);
+};
+
+#endif
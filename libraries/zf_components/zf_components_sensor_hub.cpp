@@ -0,0 +1,304 @@
+#include "zf_components_sensor_hub.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_sensor_hub sensor_hub;
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+zf_components_sensor_hub::zf_components_sensor_hub(void)
+    : hub_imu(NULL), hub_dl1x(NULL), hub_encoder_count(0), hub_adc_count(0), hub_timer(NULL),
+      hub_rt_policy{SCHED_FIFO, SENSOR_HUB_PRIORITY_DEFAULT, RT_CPU_ANY, RT_STACK_PREFAULT_DEFAULT},
+      hub_lock_sequence(0), hub_published(0)
+{
+    memset(hub_encoder, 0, sizeof(hub_encoder));
+    memset(hub_adc, 0, sizeof(hub_adc));
+    memset(&hub_imu_last, 0, sizeof(hub_imu_last));
+    memset(hub_history, 0, sizeof(hub_history));
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 析构函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 自动调用，无需手动调用
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+zf_components_sensor_hub::~zf_components_sensor_hub(void)
+{
+    stop();
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记编码器
+// 参数说明 encoder 编码器对象
+// 返回参数 int     下标 失败返回-1
+// 使用示例 sensor_hub.add_encoder(&encoder_left);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_sensor_hub::add_encoder(zf_driver_encoder *encoder)
+{
+    if(NULL != hub_timer || NULL == encoder || SENSOR_HUB_ENCODER_MAX <= hub_encoder_count) return -1;
+    hub_encoder[hub_encoder_count] = encoder;
+    return hub_encoder_count ++;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记ADC通道
+// 参数说明 adc ADC对象
+// 返回参数 int 下标 失败返回-1
+// 使用示例 sensor_hub.add_adc(&adc_battery);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_sensor_hub::add_adc(zf_driver_adc *adc)
+{
+    if(NULL != hub_timer || NULL == adc || SENSOR_HUB_ADC_MAX <= hub_adc_count) return -1;
+    hub_adc[hub_adc_count] = adc;
+    return hub_adc_count ++;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记IMU
+// 参数说明 imu IMU对象
+// 返回参数 int 0-成功 -1-失败
+// 使用示例 sensor_hub.set_imu(&imu_dev);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_sensor_hub::set_imu(zf_device_imu *imu)
+{
+    if(NULL != hub_timer) return -1;
+    hub_imu = imu;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记DL1X
+// 参数说明 dl1x DL1X对象
+// 返回参数 int  0-成功 -1-失败
+// 使用示例 sensor_hub.set_dl1x(&dl1x_dev);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_sensor_hub::set_dl1x(zf_device_dl1x *dl1x)
+{
+    if(NULL != hub_timer) return -1;
+    hub_dl1x = dl1x;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置采集线程的实时配置
+// 参数说明 policy 线程配置
+// 返回参数 无
+// 使用示例 sensor_hub.set_rt_policy(&policy);
+// 备注信息 采集已启动时调用无效果
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_sensor_hub::set_rt_policy(const rt_thread_policy_struct *policy)
+{
+    if(NULL != hub_timer || NULL == policy) return;
+    hub_rt_policy = *policy;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 启动采集
+// 参数说明 period 采样周期
+// 返回参数 int    0-成功 -1-失败
+// 使用示例 sensor_hub.start(std::chrono::milliseconds(1));
+// 备注信息 错过的周期直接丢弃 补采过去的时刻没有意义
+//-------------------------------------------------------------------------------------------------------------------
+int zf_components_sensor_hub::start(std::chrono::nanoseconds period)
+{
+    if(NULL != hub_timer) return -1;
+    if(period.count() < PIT_MIN_PERIOD_NS)
+    {
+        printf("sensor_hub error: period must be at least %d ns!\r\n", PIT_MIN_PERIOD_NS);
+        return -1;
+    }
+
+    hub_timer = new timer_fd(period, [this](){ sample(); });
+    hub_timer->set_overrun_policy(PIT_OVERRUN_SKIP);
+    hub_timer->set_rt_policy(&hub_rt_policy);
+    hub_timer->start();
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 停止采集
+// 参数说明 无
+// 返回参数 无
+// 使用示例 sensor_hub.stop();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_sensor_hub::stop(void)
+{
+    if(NULL == hub_timer) return;
+    hub_timer->stop();
+    delete hub_timer;
+    hub_timer = NULL;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取IMU
+// 参数说明 snapshot 快照
+// 返回参数 无
+// 使用示例 内部调用
+// 备注信息 缓冲模式下本周期没有新样本时沿用上一个样本 不置有效位
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_sensor_hub::sample_imu(sensor_hub_snapshot_struct *snapshot)
+{
+    if(0 > hub_imu->get_buffer_fd())
+    {
+        if(0 == hub_imu->read_sysfs_sample(&snapshot->imu))
+        {
+            snapshot->valid_mask |= SENSOR_HUB_VALID_IMU;
+        }
+        return;
+    }
+
+    int count = 0;
+    do
+    {
+        count = hub_imu->read_samples(hub_imu_batch, SENSOR_HUB_IMU_BATCH, 0);
+        if(0 < count)
+        {
+            hub_imu_last = hub_imu_batch[count - 1];
+            snapshot->valid_mask |= SENSOR_HUB_VALID_IMU;
+        }
+    }while(SENSOR_HUB_IMU_BATCH == count);                                      // 取满说明还有积压
+    snapshot->imu = hub_imu_last;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 采样一次全部传感器并发布
+// 参数说明 无
+// 返回参数 无
+// 使用示例 内部调用
+// 备注信息 单写者顺序锁 写入前序号变为奇数 写完变为偶数
+//-------------------------------------------------------------------------------------------------------------------
+void zf_components_sensor_hub::sample(void)
+{
+    sensor_hub_snapshot_struct snapshot;
+    uint32 sequence = 0;
+
+    memset(&snapshot, 0, sizeof(snapshot));
+    snapshot.timestamp_ns = time_now_ns();
+
+    for(uint8 i = 0; i < hub_encoder_count; i ++)
+    {
+        if(0 == hub_encoder[i]->read_count(&snapshot.encoder[i]))
+        {
+            snapshot.valid_mask |= SENSOR_HUB_VALID_ENCODER(i);
+        }
+    }
+    if(NULL != hub_imu)
+    {
+        sample_imu(&snapshot);
+    }
+    if(NULL != hub_dl1x)
+    {
+        if(0 == hub_dl1x->read_distance(&snapshot.distance))
+        {
+            snapshot.valid_mask |= SENSOR_HUB_VALID_DL1X;
+        }
+    }
+    for(uint8 i = 0; i < hub_adc_count; i ++)
+    {
+        if(0 == hub_adc[i]->read_convert(&snapshot.adc[i]))
+        {
+            snapshot.valid_mask |= SENSOR_HUB_VALID_ADC(i);
+        }
+    }
+    snapshot.sample_ns = (uint32)(time_now_ns() - snapshot.timestamp_ns);
+
+    // 只有采集线程写入 hub_published 无需原子读取
+    snapshot.sequence = hub_published + 1;
+
+    sequence = hub_lock_sequence.load(std::memory_order_relaxed);
+    hub_lock_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    hub_history[hub_published & (SENSOR_HUB_HISTORY_SIZE - 1)] = snapshot;
+    hub_published ++;
+
+    hub_lock_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取最新快照
+// 参数说明 snapshot 快照输出
+// 返回参数 int8     0-成功 -1-尚未采样
+// 使用示例 sensor_hub.get_latest(&snapshot);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_components_sensor_hub::get_latest(sensor_hub_snapshot_struct *snapshot)
+{
+    return (1 == get_history(snapshot, 1)) ? 0 : -1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取最近若干次快照
+// 参数说明 snapshot 快照输出数组
+// 参数说明 count    需要的数量
+// 返回参数 uint32   实际拷贝的数量
+// 使用示例 sensor_hub.get_history(history, 4);
+// 备注信息 整个拷贝过程处于同一个读区间内 期间发生写入则全部重新拷贝
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_components_sensor_hub::get_history(sensor_hub_snapshot_struct *snapshot, uint32 count)
+{
+    uint64_t published = 0;
+    uint32 copied = 0;
+    uint32 begin, end;
+
+    if(NULL == snapshot) return 0;
+    if(SENSOR_HUB_HISTORY_SIZE < count) count = SENSOR_HUB_HISTORY_SIZE;
+
+    do
+    {
+        begin = hub_lock_sequence.load(std::memory_order_acquire);
+        published = hub_published;
+        copied = (published < count) ? (uint32)published : count;
+        for(uint32 i = 0; i < copied; i ++)
+        {
+            memcpy(&snapshot[i], &hub_history[(published - 1 - i) & (SENSOR_HUB_HISTORY_SIZE - 1)], sizeof(sensor_hub_snapshot_struct));
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        end = hub_lock_sequence.load(std::memory_order_relaxed);
+    }while((begin & 1) || begin != end);
+
+    return copied;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取最新快照序号
+// 参数说明 无
+// 返回参数 uint64_t 0表示尚未采样
+// 使用示例 sensor_hub.get_sequence();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t zf_components_sensor_hub::get_sequence(void)
+{
+    uint64_t published = 0;
+    uint32 begin, end;
+
+    do
+    {
+        begin = hub_lock_sequence.load(std::memory_order_acquire);
+        published = hub_published;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        end = hub_lock_sequence.load(std::memory_order_relaxed);
+    }while((begin & 1) || begin != end);
+
+    return published;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取采集定时器
+// 参数说明 无
+// 返回参数 timer_fd* 未启动返回NULL
+// 使用示例 sensor_hub.get_timer();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+timer_fd *zf_components_sensor_hub::get_timer(void)
+{
+    return hub_timer;
+}
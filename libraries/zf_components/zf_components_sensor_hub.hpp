@@ -0,0 +1,206 @@
+#ifndef _zf_components_sensor_hub_h_
+#define _zf_components_sensor_hub_h_
+
+#include "zf_common_typedef.hpp"
+#include "zf_common_rt.hpp"
+#include "zf_driver_adc.hpp"
+#include "zf_driver_encoder.hpp"
+#include "zf_driver_pit_fd.hpp"
+#include "zf_device_dl1x.hpp"
+#include "zf_device_imu.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 说明         传感器采集中心
+//              由一个实时线程按固定周期依次读取已登记的编码器 IMU DL1X ADC 写入一份带单一时间戳的快照
+//              快照通过顺序锁发布 任意数量的读线程无锁 无系统调用地取得一致的最新快照或最近若干次历史
+//              控制线程不再各自同步读取设备 同一控制周期内使用的所有数据来自同一次采样
+//-------------------------------------------------------------------------------------------------------------------
+
+#define SENSOR_HUB_ENCODER_MAX          ( 4 )                                   // 最多登记的编码器数量
+#define SENSOR_HUB_ADC_MAX              ( 8 )                                   // 最多登记的ADC通道数量
+#define SENSOR_HUB_HISTORY_SIZE         ( 32 )                                  // 历史快照环形缓冲长度 必须为2的幂
+#define SENSOR_HUB_IMU_BATCH            ( 16 )                                  // IIO缓冲模式下每次read取出的最大样本数
+#define SENSOR_HUB_PRIORITY_DEFAULT     ( 90 )                                  // 采集线程默认SCHED_FIFO优先级 低于控制定时器默认的99
+
+// valid_mask 各位含义 对应传感器本次读取成功时置1
+#define SENSOR_HUB_VALID_ENCODER(n)     ( 1u << (n) )                           // 第n个编码器
+#define SENSOR_HUB_VALID_IMU            ( 1u << 8 )
+#define SENSOR_HUB_VALID_DL1X           ( 1u << 9 )
+#define SENSOR_HUB_VALID_ADC(n)         ( 1u << (16 + (n)) )                    // 第n个ADC通道
+
+// 一次采样的全部数据 各传感器的同类数据连续存放
+typedef struct
+{
+    uint64_t            sequence;                                               // 采样序号 从1开始 连续递增
+    uint64_t            timestamp_ns;                                           // 本次采样开始时刻 time_now_ns
+    uint32              sample_ns;                                              // 读取全部传感器的耗时
+    uint32              valid_mask;                                             // 见 SENSOR_HUB_VALID_*
+
+    int16               encoder[SENSOR_HUB_ENCODER_MAX];                        // 编码器计数 按登记顺序
+    imu_sample_struct   imu;                                                    // IMU 缓冲模式下为本周期最新的样本 时间戳取自样本本身
+    int16               distance;                                               // DL1X 距离 mm 仅 SENSOR_HUB_VALID_DL1X 置位时可用
+    uint16              adc[SENSOR_HUB_ADC_MAX];                                // ADC 原始值 按登记顺序 读取失败的通道为0且不置有效位
+}sensor_hub_snapshot_struct;
+
+class zf_components_sensor_hub
+{
+private:
+    zf_driver_encoder       *hub_encoder[SENSOR_HUB_ENCODER_MAX];
+    zf_driver_adc           *hub_adc[SENSOR_HUB_ADC_MAX];
+    zf_device_imu           *hub_imu;
+    zf_device_dl1x          *hub_dl1x;
+    uint8                   hub_encoder_count;
+    uint8                   hub_adc_count;
+
+    timer_fd                *hub_timer;                                         // 采集线程 运行中非NULL
+    rt_thread_policy_struct hub_rt_policy;
+    imu_sample_struct       hub_imu_batch[SENSOR_HUB_IMU_BATCH];                // 缓冲模式读取暂存 采集线程专用
+    imu_sample_struct       hub_imu_last;                                       // 缓冲模式下最近一个样本 本周期无新样本时沿用
+
+    std::atomic<uint32>         hub_lock_sequence;                              // 顺序锁 奇数表示正在写入
+    uint64_t                    hub_published;                                  // 已发布的快照数量 受顺序锁保护
+    sensor_hub_snapshot_struct  hub_history[SENSOR_HUB_HISTORY_SIZE];           // 历史环形缓冲 最新快照位于 (hub_published - 1) 处
+
+    zf_components_sensor_hub(const zf_components_sensor_hub&) = delete;
+    zf_components_sensor_hub& operator=(const zf_components_sensor_hub&) = delete;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 采样一次全部传感器并发布
+// 参数说明 无
+// 返回参数 无
+// 使用示例 内部调用，由采集线程每周期调用
+// 备注信息 读取设备在顺序锁之外完成 写锁只覆盖一次快照拷贝 读线程重试窗口很短
+//-------------------------------------------------------------------------------------------------------------------
+    void sample(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取IMU
+// 参数说明 snapshot 快照
+// 返回参数 无
+// 使用示例 内部调用
+// 备注信息 缓冲模式不等待 取出全部积压样本后保留最新一个 否则通过sysfs读取全部轴
+//-------------------------------------------------------------------------------------------------------------------
+    void sample_imu(sensor_hub_snapshot_struct *snapshot);
+
+public:
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 zf_components_sensor_hub sensor_hub;
+// 备注信息 不登记任何传感器 默认SCHED_FIFO SENSOR_HUB_PRIORITY_DEFAULT 不绑定CPU
+//-------------------------------------------------------------------------------------------------------------------
+    zf_components_sensor_hub(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 析构函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 自动调用，无需手动调用
+// 备注信息 停止采集线程 不关闭已登记的设备
+//-------------------------------------------------------------------------------------------------------------------
+    ~zf_components_sensor_hub(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记编码器
+// 参数说明 encoder 编码器对象 生命周期需长于采集中心
+// 返回参数 int     快照中 encoder[] 的下标 已满或采集已启动返回-1
+// 使用示例 int left = sensor_hub.add_encoder(&encoder_left);
+// 备注信息 必须在start之前调用 以下登记函数相同
+//-------------------------------------------------------------------------------------------------------------------
+    int add_encoder(zf_driver_encoder *encoder);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记ADC通道
+// 参数说明 adc ADC对象
+// 返回参数 int 快照中 adc[] 的下标 已满或采集已启动返回-1
+// 使用示例 int battery = sensor_hub.add_adc(&adc_battery);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int add_adc(zf_driver_adc *adc);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记IMU
+// 参数说明 imu 已init的IMU对象 需要缓冲模式时先调用 init_buffer
+// 返回参数 int 0-成功 -1-采集已启动
+// 使用示例 sensor_hub.set_imu(&imu_dev);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int set_imu(zf_device_imu *imu);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 登记DL1X
+// 参数说明 dl1x 已init的DL1X对象
+// 返回参数 int  0-成功 -1-采集已启动
+// 使用示例 sensor_hub.set_dl1x(&dl1x_dev);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    int set_dl1x(zf_device_dl1x *dl1x);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置采集线程的实时配置
+// 参数说明 policy 线程配置，见rt_thread_policy_struct
+// 返回参数 无
+// 使用示例 sensor_hub.set_rt_policy(&policy);
+// 备注信息 必须在start之前调用
+//-------------------------------------------------------------------------------------------------------------------
+    void set_rt_policy(const rt_thread_policy_struct *policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 启动采集
+// 参数说明 period 采样周期，std::chrono时长，不小于PIT_MIN_PERIOD_NS
+// 返回参数 int    0-成功 -1-周期无效或已启动
+// 使用示例 sensor_hub.start(std::chrono::milliseconds(1));
+// 备注信息 周期内应能读完全部传感器 耗时见快照的 sample_ns
+//          仿真时钟下不创建线程 由 time_sim_advance_ns 驱动采样
+//-------------------------------------------------------------------------------------------------------------------
+    int start(std::chrono::nanoseconds period);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 停止采集
+// 参数说明 无
+// 返回参数 无
+// 使用示例 sensor_hub.stop();
+// 备注信息 阻塞等待采集线程退出 已发布的快照仍可读取
+//-------------------------------------------------------------------------------------------------------------------
+    void stop(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取最新快照
+// 参数说明 snapshot 快照输出
+// 返回参数 int8     0-成功 -1-尚未采样
+// 使用示例 sensor_hub_snapshot_struct s; if(0 == sensor_hub.get_latest(&s)) { ... }
+// 备注信息 任意线程均可调用 无锁 无系统调用 与采集线程并发时自动重试直到拷贝一致
+//-------------------------------------------------------------------------------------------------------------------
+    int8 get_latest(sensor_hub_snapshot_struct *snapshot);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取最近若干次快照
+// 参数说明 snapshot 快照输出数组 snapshot[0]为最新
+// 参数说明 count    需要的数量 最多SENSOR_HUB_HISTORY_SIZE
+// 返回参数 uint32   实际拷贝的数量 采样次数不足时小于count
+// 使用示例 sensor_hub_snapshot_struct h[2]; if(2 == sensor_hub.get_history(h, 2)) speed = h[0].encoder[0] - h[1].encoder[0];
+// 备注信息 返回的各快照属于同一时刻的历史 序号连续 用于差分与滤波计算
+//-------------------------------------------------------------------------------------------------------------------
+    uint32 get_history(sensor_hub_snapshot_struct *snapshot, uint32 count);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取最新快照序号
+// 参数说明 无
+// 返回参数 uint64_t 0表示尚未采样
+// 使用示例 if(sensor_hub.get_sequence() != last_sequence) { ... }
+// 备注信息 只读取序号 开销小于get_latest 用于判断是否有新数据
+//-------------------------------------------------------------------------------------------------------------------
+    uint64_t get_sequence(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取采集定时器
+// 参数说明 无
+// 返回参数 timer_fd* 未启动返回NULL
+// 使用示例 sensor_hub.get_timer()->print_stat();
+// 备注信息 用于查询唤醒延迟 采样耗时 错过周期等统计
+//-------------------------------------------------------------------------------------------------------------------
+    timer_fd *get_timer(void);
+};
+
+#endif
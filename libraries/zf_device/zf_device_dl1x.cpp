@@ -11,6 +11,40 @@
  */
 
 #include "zf_device_dl1x.hpp"
+#include "zf_common_function.hpp"
+
+#define DL1X_RESULT_VALID_BIT   ( 16 )
+#define DL1X_RESULT_TIME_SHIFT  ( 17 )
+
+// 结果打包为一个64位值 读线程一次原子读取即得到一致的距离 有效标志 时间戳
+static inline uint64_t dl1x_result_pack(int16 distance, uint8 valid, uint64_t timestamp_ns)
+{
+    return (uint64_t)(uint16)distance | ((uint64_t)(valid ? 1 : 0) << DL1X_RESULT_VALID_BIT) | ((timestamp_ns / 1000) << DL1X_RESULT_TIME_SHIFT);
+}
+
+static inline void dl1x_result_unpack(uint64_t packed, dl1x_result_struct *result)
+{
+    result->distance     = (int16)(uint16)(packed & 0xFFFF);
+    result->valid        = (uint8)((packed >> DL1X_RESULT_VALID_BIT) & 1);
+    result->timestamp_ns = (packed >> DL1X_RESULT_TIME_SHIFT) * 1000;
+}
+
+// 插入排序求中值 窗口只有几个元素 偶数个时取较小的中间值
+static int16 dl1x_median(const int16 *window, uint8 count)
+{
+    int16 sorted[DL1X_FILTER_SIZE];
+    for(uint8 i = 0; i < count; i ++)
+    {
+        int16 value = window[i];
+        uint8 j = i;
+        for(; j > 0 && sorted[j - 1] > value; j --)
+        {
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+    return sorted[(count - 1) / 2];
+}
 
 /*---------------------------------------------------------------------
  * @brief    构造函数
@@ -18,10 +52,14 @@
  * @example  zf_device_dl1x dl1x_dev;
  *---------------------------------------------------------------------
  */
-zf_device_dl1x::zf_device_dl1x(void) : zf_driver_file_string(NULL, "r")
+zf_device_dl1x::zf_device_dl1x(void) : zf_driver_file_string(NULL, "r"), poll_timer(NULL), poll_running(false), poll_result(0)
 {
-    dl1x_dev_type = NO_FIND_DEVICE;
-    fd_distance = -1;                // 距离文件句柄初始化为无效值
+    dl1x_dev_type = NO_FIND_DEVICE;  // 距离属性对象构造时未打开文件
+    memset(filter_window, 0, sizeof(filter_window));
+    filter_count = 0;
+    filter_index = 0;
+    outlier_count = 0;
+    stale_count = 0;
 }
 
 /*---------------------------------------------------------------------
@@ -32,6 +70,7 @@ zf_device_dl1x::zf_device_dl1x(void) : zf_driver_file_string(NULL, "r")
  */
 zf_device_dl1x::~zf_device_dl1x(void)
 {
+    stop_poll();                     // 先停止采样线程 再关闭文件
     dl1x_close_all_fd();
 }
 
@@ -43,26 +82,21 @@ zf_device_dl1x::~zf_device_dl1x(void)
  */
 void zf_device_dl1x::dl1x_close_all_fd(void)
 {
-    if(fd_distance > 0) close(fd_distance);
-    fd_distance = -1;  // 重置为无效值，防止重复关闭
+    attr_distance.close_path();      // 已关闭时不重复关闭
 }
 
 /*---------------------------------------------------------------------
- * @brief    通过文件句柄读取传感器原始数据并转int16
- * @param    fd 已打开的传感器文件句柄
- * @return   转换后的传感器原始值，句柄无效/未初始化返回0
+ * @brief    读取距离属性原始数据并转int16
+ * @return   转换后的传感器原始值，未打开/未初始化返回0
  * @example  内部调用
  *---------------------------------------------------------------------
  */
-int16 zf_device_dl1x::dl1x_read_fd_data(int fd)
+int16 zf_device_dl1x::dl1x_read_distance(void)
 {
-    if(dl1x_dev_type == NO_FIND_DEVICE || fd < 0) return 0;
-    char str[20] = {0};
-
-    lseek(fd, 0, SEEK_SET);          // 关键：偏移到文件头，保证读最新值
-    if(read(fd, str, sizeof(str)-1) <= 0) return 0;
-
-    return atoi(str);
+    int32 value = 0;
+    if(dl1x_dev_type == NO_FIND_DEVICE) return 0;
+    if(0 != attr_distance.read_int(&value)) return 0;   // pread一次取得最新值 无需lseek
+    return (int16)value;
 }
 
 /*---------------------------------------------------------------------
@@ -75,8 +109,9 @@ int16 zf_device_dl1x::dl1x_read_fd_data(int fd)
 enum dl1x_device_type_enum zf_device_dl1x::init(void)
 {
     int fd_event = -1;
-    char read_buf[10] = {0};
-    int read_val = NO_FIND_DEVICE;
+    char read_buf[10];
+    ssize_t read_len = 0;
+    int32 read_val = NO_FIND_DEVICE;
 
     // 第一步：写入1 执行DL1X硬件初始化
     fd_event = open(DL1X_EVENT_PATH, O_RDWR);  // 读写模式打开：先写后读
@@ -97,9 +132,10 @@ enum dl1x_device_type_enum zf_device_dl1x::init(void)
 
     // 第二步：读取该文件的值 获取设备型号
     lseek(fd_event, 0, SEEK_SET);  // 写后读，必须偏移到文件头
-    if(read(fd_event, read_buf, sizeof(read_buf)-1) > 0)
+    read_len = read(fd_event, read_buf, sizeof(read_buf));
+    if(read_len > 0)
     {
-        read_val = atoi(read_buf); // 字符串转整型，直接映射枚举值
+        func_parse_int(read_buf, (size_t)read_len, &read_val); // 按读到的长度解析，直接映射枚举值
     }
     close(fd_event); // 立即关闭事件文件句柄，无泄漏
     fd_event = -1;
@@ -130,8 +166,7 @@ enum dl1x_device_type_enum zf_device_dl1x::init(void)
     }
 
     // 第三步：打开距离数据文件
-    fd_distance = open(DL1X_DISTANCE_PATH, O_RDONLY);
-    if(fd_distance < 0)
+    if(0 != attr_distance.open_path(DL1X_DISTANCE_PATH))
     {
         std::cerr << "DL1X打开距离文件失败, errno:" << errno << std::endl;
         dl1x_close_all_fd();
@@ -154,11 +189,168 @@ enum dl1x_device_type_enum zf_device_dl1x::get_dev_type(void)
 
 /*---------------------------------------------------------------------
  * @brief    读取测距传感器原始距离数据
- * @return   距离原始值，未初始化返回0
+ * @details  后台采样运行时返回最新滤波结果 结果无效时(尚无读数或连续DL1X_STALE_COUNT次没有可用读数)返回0
+ *           需要区分0与无效读数时使用read_distance
+ * @return   距离原始值，未初始化或结果无效返回0
  * @example  int16 distance = dl1x_dev.get_distance();
  *---------------------------------------------------------------------
  */
 int16 zf_device_dl1x::get_distance(void)
 {
-    return dl1x_read_fd_data(fd_distance);
+    if(poll_running.load(std::memory_order_acquire))
+    {
+        dl1x_result_struct result;
+        dl1x_result_unpack(poll_result.load(std::memory_order_acquire), &result);
+        return result.valid ? result.distance : 0;
+    }
+    return dl1x_read_distance();
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读取距离 区分无效读数
+ * @param    distance    距离输出 mm
+ * @return   0-有效 -1-未初始化 读取失败或读数无效
+ * @example  dl1x_dev.read_distance(&d);
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_dl1x::read_distance(int16 *distance)
+{
+    dl1x_result_struct result;
+    int32 value = 0;
+
+    if(NULL == distance) return -1;
+    if(poll_running.load(std::memory_order_acquire))
+    {
+        dl1x_result_unpack(poll_result.load(std::memory_order_acquire), &result);
+        *distance = result.distance;
+        return result.valid ? 0 : -1;
+    }
+
+    *distance = 0;
+    if(NO_FIND_DEVICE == dl1x_dev_type || 0 != attr_distance.read_int(&value)) return -1;
+    *distance = (int16)value;
+    return (value >= DL1X_DISTANCE_MIN && value <= DL1X_DISTANCE_MAX) ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读数送入滤波器
+ * @details  超出量程的读数直接丢弃 与中值相差过大的读数视为离群值丢弃
+ *           连续DL1X_OUTLIER_ACCEPT次离群说明距离确实突变 清空窗口从新读数重新开始
+ * @param    raw         原始读数
+ * @param    distance    当前中值输出 读数被采纳时有效
+ * @return   0-被采纳 -1-被丢弃
+ * @example  内部调用
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_dl1x::dl1x_filter(int16 raw, int16 *distance)
+{
+    if(raw < DL1X_DISTANCE_MIN || raw > DL1X_DISTANCE_MAX) return -1;
+
+    if(filter_count > 0)
+    {
+        int16 median = dl1x_median(filter_window, filter_count);
+        if(abs(raw - median) > DL1X_OUTLIER_MM)
+        {
+            outlier_count ++;
+            if(outlier_count < DL1X_OUTLIER_ACCEPT) return -1;
+            filter_count = 0;
+            filter_index = 0;
+        }
+    }
+    outlier_count = 0;
+
+    filter_window[filter_index] = raw;
+    filter_index = (filter_index + 1) % DL1X_FILTER_SIZE;
+    if(filter_count < DL1X_FILTER_SIZE) filter_count ++;
+    *distance = dl1x_median(filter_window, filter_count);
+    return 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    后台采样一次 滤波后发布
+ * @details  没有可用读数时保留上一次的距离与时间戳 连续DL1X_STALE_COUNT次后清除有效标志
+ * @return   无
+ * @example  内部调用 由采样定时器线程调用
+ *---------------------------------------------------------------------
+ */
+void zf_device_dl1x::dl1x_poll(void)
+{
+    uint64_t timestamp_ns = time_now_ns();
+    int32 raw = 0;
+    int16 distance = 0;
+
+    if(0 == attr_distance.read_int(&raw) && 0 == dl1x_filter((int16)raw, &distance))
+    {
+        stale_count = 0;
+        poll_result.store(dl1x_result_pack(distance, 1, timestamp_ns), std::memory_order_release);
+        return;
+    }
+
+    if(stale_count < DL1X_STALE_COUNT) stale_count ++;
+    if(stale_count >= DL1X_STALE_COUNT)
+    {
+        dl1x_result_struct last;
+        dl1x_result_unpack(poll_result.load(std::memory_order_relaxed), &last);
+        if(last.valid)
+        {
+            poll_result.store(dl1x_result_pack(last.distance, 0, last.timestamp_ns), std::memory_order_release);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------
+ * @brief    启动后台采样
+ * @param    period_ms   采样周期 ms
+ * @return   0-成功 -1-未初始化或已启动
+ * @example  dl1x_dev.start_poll();
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_dl1x::start_poll(uint32 period_ms)
+{
+    rt_thread_policy_struct policy = {SCHED_OTHER, 0, RT_CPU_ANY, 0};
+
+    if(NO_FIND_DEVICE == dl1x_dev_type || NULL != poll_timer || 0 == period_ms) return -1;
+
+    memset(filter_window, 0, sizeof(filter_window));
+    filter_count = 0;
+    filter_index = 0;
+    outlier_count = 0;
+    stale_count = 0;
+    poll_result.store(0, std::memory_order_relaxed);
+
+    poll_timer = new timer_fd(std::chrono::milliseconds(period_ms), [this](){ dl1x_poll(); });
+    poll_timer->set_overrun_policy(PIT_OVERRUN_SKIP);
+    poll_timer->set_rt_policy(&policy);
+    poll_running.store(true, std::memory_order_release);
+    poll_timer->start();
+    return 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    停止后台采样
+ * @return   无
+ * @example  dl1x_dev.stop_poll();
+ *---------------------------------------------------------------------
+ */
+void zf_device_dl1x::stop_poll(void)
+{
+    if(NULL == poll_timer) return;
+    poll_running.store(false, std::memory_order_release);
+    poll_timer->stop();
+    delete poll_timer;
+    poll_timer = NULL;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读取后台采样结果
+ * @param    result      结果输出
+ * @return   0-结果有效 -1-无效
+ * @example  dl1x_dev.get_result(&r);
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_dl1x::get_result(dl1x_result_struct *result)
+{
+    if(NULL == result) return -1;
+    dl1x_result_unpack(poll_result.load(std::memory_order_acquire), result);
+    return (poll_running.load(std::memory_order_acquire) && result->valid) ? 0 : -1;
 }
@@ -14,11 +14,21 @@
 #define __zf_device_dl1x_hpp__
 
 #include "zf_driver_file_string.hpp"
+#include "zf_driver_sysfs_attr.hpp"
+#include "zf_driver_pit_fd.hpp"
 #include "zf_common_typedef.hpp"
 
 #define DL1X_EVENT_PATH         "/sys/bus/iio/devices/iio:device2/events/in_voltage_change_en"     // DL1X事件文件路径
 #define DL1X_DISTANCE_PATH      "/sys/bus/iio/devices/iio:device2/events/in_distance_raw"          // DL1X距离数据路径
 
+#define DL1X_POLL_PERIOD_MS     ( 20 )          // 后台采样默认周期 与传感器默认测量周期相当 更快只会读到重复值
+#define DL1X_FILTER_SIZE        ( 5 )           // 中值滤波窗口 可容忍窗口内 (DL1X_FILTER_SIZE - 1) / 2 个离群值
+#define DL1X_DISTANCE_MIN       ( 1 )           // 有效距离下限 mm 0为传感器未就绪
+#define DL1X_DISTANCE_MAX       ( 8000 )        // 有效距离上限 mm 超量程时传感器返回8190/8191等
+#define DL1X_OUTLIER_MM         ( 300 )         // 与当前中值相差超过此值的读数视为离群值丢弃
+#define DL1X_OUTLIER_ACCEPT     ( 3 )           // 连续此次数离群时认为距离确实突变 清空窗口重新开始
+#define DL1X_STALE_COUNT        ( 5 )           // 连续此次数没有可用读数时结果标记为无效
+
 // DL1X设备类型枚举
 enum dl1x_device_type_enum {
     NO_FIND_DEVICE = 0,
@@ -26,6 +36,14 @@ enum dl1x_device_type_enum {
     ZF_DEVICE_DL1B = 2,
 };
 
+// 后台采样结果
+typedef struct
+{
+    int16       distance;                       // 滤波后距离 mm
+    uint8       valid;                          // 1-有效 0-尚无读数或连续DL1X_STALE_COUNT次没有可用读数
+    uint64_t    timestamp_ns;                   // 最近一次被采纳的读数的时刻 time_now_ns 微秒精度
+}dl1x_result_struct;
+
 /*---------------------------------------------------------------------
  * @brief    DL1X测距传感器驱动类
  * @details  继承字符串文件操作类，适配Linux IIO框架读取测距数据
@@ -36,12 +54,25 @@ class zf_device_dl1x : public zf_driver_file_string
 {
 private:
     enum dl1x_device_type_enum  dl1x_dev_type;      // 设备类型
-    int        fd_distance;                          // 距离数据文件句柄
+    zf_driver_sysfs_attr attr_distance;              // 距离数据属性
 
-    // 私有化核心函数：通过文件句柄读取原始数据并转int16
-    int16 dl1x_read_fd_data(int fd);
+    timer_fd *poll_timer;                           // 后台采样定时器 运行中非NULL 只由start_poll/stop_poll访问
+    std::atomic<bool> poll_running;                 // 后台采样运行标志 读取接口据此选择数据来源
+    std::atomic<uint64_t> poll_result;              // 最新结果 低16位距离 第16位有效标志 高47位时间戳(us)
+    int16 filter_window[DL1X_FILTER_SIZE];          // 中值滤波窗口 以下成员只由采样线程访问
+    uint8 filter_count;                             // 窗口内读数个数
+    uint8 filter_index;                             // 下一个写入位置
+    uint8 outlier_count;                            // 连续离群次数
+    uint8 stale_count;                              // 连续无可用读数次数
+
+    // 私有化核心函数：读取距离属性原始数据并转int16
+    int16 dl1x_read_distance(void);
     // 私有化函数：关闭所有打开的文件句柄
     void dl1x_close_all_fd(void);
+    // 私有化函数：后台采样一次 滤波后发布
+    void dl1x_poll(void);
+    // 私有化函数：读数送入滤波器 返回0-被采纳 -1-被丢弃 distance为当前中值
+    int8 dl1x_filter(int16 raw, int16 *distance);
 
     // 禁用拷贝构造和赋值重载，规范约束
     zf_device_dl1x(const zf_device_dl1x&) = delete;
@@ -74,12 +105,56 @@ public:
 
     /*---------------------------------------------------------------------
      * @brief    读取测距传感器原始距离数据
-     * @return   距离原始值，未初始化返回0
+     * @details  后台采样运行时直接返回最新滤波结果 不访问文件系统
+     *           结果无效(尚无读数或连续DL1X_STALE_COUNT次没有可用读数)时返回0 不返回过时的距离
+     *           需要区分0与无效读数时使用read_distance
+     * @return   距离原始值，未初始化或结果无效返回0
      * @example  int16 distance = dl1x_dev.get_distance();
      *---------------------------------------------------------------------
      */
     int16 get_distance(void);
 
+    /*---------------------------------------------------------------------
+     * @brief    读取距离 区分无效读数
+     * @details  后台采样运行时取最新滤波结果 有效标志为0时返回-1
+     *           否则同步读取一次 读取失败或超出 DL1X_DISTANCE_MIN~DL1X_DISTANCE_MAX 时返回-1
+     * @param    distance    距离输出 mm 返回-1时为最近一次的值(可能为0或过时)
+     * @return   0-有效 -1-未初始化 读取失败或读数无效
+     * @example  int16 d; if(0 == dl1x_dev.read_distance(&d)) { ... }
+     *---------------------------------------------------------------------
+     */
+    int8 read_distance(int16 *distance);
+
+    /*---------------------------------------------------------------------
+     * @brief    启动后台采样
+     * @details  采样线程按period_ms读取距离 经离群剔除与中值滤波后原子发布
+     *           任意线程通过get_result/get_distance读取 无锁 无系统调用
+     *           采样线程为普通调度优先级 不与控制定时器抢占CPU
+     * @param    period_ms   采样周期 ms 按传感器测量周期设置
+     * @return   0-成功 -1-未初始化或已启动
+     * @example  dl1x_dev.init(); dl1x_dev.start_poll();
+     *---------------------------------------------------------------------
+     */
+    int8 start_poll(uint32 period_ms = DL1X_POLL_PERIOD_MS);
+
+    /*---------------------------------------------------------------------
+     * @brief    停止后台采样
+     * @details  之后get_distance恢复为同步读取
+     * @return   无
+     * @example  dl1x_dev.stop_poll();
+     *---------------------------------------------------------------------
+     */
+    void stop_poll(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    读取后台采样结果
+     * @param    result      结果输出 距离 有效标志 时间戳
+     * @return   0-结果有效 -1-无效(未启动 尚无读数或传感器连续无可用读数)
+     * @example  dl1x_result_struct r; if(0 == dl1x_dev.get_result(&r)) { ... }
+     *---------------------------------------------------------------------
+     */
+    int8 get_result(dl1x_result_struct *result);
+
     /*---------------------------------------------------------------------
      * @brief    DL1X设备初始化
      * @details  核心流程：写1初始化→读该文件获型号→打开距离文件
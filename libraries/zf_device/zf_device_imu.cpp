@@ -7,6 +7,7 @@
  *---------------------------------------------------------------------
  * @brief    IMU惯性测量单元驱动类实现文件
  *           包含设备初始化、型号识别、加速度计、陀螺仪、磁力计数据采集等功能的实现
+ *           以及IIO缓冲模式的通道配置、样本布局解析与批量读取
  *---------------------------------------------------------------------
  */
 
@@ -21,6 +22,64 @@
 #include <sys/stat.h>
 #include <sys/ioctl.h>
 #include <sys/uio.h>
+#include <poll.h>
+#include <dirent.h>
+#include "zf_common_time.hpp"
+#include "zf_common_function.hpp"
+
+// 各轴sysfs属性路径 顺序与imu_channel_enum一致
+static const char *imu_axis_path[IMU_CHANNEL_TIMESTAMP] =
+{
+    IMU_ACC_X_PATH,  IMU_ACC_Y_PATH,  IMU_ACC_Z_PATH,
+    IMU_GYRO_X_PATH, IMU_GYRO_Y_PATH, IMU_GYRO_Z_PATH,
+    IMU_MAG_X_PATH,  IMU_MAG_Y_PATH,  IMU_MAG_Z_PATH,
+};
+
+// scan_elements下的通道名 顺序与imu_channel_enum一致
+static const char *imu_channel_name[IMU_CHANNEL_NUM] =
+{
+    "in_accel_x",   "in_accel_y",   "in_accel_z",
+    "in_anglvel_x", "in_anglvel_y", "in_anglvel_z",
+    "in_magn_x",    "in_magn_y",    "in_magn_z",
+    "in_timestamp",
+};
+
+/*---------------------------------------------------------------------
+ * @brief    向sysfs属性文件写入字符串
+ * @param    path 文件路径
+ * @param    str  写入内容
+ * @return   0-成功 -1-失败
+ * @example  内部调用
+ *---------------------------------------------------------------------
+ */
+static int8 imu_sysfs_write(const char *path, const char *str)
+{
+    int fd = open(path, O_WRONLY);
+    if(fd < 0) return -1;
+    ssize_t len = write(fd, str, strlen(str));
+    close(fd);
+    return (len == (ssize_t)strlen(str)) ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读取sysfs属性文件内容
+ * @param    path 文件路径
+ * @param    buf  接收缓冲区 读取结果以'\0'结尾
+ * @param    size 缓冲区大小
+ * @return   0-成功 -1-失败
+ * @example  内部调用
+ *---------------------------------------------------------------------
+ */
+static int8 imu_sysfs_read(const char *path, char *buf, uint32 size)
+{
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return -1;
+    ssize_t len = read(fd, buf, size - 1);
+    close(fd);
+    if(len <= 0) return -1;
+    buf[len] = '\0';
+    return 0;
+}
 
 /*---------------------------------------------------------------------
  * @brief    构造函数
@@ -31,10 +90,15 @@
 zf_device_imu::zf_device_imu(void) : zf_driver_file_string(NULL, "r")
 {
     imu_type = DEV_NO_FIND;     // 枚举体初始化
-    // 所有传感器文件句柄初始化为无效值-1
-    fd_acc_x = -1; fd_acc_y = -1; fd_acc_z = -1;
-    fd_gyro_x = -1; fd_gyro_y = -1; fd_gyro_z = -1;
-    fd_mag_x = -1; fd_mag_y = -1; fd_mag_z = -1;
+    // 各轴属性对象构造时未打开文件
+
+    // 缓冲模式默认关闭
+    fd_buffer = -1;
+    iio_dir[0] = '\0';
+    scan_size = 0;
+    buffer_pending = 0;
+    memset(scan_channel, 0, sizeof(scan_channel));
+    memset(&last_sample, 0, sizeof(last_sample));
 }
 
 /*---------------------------------------------------------------------
@@ -45,6 +109,7 @@ zf_device_imu::zf_device_imu(void) : zf_driver_file_string(NULL, "r")
  */
 zf_device_imu::~zf_device_imu(void)
 {
+    deinit_buffer();
     imu_close_all_fd();
 }
 
@@ -56,38 +121,25 @@ zf_device_imu::~zf_device_imu(void)
  */
 void zf_device_imu::imu_close_all_fd(void)
 {
-    if(fd_acc_x > 0) close(fd_acc_x);
-    if(fd_acc_y > 0) close(fd_acc_y);
-    if(fd_acc_z > 0) close(fd_acc_z);
-    if(fd_gyro_x > 0) close(fd_gyro_x);
-    if(fd_gyro_y > 0) close(fd_gyro_y);
-    if(fd_gyro_z > 0) close(fd_gyro_z);
-    if(fd_mag_x > 0) close(fd_mag_x);
-    if(fd_mag_y > 0) close(fd_mag_y);
-    if(fd_mag_z > 0) close(fd_mag_z);
-
-    // 句柄重置为无效值
-    fd_acc_x = -1; fd_acc_y = -1; fd_acc_z = -1;
-    fd_gyro_x = -1; fd_gyro_y = -1; fd_gyro_z = -1;
-    fd_mag_x = -1; fd_mag_y = -1; fd_mag_z = -1;
+    for(int i = 0; i < IMU_CHANNEL_TIMESTAMP; i ++)
+    {
+        attr_axis[i].close_path();
+    }
 }
 
 /*---------------------------------------------------------------------
- * @brief    通过文件句柄读取传感器原始数据并转int16
- * @param    fd 已打开的传感器文件句柄
- * @return   转换后的传感器原始值，句柄无效/未初始化返回0
+ * @brief    读取一个轴的sysfs原始数据并转int16
+ * @param    channel 轴编号
+ * @return   转换后的传感器原始值，未打开/未初始化返回0
  * @example  内部调用
  *---------------------------------------------------------------------
  */
-int16 zf_device_imu::imu_read_fd_data(int fd)
+int16 zf_device_imu::imu_read_axis(imu_channel_enum channel)
 {
-    if(imu_type == DEV_NO_FIND || fd < 0) return 0;
-    char str[20] = {0};
-
-    lseek(fd, 0, SEEK_SET);          // 关键：偏移到文件头，保证读最新值
-    if(read(fd, str, sizeof(str)-1) <= 0) return 0;
-
-    return atoi(str);
+    int32 value = 0;
+    if(imu_type == DEV_NO_FIND) return 0;
+    if(0 != attr_axis[channel].read_int(&value)) return 0;   // pread一次取得最新值 无需lseek
+    return (int16)value;
 }
 
 /*---------------------------------------------------------------------
@@ -100,8 +152,9 @@ int16 zf_device_imu::imu_read_fd_data(int fd)
 imu_device_type_enum zf_device_imu::init(void)
 {
     int fd_event = -1;
-    char read_buf[10] = {0};
-    int read_val = DEV_NO_FIND;
+    char read_buf[10];
+    ssize_t read_len = 0;
+    int32 read_val = DEV_NO_FIND;
 
     // 第一步：写入1 执行IMU硬件初始化
     fd_event = open(IMU_EVENT_PATH, O_RDWR);  // 读写模式打开：先写后读
@@ -122,9 +175,10 @@ imu_device_type_enum zf_device_imu::init(void)
 
     // 第二步：读取该文件的值 获取设备型号
     lseek(fd_event, 0, SEEK_SET);  // 写后读，必须偏移到文件头
-    if(read(fd_event, read_buf, sizeof(read_buf)-1) > 0)
+    read_len = read(fd_event, read_buf, sizeof(read_buf));
+    if(read_len > 0)
     {
-        read_val = atoi(read_buf); // 字符串转整型，直接映射枚举值
+        func_parse_int(read_buf, (size_t)read_len, &read_val); // 按读到的长度解析，直接映射枚举值
     }
     close(fd_event); // 立即关闭事件文件句柄，无泄漏
     fd_event = -1;
@@ -159,41 +213,22 @@ imu_device_type_enum zf_device_imu::init(void)
 
     // 第三步：按型号动态打开对应传感器文件
     // 所有型号都默认打开 加速度+陀螺仪 6个文件，这是基础功能
-    fd_acc_x  = open(IMU_ACC_X_PATH,  O_RDONLY);
-    fd_acc_y  = open(IMU_ACC_Y_PATH,  O_RDONLY);
-    fd_acc_z  = open(IMU_ACC_Z_PATH,  O_RDONLY);
-    fd_gyro_x = open(IMU_GYRO_X_PATH, O_RDONLY);
-    fd_gyro_y = open(IMU_GYRO_Y_PATH, O_RDONLY);
-    fd_gyro_z = open(IMU_GYRO_Z_PATH, O_RDONLY);
-
     // 只有 IMU963RA 才打开磁力计3个文件，660系列不打开，节省资源
-    if(imu_type == DEV_IMU963RA)
+    int axis_num = (imu_type == DEV_IMU963RA) ? IMU_CHANNEL_TIMESTAMP : IMU_CHANNEL_MAG_X;
+    for(int i = 0; i < axis_num; i ++)
     {
-        fd_mag_x  = open(IMU_MAG_X_PATH,  O_RDONLY);
-        fd_mag_y  = open(IMU_MAG_Y_PATH,  O_RDONLY);
-        fd_mag_z  = open(IMU_MAG_Z_PATH,  O_RDONLY);
+        attr_axis[i].open_path(imu_axis_path[i]);
     }
 
-    // 第四步：校验文件句柄有效性
-    if(imu_type == DEV_IMU660RA || imu_type == DEV_IMU660RB)
+    // 第四步：校验文件句柄有效性 660系列只校验加速度+陀螺仪 963系列校验所有9个文件
+    for(int i = 0; i < axis_num; i ++)
     {
-        // 660系列只校验加速度+陀螺仪
-        if(fd_acc_x<0 || fd_acc_y<0 || fd_acc_z<0 || fd_gyro_x<0 || fd_gyro_y<0 || fd_gyro_z<0)
+        if(!attr_axis[i].is_open())
         {
-            std::cerr << "IMU打开加速度/陀螺仪文件失败" << std::endl;
-            imu_close_all_fd();
-            imu_type = DEV_NO_FIND;
-        }
-    }
-    else if(imu_type == DEV_IMU963RA)
-    {
-        // 963系列校验所有9个文件
-        if(fd_acc_x<0 || fd_acc_y<0 || fd_acc_z<0 || fd_gyro_x<0 || fd_gyro_y<0 || fd_gyro_z<0 ||
-           fd_mag_x<0 || fd_mag_y<0 || fd_mag_z<0)
-        {
-            std::cerr << "IMU打开所有传感器文件失败" << std::endl;
+            std::cerr << "IMU打开传感器文件失败: " << imu_axis_path[i] << std::endl;
             imu_close_all_fd();
             imu_type = DEV_NO_FIND;
+            break;
         }
     }
 
@@ -217,7 +252,7 @@ imu_device_type_enum zf_device_imu::get_dev_type(void)
  * @example  int16 ax = imu_dev.get_acc_x();
  *---------------------------------------------------------------------
  */
-int16 zf_device_imu::get_acc_x(void) { return imu_read_fd_data(fd_acc_x); }
+int16 zf_device_imu::get_acc_x(void) { return (fd_buffer >= 0) ? last_sample.acc[0] : imu_read_axis(IMU_CHANNEL_ACC_X); }
 
 /*---------------------------------------------------------------------
  * @brief    读取加速度Y轴原始数据
@@ -225,7 +260,7 @@ int16 zf_device_imu::get_acc_x(void) { return imu_read_fd_data(fd_acc_x); }
  * @example  int16 ay = imu_dev.get_acc_y();
  *---------------------------------------------------------------------
  */
-int16 zf_device_imu::get_acc_y(void) { return imu_read_fd_data(fd_acc_y); }
+int16 zf_device_imu::get_acc_y(void) { return (fd_buffer >= 0) ? last_sample.acc[1] : imu_read_axis(IMU_CHANNEL_ACC_Y); }
 
 /*---------------------------------------------------------------------
  * @brief    读取加速度Z轴原始数据
@@ -233,7 +268,7 @@ int16 zf_device_imu::get_acc_y(void) { return imu_read_fd_data(fd_acc_y); }
  * @example  int16 az = imu_dev.get_acc_z();
  *---------------------------------------------------------------------
  */
-int16 zf_device_imu::get_acc_z(void) { return imu_read_fd_data(fd_acc_z); }
+int16 zf_device_imu::get_acc_z(void) { return (fd_buffer >= 0) ? last_sample.acc[2] : imu_read_axis(IMU_CHANNEL_ACC_Z); }
 
 /*---------------------------------------------------------------------
  * @brief    读取角速度X轴原始数据
@@ -241,7 +276,7 @@ int16 zf_device_imu::get_acc_z(void) { return imu_read_fd_data(fd_acc_z); }
  * @example  int16 gx = imu_dev.get_gyro_x();
  *---------------------------------------------------------------------
  */
-int16 zf_device_imu::get_gyro_x(void) { return imu_read_fd_data(fd_gyro_x); }
+int16 zf_device_imu::get_gyro_x(void) { return (fd_buffer >= 0) ? last_sample.gyro[0] : imu_read_axis(IMU_CHANNEL_GYRO_X); }
 
 /*---------------------------------------------------------------------
  * @brief    读取角速度Y轴原始数据
@@ -249,7 +284,7 @@ int16 zf_device_imu::get_gyro_x(void) { return imu_read_fd_data(fd_gyro_x); }
  * @example  int16 gy = imu_dev.get_gyro_y();
  *---------------------------------------------------------------------
  */
-int16 zf_device_imu::get_gyro_y(void) { return imu_read_fd_data(fd_gyro_y); }
+int16 zf_device_imu::get_gyro_y(void) { return (fd_buffer >= 0) ? last_sample.gyro[1] : imu_read_axis(IMU_CHANNEL_GYRO_Y); }
 
 /*---------------------------------------------------------------------
  * @brief    读取角速度Z轴原始数据
@@ -257,7 +292,7 @@ int16 zf_device_imu::get_gyro_y(void) { return imu_read_fd_data(fd_gyro_y); }
  * @example  int16 gz = imu_dev.get_gyro_z();
  *---------------------------------------------------------------------
  */
-int16 zf_device_imu::get_gyro_z(void) { return imu_read_fd_data(fd_gyro_z); }
+int16 zf_device_imu::get_gyro_z(void) { return (fd_buffer >= 0) ? last_sample.gyro[2] : imu_read_axis(IMU_CHANNEL_GYRO_Z); }
 
 /*---------------------------------------------------------------------
  * @brief    读取磁力计X轴原始数据
@@ -268,7 +303,8 @@ int16 zf_device_imu::get_gyro_z(void) { return imu_read_fd_data(fd_gyro_z); }
 int16 zf_device_imu::get_mag_x(void)
 {
     if(imu_type != DEV_IMU963RA) return 0;
-    return imu_read_fd_data(fd_mag_x);
+    if(fd_buffer >= 0) return last_sample.mag[0];
+    return imu_read_axis(IMU_CHANNEL_MAG_X);
 }
 
 /*---------------------------------------------------------------------
@@ -280,7 +316,8 @@ int16 zf_device_imu::get_mag_x(void)
 int16 zf_device_imu::get_mag_y(void)
 {
     if(imu_type != DEV_IMU963RA) return 0;
-    return imu_read_fd_data(fd_mag_y);
+    if(fd_buffer >= 0) return last_sample.mag[1];
+    return imu_read_axis(IMU_CHANNEL_MAG_Y);
 }
 
 /*---------------------------------------------------------------------
@@ -292,5 +329,378 @@ int16 zf_device_imu::get_mag_y(void)
 int16 zf_device_imu::get_mag_z(void)
 {
     if(imu_type != DEV_IMU963RA) return 0;
-    return imu_read_fd_data(fd_mag_z);
+    if(fd_buffer >= 0) return last_sample.mag[2];
+    return imu_read_axis(IMU_CHANNEL_MAG_Z);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读取scan_elements配置并计算样本布局
+ * @details  启用本驱动关心的通道 关闭其余通道 按scan_index排列
+ *           每个通道按自身存储字节数对齐 样本总长按最大通道对齐(IIO规则)
+ * @return   0-成功 -1-失败
+ * @example  内部调用
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_imu::imu_scan_setup(void)
+{
+    char path[160] = {0};
+    char value[32] = {0};
+    char endian = 0, sign = 0;
+    unsigned int bits = 0, storage = 0, shift = 0;
+    DIR *dir = NULL;
+    struct dirent *entry = NULL;
+    uint16 offset = 0;
+    uint8 align_max = 1;
+    uint8 placed[IMU_CHANNEL_NUM] = {0};
+
+    memset(scan_channel, 0, sizeof(scan_channel));
+
+    // 关闭其他通道(如温度) 避免其改变样本布局
+    snprintf(path, sizeof(path), "%s/scan_elements", iio_dir);
+    dir = opendir(path);
+    if(NULL == dir)
+    {
+        std::cerr << "IMU打开scan_elements失败: " << path << ", errno:" << errno << std::endl;
+        return -1;
+    }
+    while(NULL != (entry = readdir(dir)))
+    {
+        size_t len = strlen(entry->d_name);
+        if(len < 4 || 0 != strcmp(entry->d_name + len - 3, "_en")) continue;
+        snprintf(path, sizeof(path), "%s/scan_elements/%s", iio_dir, entry->d_name);
+        imu_sysfs_write(path, "0");
+    }
+    closedir(dir);
+
+    for(int i = 0; i < IMU_CHANNEL_NUM; i ++)
+    {
+        imu_scan_channel_struct *channel = &scan_channel[i];
+
+        // 磁力计等通道在部分型号上不存在 启用失败即跳过
+        snprintf(path, sizeof(path), "%s/scan_elements/%s_en", iio_dir, imu_channel_name[i]);
+        if(0 != imu_sysfs_write(path, "1")) continue;
+
+        snprintf(path, sizeof(path), "%s/scan_elements/%s_index", iio_dir, imu_channel_name[i]);
+        if(0 != imu_sysfs_read(path, value, sizeof(value))) continue;
+        channel->index = func_str_to_int(value);
+
+        // 格式 [be|le]:[s|u]bits/storagebits>>shift 例如 le:s16/16>>0
+        snprintf(path, sizeof(path), "%s/scan_elements/%s_type", iio_dir, imu_channel_name[i]);
+        if(0 != imu_sysfs_read(path, value, sizeof(value))) continue;
+        if(5 != sscanf(value, "%ce:%c%u/%u>>%u", &endian, &sign, &bits, &storage, &shift) ||
+           0 == storage || 64 < storage || 0 != storage % 8 || 0 == bits || storage < bits + shift)
+        {
+            std::cerr << "IMU通道格式无法解析: " << imu_channel_name[i] << " " << value << std::endl;
+            continue;
+        }
+        channel->is_signed  = ('s' == sign);
+        channel->big_endian = ('b' == endian);
+        channel->bytes      = storage / 8;
+        channel->bits       = bits;
+        channel->shift      = shift;
+        channel->enable     = 1;
+    }
+
+    for(int i = IMU_CHANNEL_ACC_X; i <= IMU_CHANNEL_GYRO_Z; i ++)
+    {
+        if(!scan_channel[i].enable)
+        {
+            std::cerr << "IMU缓冲模式缺少通道: " << imu_channel_name[i] << std::endl;
+            return -1;
+        }
+    }
+
+    // 按scan_index从小到大依次分配偏移
+    for(int n = 0; n < IMU_CHANNEL_NUM; n ++)
+    {
+        int next = -1;
+        for(int i = 0; i < IMU_CHANNEL_NUM; i ++)
+        {
+            if(!scan_channel[i].enable || placed[i]) continue;
+            if(next < 0 || scan_channel[i].index < scan_channel[next].index) next = i;
+        }
+        if(next < 0) break;
+        placed[next] = 1;
+        offset = (offset + scan_channel[next].bytes - 1) / scan_channel[next].bytes * scan_channel[next].bytes;
+        scan_channel[next].offset = offset;
+        offset += scan_channel[next].bytes;
+        if(scan_channel[next].bytes > align_max) align_max = scan_channel[next].bytes;
+    }
+
+    scan_size = (offset + align_max - 1) / align_max * align_max;
+    if(scan_size > IMU_SCAN_SIZE_MAX)
+    {
+        std::cerr << "IMU样本长度超出范围: " << scan_size << std::endl;
+        return -1;
+    }
+    return 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    按样本布局把一个样本解析为结构体
+ * @param    scan    样本起始地址
+ * @param    sample  解析结果
+ * @return   无
+ * @example  内部调用
+ *---------------------------------------------------------------------
+ */
+void zf_device_imu::imu_scan_parse(const uint8 *scan, imu_sample_struct *sample)
+{
+    memset(sample, 0, sizeof(imu_sample_struct));
+    for(int i = 0; i < IMU_CHANNEL_NUM; i ++)
+    {
+        const imu_scan_channel_struct *channel = &scan_channel[i];
+        const uint8 *data = scan + channel->offset;
+        uint64_t raw = 0;
+
+        if(!channel->enable) continue;
+        for(int b = 0; b < channel->bytes; b ++)
+        {
+            raw = (raw << 8) | data[channel->big_endian ? b : channel->bytes - 1 - b];
+        }
+        raw >>= channel->shift;
+        if(channel->bits < 64)
+        {
+            raw &= (1ULL << channel->bits) - 1;
+            if(channel->is_signed && (raw >> (channel->bits - 1)) & 1)
+            {
+                raw |= ~0ULL << channel->bits;                                  // 符号扩展
+            }
+        }
+
+        if(i <= IMU_CHANNEL_ACC_Z)          sample->acc[i - IMU_CHANNEL_ACC_X]   = (int16)raw;
+        else if(i <= IMU_CHANNEL_GYRO_Z)    sample->gyro[i - IMU_CHANNEL_GYRO_X] = (int16)raw;
+        else if(i <= IMU_CHANNEL_MAG_Z)     sample->mag[i - IMU_CHANNEL_MAG_X]   = (int16)raw;
+        else                                sample->timestamp_ns = (int64_t)raw;
+    }
+}
+
+/*---------------------------------------------------------------------
+ * @brief    关闭本驱动启用的scan_elements通道
+ * @details  缓冲区必须已关闭 不存在的通道写入失败直接忽略
+ * @return   无
+ * @example  内部调用
+ *---------------------------------------------------------------------
+ */
+void zf_device_imu::imu_scan_disable(void)
+{
+    char path[160] = {0};
+
+    for(int i = 0; i < IMU_CHANNEL_NUM; i ++)
+    {
+        snprintf(path, sizeof(path), "%s/scan_elements/%s_en", iio_dir, imu_channel_name[i]);
+        imu_sysfs_write(path, "0");
+    }
+    memset(scan_channel, 0, sizeof(scan_channel));
+    scan_size = 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    启用IIO缓冲模式
+ * @details  先关闭缓冲区才能修改通道与触发器 时间戳时钟切换为monotonic
+ *           与time_now_ns同一时间基准 不支持时保持内核默认
+ *           任一步失败时关闭缓冲区与已启用的通道
+ * @param    trigger_name   触发器名称 NULL表示保留当前触发器
+ * @param    buffer_length  内核缓冲区长度 单位样本
+ * @param    dir            IIO设备sysfs目录
+ * @param    dev_path       IIO缓冲数据字符设备
+ * @return   0-成功 -1-失败
+ * @example  imu_dev.init_buffer();
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_imu::init_buffer(const char *trigger_name, uint32 buffer_length, const char *dir, const char *dev_path)
+{
+    char path[160] = {0};
+    char value[16] = {0};
+    int8 return_state = -1;
+
+    deinit_buffer();
+    snprintf(iio_dir, sizeof(iio_dir), "%s", dir);
+
+    do
+    {
+        snprintf(path, sizeof(path), "%s/buffer/enable", iio_dir);
+        imu_sysfs_write(path, "0");
+
+        if(0 != imu_scan_setup()) break;
+
+        if(NULL != trigger_name)
+        {
+            snprintf(path, sizeof(path), "%s/trigger/current_trigger", iio_dir);
+            if(0 != imu_sysfs_write(path, trigger_name))
+            {
+                std::cerr << "IMU设置触发器失败: " << trigger_name << ", errno:" << errno << std::endl;
+                break;
+            }
+        }
+
+        snprintf(path, sizeof(path), "%s/buffer/length", iio_dir);
+        snprintf(value, sizeof(value), "%u", buffer_length);
+        if(0 != imu_sysfs_write(path, value))
+        {
+            std::cerr << "IMU设置缓冲区长度失败, errno:" << errno << std::endl;
+            break;
+        }
+
+        snprintf(path, sizeof(path), "%s/current_timestamp_clock", iio_dir);
+        imu_sysfs_write(path, "monotonic");
+
+        snprintf(path, sizeof(path), "%s/buffer/enable", iio_dir);
+        if(0 != imu_sysfs_write(path, "1"))
+        {
+            std::cerr << "IMU启用缓冲区失败, errno:" << errno << std::endl;
+            break;
+        }
+
+        fd_buffer = open(dev_path, O_RDONLY | O_NONBLOCK);
+        if(fd_buffer < 0)
+        {
+            std::cerr << "IMU打开缓冲数据设备失败: " << dev_path << ", errno:" << errno << std::endl;
+            imu_sysfs_write(path, "0");
+            break;
+        }
+
+        buffer_pending = 0;
+        memset(&last_sample, 0, sizeof(last_sample));
+        return_state = 0;
+        std::cout << "IMU缓冲模式已启用, 样本长度: " << scan_size << " 字节"
+                  << (scan_channel[IMU_CHANNEL_MAG_X].enable ? ", 含磁力计" : "")
+                  << (scan_channel[IMU_CHANNEL_TIMESTAMP].enable ? ", 含时间戳" : "") << std::endl;
+    }while(0);
+
+    if(0 != return_state)
+    {
+        imu_scan_disable();                                                     // 失败时不留下已启用的通道
+    }
+    return return_state;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    关闭IIO缓冲模式
+ * @return   无
+ * @example  imu_dev.deinit_buffer();
+ *---------------------------------------------------------------------
+ */
+void zf_device_imu::deinit_buffer(void)
+{
+    char path[160] = {0};
+
+    if(fd_buffer < 0) return;
+    close(fd_buffer);
+    fd_buffer = -1;
+    snprintf(path, sizeof(path), "%s/buffer/enable", iio_dir);
+    imu_sysfs_write(path, "0");
+}
+
+/*---------------------------------------------------------------------
+ * @brief    批量读取缓冲模式样本
+ * @details  不完整的样本留在接收缓冲区 与下一次读取拼接(FIFO替身可能分段写入)
+ * @param    sample      样本数组
+ * @param    count       数组长度 超过IMU_BATCH_MAX时按IMU_BATCH_MAX读取
+ * @param    timeout_ms  等待时间 0-不等待 -1-一直等待
+ * @return   读到的样本数 0-超时 -1-错误或未启用缓冲模式
+ * @example  int n = imu_dev.read_samples(s, 16, 10);
+ *---------------------------------------------------------------------
+ */
+int zf_device_imu::read_samples(imu_sample_struct *sample, uint32 count, int timeout_ms)
+{
+    struct pollfd pfd;
+    ssize_t len = 0;
+    uint32 num = 0;
+
+    if(fd_buffer < 0 || NULL == sample || 0 == count) return -1;
+    if(count > IMU_BATCH_MAX) count = IMU_BATCH_MAX;
+
+    if(0 != timeout_ms)
+    {
+        pfd.fd = fd_buffer;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ret = poll(&pfd, 1, timeout_ms);
+        if(ret == 0 || (ret < 0 && errno == EINTR)) return 0;
+        if(ret < 0)
+        {
+            perror("imu poll");
+            return -1;
+        }
+    }
+
+    len = read(fd_buffer, iio_buffer + buffer_pending, count * scan_size - buffer_pending);
+    if(len < 0)
+    {
+        if(errno == EAGAIN || errno == EINTR) return 0;
+        perror("imu read");
+        return -1;
+    }
+    if(len == 0) return -1;                                                     // 写端关闭
+
+    buffer_pending += len;
+    num = buffer_pending / scan_size;
+    for(uint32 i = 0; i < num; i ++)
+    {
+        imu_scan_parse(iio_buffer + i * scan_size, &sample[i]);
+    }
+    if(num > 0)
+    {
+        buffer_pending -= num * scan_size;
+        memmove(iio_buffer, iio_buffer + num * scan_size, buffer_pending);
+        last_sample = sample[num - 1];
+    }
+    return num;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读取一个缓冲模式样本
+ * @param    sample      样本
+ * @param    timeout_ms  等待时间 0-不等待 -1-一直等待
+ * @return   0-成功 -1-超时或错误
+ * @example  imu_dev.read_sample(&s, -1);
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_imu::read_sample(imu_sample_struct *sample, int timeout_ms)
+{
+    return (1 == read_samples(sample, 1, timeout_ms)) ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    通过sysfs连续读取全部轴
+ * @details  各轴依次pread 磁力计只在IMU963RA上读取
+ * @param    sample      样本
+ * @return   0-成功 -1-未初始化或有轴读取失败
+ * @example  imu_dev.read_sysfs_sample(&s);
+ *---------------------------------------------------------------------
+ */
+int8 zf_device_imu::read_sysfs_sample(imu_sample_struct *sample)
+{
+    zf_driver_sysfs_attr *axis[IMU_CHANNEL_TIMESTAMP];
+    int32 value[IMU_CHANNEL_TIMESTAMP];
+    uint32 axis_num = (imu_type == DEV_IMU963RA) ? IMU_CHANNEL_TIMESTAMP : IMU_CHANNEL_MAG_X;
+
+    if(imu_type == DEV_NO_FIND || NULL == sample) return -1;
+    for(uint32 i = 0; i < axis_num; i ++)
+    {
+        axis[i] = &attr_axis[i];
+    }
+    uint32 success = zf_driver_sysfs_attr::read_int_batch(axis, value, axis_num);
+
+    memset(sample, 0, sizeof(imu_sample_struct));
+    for(uint32 i = 0; i < axis_num; i ++)
+    {
+        if(i <= IMU_CHANNEL_ACC_Z)          sample->acc[i - IMU_CHANNEL_ACC_X]   = (int16)value[i];
+        else if(i <= IMU_CHANNEL_GYRO_Z)    sample->gyro[i - IMU_CHANNEL_GYRO_X] = (int16)value[i];
+        else                                sample->mag[i - IMU_CHANNEL_MAG_X]   = (int16)value[i];
+    }
+    sample->timestamp_ns = (int64_t)time_now_ns();
+    return (success == axis_num) ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    获取IIO缓冲模式数据句柄
+ * @return   字符设备句柄 未启用缓冲模式返回-1
+ * @example  int fd = imu_dev.get_buffer_fd();
+ *---------------------------------------------------------------------
+ */
+int zf_device_imu::get_buffer_fd(void)
+{
+    return fd_buffer;
 }
@@ -8,6 +8,7 @@
  * @brief    IMU惯性测量单元驱动类，基于Linux IIO框架实现
  *           支持IMU660RA/RB/RC和IMU963RA型号自动识别
  *           包含加速度计、陀螺仪、磁力计数据采集功能
+ *           支持IIO缓冲模式：一次read()取得全部轴与内核时间戳
  *---------------------------------------------------------------------
  */
 
@@ -15,6 +16,7 @@
 #define __zf_device_imu_hpp__
 
 #include "zf_driver_file_string.hpp"
+#include "zf_driver_sysfs_attr.hpp"
 #include "zf_common_typedef.hpp"
 
 // IMU IIO框架路径宏定义
@@ -29,6 +31,29 @@
 #define IMU_MAG_Y_PATH          "/sys/bus/iio/devices/iio:device1/in_magn_y_raw"                   // 磁力计Y轴路径
 #define IMU_MAG_Z_PATH          "/sys/bus/iio/devices/iio:device1/in_magn_z_raw"                   // 磁力计Z轴路径
 
+// IMU IIO缓冲模式宏定义
+#define IMU_IIO_DIR             "/sys/bus/iio/devices/iio:device1"                                 // IIO设备sysfs目录
+#define IMU_IIO_DEV_PATH        "/dev/iio:device1"                                                 // IIO缓冲数据字符设备
+#define IMU_BUFFER_LENGTH       ( 128 )                                                            // 内核缓冲区默认长度 单位样本
+#define IMU_BATCH_MAX           ( 64 )                                                             // 一次read()最多取出的样本数
+#define IMU_SCAN_SIZE_MAX       ( 128 )                                                            // 单个样本最大字节数
+
+// IIO缓冲模式通道编号 对应scan_elements下的通道名
+typedef enum
+{
+    IMU_CHANNEL_ACC_X = 0,
+    IMU_CHANNEL_ACC_Y,
+    IMU_CHANNEL_ACC_Z,
+    IMU_CHANNEL_GYRO_X,
+    IMU_CHANNEL_GYRO_Y,
+    IMU_CHANNEL_GYRO_Z,
+    IMU_CHANNEL_MAG_X,
+    IMU_CHANNEL_MAG_Y,
+    IMU_CHANNEL_MAG_Z,
+    IMU_CHANNEL_TIMESTAMP,
+    IMU_CHANNEL_NUM
+}imu_channel_enum;
+
 // IMU设备类型枚举
 typedef enum
 {
@@ -39,31 +64,61 @@ typedef enum
     DEV_IMU963RA   = 4     // IMU963RA型号(带磁力计)
 }imu_device_type_enum;
 
+// 一次采样的全部数据 各轴来自同一时刻
+typedef struct
+{
+    int16   acc[3];                 // 加速度XYZ原始值
+    int16   gyro[3];                // 角速度XYZ原始值
+    int16   mag[3];                 // 磁力计XYZ原始值 未启用磁力计通道时为0
+    int64_t timestamp_ns;           // 内核采样时间戳 单位ns 未启用时间戳通道时为0
+}imu_sample_struct;
+
+// scan_elements中单个通道在样本内的布局
+typedef struct
+{
+    uint8   enable;                 // 通道是否存在并已启用
+    uint8   is_signed;              // 1-有符号
+    uint8   big_endian;             // 1-大端
+    uint8   bytes;                  // 存储字节数
+    uint8   bits;                   // 有效位数
+    uint8   shift;                  // 右移位数
+    uint16  offset;                 // 在样本内的字节偏移
+    int     index;                  // scan_index 决定通道在样本内的顺序
+}imu_scan_channel_struct;
+
 /*---------------------------------------------------------------------
  * @brief    IMU惯性测量单元驱动类
  * @details  继承字符串文件操作类，适配Linux IIO框架读取IMU数据
  *           支持IMU660系列和IMU963RA型号自动识别
  *           按型号动态打开文件，无重复IO操作，性能最优
+ *           启用缓冲模式后get_acc_x等返回最近一次read_samples读到的样本
  *---------------------------------------------------------------------
  */
 class zf_device_imu : public zf_driver_file_string
 {
 private:
-    int     fd_acc_x;               // 加速度X轴文件句柄
-    int     fd_acc_y;               // 加速度Y轴文件句柄
-    int     fd_acc_z;               // 加速度Z轴文件句柄
-    int     fd_gyro_x;              // 角速度X轴文件句柄
-    int     fd_gyro_y;              // 角速度Y轴文件句柄
-    int     fd_gyro_z;              // 角速度Z轴文件句柄
-    int     fd_mag_x;               // 磁力计X轴文件句柄
-    int     fd_mag_y;               // 磁力计Y轴文件句柄
-    int     fd_mag_z;               // 磁力计Z轴文件句柄
-
-    // 私有化核心函数：通过文件句柄读取原始数据并转int16
-    int16 imu_read_fd_data(int fd);
+    zf_driver_sysfs_attr attr_axis[IMU_CHANNEL_TIMESTAMP];     // 各轴sysfs属性 按imu_channel_enum编号
+
+    // 私有化核心函数：读取一个轴的sysfs原始数据并转int16
+    int16 imu_read_axis(imu_channel_enum channel);
     // 私有化函数：关闭所有打开的文件句柄
     void imu_close_all_fd(void);
 
+    int     fd_buffer;              // IIO缓冲数据字符设备句柄 -1表示未启用缓冲模式
+    char    iio_dir[64];            // 启用缓冲模式时使用的sysfs目录
+    uint16  scan_size;              // 单个样本字节数
+    uint32  buffer_pending;         // iio_buffer中尚未解析的字节数
+    imu_scan_channel_struct scan_channel[IMU_CHANNEL_NUM];
+    imu_sample_struct       last_sample;                    // 最近一次读取的样本 缓冲模式下get_acc_x等返回该值
+    uint8   iio_buffer[IMU_BATCH_MAX * IMU_SCAN_SIZE_MAX];  // read()接收缓冲区
+
+    // 私有化函数：读取scan_elements配置并计算样本布局
+    int8 imu_scan_setup(void);
+    // 私有化函数：按样本布局把一个样本解析为结构体
+    void imu_scan_parse(const uint8 *scan, imu_sample_struct *sample);
+    // 私有化函数：关闭本驱动启用的scan_elements通道
+    void imu_scan_disable(void);
+
     // 禁用拷贝构造和赋值重载，规范约束
     zf_device_imu(const zf_device_imu&) = delete;
     zf_device_imu& operator=(const zf_device_imu&) = delete;
@@ -175,6 +230,74 @@ public:
      *---------------------------------------------------------------------
      */
     imu_device_type_enum init(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    启用IIO缓冲模式
+     * @details  启用scan_elements中存在的加速度/陀螺仪/磁力计/时间戳通道
+     *           设置触发器与内核缓冲区长度后打开字符设备
+     *           之后read_samples一次read()取得多个完整样本
+     *           失败时保持sysfs读取方式不变
+     * @param    trigger_name   触发器名称 写入trigger/current_trigger
+     *                          传NULL表示保留驱动当前的触发器(如自带数据就绪触发器)
+     * @param    buffer_length  内核缓冲区长度 单位样本
+     * @param    dir            IIO设备sysfs目录
+     * @param    dev_path       IIO缓冲数据字符设备 可替换为输出相同二进制格式的FIFO用于主机测试
+     * @return   0-成功 -1-失败
+     * @example  imu_dev.init(); imu_dev.init_buffer();
+     *---------------------------------------------------------------------
+     */
+    int8 init_buffer(const char *trigger_name = NULL, uint32 buffer_length = IMU_BUFFER_LENGTH,
+                     const char *dir = IMU_IIO_DIR, const char *dev_path = IMU_IIO_DEV_PATH);
+
+    /*---------------------------------------------------------------------
+     * @brief    关闭IIO缓冲模式
+     * @details  关闭内核缓冲区并关闭字符设备 之后get_acc_x等恢复sysfs读取
+     * @return   无
+     * @example  imu_dev.deinit_buffer();
+     *---------------------------------------------------------------------
+     */
+    void deinit_buffer(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    批量读取缓冲模式样本
+     * @details  一次read()取出内核缓冲区中已有的样本 最多count个
+     *           缓冲区为空时最多等待timeout_ms
+     * @param    sample      样本数组
+     * @param    count       数组长度
+     * @param    timeout_ms  等待时间 0-不等待 -1-一直等待
+     * @return   读到的样本数 0-超时 -1-错误或未启用缓冲模式
+     * @example  imu_sample_struct s[16]; int n = imu_dev.read_samples(s, 16, 10);
+     *---------------------------------------------------------------------
+     */
+    int read_samples(imu_sample_struct *sample, uint32 count, int timeout_ms);
+
+    /*---------------------------------------------------------------------
+     * @brief    读取一个缓冲模式样本
+     * @param    sample      样本
+     * @param    timeout_ms  等待时间 0-不等待 -1-一直等待
+     * @return   0-成功 -1-超时或错误
+     * @example  imu_sample_struct s; if(0 == imu_dev.read_sample(&s, -1)) { ... }
+     *---------------------------------------------------------------------
+     */
+    int8 read_sample(imu_sample_struct *sample, int timeout_ms);
+
+    /*---------------------------------------------------------------------
+     * @brief    通过sysfs连续读取全部轴
+     * @details  未启用缓冲模式时使用 各轴依次pread 时间戳为读取完成的time_now_ns
+     * @param    sample      样本
+     * @return   0-成功 -1-未初始化或有轴读取失败
+     * @example  imu_sample_struct s; imu_dev.read_sysfs_sample(&s);
+     *---------------------------------------------------------------------
+     */
+    int8 read_sysfs_sample(imu_sample_struct *sample);
+
+    /*---------------------------------------------------------------------
+     * @brief    获取IIO缓冲模式数据句柄
+     * @return   字符设备句柄 未启用缓冲模式返回-1
+     * @example  加入poll/epoll 可读时调用read_samples
+     *---------------------------------------------------------------------
+     */
+    int get_buffer_fd(void);
 };
 
 #endif
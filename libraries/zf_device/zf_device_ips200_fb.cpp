@@ -13,201 +13,298 @@
 #include "zf_device_ips200_fb.hpp"
 #include "zf_common_font.hpp"
 #include "zf_common_function.hpp"
+#include "zf_driver_pit_fd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 
 // DisplayIps200类的static成员变量定义
 uint16 DisplayIps200::pen_color = DEFAULT_PENCOLOR;
 uint16 DisplayIps200::bg_color = DEFAULT_BGCOLOR;
+ips200_font_size_enum DisplayIps200::font = IPS200_8X16_FONT;
+uint32 DisplayIps200::style_version = 0;
 int DisplayIps200::width = 0;
 int DisplayIps200::height = 0;
+int DisplayIps200::stride = 0;
 unsigned short *DisplayIps200::screen_base = nullptr;
+unsigned short *DisplayIps200::fb_base = nullptr;
+int DisplayIps200::fb_stride = 0;
+uint16 *DisplayIps200::back_buffer = nullptr;
+
+typedef struct
+{
+    int x, y, w, h;
+}ips200_rect_struct;
+
+static ips200_rect_struct   ips200_dirty[IPS200_DIRTY_MAX];         // 后台缓冲中尚未提交的区域
+static uint32               ips200_dirty_count = 0;
+static ips200_rect_struct   ips200_pending[IPS200_DIRTY_MAX];       // 刷新线程模式下已提交到暂存缓冲 尚未写入显存的区域
+static uint32               ips200_pending_count = 0;
+static uint16              *ips200_staging = nullptr;               // 刷新线程模式下的暂存缓冲 每行width个像素
+static timer_fd            *ips200_present_timer = nullptr;         // 刷新线程 运行中非nullptr
+static std::mutex           ips200_present_mutex;                   // present 与刷新线程之间互斥
+
+#define IPS200_FONT_6X8_COUNT       ('z' - ' ' + 1)                     // 6x8 字模只有 ' '~'z'
+static uint16               ips200_glyph_cache[IPS200_GLYPH_COUNT * 8 * 16];    // 按当前字体与颜色展开的字模 每个字符逐行存放
+static bool                 ips200_glyph_valid = false;             // 颜色或字体改变后置false 下次显示字符时重建
+
+static void                *ips200_fb_map = nullptr;                // init 映射的显存 重复init时释放
+static size_t               ips200_fb_map_size = 0;
+
+// /proc/modules 中的模块状态
+typedef enum
+{
+    IPS200_MODULE_ABSENT = 0,                                           // 未加载
+    IPS200_MODULE_LIVE,                                                 // 已加载完成
+    IPS200_MODULE_BUSY,                                                 // 正在加载或卸载
+}ips200_module_state_enum;
+
+// 以8字节为单位写显存 may_alias 允许通过该类型写入uint16数组
+typedef uint64_t __attribute__((__may_alias__)) ips200_word_t;
 
 /*---------------------------------------------------------------------
- * @brief    清屏函数
- * @return   无
- * @example  DisplayIps200::clear();
+ * @brief    把矩形裁剪到屏幕范围内
+ * @param    x,y,w,h 矩形 裁剪后原地修改
+ * @param    src_x,src_y 源图像中对应的起点偏移输出 可以为NULL
+ * @return   true-裁剪后仍有像素需要绘制
  *---------------------------------------------------------------------
  */
-void DisplayIps200::clear(void)
+bool DisplayIps200::clipRect(int *x, int *y, int *w, int *h, int *src_x, int *src_y)
 {
-    full(DEFAULT_BGCOLOR);
+    int skip_x = 0, skip_y = 0;
+
+    if(nullptr == screen_base || 0 >= *w || 0 >= *h)
+    {
+        return false;
+    }
+    if(0 > *x)
+    {
+        skip_x = -*x;
+        *w += *x;
+        *x = 0;
+    }
+    if(0 > *y)
+    {
+        skip_y = -*y;
+        *h += *y;
+        *y = 0;
+    }
+    if(*x + *w > width)
+    {
+        *w = width - *x;
+    }
+    if(*y + *h > height)
+    {
+        *h = height - *y;
+    }
+    if(nullptr != src_x)
+    {
+        *src_x = skip_x;
+    }
+    if(nullptr != src_y)
+    {
+        *src_y = skip_y;
+    }
+    return (0 < *w && 0 < *h);
 }
 
+// 灰度到RGB565的查找表 编译期生成 与原逐点转换的结果相同
+struct ips200_gray_lut_struct
+{
+    uint16 value[256];
+
+    constexpr ips200_gray_lut_struct() : value()
+    {
+        for(int i = 0; i < 256; i ++)
+        {
+            value[i] = (uint16)(((i >> 3) << 11) | ((i >> 2) << 5) | (i >> 3));
+        }
+    }
+};
+static constexpr ips200_gray_lut_struct ips200_gray_lut;
+
 /*---------------------------------------------------------------------
- * @brief    屏幕填充函数
- * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
- * @return   无
- * @example  DisplayIps200::full(RGB565_BLACK);
+ * @brief    把一个像素转换为RGB565
+ * @param    p 像素首地址 CHANNELS为1时是灰度 为3时按B G R排列
+ * @return   RGB565颜色
  *---------------------------------------------------------------------
  */
-void DisplayIps200::full(const uint16 color)
+template<int CHANNELS>
+static inline uint16 ips200_pixel(const uint8 *p)
 {
-    uint16 i,j;
-    for(i=0;i<240; i++)
+    if(1 == CHANNELS)
     {
-        for(j=0; j<320; j++)
-        {
-            drawPoint(i, j, color);
-        }
+        return ips200_gray_lut.value[p[0]];
     }
+    return (uint16)(((p[2] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[0] >> 3));
 }
 
 /*---------------------------------------------------------------------
- * @brief    画点函数
- * @param    x 坐标x方向的点位置 [0, width-1]
- * @param    y 坐标y方向的点位置 [0, height-1]
- * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @brief    转换一行像素 不缩放
+ * @param    dst 目标行
+ * @param    src 源行
+ * @param    count 像素数
  * @return   无
- * @example  DisplayIps200::drawPoint(10, 20, RGB565_BLUE);
+ * @details  restrict 说明源与目标不重叠 BGR转换可以被编译器向量化
  *---------------------------------------------------------------------
  */
-void DisplayIps200::drawPoint(uint16 x, uint16 y, const uint16 color)
+template<int CHANNELS>
+static void ips200_row_copy(uint16 *__restrict dst, const uint8 *__restrict src, int count)
 {
-    if(nullptr != screen_base)
+    for(int i = 0; i < count; i ++)
     {
-        screen_base[y * width + x] = color;
+        dst[i] = ips200_pixel<CHANNELS>(src + i * CHANNELS);
     }
 }
 
 /*---------------------------------------------------------------------
- * @brief    画线函数
- * @param    x_start 坐标x方向的起点 [0, width-1]
- * @param    y_start 坐标y方向的起点 [0, height-1]
- * @param    x_end 坐标x方向的终点 [0, width-1]
- * @param    y_end 坐标y方向的终点 [0, height-1]
- * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @brief    最近邻缩放一行像素
+ * @param    dst 目标行
+ * @param    src 源行
+ * @param    count 目标像素数
+ * @param    fx 第一个目标像素对应的源x坐标 16.16定点
+ * @param    step_x 源x坐标步进 16.16定点
+ * @param    max_x 源x坐标上限(像素)
  * @return   无
- * @example  DisplayIps200::drawLine(0, 0, 10, 10, RGB565_RED);
  *---------------------------------------------------------------------
  */
-void DisplayIps200::drawLine (uint16 x_start, uint16 y_start, uint16 x_end, uint16 y_end, const uint16 color)
+template<int CHANNELS>
+static void ips200_row_nearest(uint16 *__restrict dst, const uint8 *__restrict src, int count, uint32 fx, uint32 step_x, uint32 max_x)
 {
-    int16 x_dir = (x_start < x_end ? 1 : -1);
-    int16 y_dir = (y_start < y_end ? 1 : -1);
-    float temp_rate = 0;
-    float temp_b = 0;
-
-    do
+    for(int i = 0; i < count; i ++, fx += step_x)
     {
-        if(x_start != x_end)
-        {
-            temp_rate = (float)(y_start - y_end) / (float)(x_start - x_end);
-            temp_b = (float)y_start - (float)x_start * temp_rate;
-        }
-        else
-        {
-            while(y_start != y_end)
-            {
-                drawPoint(x_start, y_start, color);
-                y_start += y_dir;
-            }
-            drawPoint(x_start, y_start, color);
-            break;
-        }
-        if(func_abs(y_start - y_end) > func_abs(x_start - x_end))
-        {
-            while(y_start != y_end)
-            {
-                drawPoint(x_start, y_start, color);
-                y_start += y_dir;
-                x_start = (int16)(((float)y_start - temp_b) / temp_rate);
-            }
-            drawPoint(x_start, y_start, color);
-        }
-        else
-        {
-            while(x_start != x_end)
-            {
-                drawPoint(x_start, y_start, color);
-                x_start += x_dir;
-                y_start = (int16)((float)x_start * temp_rate + temp_b);
-            }
-            drawPoint(x_start, y_start, color);
-        }
-    }while(0);
+        uint32 sx = fx >> 16;
+        sx = (sx < max_x) ? sx : max_x;
+        dst[i] = ips200_pixel<CHANNELS>(src + sx * CHANNELS);
+    }
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示单个字符
- * @param    x 坐标x方向的起点 [0, width-1]
- * @param    y 坐标y方向的起点 [0, height-1]
- * @param    dat 需要显示的单个字符
+ * @brief    双线性缩放一行像素
+ * @param    dst 目标行
+ * @param    top,bottom 上下两条源行
+ * @param    wy 垂直权重 [0, 256)
+ * @param    count 目标像素数
+ * @param    fx 第一个目标像素对应的源x坐标 16.16定点 可以为负
+ * @param    step_x 源x坐标步进 16.16定点
+ * @param    max_x 源x坐标上限(像素)
  * @return   无
- * @example  DisplayIps200::showChar(10, 20, 'A');
+ * @details  先垂直后水平插值 权重为8位定点 结果截断
  *---------------------------------------------------------------------
  */
-void DisplayIps200::showChar(uint16 x, uint16 y, const char dat)
+template<int CHANNELS>
+static void ips200_row_bilinear(uint16 *__restrict dst, const uint8 *__restrict top, const uint8 *__restrict bottom, uint32 wy,
+                                int count, int32 fx, uint32 step_x, int32 max_x)
 {
-    uint8 i = 0, j = 0;
-    for(i = 0; 8 > i; i ++)
+    const int32 limit = max_x << 16;
+
+    for(int i = 0; i < count; i ++, fx += step_x)
     {
-        uint8 temp_top = ascii_font_8x16[dat - 32][i];
-        uint8 temp_bottom = ascii_font_8x16[dat - 32][i + 8];
-        for(j = 0; 8 > j; j ++)
-        {
-            if(temp_top & 0x01)
-            {
-                drawPoint(x + i, y + j, pen_color);
-            }
-            else
-            {
-                drawPoint(x + i, y + j, bg_color);
-            }
-            temp_top >>= 1;
-        }
+        int32 cx = (fx < 0) ? 0 : ((fx > limit) ? limit : fx);
+        int32 x0 = cx >> 16;
+        int32 x1 = ((x0 < max_x) ? x0 + 1 : x0) * CHANNELS;
+        uint32 wx = (uint32)(cx >> 8) & 0xFF;
+        uint8 v[CHANNELS];
 
-        for(j = 0; 8 > j; j ++)
+        x0 *= CHANNELS;
+        for(int c = 0; c < CHANNELS; c ++)
         {
-            if(temp_bottom & 0x01)
-            {
-                drawPoint(x + i, y + j + 8, pen_color);
-            }
-            else
-            {
-                drawPoint(x + i, y + j + 8, bg_color);
-            }
-            temp_bottom >>= 1;
+            uint32 left  = (top[x0 + c] << 8) + (bottom[x0 + c] - top[x0 + c]) * (int32)wy;
+            uint32 right = (top[x1 + c] << 8) + (bottom[x1 + c] - top[x1 + c]) * (int32)wy;
+            v[c] = (uint8)(((left << 8) + (right - left) * wx) >> 16);
         }
+        dst[i] = ips200_pixel<CHANNELS>(v);
     }
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示字符串
- * @param    x 坐标x方向的起点 [0, width-1]
- * @param    y 坐标y方向的起点 [0, height-1]
- * @param    dat 需要显示的字符串首地址
+ * @brief    把图像缩放转换后写入目标缓冲
+ * @param    dst 裁剪后目标矩形左上角的地址
+ * @param    dst_stride 目标缓冲每行像素数
+ * @param    dst_w,dst_h 裁剪后目标矩形的尺寸
+ * @param    skip_x,skip_y 裁剪掉的左侧列数与上方行数
+ * @param    full_w,full_h 裁剪前目标矩形的尺寸 决定缩放比例
+ * @param    image,image_width,image_height,image_stride 源图像 stride单位字节
+ * @param    mode 缩放方式
  * @return   无
- * @example  DisplayIps200::showString(10, 20, "SEEKFREE");
+ * @details  源坐标用16.16定点数按像素中心对齐 整数倍缩放时没有累计误差
  *---------------------------------------------------------------------
  */
-void DisplayIps200::showString(uint16 x, uint16 y, const char dat[])
+template<int CHANNELS>
+static void ips200_blit(uint16 *dst, int dst_stride, int dst_w, int dst_h, int skip_x, int skip_y, int full_w, int full_h,
+                        const uint8 *image, int image_width, int image_height, int image_stride, ips200_scale_enum mode)
 {
-    uint16 j = 0;
+    if(full_w == image_width && full_h == image_height)
+    {
+        const uint8 *src = image + skip_y * image_stride + skip_x * CHANNELS;
+        for(int row = 0; row < dst_h; row ++)
+        {
+            ips200_row_copy<CHANNELS>(dst, src, dst_w);
+            dst += dst_stride;
+            src += image_stride;
+        }
+        return;
+    }
 
-    while('\0' != dat[j])
+    uint32 step_x = (uint32)(((uint64_t)image_width  << 16) / full_w);
+    uint32 step_y = (uint32)(((uint64_t)image_height << 16) / full_h);
+
+    if(IPS200_SCALE_BILINEAR == mode)
     {
-        showChar(x + 8 * j,  y, dat[j]);
-        j ++;
+        // 像素中心对齐 src = (dst + 0.5) * step - 0.5 边界处夹紧
+        int32 fx = (int32)(skip_x * step_x + step_x / 2) - 32768;
+        int32 fy = (int32)(skip_y * step_y + step_y / 2) - 32768;
+        int32 limit_y = (image_height - 1) << 16;
+        for(int row = 0; row < dst_h; row ++, fy += step_y)
+        {
+            int32 cy = (fy < 0) ? 0 : ((fy > limit_y) ? limit_y : fy);
+            int y0 = cy >> 16;
+            int y1 = (y0 + 1 < image_height) ? y0 + 1 : y0;
+            ips200_row_bilinear<CHANNELS>(dst, image + y0 * image_stride, image + y1 * image_stride, (uint32)(cy >> 8) & 0xFF,
+                                          dst_w, fx, step_x, image_width - 1);
+            dst += dst_stride;
+        }
+        return;
+    }
+
+    int last_y = -1;
+    for(int row = 0; row < dst_h; row ++)
+    {
+        int sy = (int)(((skip_y + row) * step_y + step_y / 2) >> 16);
+        if(sy >= image_height)
+        {
+            sy = image_height - 1;
+        }
+        if(sy == last_y)
+        {
+            memcpy(dst, dst - dst_stride, (size_t)dst_w * sizeof(uint16));   // 放大时与上一行取自同一源行
+        }
+        else
+        {
+            ips200_row_nearest<CHANNELS>(dst, image + sy * image_stride, dst_w, skip_x * step_x + step_x / 2, step_x, image_width - 1);
+            last_y = sy;
+        }
+        dst += dst_stride;
     }
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示有符号整型数
- * @param    x 坐标x方向的起点 [0, width-1]
- * @param    y 坐标y方向的起点 [0, height-1]
+ * @brief    格式化有符号整型数
+ * @param    buffer 输出 至少12字节
  * @param    dat 需要显示的变量
- * @param    num 整数显示长度，最高支持10位
+ * @param    num 整数显示长度 最高支持10位
  * @return   无
- * @example  DisplayIps200::showInt(10, 20, -123, 3);
+ * @details  末尾补空格以覆盖上一次较长的显示 showInt与数值控件共用
  *---------------------------------------------------------------------
  */
-void DisplayIps200::showInt(uint16 x, uint16 y, const int32 dat, uint8 num)
+static void ips200_format_int(char *buffer, int32 dat, uint8 num)
 {
-    int32 dat_temp = dat;
     int32 offset = 1;
-    char data_buffer[12] = {0};
 
-    std::memset(data_buffer, 0, 12);
-    std::memset(data_buffer, ' ', num+1);
+    std::memset(buffer, 0, 12);
+    std::memset(buffer, ' ', num + 1);
 
     if(10 > num)
     {
@@ -215,29 +312,25 @@ void DisplayIps200::showInt(uint16 x, uint16 y, const int32 dat, uint8 num)
         {
             offset *= 10;
         }
-        dat_temp %= offset;
+        dat %= offset;
     }
-    func_int_to_str(data_buffer, dat_temp);
-    showString(x, y, (const char *)&data_buffer);
+    func_int_to_str(buffer, dat);
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示无符号整型数
- * @param    x 坐标x方向的起点 [0, width-1]
- * @param    y 坐标y方向的起点 [0, height-1]
+ * @brief    格式化无符号整型数
+ * @param    buffer 输出 至少12字节
  * @param    dat 需要显示的变量
- * @param    num 整数显示长度，最高支持10位
+ * @param    num 整数显示长度 最高支持10位
  * @return   无
- * @example  DisplayIps200::showUint(10, 20, 123, 3);
  *---------------------------------------------------------------------
  */
-void DisplayIps200::showUint(uint16 x, uint16 y, const uint32 dat, uint8 num)
+static void ips200_format_uint(char *buffer, uint32 dat, uint8 num)
 {
-    uint32 dat_temp = dat;
     int32 offset = 1;
-    char data_buffer[12] = {0};
-    std::memset(data_buffer, 0, 12);
-    std::memset(data_buffer, ' ', num);
+
+    std::memset(buffer, 0, 12);
+    std::memset(buffer, ' ', num);
 
     if(10 > num)
     {
@@ -245,151 +338,1467 @@ void DisplayIps200::showUint(uint16 x, uint16 y, const uint32 dat, uint8 num)
         {
             offset *= 10;
         }
-        dat_temp %= offset;
+        dat %= offset;
     }
-    func_uint_to_str(data_buffer, dat_temp);
-    showString(x, y, (const char *)&data_buffer);
+    func_uint_to_str(buffer, dat);
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示浮点数(去除整数部分无效的0)
- * @param    x 坐标x方向的起点 [0, width-1]
- * @param    y 坐标y方向的起点 [0, height-1]
+ * @brief    格式化浮点数(去除整数部分无效的0)
+ * @param    buffer 输出 至少17字节
  * @param    dat 需要显示的变量
- * @param    num 整数位显示长度，最高8位
- * @param    pointnum 小数位显示长度，最高6位
+ * @param    num 整数位显示长度 最高8位
+ * @param    pointnum 小数位显示长度 最高6位
  * @return   无
- * @example  DisplayIps200::showFloat(0, 0, x, 2, 3);
  *---------------------------------------------------------------------
  */
-void DisplayIps200::showFloat (uint16 x, uint16 y, const double dat, uint8 num, uint8 pointnum)
+static void ips200_format_float(char *buffer, double dat, uint8 num, uint8 pointnum)
 {
-    double dat_temp = dat;
     double offset = 1.0;
-    char data_buffer[17] = {0};
-    std::memset(data_buffer, 0, 17);
-    std::memset(data_buffer, ' ', num+pointnum+2);
+    double half = 0.5;                                                  // 最后一位小数的一半
+
+    std::memset(buffer, 0, 17);
+    std::memset(buffer, ' ', num + pointnum + 2);
 
     for(; 0 < num; num --)
     {
         offset *= 10;
     }
-    dat_temp = dat_temp - ((int)dat_temp / (int)offset) * offset;
-    func_double_to_str(data_buffer, dat_temp, pointnum);
-    showString(x, y, data_buffer);
+    for(uint8 i = 0; i < pointnum; i ++)
+    {
+        half /= 10;
+    }
+    dat = dat - ((int)dat / (int)offset) * offset;
+    if(offset - half <= std::fabs(dat))                                 // 四舍五入后会进位到 offset 时同样取模 保持显示宽度
+    {
+        dat = std::copysign(std::fabs(dat) - offset, dat);              // 取模后的余数很小 保留原符号 99.996 显示 0.00 而不是 -0.00
+    }
+    func_double_to_str(buffer, dat, pointnum);
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示灰度图像
- * @param    x 坐标x方向的起点 [0, width-1]
- * @param    y 坐标y方向的起点 [0, height-1]
- * @param    image 灰度图像数据首地址
- * @param    width 图像宽度(像素)
- * @param    height 图像高度(像素)
+ * @brief    计算点相对屏幕的区域编码
+ * @param    x,y 点
+ * @param    w,h 屏幕尺寸
+ * @return   位0-左侧 位1-右侧 位2-上方 位3-下方 0表示在屏幕内
+ *---------------------------------------------------------------------
+ */
+static inline uint8 ips200_outcode(int x, int y, int w, int h)
+{
+    return (uint8)((x < 0) | ((x >= w) << 1) | ((y < 0) << 2) | ((y >= h) << 3));
+}
+
+/*---------------------------------------------------------------------
+ * @brief    向下取整的整数除法
+ * @param    numerator 被除数
+ * @param    denominator 除数 大于0
+ * @return   不大于真实商的最大整数
+ *---------------------------------------------------------------------
+ */
+static inline int64_t ips200_div_floor(int64_t numerator, int64_t denominator)
+{
+    int64_t quotient = numerator / denominator;
+    return (quotient * denominator > numerator) ? quotient - 1 : quotient;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    把矩形加入矩形列表
+ * @param    list 矩形列表
+ * @param    count 列表中的矩形数量
+ * @param    rect 新矩形
  * @return   无
- * @example  DisplayIps200::showGrayImage(0, 0, gray_buf, 100, 80);
+ * @details  重叠或相邻且合并后面积不超过两者之和时合并 即包含 同行等高相邻的字符等情况
+ *           合并后的矩形重新与列表比较 列表已满时与合并后面积增量最小的矩形合并
  *---------------------------------------------------------------------
  */
-void DisplayIps200::showGrayImage(uint16 x, uint16 y, const uint8 *image, uint16 width, uint16 height)
+static void ips200_rect_add(ips200_rect_struct *list, uint32 *count, ips200_rect_struct rect)
 {
-    uint32 x_start = 0, y_start = 0;
-    uint16 color = 0;
+    uint32 i = 0;
 
-    for(y_start = y; y_start < (y + height); y_start++)
+    for(i = 0; i < *count; i ++)
     {
-        for(x_start = x; x_start < (x + width); x_start++)
+        const ips200_rect_struct *r = &list[i];
+        if(r->x <= rect.x && r->y <= rect.y && rect.x + rect.w <= r->x + r->w && rect.y + rect.h <= r->y + r->h)
         {
-            uint8 grayValue = image[(x_start - x) + (y_start- y) * width];
+            return;                                                     // 已被包含 逐点绘制时的常见情况
+        }
+    }
+
+    i = 0;
+    while(i < *count)
+    {
+        const ips200_rect_struct *r = &list[i];
+        int x0 = std::min(r->x, rect.x);
+        int y0 = std::min(r->y, rect.y);
+        int x1 = std::max(r->x + r->w, rect.x + rect.w);
+        int y1 = std::max(r->y + r->h, rect.y + rect.h);
+        bool touch = (r->x <= rect.x + rect.w && rect.x <= r->x + r->w && r->y <= rect.y + rect.h && rect.y <= r->y + r->h);
+        bool full = (IPS200_DIRTY_MAX <= *count && i == *count - 1);
 
-            uint16 r = (grayValue >> 3) & 0b11111;
-            uint16 g = (grayValue >> 2) & 0b111111;
-            uint16 b = (grayValue >> 3) & 0b11111;
-            color = (r << 11) | (g << 5) | (b << 0);
+        if(!touch || (x1 - x0) * (y1 - y0) > r->w * r->h + rect.w * rect.h)
+        {
+            if(!full)
+            {
+                i ++;
+                continue;
+            }
 
-            drawPoint(x_start, y_start,  color);
+            // 列表已满且没有可以直接合并的矩形 选面积增量最小的强制合并
+            uint32 best = 0;
+            int best_growth = INT32_MAX;
+            for(uint32 j = 0; j < *count; j ++)
+            {
+                const ips200_rect_struct *c = &list[j];
+                int growth = (std::max(c->x + c->w, rect.x + rect.w) - std::min(c->x, rect.x)) *
+                             (std::max(c->y + c->h, rect.y + rect.h) - std::min(c->y, rect.y)) - c->w * c->h;
+                if(growth < best_growth)
+                {
+                    best_growth = growth;
+                    best = j;
+                }
+            }
+            r = &list[best];
+            i = best;
+            x0 = std::min(r->x, rect.x);
+            y0 = std::min(r->y, rect.y);
+            x1 = std::max(r->x + r->w, rect.x + rect.w);
+            y1 = std::max(r->y + r->h, rect.y + rect.h);
         }
+
+        rect.x = x0;
+        rect.y = y0;
+        rect.w = x1 - x0;
+        rect.h = y1 - y0;
+        list[i] = list[-- *count];
+        i = 0;
     }
+    list[(*count) ++] = rect;
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示RGB565格式图像
- * @param    x 坐标x方向的起点 [0, width-1]
- * @param    y 坐标y方向的起点 [0, height-1]
- * @param    image RGB565图像数据首地址
- * @param    width 图像宽度(像素)
- * @param    height 图像高度(像素)
+ * @brief    按行拷贝矩形区域
+ * @param    dst 目标缓冲首地址
+ * @param    dst_stride 目标缓冲每行像素数
+ * @param    src 源缓冲首地址
+ * @param    src_stride 源缓冲每行像素数
+ * @param    rect 区域 两个缓冲中坐标相同
  * @return   无
- * @example  DisplayIps200::showRgbImage(0, 0, rgb_buf, 100, 80);
  *---------------------------------------------------------------------
  */
-void DisplayIps200::showRgbImage(uint16 x, uint16 y, const uint16 *image, uint16 width, uint16 height)
+static void ips200_rect_copy(uint16 *dst, int dst_stride, const uint16 *src, int src_stride, const ips200_rect_struct *rect)
 {
-    uint32 x_start = 0, y_start = 0;
-    for(y_start = y; y_start < (y + height); y_start++)
+    dst += rect->y * dst_stride + rect->x;
+    src += rect->y * src_stride + rect->x;
+    for(int i = 0; i < rect->h; i ++)
     {
-        for(x_start = x; x_start < (x + width); x_start++)
-        {
-            uint16 rgbValue = image[(x_start - x) + (y_start- y) * width];
-            drawPoint(x_start, y_start,  rgbValue);
-        }
+        memcpy(dst, src, (size_t)rect->w * sizeof(uint16));
+        dst += dst_stride;
+        src += src_stride;
     }
 }
 
 /*---------------------------------------------------------------------
- * @brief    显示屏初始化函数
- * @param    path framebuffer设备节点路径，如"/dev/fb0"
- * @param    is_reload_driver 是否重新加载驱动，默认为1
+ * @brief    把矩形加入脏矩形列表
+ * @param    x,y,w,h 已裁剪的矩形
  * @return   无
- * @example  DisplayIps200::init("/dev/fb0");
  *---------------------------------------------------------------------
  */
-void DisplayIps200::init(const char *path, uint8 is_reload_driver)
+void DisplayIps200::addDirty(int x, int y, int w, int h)
 {
-    struct fb_fix_screeninfo fb_fix;
-    struct fb_var_screeninfo fb_var;
-    unsigned int screen_size;
-    int fd;
+    ips200_rect_add(ips200_dirty, &ips200_dirty_count, {x, y, w, h});
+}
+
+/*---------------------------------------------------------------------
+ * @brief    连续填充一段像素
+ * @param    dst 起始地址
+ * @param    count 像素数
+ * @param    color 颜色格式RGB565
+ * @return   无
+ * @example  DisplayIps200::fillSpan(line, 240, RGB565_BLACK);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::fillSpan(uint16 *dst, uint32 count, const uint16 color)
+{
+    uint64_t pattern = (uint64_t)color * 0x0001000100010001ULL;
 
-    if (is_reload_driver)
+    while(count && ((uintptr_t)dst & 7))
     {
-        std::cout << "ips200: 卸载fb_st7789v驱动..." << std::endl;
-        // 卸载fb_st7789v驱动模块，忽略卸载失败(比如驱动本就没加载的情况)
-        system("rmmod fb_st7789v > /dev/null 2>&1");
-        usleep(200*1000); // 延时200ms，保证驱动卸载干净，避免加载失败
-        std::cout << "ips200: 加载fb_st7789v驱动..." << std::endl;
-        // 重新加载fb_st7789v驱动模块，必须保证驱动文件路径正确
-        if(system("insmod /lib/modules/4.19.190/fb_st7789v.ko") != 0)
-        {
-            std::cerr << "insmod fb_st7789v驱动失败" << std::endl;
-            exit(EXIT_FAILURE);
-        }
-        usleep(200*1000); // 延时300ms，驱动加载完成+硬件初始化完成，关键延时
+        *dst ++ = color;
+        count --;
     }
 
-    if (0 > (fd = open(path, O_RDWR))) {
-        std::cerr << "打开framebuffer设备失败" << std::endl;
-        exit(EXIT_FAILURE);
+    ips200_word_t *word = (ips200_word_t *)dst;
+    for(uint32 i = count / 4; 0 < i; i --)
+    {
+        *word ++ = pattern;
     }
 
-    ioctl(fd, FBIOGET_VSCREENINFO, &fb_var);
-    ioctl(fd, FBIOGET_FSCREENINFO, &fb_fix);
+    dst = (uint16 *)word;
+    for(count &= 3; 0 < count; count --)
+    {
+        *dst ++ = color;
+    }
+}
 
-    screen_size = fb_fix.line_length * fb_var.yres;
-    DisplayIps200::width = fb_var.xres;
-    DisplayIps200::height = fb_var.yres;
+/*---------------------------------------------------------------------
+ * @brief    矩形填充
+ * @param    x 矩形左上角x
+ * @param    y 矩形左上角y
+ * @param    w 矩形宽度(像素)
+ * @param    h 矩形高度(像素)
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::fillRect(0, 300, 240, 20, RGB565_BLACK);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::fillRect(int x, int y, int w, int h, const uint16 color)
+{
+    if(!clipRect(&x, &y, &w, &h, nullptr, nullptr))
+    {
+        return;
+    }
+    if(nullptr != back_buffer)
+    {
+        addDirty(x, y, w, h);
+    }
 
-    screen_base = (unsigned short *)mmap(nullptr, screen_size, PROT_WRITE, MAP_SHARED, fd, 0);
-    if (MAP_FAILED == (void *)screen_base) {
-        std::cerr << "mmap映射显存失败" << std::endl;
-        close(fd);
-        exit(EXIT_FAILURE);
+    uint16 *line = screen_base + y * stride + x;
+    if(w == stride)
+    {
+        fillSpan(line, (uint32)w * h, color);                  // 整行宽度且行间无填充 一次连续写入
+        return;
+    }
+    for(; 0 < h; h --)
+    {
+        fillSpan(line, w, color);
+        line += stride;
     }
+}
 
-    for(uint16 i=0;i<240;i++)
+/*---------------------------------------------------------------------
+ * @brief    矩形拷贝
+ * @param    x 目标左上角x
+ * @param    y 目标左上角y
+ * @param    image RGB565源图像首地址
+ * @param    w 拷贝宽度(像素)
+ * @param    h 拷贝高度(像素)
+ * @param    image_stride 源图像每行像素数 0表示等于w
+ * @return   无
+ * @example  DisplayIps200::copyRect(0, 0, frame, 160, 120, 0);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::copyRect(int x, int y, const uint16 *image, int w, int h, int image_stride)
+{
+    int src_x = 0, src_y = 0;
+
+    if(0 >= image_stride)
     {
-        for(uint16 j=0;j<320;j++)
-        {
-            drawPoint(i, j, DEFAULT_BGCOLOR);
-        }
+        image_stride = w;
     }
+    if(nullptr == image || !clipRect(&x, &y, &w, &h, &src_x, &src_y))
+    {
+        return;
+    }
+    if(nullptr != back_buffer)
+    {
+        addDirty(x, y, w, h);
+    }
+
+    uint16 *line = screen_base + y * stride + x;
+    const uint16 *src = image + src_y * image_stride + src_x;
+    for(; 0 < h; h --)
+    {
+        memcpy(line, src, (size_t)w * sizeof(uint16));
+        line += stride;
+        src += image_stride;
+    }
+}
+
+/*---------------------------------------------------------------------
+ * @brief    清屏函数
+ * @return   无
+ * @example  DisplayIps200::clear();
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::clear(void)
+{
+    full(DEFAULT_BGCOLOR);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    屏幕填充函数
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::full(RGB565_BLACK);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::full(const uint16 color)
+{
+    fillRect(0, 0, width, height, color);
+    style_version ++;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    画点函数
+ * @details  超出屏幕的点直接忽略
+ * @param    x 坐标x方向的点位置 [0, width-1]
+ * @param    y 坐标y方向的点位置 [0, height-1]
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::drawPoint(10, 20, RGB565_BLUE);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::drawPoint(uint16 x, uint16 y, const uint16 color)
+{
+    if(x >= width || y >= height)
+    {
+        return;
+    }
+    setPixel(x, y, color);
+    markDirty(x, y, 1, 1);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    光栅化一条线段
+ * @param    x0,y0 起点 可以超出屏幕
+ * @param    x1,y1 终点 可以超出屏幕
+ * @param    color 颜色格式RGB565
+ * @param    bound 输出实际绘制的像素范围 最小x 最小y 最大x 最大y
+ * @return   true-绘制了至少一个像素
+ *---------------------------------------------------------------------
+ */
+bool DisplayIps200::rasterLine(int x0, int y0, int x1, int y1, const uint16 color, int *bound)
+{
+    uint8 code0 = ips200_outcode(x0, y0, width, height);
+    uint8 code1 = ips200_outcode(x1, y1, width, height);
+
+    if((code0 & code1) || IPS200_LINE_LIMIT < func_abs(x0) || IPS200_LINE_LIMIT < func_abs(y0) ||
+       IPS200_LINE_LIMIT < func_abs(x1) || IPS200_LINE_LIMIT < func_abs(y1))
+    {
+        return false;                                                   // 两端在屏幕同一侧之外
+    }
+    if(y0 == y1)
+    {
+        bound[0] = std::max(std::min(x0, x1), 0);
+        bound[2] = std::min(std::max(x0, x1), width - 1);
+        bound[1] = bound[3] = y0;
+        fillSpan(screen_base + y0 * stride + bound[0], (uint32)(bound[2] - bound[0] + 1), color);
+        return true;
+    }
+
+    // 沿主轴走第k步时 副轴偏移 = floor((2k*minor + major) / (2*major)) 与Bresenham算法逐点累加误差的结果相同
+    int64_t ax = func_abs((int64_t)x1 - x0);
+    int64_t ay = func_abs((int64_t)y1 - y0);
+    bool x_major = (ax >= ay);
+    int64_t major = x_major ? ax : ay;
+    int64_t minor = x_major ? ay : ax;
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int64_t k_lo = 0, k_hi = major;
+
+    if(code0 | code1)
+    {
+        // 端点在屏幕外 由主轴与副轴的屏幕范围分别反解出k的范围 取交集
+        // 裁剪后画出的像素与不裁剪时完全相同 只是跳过了屏幕外的部分
+        int64_t a0 = x_major ? x0 : y0, b0 = x_major ? y0 : x0;
+        int sa = x_major ? sx : sy, sb = x_major ? sy : sx;
+        int64_t a_size = x_major ? width : height, b_size = x_major ? height : width;
+        int64_t m_lo = (0 < sb) ? -b0 : b0 - (b_size - 1);
+        int64_t m_hi = (0 < sb) ? b_size - 1 - b0 : b0;
+
+        k_lo = std::max(k_lo, (0 < sa) ? -a0 : a0 - (a_size - 1));
+        k_hi = std::min(k_hi, (0 < sa) ? a_size - 1 - a0 : a0);
+        if(0 == minor)
+        {
+            if(0 < m_lo || 0 > m_hi)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // offset(k) >= m_lo 且 offset(k) <= m_hi
+            k_lo = std::max(k_lo, -ips200_div_floor(-(2 * m_lo - 1) * major, 2 * minor));
+            k_hi = std::min(k_hi, ips200_div_floor((2 * m_hi + 1) * major - 1, 2 * minor));
+        }
+        if(k_lo > k_hi)
+        {
+            return false;
+        }
+    }
+
+    // 未裁剪时起点偏移为0 终点偏移为minor 省去除法
+    int64_t offset = (0 == k_lo) ? 0 : (2 * k_lo * minor + major) / (2 * major);
+    int64_t remainder = (0 == k_lo) ? major : (2 * k_lo * minor + major) % (2 * major);
+    int64_t offset_end = (major == k_hi) ? minor : (2 * k_hi * minor + major) / (2 * major);
+    int64_t step_major = x_major ? sx : (int64_t)sy * stride;
+    int64_t step_minor = x_major ? (int64_t)sy * stride : sx;
+    int first_x = (int)(x0 + sx * (x_major ? k_lo : offset));
+    int first_y = (int)(y0 + sy * (x_major ? offset : k_lo));
+    int last_x = (int)(x0 + sx * (x_major ? k_hi : offset_end));
+    int last_y = (int)(y0 + sy * (x_major ? offset_end : k_hi));
+    int64_t index = (int64_t)first_y * stride + first_x;
+
+    for(int64_t k = k_lo; k <= k_hi; k ++)
+    {
+        screen_base[index] = color;
+        index += step_major;
+        remainder += 2 * minor;
+        if(remainder >= 2 * major)
+        {
+            remainder -= 2 * major;
+            index += step_minor;
+        }
+    }
+
+    bound[0] = std::min(first_x, last_x);
+    bound[1] = std::min(first_y, last_y);
+    bound[2] = std::max(first_x, last_x);
+    bound[3] = std::max(first_y, last_y);
+    return true;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    画线函数
+ * @param    x_start 坐标x方向的起点
+ * @param    y_start 坐标y方向的起点
+ * @param    x_end 坐标x方向的终点
+ * @param    y_end 坐标y方向的终点
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::drawLine(0, 0, 10, 10, RGB565_RED);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::drawLine(int x_start, int y_start, int x_end, int y_end, const uint16 color)
+{
+    int bound[4];
+
+    if(nullptr == screen_base || !rasterLine(x_start, y_start, x_end, y_end, color, bound))
+    {
+        return;
+    }
+    markDirty(bound[0], bound[1], bound[2] - bound[0] + 1, bound[3] - bound[1] + 1);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    折线的公共实现
+ * @param    x_offset,y_offset 所有点的偏移
+ * @param    x,y 坐标数组 可以为NULL
+ * @param    element_size 数组元素字节数 1或2
+ * @param    count 点数
+ * @param    color 颜色格式RGB565
+ * @return   无
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::drawPolylineImpl(int x_offset, int y_offset, const void *x, const void *y, uint8 element_size, uint32 count, const uint16 color)
+{
+    int min_x = INT32_MAX, min_y = INT32_MAX, max_x = INT32_MIN, max_y = INT32_MIN;
+    int last_x = 0, last_y = 0;
+
+    if(nullptr == screen_base || 0 == count)
+    {
+        return;
+    }
+
+    for(uint32 i = 0; i < count; i ++)
+    {
+        int px = x_offset + (int)((nullptr == x) ? i : ((1 == element_size) ? ((const uint8 *)x)[i] : ((const uint16 *)x)[i]));
+        int py = y_offset + (int)((nullptr == y) ? i : ((1 == element_size) ? ((const uint8 *)y)[i] : ((const uint16 *)y)[i]));
+        int bound[4];
+        int x0 = (0 == i) ? px : last_x;
+        int y0 = (0 == i) ? py : last_y;
+
+        last_x = px;
+        last_y = py;
+        if(!rasterLine(x0, y0, px, py, color, bound))
+        {
+            continue;
+        }
+        min_x = std::min(min_x, bound[0]);
+        min_y = std::min(min_y, bound[1]);
+        max_x = std::max(max_x, bound[2]);
+        max_y = std::max(max_y, bound[3]);
+    }
+
+    if(min_x <= max_x)
+    {
+        markDirty(min_x, min_y, max_x - min_x + 1, max_y - min_y + 1);
+    }
+}
+
+/*---------------------------------------------------------------------
+ * @brief    画折线
+ * @param    x_offset,y_offset 所有点的偏移
+ * @param    x,y 坐标数组 可以为NULL
+ * @param    count 点数
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::drawPolyline(0, 0, left_border, NULL, MT9V03X_H, RGB565_RED);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::drawPolyline(int x_offset, int y_offset, const uint8 *x, const uint8 *y, uint32 count, const uint16 color)
+{
+    drawPolylineImpl(x_offset, y_offset, x, y, 1, count, color);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    画折线 坐标为uint16数组
+ * @param    x_offset,y_offset 所有点的偏移
+ * @param    x,y 坐标数组 可以为NULL
+ * @param    count 点数
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::drawPolyline(0, 0, xy_x, xy_y, 160, RGB565_BLUE);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::drawPolyline(int x_offset, int y_offset, const uint16 *x, const uint16 *y, uint32 count, const uint16 color)
+{
+    drawPolylineImpl(x_offset, y_offset, x, y, 2, count, color);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    画矩形边框
+ * @param    x,y 矩形左上角
+ * @param    w,h 矩形尺寸(像素)
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::drawRect(10, 10, 50, 30, RGB565_GREEN);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::drawRect(int x, int y, int w, int h, const uint16 color)
+{
+    if(0 >= w || 0 >= h)
+    {
+        return;
+    }
+    fillRect(x, y, w, 1, color);
+    fillRect(x, y + h - 1, w, 1, color);
+    fillRect(x, y + 1, 1, h - 2, color);
+    fillRect(x + w - 1, y + 1, 1, h - 2, color);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    画圆
+ * @param    x_center,y_center 圆心
+ * @param    radius 半径(像素)
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::drawCircle(120, 160, 50, RGB565_BLUE);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::drawCircle(int x_center, int y_center, int radius, const uint16 color)
+{
+    int x = radius, y = 0;
+    int error = 1 - radius;
+
+    if(nullptr == screen_base || 0 > radius)
+    {
+        return;
+    }
+    markDirty(x_center - radius, y_center - radius, 2 * radius + 1, 2 * radius + 1);
+
+    // 每次算出一个八分圆上的点 按对称性画出8个
+    while(x >= y)
+    {
+        const int point[8][2] =
+        {
+            {x_center + x, y_center + y}, {x_center - x, y_center + y}, {x_center + x, y_center - y}, {x_center - x, y_center - y},
+            {x_center + y, y_center + x}, {x_center - y, y_center + x}, {x_center + y, y_center - x}, {x_center - y, y_center - x},
+        };
+        for(int i = 0; i < 8; i ++)
+        {
+            if(0 <= point[i][0] && point[i][0] < width && 0 <= point[i][1] && point[i][1] < height)
+            {
+                screen_base[point[i][1] * stride + point[i][0]] = color;
+            }
+        }
+
+        y ++;
+        if(0 > error)
+        {
+            error += 2 * y + 1;
+        }
+        else
+        {
+            x --;
+            error += 2 * (y - x) + 1;
+        }
+    }
+}
+
+/*---------------------------------------------------------------------
+ * @brief    画实心圆
+ * @param    x_center,y_center 圆心
+ * @param    radius 半径(像素)
+ * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+ * @return   无
+ * @example  DisplayIps200::fillCircle(120, 160, 8, RGB565_RED);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::fillCircle(int x_center, int y_center, int radius, const uint16 color)
+{
+    int half = radius;
+
+    if(nullptr == screen_base || 0 > radius)
+    {
+        return;
+    }
+    markDirty(x_center - radius, y_center - radius, 2 * radius + 1, 2 * radius + 1);
+
+    // 第dy行的半宽取满足 x*x + dy*dy <= r*r + r 的最大x 与中点画圆的边界一致
+    for(int dy = 0; dy <= radius; dy ++)
+    {
+        while(half * half + dy * dy > radius * radius + radius)
+        {
+            half --;
+        }
+
+        int x0 = std::max(x_center - half, 0);
+        int x1 = std::min(x_center + half, width - 1);
+        if(x0 > x1)
+        {
+            continue;
+        }
+        if(0 <= y_center + dy && y_center + dy < height)
+        {
+            fillSpan(screen_base + (y_center + dy) * stride + x0, (uint32)(x1 - x0 + 1), color);
+        }
+        if(0 < dy && 0 <= y_center - dy && y_center - dy < height)
+        {
+            fillSpan(screen_base + (y_center - dy) * stride + x0, (uint32)(x1 - x0 + 1), color);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------
+ * @brief    设置画笔与背景颜色
+ * @param    pen 画笔颜色 RGB565
+ * @param    bg 背景颜色 RGB565
+ * @return   无
+ * @example  DisplayIps200::setColor(RGB565_BLACK, RGB565_WHITE);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::setColor(const uint16 pen, const uint16 bg)
+{
+    if(pen == pen_color && bg == bg_color)
+    {
+        return;
+    }
+    pen_color = pen;
+    bg_color = bg;
+    ips200_glyph_valid = false;
+    style_version ++;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    设置字体
+ * @param    font IPS200_8X16_FONT 或 IPS200_6X8_FONT
+ * @return   无
+ * @example  DisplayIps200::setFont(IPS200_6X8_FONT);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::setFont(const ips200_font_size_enum font)
+{
+    if(font == DisplayIps200::font)
+    {
+        return;
+    }
+    DisplayIps200::font = font;
+    ips200_glyph_valid = false;
+    style_version ++;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    按当前字体与颜色重建字模缓存
+ * @return   无
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::buildGlyphCache(void)
+{
+    int glyph_width = getFontWidth();
+    int glyph_height = getFontHeight();
+
+    for(int c = 0; c < IPS200_GLYPH_COUNT; c ++)
+    {
+        uint16 *glyph = ips200_glyph_cache + c * glyph_width * glyph_height;
+        for(int i = 0; i < glyph_width; i ++)
+        {
+            // 两种字模都是按列存放 每个字节为一列中的8个点 低位在上
+            uint32 column = 0;
+            if(IPS200_6X8_FONT == font)
+            {
+                column = (c < IPS200_FONT_6X8_COUNT) ? ascii_font_6x8[c][i] : 0;
+            }
+            else
+            {
+                column = ascii_font_8x16[c][i] | (ascii_font_8x16[c][i + 8] << 8);
+            }
+            for(int j = 0; j < glyph_height; j ++)
+            {
+                glyph[j * glyph_width + i] = ((column >> j) & 0x01) ? pen_color : bg_color;
+            }
+        }
+    }
+    ips200_glyph_valid = true;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示单个字符
+ * @param    x 坐标x方向的起点 [0, width-1]
+ * @param    y 坐标y方向的起点 [0, height-1]
+ * @param    dat 需要显示的单个字符
+ * @return   无
+ * @example  DisplayIps200::showChar(10, 20, 'A');
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::showChar(uint16 x, uint16 y, const char dat)
+{
+    int glyph_width = getFontWidth();
+    int glyph_height = getFontHeight();
+    int index = (uint8)dat - ' ';
+
+    if(!ips200_glyph_valid)
+    {
+        buildGlyphCache();
+    }
+    if(0 > index || IPS200_GLYPH_COUNT <= index)
+    {
+        index = 0;
+    }
+
+    const uint16 *glyph = ips200_glyph_cache + index * glyph_width * glyph_height;
+    if(nullptr == screen_base || x + glyph_width > width || y + glyph_height > height)
+    {
+        copyRect(x, y, glyph, glyph_width, glyph_height, glyph_width);
+        return;
+    }
+
+    // 完全在屏幕内 定长拷贝由编译器展开为几条存储指令
+    uint16 *line = screen_base + y * stride + x;
+    if(8 == glyph_width)
+    {
+        for(int j = 0; j < 16; j ++, line += stride, glyph += 8)
+        {
+            memcpy(line, glyph, 8 * sizeof(uint16));
+        }
+    }
+    else
+    {
+        for(int j = 0; j < 8; j ++, line += stride, glyph += 6)
+        {
+            memcpy(line, glyph, 6 * sizeof(uint16));
+        }
+    }
+    markDirty(x, y, glyph_width, glyph_height);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示字符串
+ * @param    x 坐标x方向的起点 [0, width-1]
+ * @param    y 坐标y方向的起点 [0, height-1]
+ * @param    dat 需要显示的字符串首地址
+ * @return   无
+ * @example  DisplayIps200::showString(10, 20, "SEEKFREE");
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::showString(uint16 x, uint16 y, const char dat[])
+{
+    uint16 j = 0;
+    int glyph_width = getFontWidth();
+
+    while('\0' != dat[j])
+    {
+        showChar(x + glyph_width * j,  y, dat[j]);
+        j ++;
+    }
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示有符号整型数
+ * @param    x 坐标x方向的起点 [0, width-1]
+ * @param    y 坐标y方向的起点 [0, height-1]
+ * @param    dat 需要显示的变量
+ * @param    num 整数显示长度，最高支持10位
+ * @return   无
+ * @example  DisplayIps200::showInt(10, 20, -123, 3);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::showInt(uint16 x, uint16 y, const int32 dat, uint8 num)
+{
+    char data_buffer[12];
+
+    ips200_format_int(data_buffer, dat, num);
+    showString(x, y, data_buffer);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示无符号整型数
+ * @param    x 坐标x方向的起点 [0, width-1]
+ * @param    y 坐标y方向的起点 [0, height-1]
+ * @param    dat 需要显示的变量
+ * @param    num 整数显示长度，最高支持10位
+ * @return   无
+ * @example  DisplayIps200::showUint(10, 20, 123, 3);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::showUint(uint16 x, uint16 y, const uint32 dat, uint8 num)
+{
+    char data_buffer[12];
+
+    ips200_format_uint(data_buffer, dat, num);
+    showString(x, y, data_buffer);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示浮点数(去除整数部分无效的0)
+ * @param    x 坐标x方向的起点 [0, width-1]
+ * @param    y 坐标y方向的起点 [0, height-1]
+ * @param    dat 需要显示的变量
+ * @param    num 整数位显示长度，最高8位
+ * @param    pointnum 小数位显示长度，最高6位
+ * @return   无
+ * @example  DisplayIps200::showFloat(0, 0, x, 2, 3);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::showFloat (uint16 x, uint16 y, const double dat, uint8 num, uint8 pointnum)
+{
+    char data_buffer[17];
+
+    ips200_format_float(data_buffer, dat, num, pointnum);
+    showString(x, y, data_buffer);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示灰度图像
+ * @param    x 坐标x方向的起点 [0, width-1]
+ * @param    y 坐标y方向的起点 [0, height-1]
+ * @param    image 灰度图像数据首地址
+ * @param    width 图像宽度(像素)
+ * @param    height 图像高度(像素)
+ * @return   无
+ * @example  DisplayIps200::showGrayImage(0, 0, gray_buf, 100, 80);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::showGrayImage(uint16 x, uint16 y, const uint8 *image, uint16 width, uint16 height)
+{
+    blitGray(x, y, width, height, image, width, height, width);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示RGB565格式图像
+ * @param    x 坐标x方向的起点 [0, width-1]
+ * @param    y 坐标y方向的起点 [0, height-1]
+ * @param    image RGB565图像数据首地址
+ * @param    width 图像宽度(像素)
+ * @param    height 图像高度(像素)
+ * @return   无
+ * @example  DisplayIps200::showRgbImage(0, 0, rgb_buf, 100, 80);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::showRgbImage(uint16 x, uint16 y, const uint16 *image, uint16 width, uint16 height)
+{
+    copyRect(x, y, image, width, height, width);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示灰度图像并缩放到目标矩形
+ * @param    x,y,w,h 目标矩形
+ * @param    image 灰度图像首地址
+ * @param    image_width 图像宽度(像素)
+ * @param    image_height 图像高度(像素)
+ * @param    image_stride 图像每行字节数 0表示等于image_width
+ * @param    mode 缩放方式
+ * @return   无
+ * @example  DisplayIps200::blitGray(0, 0, 240, 180, gray.data, gray.cols, gray.rows, gray.step);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::blitGray(int x, int y, int w, int h, const uint8 *image, int image_width, int image_height, int image_stride, ips200_scale_enum mode)
+{
+    int full_w = w, full_h = h;
+    int skip_x = 0, skip_y = 0;
+
+    if(nullptr == image || 0 >= image_width || 0 >= image_height)
+    {
+        return;
+    }
+    if(!clipRect(&x, &y, &w, &h, &skip_x, &skip_y))
+    {
+        return;
+    }
+    if(nullptr != back_buffer)
+    {
+        addDirty(x, y, w, h);
+    }
+    ips200_blit<1>(screen_base + y * stride + x, stride, w, h, skip_x, skip_y, full_w, full_h,
+                   image, image_width, image_height, (0 < image_stride) ? image_stride : image_width, mode);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示BGR888图像并缩放到目标矩形
+ * @param    x,y,w,h 目标矩形
+ * @param    image BGR888图像首地址
+ * @param    image_width 图像宽度(像素)
+ * @param    image_height 图像高度(像素)
+ * @param    image_stride 图像每行字节数 0表示等于image_width*3
+ * @param    mode 缩放方式
+ * @return   无
+ * @example  DisplayIps200::blitBgr(0, 0, 240, 180, frame.data, frame.cols, frame.rows, frame.step);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::blitBgr(int x, int y, int w, int h, const uint8 *image, int image_width, int image_height, int image_stride, ips200_scale_enum mode)
+{
+    int full_w = w, full_h = h;
+    int skip_x = 0, skip_y = 0;
+
+    if(nullptr == image || 0 >= image_width || 0 >= image_height)
+    {
+        return;
+    }
+    if(!clipRect(&x, &y, &w, &h, &skip_x, &skip_y))
+    {
+        return;
+    }
+    if(nullptr != back_buffer)
+    {
+        addDirty(x, y, w, h);
+    }
+    ips200_blit<3>(screen_base + y * stride + x, stride, w, h, skip_x, skip_y, full_w, full_h,
+                   image, image_width, image_height, (0 < image_stride) ? image_stride : image_width * 3, mode);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    启用后台缓冲
+ * @return   0-成功 -1-失败
+ * @example  DisplayIps200::enableBackBuffer();
+ *---------------------------------------------------------------------
+ */
+int DisplayIps200::enableBackBuffer(void)
+{
+    if(nullptr != back_buffer)
+    {
+        return 0;
+    }
+    if(nullptr == screen_base || 0 >= width || 0 >= height)
+    {
+        return -1;
+    }
+
+    back_buffer = new (std::nothrow) uint16[(size_t)width * height];
+    if(nullptr == back_buffer)
+    {
+        return -1;
+    }
+    for(int i = 0; i < height; i ++)
+    {
+        memcpy(back_buffer + i * width, screen_base + i * stride, (size_t)width * sizeof(uint16));
+    }
+
+    fb_base = screen_base;
+    fb_stride = stride;
+    screen_base = back_buffer;
+    stride = width;
+    ips200_dirty_count = 0;
+    return 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    关闭后台缓冲
+ * @return   无
+ * @example  DisplayIps200::disableBackBuffer();
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::disableBackBuffer(void)
+{
+    if(nullptr == back_buffer)
+    {
+        return;
+    }
+    stopPresentThread();
+    present();
+
+    screen_base = fb_base;
+    stride = fb_stride;
+    delete[] back_buffer;
+    back_buffer = nullptr;
+    fb_base = nullptr;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    提交一帧
+ * @return   本次提交的像素数
+ * @example  DisplayIps200::present();
+ *---------------------------------------------------------------------
+ */
+uint32 DisplayIps200::present(void)
+{
+    uint32 pixels = 0;
+
+    if(nullptr == back_buffer)
+    {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(ips200_present_mutex);
+    for(uint32 i = 0; i < ips200_dirty_count; i ++)
+    {
+        const ips200_rect_struct *rect = &ips200_dirty[i];
+        if(nullptr != ips200_present_timer)
+        {
+            ips200_rect_copy(ips200_staging, width, back_buffer, width, rect);
+            ips200_rect_add(ips200_pending, &ips200_pending_count, *rect);
+        }
+        else
+        {
+            ips200_rect_copy(fb_base, fb_stride, back_buffer, width, rect);
+        }
+        pixels += (uint32)rect->w * rect->h;
+    }
+    ips200_dirty_count = 0;
+    return pixels;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    把已提交的区域从暂存缓冲写入显存
+ * @return   无
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::flushPending(void)
+{
+    std::lock_guard<std::mutex> lock(ips200_present_mutex);
+    for(uint32 i = 0; i < ips200_pending_count; i ++)
+    {
+        ips200_rect_copy(fb_base, fb_stride, ips200_staging, width, &ips200_pending[i]);
+    }
+    ips200_pending_count = 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    启动刷新线程
+ * @param    fps 帧率上限
+ * @return   0-成功 -1-失败
+ * @example  DisplayIps200::startPresentThread(30);
+ *---------------------------------------------------------------------
+ */
+int DisplayIps200::startPresentThread(uint32 fps)
+{
+    rt_thread_policy_struct policy = {SCHED_OTHER, 0, RT_CPU_ANY, 0};
+
+    if(nullptr == back_buffer || nullptr != ips200_present_timer || 0 == fps)
+    {
+        return -1;
+    }
+
+    ips200_staging = new (std::nothrow) uint16[(size_t)width * height];
+    if(nullptr == ips200_staging)
+    {
+        return -1;
+    }
+    ips200_pending_count = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(ips200_present_mutex);
+        ips200_present_timer = new timer_fd(std::chrono::nanoseconds(1000000000ULL / fps), [](){ flushPending(); });
+    }
+    ips200_present_timer->set_overrun_policy(PIT_OVERRUN_SKIP);
+    ips200_present_timer->set_rt_policy(&policy);
+    ips200_present_timer->start();
+    return 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    停止刷新线程
+ * @return   无
+ * @example  DisplayIps200::stopPresentThread();
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::stopPresentThread(void)
+{
+    if(nullptr == ips200_present_timer)
+    {
+        return;
+    }
+    ips200_present_timer->stop();
+    flushPending();
+
+    std::lock_guard<std::mutex> lock(ips200_present_mutex);
+    delete ips200_present_timer;
+    ips200_present_timer = nullptr;
+    delete[] ips200_staging;
+    ips200_staging = nullptr;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读取单调时钟
+ * @return   毫秒
+ * @details  等待驱动使用真实时间 不受仿真时钟影响
+ *---------------------------------------------------------------------
+ */
+static uint64_t ips200_clock_ms(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    查询驱动模块状态
+ * @param    name 模块名
+ * @return   模块状态
+ * @details  /proc/modules 每行格式为 名称 大小 引用数 依赖 状态 地址
+ *---------------------------------------------------------------------
+ */
+static ips200_module_state_enum ips200_module_state(const char *name)
+{
+    ips200_module_state_enum state = IPS200_MODULE_ABSENT;
+    size_t length = strlen(name);
+    char line[512];
+    FILE *fp = fopen("/proc/modules", "re");
+
+    if(nullptr == fp)
+    {
+        return IPS200_MODULE_ABSENT;
+    }
+    while(nullptr != fgets(line, sizeof(line), fp))
+    {
+        if(0 == strncmp(line, name, length) && ' ' == line[length])
+        {
+            state = (nullptr != strstr(line + length, " Live ")) ? IPS200_MODULE_LIVE : IPS200_MODULE_BUSY;
+            break;
+        }
+    }
+    fclose(fp);
+    return state;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    打开framebuffer并读取屏幕参数
+ * @param    path 设备节点路径
+ * @param    fb_var 输出可变参数
+ * @param    fb_fix 输出固定参数
+ * @return   文件描述符 设备不存在或参数不是16位色时返回-1
+ *---------------------------------------------------------------------
+ */
+static int ips200_fb_open(const char *path, struct fb_var_screeninfo *fb_var, struct fb_fix_screeninfo *fb_fix)
+{
+    int fd = open(path, O_RDWR | O_CLOEXEC);
+
+    if(0 > fd)
+    {
+        return -1;
+    }
+    if(0 > ioctl(fd, FBIOGET_VSCREENINFO, fb_var) || 0 > ioctl(fd, FBIOGET_FSCREENINFO, fb_fix) ||
+       0 == fb_var->xres || 0 == fb_var->yres || 16 != fb_var->bits_per_pixel ||
+       fb_fix->line_length < fb_var->xres * sizeof(uint16))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    轮询等待framebuffer可用
+ * @param    path 设备节点路径
+ * @param    fb_var 输出可变参数
+ * @param    fb_fix 输出固定参数
+ * @param    deadline_ms 截止时刻 ips200_clock_ms的时间基准
+ * @return   文件描述符 超时返回-1
+ * @details  至少尝试一次 驱动加载后设备节点由udev/mdev创建 需要等待
+ *---------------------------------------------------------------------
+ */
+static int ips200_fb_wait(const char *path, struct fb_var_screeninfo *fb_var, struct fb_fix_screeninfo *fb_fix, uint64_t deadline_ms)
+{
+    int fd = ips200_fb_open(path, fb_var, fb_fix);
+
+    while(0 > fd && ips200_clock_ms() < deadline_ms)
+    {
+        usleep(IPS200_POLL_INTERVAL_US);
+        fd = ips200_fb_open(path, fb_var, fb_fix);
+    }
+    return fd;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    卸载驱动模块并等待完成
+ * @param    name 模块名
+ * @param    deadline_ms 截止时刻
+ * @return   0-成功 -1-失败 模块正在被使用时失败
+ *---------------------------------------------------------------------
+ */
+static int ips200_module_unload(const char *name, uint64_t deadline_ms)
+{
+    // O_NONBLOCK 与 rmmod 相同 模块正在被使用时立即返回 EWOULDBLOCK
+    if(0 != syscall(SYS_delete_module, name, O_NONBLOCK) && ENOENT != errno)
+    {
+        return -1;
+    }
+    while(IPS200_MODULE_ABSENT != ips200_module_state(name))
+    {
+        if(ips200_clock_ms() >= deadline_ms)
+        {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+        usleep(IPS200_POLL_INTERVAL_US);
+    }
+    return 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    加载驱动模块
+ * @param    path 模块文件路径
+ * @return   0-成功或模块已存在 -1-失败
+ * @details  内核不支持finit_module时映射文件后用init_module加载
+ *---------------------------------------------------------------------
+ */
+static int ips200_module_load(const char *path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    int ret = -1;
+    int error = 0;
+
+    if(0 > fd)
+    {
+        return -1;
+    }
+    ret = (int)syscall(SYS_finit_module, fd, "", 0);
+    if(0 != ret && ENOSYS == errno)
+    {
+        struct stat st;
+        void *image = MAP_FAILED;
+
+        if(0 == fstat(fd, &st))
+        {
+            image = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        if(MAP_FAILED != image)
+        {
+            ret = (int)syscall(SYS_init_module, image, (unsigned long)st.st_size, "");
+            error = errno;
+            munmap(image, (size_t)st.st_size);
+            errno = error;
+        }
+    }
+    error = errno;
+    close(fd);
+    errno = error;
+    return (0 == ret || EEXIST == errno) ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示屏初始化函数
+ * @param    path framebuffer设备节点路径，如"/dev/fb0"
+ * @param    driver_mode 驱动加载方式 见ips200_driver_mode_enum
+ * @return   0-成功 -1-失败
+ * @example  DisplayIps200::init("/dev/fb0");
+ *---------------------------------------------------------------------
+ */
+int DisplayIps200::init(const char *path, uint8 driver_mode)
+{
+    struct fb_fix_screeninfo fb_fix;
+    struct fb_var_screeninfo fb_var;
+    uint64_t begin_ms = ips200_clock_ms();
+    ips200_module_state_enum state = IPS200_MODULE_ABSENT;
+    size_t screen_size = 0;
+    void *map = MAP_FAILED;
+    int fd = -1;
+
+    disableBackBuffer();
+    if(nullptr != ips200_fb_map)
+    {
+        munmap(ips200_fb_map, ips200_fb_map_size);
+        ips200_fb_map = nullptr;
+        screen_base = nullptr;
+    }
+
+    if(IPS200_DRIVER_KEEP == driver_mode)
+    {
+        fd = ips200_fb_open(path, &fb_var, &fb_fix);
+    }
+    else if(IPS200_DRIVER_AUTO == driver_mode)
+    {
+        // 驱动已加载时直接使用 其他进程正在加载时等待其完成
+        state = ips200_module_state(IPS200_MODULE_NAME);
+        if(IPS200_MODULE_ABSENT != state)
+        {
+            fd = ips200_fb_wait(path, &fb_var, &fb_fix, (IPS200_MODULE_LIVE == state) ? 0 : begin_ms + IPS200_READY_TIMEOUT_MS);
+        }
+    }
+
+    if(0 > fd && IPS200_DRIVER_KEEP != driver_mode)
+    {
+        std::cout << "ips200: 加载" IPS200_MODULE_NAME "驱动..." << std::endl;
+        if(IPS200_MODULE_ABSENT != ips200_module_state(IPS200_MODULE_NAME) &&
+           0 != ips200_module_unload(IPS200_MODULE_NAME, ips200_clock_ms() + IPS200_READY_TIMEOUT_MS))
+        {
+            std::cerr << "ips200: 卸载" IPS200_MODULE_NAME "驱动失败: " << strerror(errno) << std::endl;
+            return -1;
+        }
+        if(0 != ips200_module_load(IPS200_MODULE_PATH))
+        {
+            std::cerr << "ips200: 加载" IPS200_MODULE_PATH "失败: " << strerror(errno) << std::endl;
+            return -1;
+        }
+        fd = ips200_fb_wait(path, &fb_var, &fb_fix, ips200_clock_ms() + IPS200_READY_TIMEOUT_MS);
+        std::cout << "ips200: 驱动加载用时 " << ips200_clock_ms() - begin_ms << " ms" << std::endl;
+    }
+
+    if(0 > fd)
+    {
+        std::cerr << "ips200: 打开framebuffer设备" << path << "失败" << std::endl;
+        return -1;
+    }
+
+    screen_size = (size_t)fb_fix.line_length * fb_var.yres;
+    map = mmap(nullptr, screen_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);                                                          // 映射在关闭文件后仍然有效
+    if(MAP_FAILED == map)
+    {
+        std::cerr << "ips200: mmap映射显存失败" << std::endl;
+        return -1;
+    }
+
+    ips200_fb_map = map;
+    ips200_fb_map_size = screen_size;
+    DisplayIps200::width = fb_var.xres;
+    DisplayIps200::height = fb_var.yres;
+    DisplayIps200::stride = fb_fix.line_length / sizeof(uint16);
+    screen_base = (unsigned short *)map;
+
+    full(DEFAULT_BGCOLOR);
+    return 0;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    绑定内存显存
+ * @param    buffer 显存首地址，RGB565格式，大小不小于stride*height
+ * @param    width 显存宽度(像素)
+ * @param    height 显存高度(像素)
+ * @param    stride 每行像素数 0表示等于width
+ * @return   无
+ * @example  static uint16 frame[240*320]; DisplayIps200::attach(frame, 240, 320);
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200::attach(uint16 *buffer, int width, int height, int stride)
+{
+    disableBackBuffer();
+    DisplayIps200::width = width;
+    DisplayIps200::height = height;
+    DisplayIps200::stride = (0 < stride) ? stride : width;
+    screen_base = buffer;
+    style_version ++;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    构造函数
+ * @param    x 坐标x方向的起点
+ * @param    y 坐标y方向的起点
+ * @param    length 显示的字符数
+ * @example  DisplayIps200Field speed_field(56, 130, 8);
+ *---------------------------------------------------------------------
+ */
+DisplayIps200Field::DisplayIps200Field(uint16 x, uint16 y, uint8 length)
+    : x(x), y(y), length((IPS200_FIELD_MAX < length) ? IPS200_FIELD_MAX : length), style_version(0)
+{
+    last[0] = '\0';
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示字符串
+ * @param    dat 字符串
+ * @return   实际重绘的字符数
+ * @example  state_field.showString("RUN");
+ *---------------------------------------------------------------------
+ */
+uint8 DisplayIps200Field::showString(const char dat[])
+{
+    char text[IPS200_FIELD_MAX + 1];
+    uint8 drawn = 0;
+    uint8 i = 0;
+    bool redraw_all = ('\0' == last[0] || style_version != DisplayIps200::style_version);
+    int glyph_width = DisplayIps200::getFontWidth();
+
+    // 补空格到固定长度 变短时擦除多出的字符
+    for(i = 0; i < length && '\0' != dat[i]; i ++)
+    {
+        text[i] = dat[i];
+    }
+    for(; i < length; i ++)
+    {
+        text[i] = ' ';
+    }
+    text[length] = '\0';
+
+    for(i = 0; i < length; i ++)
+    {
+        if(redraw_all || text[i] != last[i])
+        {
+            DisplayIps200::showChar(x + glyph_width * i, y, text[i]);
+            drawn ++;
+        }
+    }
+    memcpy(last, text, sizeof(text));
+    style_version = DisplayIps200::style_version;
+    return drawn;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示有符号整型数
+ * @param    dat 需要显示的变量
+ * @param    num 整数显示长度
+ * @return   实际重绘的字符数
+ * @example  angle_field.showInt(angle, 4);
+ *---------------------------------------------------------------------
+ */
+uint8 DisplayIps200Field::showInt(const int32 dat, uint8 num)
+{
+    char data_buffer[12];
+
+    ips200_format_int(data_buffer, dat, num);
+    return showString(data_buffer);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示无符号整型数
+ * @param    dat 需要显示的变量
+ * @param    num 整数显示长度
+ * @return   实际重绘的字符数
+ * @example  count_field.showUint(count, 5);
+ *---------------------------------------------------------------------
+ */
+uint8 DisplayIps200Field::showUint(const uint32 dat, uint8 num)
+{
+    char data_buffer[12];
+
+    ips200_format_uint(data_buffer, dat, num);
+    return showString(data_buffer);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    显示浮点数
+ * @param    dat 需要显示的变量
+ * @param    num 整数位显示长度
+ * @param    pointnum 小数位显示长度
+ * @return   实际重绘的字符数
+ * @example  speed_field.showFloat(speed, 3, 2);
+ *---------------------------------------------------------------------
+ */
+uint8 DisplayIps200Field::showFloat(const double dat, uint8 num, uint8 pointnum)
+{
+    char data_buffer[17];
+
+    ips200_format_float(data_buffer, dat, num, pointnum);
+    return showString(data_buffer);
+}
+
+/*---------------------------------------------------------------------
+ * @brief    下一次显示时整体重绘
+ * @return   无
+ * @example  speed_field.invalidate();
+ *---------------------------------------------------------------------
+ */
+void DisplayIps200Field::invalidate(void)
+{
+    last[0] = '\0';
 }
@@ -19,6 +19,38 @@
 #define DEFAULT_PENCOLOR         (RGB565_RED)                          // 默认的画笔颜色
 #define DEFAULT_BGCOLOR          (RGB565_WHITE)                        // 默认的背景颜色
 #define FB_PATH                 "/dev/fb0"                             // framebuffer设备节点路径
+#define IPS200_MODULE_NAME       "fb_st7789v"                          // 屏幕驱动模块名 与/proc/modules中的名称一致
+#define IPS200_MODULE_PATH       "/lib/modules/4.19.190/fb_st7789v.ko" // 屏幕驱动模块文件
+#define IPS200_READY_TIMEOUT_MS  (2000)                                // 加载或卸载驱动后等待完成的最长时间
+#define IPS200_POLL_INTERVAL_US  (2000)                                // 等待驱动时的查询间隔
+#define IPS200_DIRTY_MAX         (16)                                  // 脏矩形列表长度 超出后与增量面积最小的矩形合并
+#define IPS200_PRESENT_FPS       (30)                                  // 刷新线程默认帧率上限
+
+#define IPS200_GLYPH_COUNT       (95)                                  // 字模缓存的字符数 ' '~'~'
+#define IPS200_FIELD_MAX         (24)                                  // 数值控件最多显示的字符数
+#define IPS200_LINE_LIMIT        (1 << 28)                             // 画线坐标的绝对值上限 超出时不绘制 保证裁剪计算不溢出
+
+// 字体
+typedef enum
+{
+    IPS200_6X8_FONT = 0,                                               // 6x8 字体 只有 ' '~'z'
+    IPS200_8X16_FONT,                                                  // 8x16 字体 默认
+}ips200_font_size_enum;
+
+// 驱动加载方式
+typedef enum
+{
+    IPS200_DRIVER_KEEP = 0,                                            // 不加载驱动 直接打开framebuffer
+    IPS200_DRIVER_AUTO,                                                // 驱动未加载或framebuffer不可用时才加载 默认
+    IPS200_DRIVER_RELOAD,                                              // 总是卸载后重新加载 用于屏幕花屏等需要重新初始化屏幕的情况
+}ips200_driver_mode_enum;
+
+// 图像缩放方式
+typedef enum
+{
+    IPS200_SCALE_NEAREST = 0,                                          // 最近邻 整数倍放大时重复的行直接拷贝上一行
+    IPS200_SCALE_BILINEAR,                                             // 双线性 8位权重定点计算 缩小时不做额外的低通滤波
+}ips200_scale_enum;
 
 /*---------------------------------------------------------------------
  * @brief    IPS200显示屏驱动类
@@ -35,12 +67,223 @@ private:
     // 而不是点运算符.（点运算符用于结构体成员访问）
     static uint16 pen_color;                   // 画笔颜色
     static uint16 bg_color;                    // 背景颜色
+    static ips200_font_size_enum font;         // 当前字体
+    static uint32 style_version;               // 颜色 字体或整屏内容改变时递增 数值控件据此判断是否需要整体重绘
     static int width;                          // 屏幕宽度
     static int height;                         // 屏幕高度
-    static unsigned short *screen_base;        // 映射后的显存基地址
+    static int stride;                         // 显存每行的像素数 由fb_fix.line_length换算 可能大于width
+    static unsigned short *screen_base;        // 绘图目标 启用后台缓冲时指向back_buffer
+    static unsigned short *fb_base;            // 启用后台缓冲时保存的显存基地址
+    static int fb_stride;                      // 启用后台缓冲时保存的显存stride
+    static uint16 *back_buffer;                // 后台缓冲 未启用为nullptr
+
+    /*---------------------------------------------------------------------
+     * @brief    把矩形裁剪到屏幕范围内
+     * @param    x,y,w,h 矩形 裁剪后原地修改
+     * @param    src_x,src_y 源图像中对应的起点偏移输出 可以为NULL
+     * @return   true-裁剪后仍有像素需要绘制
+     *---------------------------------------------------------------------
+     */
+    static bool clipRect(int *x, int *y, int *w, int *h, int *src_x, int *src_y);
+
+    /*---------------------------------------------------------------------
+     * @brief    写一个像素 不记录脏区域
+     * @details  供内部逐点绘制使用 调用者自行对整块区域调用markDirty
+     *---------------------------------------------------------------------
+     */
+    static inline void setPixel(uint16 x, uint16 y, const uint16 color)
+    {
+        if(nullptr != screen_base)
+        {
+            screen_base[y * stride + x] = color;
+        }
+    }
+
+    /*---------------------------------------------------------------------
+     * @brief    把矩形加入脏矩形列表
+     * @details  与已有矩形重叠或相邻时合并 矩形已经裁剪过
+     *---------------------------------------------------------------------
+     */
+    static void addDirty(int x, int y, int w, int h);
+
+    /*---------------------------------------------------------------------
+     * @brief    把已提交的区域从暂存缓冲写入显存
+     * @details  刷新线程每周期调用 stopPresentThread时调用一次
+     *---------------------------------------------------------------------
+     */
+    static void flushPending(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    按当前字体与颜色重建字模缓存
+     * @details  每个字符展开为逐行排列的RGB565像素 显示时每行一次拷贝
+     *---------------------------------------------------------------------
+     */
+    static void buildGlyphCache(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    光栅化一条线段 不记录脏区域
+     * @details  区域编码判断整体在屏幕外的线段 水平线裁剪后整段填充
+     *           其余线段只遍历屏幕内的一段 绘制的像素与未裁剪时的整数Bresenham算法完全相同
+     *           bound输出实际绘制的像素范围 最小x 最小y 最大x 最大y
+     *---------------------------------------------------------------------
+     */
+    static bool rasterLine(int x0, int y0, int x1, int y1, const uint16 color, int *bound);
+
+    /*---------------------------------------------------------------------
+     * @brief    折线的公共实现
+     * @details  element_size为1或2 对应uint8或uint16坐标数组
+     *---------------------------------------------------------------------
+     */
+    static void drawPolylineImpl(int x_offset, int y_offset, const void *x, const void *y, uint8 element_size, uint32 count, const uint16 color);
+
+    friend class DisplayIps200Field;
 
 public:
 
+    /*---------------------------------------------------------------------
+     * @brief    获取屏幕宽度
+     * @return   像素 未初始化返回0
+     * @example  int w = DisplayIps200::getWidth();
+     *---------------------------------------------------------------------
+     */
+    static int getWidth(void) { return width; }
+
+    /*---------------------------------------------------------------------
+     * @brief    获取屏幕高度
+     * @return   像素 未初始化返回0
+     * @example  int h = DisplayIps200::getHeight();
+     *---------------------------------------------------------------------
+     */
+    static int getHeight(void) { return height; }
+
+    /*---------------------------------------------------------------------
+     * @brief    启用后台缓冲
+     * @details  在内存中分配一份与屏幕同尺寸的缓冲并拷入当前显存内容
+     *           之后所有绘图函数写入该缓冲并记录脏矩形 present时只把脏矩形拷入显存
+     *           fbtft按被写入的显存页推送SPI 只写变化的区域可以成倍减少刷屏数据量
+     *           也避免了在图像上叠加文字时屏幕刷出中间状态
+     * @return   0-成功 -1-未初始化或内存不足
+     * @example  DisplayIps200::init(); DisplayIps200::enableBackBuffer();
+     *---------------------------------------------------------------------
+     */
+    static int enableBackBuffer(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    关闭后台缓冲
+     * @details  停止刷新线程 提交剩余脏区域后释放缓冲 绘图恢复为直接写显存
+     * @return   无
+     * @example  DisplayIps200::disableBackBuffer();
+     *---------------------------------------------------------------------
+     */
+    static void disableBackBuffer(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    标记脏区域
+     * @details  直接修改getBuffer返回的缓冲后调用 绘图函数内部已自动标记
+     * @param    x 矩形左上角x 可以为负
+     * @param    y 矩形左上角y 可以为负
+     * @param    w 矩形宽度(像素)
+     * @param    h 矩形高度(像素)
+     * @return   无
+     * @example  DisplayIps200::markDirty(0, 0, 160, 120);
+     *---------------------------------------------------------------------
+     */
+    static inline void markDirty(int x, int y, int w, int h)
+    {
+        if(nullptr != back_buffer && clipRect(&x, &y, &w, &h, nullptr, nullptr))
+        {
+            addDirty(x, y, w, h);
+        }
+    }
+
+    /*---------------------------------------------------------------------
+     * @brief    获取当前绘图目标
+     * @return   启用后台缓冲时为后台缓冲 否则为显存 每行getStride个像素
+     * @example  uint16 *buffer = DisplayIps200::getBuffer();
+     *---------------------------------------------------------------------
+     */
+    static uint16 *getBuffer(void) { return screen_base; }
+
+    /*---------------------------------------------------------------------
+     * @brief    获取当前绘图目标每行的像素数
+     * @return   像素
+     * @example  int stride = DisplayIps200::getStride();
+     *---------------------------------------------------------------------
+     */
+    static int getStride(void) { return stride; }
+
+    /*---------------------------------------------------------------------
+     * @brief    提交一帧
+     * @details  未启动刷新线程时 把全部脏矩形拷入显存后返回
+     *           已启动刷新线程时 只把脏矩形拷入暂存缓冲 由刷新线程按帧率上限写入显存
+     *           两次刷新之间多次提交的区域合并后只写一次
+     *           绘图与present应在同一线程调用
+     * @return   本次提交的像素数 未启用后台缓冲返回0
+     * @example  DisplayIps200::showString(0, 0, "speed"); DisplayIps200::present();
+     *---------------------------------------------------------------------
+     */
+    static uint32 present(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    启动刷新线程
+     * @details  普通调度优先级 不与控制线程争抢CPU 错过的周期直接跳过
+     * @param    fps 帧率上限 一般不超过屏幕刷新率
+     * @return   0-成功 -1-未启用后台缓冲或已启动
+     * @example  DisplayIps200::enableBackBuffer(); DisplayIps200::startPresentThread(30);
+     *---------------------------------------------------------------------
+     */
+    static int startPresentThread(uint32 fps = IPS200_PRESENT_FPS);
+
+    /*---------------------------------------------------------------------
+     * @brief    停止刷新线程
+     * @details  等待线程退出 已提交但尚未写入显存的区域立即写入
+     * @return   无
+     * @example  DisplayIps200::stopPresentThread();
+     *---------------------------------------------------------------------
+     */
+    static void stopPresentThread(void);
+
+    /*---------------------------------------------------------------------
+     * @brief    连续填充一段像素
+     * @details  先按像素对齐到8字节 中间部分一次写4个像素 编译器可进一步合并为向量存储
+     * @param    dst 起始地址
+     * @param    count 像素数
+     * @param    color 颜色格式RGB565
+     * @return   无
+     * @example  DisplayIps200::fillSpan(line, 240, RGB565_BLACK);
+     *---------------------------------------------------------------------
+     */
+    static void fillSpan(uint16 *dst, uint32 count, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    矩形填充
+     * @details  按行写入显存 行间按stride跳转 超出屏幕的部分被裁剪
+     * @param    x 矩形左上角x 可以为负
+     * @param    y 矩形左上角y 可以为负
+     * @param    w 矩形宽度(像素)
+     * @param    h 矩形高度(像素)
+     * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+     * @return   无
+     * @example  DisplayIps200::fillRect(0, 300, 240, 20, RGB565_BLACK);
+     *---------------------------------------------------------------------
+     */
+    static void fillRect(int x, int y, int w, int h, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    矩形拷贝
+     * @details  每行一次memcpy 超出屏幕的部分被裁剪
+     * @param    x 目标左上角x 可以为负
+     * @param    y 目标左上角y 可以为负
+     * @param    image RGB565源图像首地址
+     * @param    w 拷贝宽度(像素)
+     * @param    h 拷贝高度(像素)
+     * @param    image_stride 源图像每行像素数 0表示等于w
+     * @return   无
+     * @example  DisplayIps200::copyRect(0, 0, frame, 160, 120, 0);
+     *---------------------------------------------------------------------
+     */
+    static void copyRect(int x, int y, const uint16 *image, int w, int h, int image_stride = 0);
+
     /*---------------------------------------------------------------------
      * @brief    清屏函数
      * @return   无
@@ -51,6 +294,7 @@ public:
 
     /*---------------------------------------------------------------------
      * @brief    屏幕填充函数
+     * @details  按实际分辨率填充 行间无填充字节时整屏一次连续写入
      * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
      * @return   无
      * @example  DisplayIps200::full(RGB565_BLACK);
@@ -65,30 +309,134 @@ public:
      * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
      * @return   无
      * @example  DisplayIps200::drawPoint(10, 20, RGB565_BLUE);
+     * @details  超出屏幕的点直接忽略
+     *           启用后台缓冲时每个点单独记录脏区域 大量逐点绘制时直接写getBuffer后调用一次markDirty
      *---------------------------------------------------------------------
      */
     static void drawPoint(uint16 x, uint16 y, const uint16 color);
 
     /*---------------------------------------------------------------------
      * @brief    画线函数
-     * @param    x_start 坐标x方向的起点 [0, width-1]
-     * @param    y_start 坐标y方向的起点 [0, height-1]
-     * @param    x_end 坐标x方向的终点 [0, width-1]
-     * @param    y_end 坐标y方向的终点 [0, height-1]
+     * @param    x_start 坐标x方向的起点 可以超出屏幕
+     * @param    y_start 坐标y方向的起点 可以超出屏幕
+     * @param    x_end 坐标x方向的终点 可以超出屏幕
+     * @param    y_end 坐标y方向的终点 可以超出屏幕
      * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
      * @return   无
      * @example  DisplayIps200::drawLine(0, 0, 10, 10, RGB565_RED);
+     * @details  整数Bresenham算法 区域编码排除整体在屏幕外的线段 端点在屏幕外时只遍历屏幕内的一段
+     *---------------------------------------------------------------------
+     */
+    static void drawLine(int x_start, int y_start, int x_end, int y_end, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    画折线
+     * @details  依次连接相邻的点 整条折线只记录一次脏区域
+     *           x或y为NULL时该坐标取点的序号 即X_BOUNDARY形式的边线数组可以直接传入
+     * @param    x_offset 所有点的x偏移 通常为图像在屏幕上的左上角
+     * @param    y_offset 所有点的y偏移
+     * @param    x 横坐标数组 可以为NULL
+     * @param    y 纵坐标数组 可以为NULL
+     * @param    count 点数
+     * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+     * @return   无
+     * @example  DisplayIps200::drawPolyline(0, 0, left_border, NULL, MT9V03X_H, RGB565_RED);
      *---------------------------------------------------------------------
      */
-    static void drawLine(uint16 x_start, uint16 y_start, uint16 x_end, uint16 y_end, const uint16 color);
+    static void drawPolyline(int x_offset, int y_offset, const uint8 *x, const uint8 *y, uint32 count, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    画折线 坐标为uint16数组
+     * @details  同uint8版本 用于宽度超过255的图像
+     * @example  DisplayIps200::drawPolyline(0, 0, xy_x, xy_y, 160, RGB565_BLUE);
+     *---------------------------------------------------------------------
+     */
+    static void drawPolyline(int x_offset, int y_offset, const uint16 *x, const uint16 *y, uint32 count, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    画矩形边框
+     * @param    x 矩形左上角x 可以为负
+     * @param    y 矩形左上角y 可以为负
+     * @param    w 矩形宽度(像素)
+     * @param    h 矩形高度(像素)
+     * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+     * @return   无
+     * @example  DisplayIps200::drawRect(10, 10, 50, 30, RGB565_GREEN);
+     * @details  四条边分别按整行或整列填充
+     *---------------------------------------------------------------------
+     */
+    static void drawRect(int x, int y, int w, int h, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    画圆
+     * @param    x_center 圆心x 可以超出屏幕
+     * @param    y_center 圆心y 可以超出屏幕
+     * @param    radius 半径(像素)
+     * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+     * @return   无
+     * @example  DisplayIps200::drawCircle(120, 160, 50, RGB565_BLUE);
+     * @details  整数中点画圆算法 超出屏幕的点不绘制
+     *---------------------------------------------------------------------
+     */
+    static void drawCircle(int x_center, int y_center, int radius, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    画实心圆
+     * @param    x_center 圆心x 可以超出屏幕
+     * @param    y_center 圆心y 可以超出屏幕
+     * @param    radius 半径(像素)
+     * @param    color 颜色格式RGB565或rgb565_color_enum枚举值
+     * @return   无
+     * @example  DisplayIps200::fillCircle(120, 160, 8, RGB565_RED);
+     * @details  中点画圆算法求出每行的左右边界 逐行整段填充
+     *---------------------------------------------------------------------
+     */
+    static void fillCircle(int x_center, int y_center, int radius, const uint16 color);
+
+    /*---------------------------------------------------------------------
+     * @brief    设置画笔与背景颜色
+     * @param    pen 画笔颜色 RGB565
+     * @param    bg 背景颜色 RGB565
+     * @return   无
+     * @example  DisplayIps200::setColor(RGB565_BLACK, RGB565_WHITE);
+     * @details  字模缓存在下一次显示字符时按新颜色重建 频繁切换颜色会反复重建
+     *---------------------------------------------------------------------
+     */
+    static void setColor(const uint16 pen, const uint16 bg);
+
+    /*---------------------------------------------------------------------
+     * @brief    设置字体
+     * @param    font IPS200_8X16_FONT 或 IPS200_6X8_FONT
+     * @return   无
+     * @example  DisplayIps200::setFont(IPS200_6X8_FONT);
+     *---------------------------------------------------------------------
+     */
+    static void setFont(const ips200_font_size_enum font);
+
+    /*---------------------------------------------------------------------
+     * @brief    获取当前字体的字符宽度
+     * @return   像素
+     * @example  x += DisplayIps200::getFontWidth();
+     *---------------------------------------------------------------------
+     */
+    static int getFontWidth(void) { return (IPS200_6X8_FONT == font) ? 6 : 8; }
+
+    /*---------------------------------------------------------------------
+     * @brief    获取当前字体的字符高度
+     * @return   像素
+     * @example  y += DisplayIps200::getFontHeight();
+     *---------------------------------------------------------------------
+     */
+    static int getFontHeight(void) { return (IPS200_6X8_FONT == font) ? 8 : 16; }
 
     /*---------------------------------------------------------------------
      * @brief    显示单个字符
      * @param    x 坐标x方向的起点 [0, width-1]
      * @param    y 坐标y方向的起点 [0, height-1]
-     * @param    dat 需要显示的单个字符
+     * @param    dat 需要显示的单个字符 字体中没有的字符显示为空格
      * @return   无
      * @example  DisplayIps200::showChar(10, 20, 'A');
+     * @details  从字模缓存按行拷贝 超出屏幕的部分被裁剪
      *---------------------------------------------------------------------
      */
     static void showChar(uint16 x, uint16 y, const char dat);
@@ -150,6 +498,7 @@ public:
      * @param    height 图像高度(像素)
      * @return   无
      * @example  DisplayIps200::showGrayImage(0, 0, gray_buf, 100, 80);
+     * @details  等同于不缩放的blitGray
      *---------------------------------------------------------------------
      */
     static void showGrayImage(uint16 x, uint16 y, const uint8 *image, uint16 width, uint16 height);
@@ -167,15 +516,147 @@ public:
      */
     static void showRgbImage(uint16 x, uint16 y, const uint16 *image, uint16 width, uint16 height);
 
+    /*---------------------------------------------------------------------
+     * @brief    显示灰度图像并缩放到目标矩形
+     * @details  经256项查找表转换为RGB565 逐行写入 目标矩形超出屏幕的部分被裁剪
+     *           图像与目标矩形尺寸相同时不做缩放 整行连续转换
+     * @param    x 目标左上角x 可以为负
+     * @param    y 目标左上角y 可以为负
+     * @param    w 目标宽度(像素)
+     * @param    h 目标高度(像素)
+     * @param    image 灰度图像首地址
+     * @param    image_width 图像宽度(像素)
+     * @param    image_height 图像高度(像素)
+     * @param    image_stride 图像每行字节数 0表示等于image_width
+     * @param    mode 缩放方式
+     * @return   无
+     * @example  DisplayIps200::blitGray(0, 0, 240, 180, gray.data, gray.cols, gray.rows, gray.step);
+     *---------------------------------------------------------------------
+     */
+    static void blitGray(int x, int y, int w, int h, const uint8 *image, int image_width, int image_height, int image_stride = 0, ips200_scale_enum mode = IPS200_SCALE_NEAREST);
+
+    /*---------------------------------------------------------------------
+     * @brief    显示BGR888图像并缩放到目标矩形
+     * @details  按OpenCV默认的B G R字节顺序读取 转换为RGB565后逐行写入 其余同blitGray
+     * @param    x 目标左上角x 可以为负
+     * @param    y 目标左上角y 可以为负
+     * @param    w 目标宽度(像素)
+     * @param    h 目标高度(像素)
+     * @param    image BGR888图像首地址
+     * @param    image_width 图像宽度(像素)
+     * @param    image_height 图像高度(像素)
+     * @param    image_stride 图像每行字节数 0表示等于image_width*3
+     * @param    mode 缩放方式
+     * @return   无
+     * @example  DisplayIps200::blitBgr(0, 0, 240, 180, frame.data, frame.cols, frame.rows, frame.step, IPS200_SCALE_BILINEAR);
+     *---------------------------------------------------------------------
+     */
+    static void blitBgr(int x, int y, int w, int h, const uint8 *image, int image_width, int image_height, int image_stride = 0, ips200_scale_enum mode = IPS200_SCALE_NEAREST);
+
     /*---------------------------------------------------------------------
      * @brief    显示屏初始化函数
      * @param    path framebuffer设备节点路径，如"/dev/fb0"
-     * @param    is_reload_driver 是否重新加载驱动，默认为1
+     * @param    driver_mode 驱动加载方式 见ips200_driver_mode_enum 默认IPS200_DRIVER_AUTO
+     * @return   0-成功 -1-失败 失败原因输出到标准错误 不会退出程序
+     * @example  if(0 != DisplayIps200::init()) { 不使用屏幕继续运行 }
+     * @details  驱动已加载且framebuffer为16位色时直接使用 不再卸载重装 程序重启时几乎不耗时
+     *           需要加载时通过finit_module系统调用加载模块 不创建子进程
+     *           加载或卸载后轮询模块列表与framebuffer 就绪即返回 不使用固定延时
+     *           会关闭已启用的后台缓冲 重复调用时释放上一次的显存映射
+     *---------------------------------------------------------------------
+     */
+    static int init(const char *path = FB_PATH, uint8 driver_mode = IPS200_DRIVER_AUTO);
+
+    /*---------------------------------------------------------------------
+     * @brief    绑定内存显存
+     * @param    buffer 显存首地址，RGB565格式，大小不小于stride*height
+     * @param    width 显存宽度(像素)
+     * @param    height 显存高度(像素)
+     * @param    stride 每行像素数 0表示等于width
+     * @return   无
+     * @example  static uint16 frame[240*320]; DisplayIps200::attach(frame, 240, 320);
+     * @details  不打开framebuffer设备，所有绘图函数改为写入该内存
+     *           用于离屏绘制和主机上的性能测试 会关闭已启用的后台缓冲
+     *---------------------------------------------------------------------
+     */
+    static void attach(uint16 *buffer, int width, int height, int stride = 0);
+};
+
+/*---------------------------------------------------------------------
+ * @brief    屏幕数值控件
+ * @details  记住上一次显示的字符串 再次显示时只重绘变化的字符
+ *           数字每帧刷新的调试界面通常只有一两个字符改变
+ *           颜色 字体改变或整屏填充后自动整体重绘
+ *---------------------------------------------------------------------
+ */
+class DisplayIps200Field
+{
+private:
+    uint16 x;                                  // 起点x
+    uint16 y;                                  // 起点y
+    uint8 length;                              // 显示的字符数 不足时补空格 超出时截断
+    uint32 style_version;                      // 上次绘制时的DisplayIps200::style_version
+    char last[IPS200_FIELD_MAX + 1];           // 上次显示的字符串 空表示尚未绘制
+
+public:
+    /*---------------------------------------------------------------------
+     * @brief    构造函数
+     * @param    x 坐标x方向的起点
+     * @param    y 坐标y方向的起点
+     * @param    length 显示的字符数 最多IPS200_FIELD_MAX
+     * @example  DisplayIps200Field speed_field(56, 130, 8);
+     *---------------------------------------------------------------------
+     */
+    DisplayIps200Field(uint16 x, uint16 y, uint8 length);
+
+    /*---------------------------------------------------------------------
+     * @brief    显示字符串
+     * @param    dat 字符串
+     * @return   实际重绘的字符数
+     * @example  state_field.showString(running ? "RUN" : "STOP");
+     *---------------------------------------------------------------------
+     */
+    uint8 showString(const char dat[]);
+
+    /*---------------------------------------------------------------------
+     * @brief    显示有符号整型数
+     * @param    dat 需要显示的变量
+     * @param    num 整数显示长度 同DisplayIps200::showInt
+     * @return   实际重绘的字符数
+     * @example  angle_field.showInt(angle, 4);
+     *---------------------------------------------------------------------
+     */
+    uint8 showInt(const int32 dat, uint8 num);
+
+    /*---------------------------------------------------------------------
+     * @brief    显示无符号整型数
+     * @param    dat 需要显示的变量
+     * @param    num 整数显示长度 同DisplayIps200::showUint
+     * @return   实际重绘的字符数
+     * @example  count_field.showUint(count, 5);
+     *---------------------------------------------------------------------
+     */
+    uint8 showUint(const uint32 dat, uint8 num);
+
+    /*---------------------------------------------------------------------
+     * @brief    显示浮点数
+     * @param    dat 需要显示的变量
+     * @param    num 整数位显示长度 同DisplayIps200::showFloat
+     * @param    pointnum 小数位显示长度
+     * @return   实际重绘的字符数
+     * @example  speed_field.showFloat(speed, 3, 2);
+     *---------------------------------------------------------------------
+     */
+    uint8 showFloat(const double dat, uint8 num, uint8 pointnum);
+
+    /*---------------------------------------------------------------------
+     * @brief    下一次显示时整体重绘
      * @return   无
-     * @example  DisplayIps200::init("/dev/fb0");
+     * @example  DisplayIps200::fillRect(0, 120, 240, 60, RGB565_WHITE); speed_field.invalidate();
+     * @details  只覆盖了部分区域时调用 整屏填充会自动处理
      *---------------------------------------------------------------------
      */
-    static void init(const char *path = FB_PATH, uint8 is_reload_driver = 1);
+    void invalidate(void);
 };
 
 #endif
@@ -3,9 +3,10 @@
 
 
 #include "zf_common_typedef.hpp"
+#include "zf_common_time.hpp"
 
-#define system_delay_ms(time)  (usleep(time*1000))
-#define system_delay_us(time)  (usleep(time))
+#define system_delay_ms(time)  (time_sleep_ns((uint64_t)(time) * 1000000))
+#define system_delay_us(time)  (time_sleep_ns((uint64_t)(time) * 1000))
 
 
 #endif
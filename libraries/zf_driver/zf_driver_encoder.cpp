@@ -28,6 +28,21 @@ int16 zf_driver_encoder::get_count(void)
     return data;
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取编码器计数值并返回读取结果
+// 参数说明 count 编码器当前计数值
+// 返回参数 int8  0-成功 -1-读取失败
+// 使用示例 encoder_obj.read_count(&cnt);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_encoder::read_count(int16 *count)
+{
+    int16 data = 0;
+    if(NULL == count || 0 != this->read_buff((uint8*)&data, sizeof(data))) return -1;
+    *count = data;
+    return 0;
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介 清零编码器计数值
 // 参数说明 无
@@ -38,6 +38,15 @@ public:
 //-------------------------------------------------------------------------------------------------------------------
     int16 get_count(void);
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取编码器计数值并返回读取结果
+// 参数说明 count 编码器当前计数值
+// 返回参数 int8  0-成功 -1-读取失败 count不修改
+// 使用示例 int16 cnt; if(0 == encoder_obj.read_count(&cnt)) { ... }
+// 备注信息 与get_count相同只有一次read 便于调用者区分读取失败与计数为0
+//-------------------------------------------------------------------------------------------------------------------
+    int8 read_count(int16 *count);
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介 清零编码器计数值
 // 参数说明 无
@@ -17,8 +17,21 @@ zf_driver_pit::zf_driver_pit(void)
     pit_timer_fd = -1;
     pit_epoll_fd = -1;
     pit_thread_id = 0;    // ✅ 修复1: pthread_t是无符号类型，初始化用0表示未创建，替代-1
-    pit_period_ms = PIT_MIN_PERIOD_MS;
     pit_user_callback = NULL;
+    pit_missed_callback = NULL;
+    pit_overrun_policy = PIT_OVERRUN_SKIP;
+    pit_sim_timer = -1;
+    pit_rt_policy.sched_policy = SCHED_FIFO;
+    pit_rt_policy.sched_priority = PIT_THREAD_PRIORITY;
+    pit_rt_policy.cpu = RT_CPU_ANY;
+    pit_rt_policy.stack_prefault = RT_STACK_PREFAULT_DEFAULT;
+    pit_start_ns = 0;
+    pit_period_ns = (uint64_t)PIT_MIN_PERIOD_MS * 1000000;
+    pit_wait_mode = PIT_WAIT_SLEEP;
+    pit_spin_margin_ns = 0;
+    pit_expire_total = 0;
+    pit_missed_count = 0;
+    pit_overrun_count = 0;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -35,33 +48,17 @@ zf_driver_pit::~zf_driver_pit(void)
 }
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介  设置线程为SCHED_FIFO实时调度+99级最高优先级
-// 参数说明  无
-// 返回参数  int 成功返回0 失败返回-1
+// 函数简介  纳秒时间转换为timespec
+// 参数说明  ns 时间，单位ns
+// 参数说明  ts 转换结果
+// 返回参数  void
 // 使用示例  内部调用，无需外部调用
-// 备注信息  龙芯MIPS架构完美兼容，单核下线程独占CPU无任何抢占
+// 备注信息  tv_nsec 必须小于1秒 否则timerfd_settime返回EINVAL
 //-------------------------------------------------------------------------------------------------------------------
-int zf_driver_pit::set_realtime_priority(void)
+static void pit_ns_to_timespec(uint64_t ns, struct timespec *ts)
 {
-    pthread_attr_t attr;
-    struct sched_param sched_param;
-
-    pthread_attr_init(&attr);
-    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
-    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
-    memset(&sched_param, 0, sizeof(sched_param));
-    sched_param.sched_priority = PIT_THREAD_PRIORITY;
-    pthread_attr_setschedparam(&attr, &sched_param);
-
-    if (pthread_setschedparam(pit_thread_id, SCHED_FIFO, &sched_param) != 0)
-    {
-        perror("pthread_setschedparam error");
-        pthread_attr_destroy(&attr);
-        return -1;
-    }
-
-    pthread_attr_destroy(&attr);
-    return 0;
+    ts->tv_sec  = ns / 1000000000;
+    ts->tv_nsec = ns % 1000000000;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
@@ -105,6 +102,7 @@ void *zf_driver_pit::pit_timer_thread(void *arg)
     int ret = 0;
 
     prctl(PR_SET_NAME, "pit_timer_thread");
+    rt_thread_setup(&pit_obj->pit_rt_policy);                                   // 锁定内存 设置优先级与CPU绑定 预触碰栈 失败时已打印警告
 
     while (!pit_obj->pit_exit_flag)
     {
@@ -120,10 +118,9 @@ void *zf_driver_pit::pit_timer_thread(void *arg)
         {
             if (events[i].data.fd == pit_obj->pit_timer_fd && (events[i].events & EPOLLIN))
             {
-                read(pit_obj->pit_timer_fd, &timer_expire_cnt, sizeof(uint64_t));
-                if(pit_obj->pit_user_callback != NULL)
+                if (read(pit_obj->pit_timer_fd, &timer_expire_cnt, sizeof(uint64_t)) == sizeof(uint64_t) && timer_expire_cnt > 0)
                 {
-                    pit_obj->pit_user_callback();
+                    pit_obj->timer_expire(timer_expire_cnt);
                 }
             }
         }
@@ -132,6 +129,73 @@ void *zf_driver_pit::pit_timer_thread(void *arg)
     pthread_exit(NULL);
 }
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  仿真定时器回调
+// 参数说明  arg 类对象指针
+// 返回参数  void
+// 使用示例  内部调用，无需外部调用
+// 备注信息  虚拟时间恰好等于计划到期时刻 唤醒延迟恒为0 不会错过周期
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit::pit_sim_expire(void *arg)
+{
+    ((zf_driver_pit *)arg)->timer_expire(1);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  处理一次定时器唤醒
+// 参数说明  expire_cnt 从timerfd读出的到期次数
+// 返回参数  void
+// 使用示例  内部调用，无需外部调用
+// 备注信息  唤醒延迟以最近一次到期的计划时刻为基准 错过的周期单独计数
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit::timer_expire(uint64_t expire_cnt)
+{
+    pit_overrun_policy_enum policy = pit_overrun_policy.load(std::memory_order_relaxed);
+    uint64_t wake_ns = 0;
+    uint64_t deadline_ns = 0;
+    uint64_t exec_start_ns = 0;
+    uint64_t exec_ns = 0;
+    uint64_t run_cnt = (policy == PIT_OVERRUN_BURST) ? expire_cnt : 1;
+    uint32 missed = (expire_cnt - 1 > UINT32_MAX) ? UINT32_MAX : (uint32)(expire_cnt - 1);
+
+    pit_expire_total += expire_cnt;
+    deadline_ns = pit_start_ns + (pit_expire_total - 1) * pit_period_ns;
+    wake_ns = time_now_ns();
+    if (pit_wait_mode == PIT_WAIT_HYBRID)
+    {
+        while (wake_ns < deadline_ns)                                           // timerfd提前spin_margin到期 剩余时间忙等
+        {
+            wake_ns = time_now_ns();
+        }
+    }
+    pit_latency_hist.record(wake_ns > deadline_ns ? wake_ns - deadline_ns : 0);
+    if (missed > 0)
+    {
+        pit_missed_count.fetch_add(missed, std::memory_order_relaxed);
+    }
+
+    for (uint64_t i = 0; i < run_cnt; i++)
+    {
+        exec_start_ns = time_now_ns();
+        rt_section_enter();
+        if (pit_missed_callback != NULL)
+        {
+            pit_missed_callback(policy == PIT_OVERRUN_ONCE ? missed : 0);
+        }
+        else if (pit_user_callback != NULL)
+        {
+            pit_user_callback();
+        }
+        rt_section_exit();
+        exec_ns = time_now_ns() - exec_start_ns;
+        pit_exec_hist.record(exec_ns);
+        if (exec_ns > pit_period_ns)
+        {
+            pit_overrun_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介  PIT定时器初始化，配置周期并注册回调函数
 // 参数说明  period_ms 定时器周期，单位ms
@@ -142,18 +206,142 @@ void *zf_driver_pit::pit_timer_thread(void *arg)
 //-------------------------------------------------------------------------------------------------------------------
 int zf_driver_pit::init_ms(uint32_t period_ms, pit_callback_fun callback)
 {
-    struct itimerspec timer_spec;
-    struct epoll_event epoll_ev;
-    int ret = 0;
+    if(callback == NULL)
+    {
+        printf("pit_init error: callback function is null!\n");
+        return -1;
+    }
+    pit_user_callback = callback;
+    pit_missed_callback = NULL;
 
-    pit_period_ms = period_ms;
+    return timer_start((uint64_t)period_ms * 1000000);
+}
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  PIT定时器初始化，注册带错过周期数的回调函数
+// 参数说明  period_ms 定时器周期，单位ms
+// 参数说明  callback 用户业务回调函数指针，参数为错过的周期数
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  pit_timer.init_ms(1, control_callback);
+// 备注信息  溢出策略自动设为PIT_OVERRUN_ONCE
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit::init_ms(uint32_t period_ms, pit_callback_missed_fun callback)
+{
     if(callback == NULL)
     {
         printf("pit_init error: callback function is null!\n");
         return -1;
     }
+    pit_user_callback = NULL;
+    pit_missed_callback = callback;
+    pit_overrun_policy = PIT_OVERRUN_ONCE;
+
+    return timer_start((uint64_t)period_ms * 1000000);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  PIT定时器初始化，纳秒分辨率周期
+// 参数说明  period 定时器周期
+// 参数说明  callback 用户业务回调函数指针
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  pit_timer.init_ns(std::chrono::microseconds(250), current_loop);
+// 备注信息  无
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit::init_ns(std::chrono::nanoseconds period, pit_callback_fun callback)
+{
+    if(callback == NULL)
+    {
+        printf("pit_init error: callback function is null!\n");
+        return -1;
+    }
+    if(period.count() < PIT_MIN_PERIOD_NS)
+    {
+        printf("pit_init error: period must be at least %d ns!\n", PIT_MIN_PERIOD_NS);
+        return -1;
+    }
     pit_user_callback = callback;
+    pit_missed_callback = NULL;
+
+    return timer_start((uint64_t)period.count());
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  PIT定时器初始化，纳秒分辨率周期，注册带错过周期数的回调函数
+// 参数说明  period 定时器周期
+// 参数说明  callback 用户业务回调函数指针，参数为错过的周期数
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  pit_timer.init_ns(std::chrono::microseconds(250), current_loop);
+// 备注信息  溢出策略自动设为PIT_OVERRUN_ONCE
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit::init_ns(std::chrono::nanoseconds period, pit_callback_missed_fun callback)
+{
+    if(callback == NULL)
+    {
+        printf("pit_init error: callback function is null!\n");
+        return -1;
+    }
+    if(period.count() < PIT_MIN_PERIOD_NS)
+    {
+        printf("pit_init error: period must be at least %d ns!\n", PIT_MIN_PERIOD_NS);
+        return -1;
+    }
+    pit_user_callback = NULL;
+    pit_missed_callback = callback;
+    pit_overrun_policy = PIT_OVERRUN_ONCE;
+
+    return timer_start((uint64_t)period.count());
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置等待到期的方式
+// 参数说明  mode 等待方式
+// 参数说明  spin_margin 混合等待时timerfd提前唤醒的时间
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.set_wait_mode(PIT_WAIT_HYBRID, std::chrono::microseconds(30));
+// 备注信息  PIT_WAIT_SLEEP时忽略spin_margin
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit::set_wait_mode(pit_wait_mode_enum mode, std::chrono::nanoseconds spin_margin)
+{
+    pit_wait_mode = mode;
+    pit_spin_margin_ns = (mode == PIT_WAIT_HYBRID && spin_margin.count() > 0) ? (uint64_t)spin_margin.count() : 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  创建定时器与线程
+// 参数说明  period_ns 定时器周期，单位ns
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  内部调用，无需外部调用
+// 备注信息  使用绝对时间定时 第一次立即到期 之后第k次到期的计划时刻固定为 启动时刻 + k * 周期
+//           混合等待时timerfd整体提前spin_margin 计划时刻不变
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit::timer_start(uint64_t period_ns)
+{
+    struct itimerspec timer_spec;
+    struct epoll_event epoll_ev;
+    int ret = 0;
+
+    if (pit_spin_margin_ns >= period_ns)
+    {
+        printf("pit_init error: spin margin must be shorter than period!\n");
+        return -1;
+    }
+
+    pit_period_ns = period_ns;
+    pit_expire_total = 0;
+    pit_exit_flag = 0;
+
+    if (time_get_source() == TIME_SOURCE_SIM)
+    {
+        // 仿真时钟 不创建timerfd和线程 由time_sim_advance_ns推进虚拟时间时调用回调
+        pit_start_ns = time_now_ns();
+        pit_sim_timer = time_sim_timer_add(pit_sim_expire, this, pit_start_ns, pit_period_ns);
+        if (pit_sim_timer < 0)
+        {
+            return -1;
+        }
+        printf("pit init success, period = %.3f ms, simulated clock\r\n", pit_period_ns / 1000000.0);
+        return 0;
+    }
 
     pit_timer_fd = timerfd_handle_init();
     if (pit_timer_fd < 0)
@@ -163,12 +351,11 @@ int zf_driver_pit::init_ms(uint32_t period_ms, pit_callback_fun callback)
     }
 
     memset(&timer_spec, 0, sizeof(timer_spec));
-    timer_spec.it_interval.tv_sec  = pit_period_ms / 1000;
-    timer_spec.it_interval.tv_nsec = (pit_period_ms % 1000) * 1000000;
-    timer_spec.it_value.tv_sec     = 0;
-    timer_spec.it_value.tv_nsec    = 1;
+    pit_start_ns = time_now_ns();
+    pit_ns_to_timespec(pit_period_ns, &timer_spec.it_interval);
+    pit_ns_to_timespec(pit_start_ns - pit_spin_margin_ns, &timer_spec.it_value);
 
-    ret = timerfd_settime(pit_timer_fd, 0, &timer_spec, NULL);
+    ret = timerfd_settime(pit_timer_fd, TFD_TIMER_ABSTIME, &timer_spec, NULL);
     if (ret < 0)
     {
         perror("timerfd_settime error");
@@ -211,12 +398,7 @@ int zf_driver_pit::init_ms(uint32_t period_ms, pit_callback_fun callback)
         return -1;
     }
 
-    if (set_realtime_priority() != 0)
-    {
-        printf("pit warning: 请用sudo运行程序，否则无法设置实时优先级！\n");
-    }
-
-    printf("pit init success, period = %d ms\r\n", pit_period_ms);
+    printf("pit init success, period = %.3f ms\r\n", pit_period_ns / 1000000.0);
     return 0;
 }
 
@@ -233,6 +415,12 @@ void zf_driver_pit::stop(void)
 
     pit_exit_flag = 1;
 
+    if(pit_sim_timer >= 0)
+    {
+        time_sim_timer_remove(pit_sim_timer);
+        pit_sim_timer = -1;
+    }
+
     if(pit_thread_id != 0)    // ✅ 修复2: 无符号类型判断，0表示未创建线程，非0表示有效线程ID
     {
         pthread_join(pit_thread_id, NULL);
@@ -252,5 +440,110 @@ void zf_driver_pit::stop(void)
     }
 
     pit_user_callback = NULL;
+    pit_missed_callback = NULL;
     printf("pit timer stop success, resource release ok\n");
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置定时器溢出处理策略
+// 参数说明  policy 溢出策略
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.set_overrun_policy(PIT_OVERRUN_BURST);
+// 备注信息  定时器线程每次唤醒读取一次 运行中修改无需加锁
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit::set_overrun_policy(pit_overrun_policy_enum policy)
+{
+    pit_overrun_policy = policy;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置定时器线程的实时配置
+// 参数说明  policy 线程配置
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.set_rt_policy(&policy);
+// 备注信息  配置在定时器线程启动时由rt_thread_setup应用
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit::set_rt_policy(const rt_thread_policy_struct *policy)
+{
+    if (policy != NULL)
+    {
+        pit_rt_policy = *policy;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取唤醒延迟直方图
+// 参数说明  无
+// 返回参数  const zf_common_histogram& 单位ns
+// 使用示例  pit_timer.get_latency_hist().print("latency(us)", 1000);
+// 备注信息  无
+//-------------------------------------------------------------------------------------------------------------------
+const zf_common_histogram &zf_driver_pit::get_latency_hist(void)
+{
+    return pit_latency_hist;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取回调执行耗时直方图
+// 参数说明  无
+// 返回参数  const zf_common_histogram& 单位ns
+// 使用示例  pit_timer.get_exec_hist().print("exec(us)", 1000);
+// 备注信息  无
+//-------------------------------------------------------------------------------------------------------------------
+const zf_common_histogram &zf_driver_pit::get_exec_hist(void)
+{
+    return pit_exec_hist;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取错过的周期数
+// 参数说明  无
+// 返回参数  uint64_t 错过的周期数累计
+// 使用示例  uint64_t missed = pit_timer.get_missed_count();
+// 备注信息  无
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t zf_driver_pit::get_missed_count(void)
+{
+    return pit_missed_count.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取回调超时次数
+// 参数说明  无
+// 返回参数  uint64_t 回调执行耗时超过周期的次数
+// 使用示例  uint64_t overrun = pit_timer.get_overrun_count();
+// 备注信息  无
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t zf_driver_pit::get_overrun_count(void)
+{
+    return pit_overrun_count.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  清空所有统计
+// 参数说明  无
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.reset_stat();
+// 备注信息  常用于初始化阶段结束后 丢弃启动过程中的异常样本
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit::reset_stat(void)
+{
+    pit_latency_hist.reset();
+    pit_exec_hist.reset();
+    pit_missed_count = 0;
+    pit_overrun_count = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  打印定时统计
+// 参数说明  无
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.print_stat();
+// 备注信息  时间单位换算为us输出
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit::print_stat(void)
+{
+    printf("pit period %.3f ms, %s, missed %" PRIu64 ", overrun %" PRIu64 "\r\n", pit_period_ns / 1000000.0, (pit_wait_mode == PIT_WAIT_HYBRID) ? "hybrid" : "sleep", get_missed_count(), get_overrun_count());
+    pit_latency_hist.print("pit wake latency(us)", 1000);
+    pit_exec_hist.print("pit callback exec(us)", 1000);
 }
\ No newline at end of file
@@ -2,11 +2,32 @@
 #define __zf_driver_pit_HPP__
 
 #include "zf_common_typedef.hpp"
+#include "zf_common_histogram.hpp"
+#include "zf_common_rt.hpp"
+#include "zf_common_time.hpp"
 
 #define PIT_MIN_PERIOD_MS        1
 #define PIT_MAX_PERIOD_MS     1000
+#define PIT_MIN_PERIOD_NS    20000                                              // init_ns允许的最短周期 20us
+#define PIT_SPIN_MARGIN_NS   50000                                              // 混合等待默认提前唤醒量 50us
 
 typedef void (*pit_callback_fun)(void);
+typedef void (*pit_callback_missed_fun)(uint32 missed);                         // missed 为本次唤醒前错过的周期数
+
+// 定时器溢出处理策略 回调执行过久或线程被阻塞时 一次唤醒可能对应多个到期周期
+typedef enum
+{
+    PIT_OVERRUN_SKIP = 0,                                                       // 只执行一次回调 错过的周期丢弃 仅计入统计
+    PIT_OVERRUN_BURST,                                                          // 错过几个周期就连续补执行几次回调
+    PIT_OVERRUN_ONCE,                                                           // 只执行一次回调 并把错过的周期数传给回调 由控制律自行补偿
+}pit_overrun_policy_enum;
+
+// 等待到期的方式
+typedef enum
+{
+    PIT_WAIT_SLEEP = 0,                                                         // 完全由timerfd唤醒 等待期间不占用CPU 抖动取决于内核唤醒延迟
+    PIT_WAIT_HYBRID,                                                            // timerfd提前spin_margin唤醒 再忙等到计划时刻 抖动更小 每周期多占用spin_margin的CPU
+}pit_wait_mode_enum;
 
 //-------------------------------------------------------------------------------------------------------------------
 // 类名         zf_driver_pit
@@ -19,8 +40,21 @@ private:
     int pit_timer_fd;
     int pit_epoll_fd;
     pthread_t pit_thread_id;
-    uint32_t pit_period_ms;
     pit_callback_fun pit_user_callback;
+    pit_callback_missed_fun pit_missed_callback;
+    std::atomic<pit_overrun_policy_enum> pit_overrun_policy;
+    int pit_sim_timer;                                                          // 仿真时钟下注册的仿真定时器编号 -1表示未注册
+    rt_thread_policy_struct pit_rt_policy;                                      // 定时器线程的调度策略/优先级/CPU绑定/栈预触碰配置
+
+    uint64_t pit_start_ns;                                                      // 第一次到期的计划时刻 CLOCK_MONOTONIC
+    uint64_t pit_period_ns;
+    pit_wait_mode_enum pit_wait_mode;
+    uint64_t pit_spin_margin_ns;                                                // 混合等待时timerfd提前到期的时间
+    uint64_t pit_expire_total;                                                  // 累计到期次数 用于推算每次到期的计划时刻
+    zf_common_histogram pit_latency_hist;                                       // 唤醒延迟 实际唤醒时刻减去计划到期时刻
+    zf_common_histogram pit_exec_hist;                                          // 回调执行耗时
+    std::atomic<uint64_t> pit_missed_count;                                     // 错过的周期数 即一次唤醒对应多次到期时多出的次数
+    std::atomic<uint64_t> pit_overrun_count;                                    // 回调执行耗时超过周期的次数
 
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介  PIT定时器核心线程处理函数
@@ -32,13 +66,32 @@ private:
     static void *pit_timer_thread(void *arg);
 
 //-------------------------------------------------------------------------------------------------------------------
-// 函数简介  设置线程为SCHED_FIFO最高优先级实时调度策略
-// 参数说明  无
+// 函数简介  仿真定时器回调
+// 参数说明  arg 类对象指针
+// 返回参数  void
+// 使用示例  内部调用，无需外部调用
+// 备注信息  仿真时钟下由time_sim_advance_ns在推进线程中调用 每次对应一次到期
+//-------------------------------------------------------------------------------------------------------------------
+    static void pit_sim_expire(void *arg);
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  创建定时器与线程
+// 参数说明  period_ns 定时器周期，单位ns
 // 返回参数  int 成功返回0 失败返回-1
 // 使用示例  内部调用，无需外部调用
-// 备注信息  龙芯单核独占CPU无抢占，替代x86的cli/sti指令，强实时核心保障
+// 备注信息  回调函数由init_ms/init_ns的各个重载预先设置
+//-------------------------------------------------------------------------------------------------------------------
+    int timer_start(uint64_t period_ns);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  处理一次定时器唤醒
+// 参数说明  expire_cnt 从timerfd读出的到期次数
+// 返回参数  void
+// 使用示例  内部调用，无需外部调用
+// 备注信息  记录唤醒延迟 按溢出策略执行回调并记录执行耗时
 //-------------------------------------------------------------------------------------------------------------------
-    int set_realtime_priority(void);
+    void timer_expire(uint64_t expire_cnt);
 
 public:
 
@@ -70,6 +123,119 @@ public:
 //-------------------------------------------------------------------------------------------------------------------
     int init_ms(uint32_t period_ms, pit_callback_fun callback);
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  PIT定时器初始化，注册带错过周期数的回调函数
+// 参数说明  period_ms 定时器周期，单位ms
+// 参数说明  callback 定时器回调函数指针，参数为本次唤醒前错过的周期数，不能为空
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  pit_timer.init_ms(1, control_callback);
+// 备注信息  溢出策略自动设为PIT_OVERRUN_ONCE 回调可按 (missed + 1) 个周期计算积分等时间相关量
+//-------------------------------------------------------------------------------------------------------------------
+    int init_ms(uint32_t period_ms, pit_callback_missed_fun callback);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  PIT定时器初始化，纳秒分辨率周期
+// 参数说明  period 定时器周期，std::chrono时长，不小于PIT_MIN_PERIOD_NS
+// 参数说明  callback 定时器回调函数指针，不能为空
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  pit_timer.init_ns(std::chrono::microseconds(250), current_loop);
+// 备注信息  到期时刻为 启动时刻 + k * period 的绝对时间 不随回调耗时累积漂移
+//-------------------------------------------------------------------------------------------------------------------
+    int init_ns(std::chrono::nanoseconds period, pit_callback_fun callback);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  PIT定时器初始化，纳秒分辨率周期，注册带错过周期数的回调函数
+// 参数说明  period 定时器周期，std::chrono时长，不小于PIT_MIN_PERIOD_NS
+// 参数说明  callback 定时器回调函数指针，参数为本次唤醒前错过的周期数，不能为空
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  pit_timer.init_ns(std::chrono::microseconds(250), current_loop);
+// 备注信息  溢出策略自动设为PIT_OVERRUN_ONCE
+//-------------------------------------------------------------------------------------------------------------------
+    int init_ns(std::chrono::nanoseconds period, pit_callback_missed_fun callback);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置等待到期的方式
+// 参数说明  mode 等待方式，见pit_wait_mode_enum
+// 参数说明  spin_margin 混合等待时timerfd提前唤醒的时间，应略大于实测唤醒延迟的p99，且小于周期
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.set_wait_mode(PIT_WAIT_HYBRID, std::chrono::microseconds(30));
+// 备注信息  必须在init_ms/init_ns之前调用 默认PIT_WAIT_SLEEP
+//           单核平台忙等期间其他线程无法运行 提前量越大占用CPU越多
+//-------------------------------------------------------------------------------------------------------------------
+    void set_wait_mode(pit_wait_mode_enum mode, std::chrono::nanoseconds spin_margin = std::chrono::nanoseconds(PIT_SPIN_MARGIN_NS));
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置定时器溢出处理策略
+// 参数说明  policy 溢出策略，见pit_overrun_policy_enum
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.set_overrun_policy(PIT_OVERRUN_BURST);
+// 备注信息  默认PIT_OVERRUN_SKIP 运行中可随时修改 下一次唤醒生效
+//           使用无参数回调时PIT_OVERRUN_ONCE与PIT_OVERRUN_SKIP行为相同
+//-------------------------------------------------------------------------------------------------------------------
+    void set_overrun_policy(pit_overrun_policy_enum policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置定时器线程的实时配置
+// 参数说明  policy 线程配置，见rt_thread_policy_struct
+// 返回参数  void 无返回值
+// 使用示例  rt_thread_policy_struct policy = {SCHED_FIFO, 90, 0, 128 * 1024};
+// 使用示例  pit_timer.set_rt_policy(&policy);
+// 备注信息  必须在init_ms/init_ns之前调用 默认SCHED_FIFO 99 不绑定CPU 预触碰RT_STACK_PREFAULT_DEFAULT字节栈
+//           线程启动时锁定进程内存 回调执行期间处于实时区间 定义ZF_RT_DEBUG时检查回调中的内存分配与阻塞调用
+//-------------------------------------------------------------------------------------------------------------------
+    void set_rt_policy(const rt_thread_policy_struct *policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取唤醒延迟直方图
+// 参数说明  无
+// 返回参数  const zf_common_histogram& 单位ns
+// 使用示例  uint64_t p99 = pit_timer.get_latency_hist().get_percentile(99);
+// 备注信息  任意线程均可查询
+//-------------------------------------------------------------------------------------------------------------------
+    const zf_common_histogram &get_latency_hist(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取回调执行耗时直方图
+// 参数说明  无
+// 返回参数  const zf_common_histogram& 单位ns
+// 使用示例  uint64_t max = pit_timer.get_exec_hist().get_max();
+// 备注信息  任意线程均可查询
+//-------------------------------------------------------------------------------------------------------------------
+    const zf_common_histogram &get_exec_hist(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取错过的周期数
+// 参数说明  无
+// 返回参数  uint64_t 一次唤醒对应多次到期时多出的次数累计
+// 使用示例  uint64_t missed = pit_timer.get_missed_count();
+//-------------------------------------------------------------------------------------------------------------------
+    uint64_t get_missed_count(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取回调超时次数
+// 参数说明  无
+// 返回参数  uint64_t 回调执行耗时超过定时器周期的次数
+// 使用示例  uint64_t overrun = pit_timer.get_overrun_count();
+//-------------------------------------------------------------------------------------------------------------------
+    uint64_t get_overrun_count(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  清空所有统计
+// 参数说明  无
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.reset_stat();
+//-------------------------------------------------------------------------------------------------------------------
+    void reset_stat(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  打印定时统计
+// 参数说明  无
+// 返回参数  void 无返回值
+// 使用示例  pit_timer.print_stat();
+// 备注信息  使用printf输出 不要在回调中调用
+//-------------------------------------------------------------------------------------------------------------------
+    void print_stat(void);
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介  停止PIT定时器并释放所有资源
 // 参数说明  无
@@ -1,5 +1,8 @@
 #include "zf_driver_pit_fd.hpp"
 
+#define TIMER_FD_THREAD_PRIORITY 10
+
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介 构造函数
 // 参数说明 interval 定时触发间隔，单位毫秒
@@ -9,7 +12,52 @@
 // 备注信息 初始化定时器参数，默认未启动状态
 //-------------------------------------------------------------------------------------------------------------------
 timer_fd::timer_fd(int interval, const std::function<void()>& func)
-    : interval(interval), func(func), running(false)
+    : timer_fd(std::chrono::milliseconds(interval), func)
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数 回调带错过周期数
+// 参数说明 interval 定时触发间隔，单位毫秒
+// 参数说明 func     定时触发的回调函数，参数为错过的周期数
+// 返回参数 无
+// 使用示例 timer_fd timer(1, [](uint32 missed){ control(missed + 1); });
+// 备注信息 溢出策略默认为PIT_OVERRUN_ONCE
+//-------------------------------------------------------------------------------------------------------------------
+timer_fd::timer_fd(int interval, const std::function<void(uint32)>& func)
+    : timer_fd(std::chrono::milliseconds(interval), func)
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数 纳秒分辨率间隔
+// 参数说明 interval 定时触发间隔
+// 参数说明 func     定时触发的回调函数
+// 返回参数 无
+// 使用示例 timer_fd timer(std::chrono::microseconds(250), callback_func);
+// 备注信息 负数间隔按0处理 由init_timer_fd报错
+//-------------------------------------------------------------------------------------------------------------------
+timer_fd::timer_fd(std::chrono::nanoseconds interval, const std::function<void()>& func)
+    : interval_ns(interval.count() > 0 ? (uint64_t)interval.count() : 0), func(func), running(false),
+      overrun_policy(PIT_OVERRUN_BURST), start_ns(0), wait_mode(PIT_WAIT_SLEEP), spin_margin_ns(0),
+      rt_policy{SCHED_FIFO, TIMER_FD_THREAD_PRIORITY, RT_CPU_ANY, RT_STACK_PREFAULT_DEFAULT},
+      expire_total(0), sim_timer(-1), missed_count(0), overrun_count(0)
+{
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数 纳秒分辨率间隔 回调带错过周期数
+// 参数说明 interval 定时触发间隔
+// 参数说明 func     定时触发的回调函数，参数为错过的周期数
+// 返回参数 无
+// 使用示例 timer_fd timer(std::chrono::microseconds(250), [](uint32 missed){ control(missed + 1); });
+// 备注信息 溢出策略默认为PIT_OVERRUN_ONCE
+//-------------------------------------------------------------------------------------------------------------------
+timer_fd::timer_fd(std::chrono::nanoseconds interval, const std::function<void(uint32)>& func)
+    : interval_ns(interval.count() > 0 ? (uint64_t)interval.count() : 0), missed_func(func), running(false),
+      overrun_policy(PIT_OVERRUN_ONCE), start_ns(0), wait_mode(PIT_WAIT_SLEEP), spin_margin_ns(0),
+      rt_policy{SCHED_FIFO, TIMER_FD_THREAD_PRIORITY, RT_CPU_ANY, RT_STACK_PREFAULT_DEFAULT},
+      expire_total(0), sim_timer(-1), missed_count(0), overrun_count(0)
 {
 }
 
@@ -35,6 +83,19 @@ timer_fd::~timer_fd()
 void timer_fd::start() 
 {
     if (running) return;
+    if (time_get_source() == TIME_SOURCE_SIM)
+    {
+        // 仿真时钟 不创建线程，由time_sim_advance_ns推进虚拟时间时调用回调
+        if (interval_ns < PIT_MIN_PERIOD_NS) {
+            printf("timer_fd error: interval must be at least %d ns!\n", PIT_MIN_PERIOD_NS);
+            return;
+        }
+        expire_total = 0;
+        start_ns = time_now_ns() + interval_ns;
+        sim_timer = time_sim_timer_add(&timer_fd::sim_expire, this, start_ns, interval_ns);
+        running = (sim_timer >= 0);
+        return;
+    }
     running = true;
     timerThread = std::thread(&timer_fd::timer_loop, this);
 }
@@ -50,6 +111,10 @@ void timer_fd::stop()
 {
     if (!running) return;
     running = false;
+    if (sim_timer >= 0) {
+        time_sim_timer_remove(sim_timer);
+        sim_timer = -1;
+    }
     if (timerThread.joinable()) {
         timerThread.join();
     }
@@ -64,19 +129,28 @@ void timer_fd::stop()
 //-------------------------------------------------------------------------------------------------------------------
 int timer_fd::init_timer_fd() 
 {
+    if (interval_ns < PIT_MIN_PERIOD_NS || spin_margin_ns >= interval_ns) {
+        printf("timer_fd error: interval must be at least %d ns and longer than spin margin!\n", PIT_MIN_PERIOD_NS);
+        return -1;
+    }
+
     int fd = timerfd_create(CLOCK_MONOTONIC, 0);
     if (fd == -1) {
         perror("timerfd_create");
         return -1;
     }
 
+    // 绝对时间定时 第k次到期的计划时刻固定为 start_ns + k * interval 不随回调耗时漂移
+    // 混合等待时timerfd整体提前spin_margin 计划时刻不变
+    // tv_nsec 必须小于1秒 否则 timerfd_settime 返回 EINVAL
     struct itimerspec its;
-    its.it_value.tv_sec = 0;
-    its.it_value.tv_nsec = interval * 1000000;  // 毫秒转纳秒
-    its.it_interval.tv_sec = 0;
-    its.it_interval.tv_nsec = interval * 1000000;
+    start_ns = time_now_ns() + interval_ns;
+    its.it_value.tv_sec = (start_ns - spin_margin_ns) / 1000000000;
+    its.it_value.tv_nsec = (start_ns - spin_margin_ns) % 1000000000;
+    its.it_interval.tv_sec = interval_ns / 1000000000;
+    its.it_interval.tv_nsec = interval_ns % 1000000000;
 
-    if (timerfd_settime(fd, 0, &its, NULL) == -1) {
+    if (timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, NULL) == -1) {
         perror("timerfd_settime");
         close(fd);
         return -1;
@@ -97,12 +171,11 @@ void timer_fd::timer_loop()
     int fd = init_timer_fd();
     if (fd == -1) return;
 
-    // 设置线程为FIFO调度策略 + 高优先级(10)，保证定时器精准触发
-    struct sched_param param;
-    param.sched_priority = 10;
-    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    // 锁定内存，设置线程为FIFO调度策略 + 高优先级(默认10)，预触碰栈，保证定时器精准触发
+    rt_thread_setup(&rt_policy);
 
     uint64_t expirations;
+    expire_total = 0;
     while (running) 
     {
         if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) 
@@ -110,12 +183,208 @@ void timer_fd::timer_loop()
             perror("read timerfd");
             break;
         }
+        expire(expirations);
+    }
+    close(fd);
+}
 
-        // 处理定时器溢出：如果阻塞期间错过多次触发，一次性补全调用
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 处理一次定时器唤醒
+// 参数说明 expirations 本次唤醒对应的到期次数
+// 返回参数 无
+// 使用示例 内部调用，无需外部调用
+// 备注信息 唤醒延迟以最近一次到期的计划时刻为基准，错过的周期单独计数
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::expire(uint64_t expirations)
+{
+    expire_total += expirations;
+    uint64_t deadline_ns = start_ns + (expire_total - 1) * interval_ns;
+    uint64_t wake_ns = time_now_ns();
+    if (wait_mode == PIT_WAIT_HYBRID)
+    {
+        // timerfd提前spin_margin到期，剩余时间忙等
+        while (wake_ns < deadline_ns)
+        {
+            wake_ns = time_now_ns();
+        }
+    }
+    latency_hist.record(wake_ns > deadline_ns ? wake_ns - deadline_ns : 0);
+
+    uint32 missed = (expirations - 1 > UINT32_MAX) ? UINT32_MAX : (uint32)(expirations - 1);
+    if (missed > 0)
+    {
+        missed_count.fetch_add(missed, std::memory_order_relaxed);
+    }
+
+    pit_overrun_policy_enum policy = overrun_policy.load(std::memory_order_relaxed);
+    if (policy == PIT_OVERRUN_BURST)
+    {
+        // 阻塞期间错过多次触发，一次性补全调用
         for (uint64_t i = 0; i < expirations; ++i)
         {
-            func();
+            invoke(0);
         }
     }
-    close(fd);
+    else
+    {
+        invoke(policy == PIT_OVERRUN_ONCE ? missed : 0);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 仿真定时器回调
+// 参数说明 arg 类对象指针
+// 返回参数 无
+// 使用示例 内部调用，无需外部调用
+// 备注信息 虚拟时间恰好等于计划到期时刻，唤醒延迟恒为0
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::sim_expire(void *arg)
+{
+    static_cast<timer_fd *>(arg)->expire(1);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 执行一次回调并记录耗时
+// 参数说明 missed 传给带错过周期数回调的参数
+// 返回参数 无
+// 使用示例 内部调用，无需外部调用
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::invoke(uint32 missed)
+{
+    uint64_t exec_start_ns = time_now_ns();
+    rt_section_enter();
+    if (missed_func)
+    {
+        missed_func(missed);
+    }
+    else if (func)
+    {
+        func();
+    }
+    rt_section_exit();
+    uint64_t exec_ns = time_now_ns() - exec_start_ns;
+    exec_hist.record(exec_ns);
+    if (exec_ns > interval_ns)
+    {
+        overrun_count.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置定时器溢出处理策略
+// 参数说明 policy 溢出策略
+// 返回参数 无
+// 使用示例 timer.set_overrun_policy(PIT_OVERRUN_SKIP);
+// 备注信息 定时器线程每次唤醒读取一次
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::set_overrun_policy(pit_overrun_policy_enum policy)
+{
+    overrun_policy = policy;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置等待到期的方式
+// 参数说明 mode        等待方式
+// 参数说明 spin_margin 混合等待时timerfd提前唤醒的时间
+// 返回参数 无
+// 使用示例 timer.set_wait_mode(PIT_WAIT_HYBRID, std::chrono::microseconds(30));
+// 备注信息 PIT_WAIT_SLEEP时忽略spin_margin 定时器运行中调用无效果
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::set_wait_mode(pit_wait_mode_enum mode, std::chrono::nanoseconds spin_margin)
+{
+    if (running) return;
+    wait_mode = mode;
+    spin_margin_ns = (mode == PIT_WAIT_HYBRID && spin_margin.count() > 0) ? (uint64_t)spin_margin.count() : 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置定时器线程的实时配置
+// 参数说明 policy 线程配置
+// 返回参数 无
+// 使用示例 timer.set_rt_policy(&policy);
+// 备注信息 定时器运行中调用无效果
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::set_rt_policy(const rt_thread_policy_struct *policy)
+{
+    if (running || policy == NULL) return;
+    rt_policy = *policy;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取唤醒延迟直方图
+// 参数说明 无
+// 返回参数 const zf_common_histogram& 单位ns
+// 使用示例 timer.get_latency_hist().print("latency(us)", 1000);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+const zf_common_histogram& timer_fd::get_latency_hist() const
+{
+    return latency_hist;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取回调执行耗时直方图
+// 参数说明 无
+// 返回参数 const zf_common_histogram& 单位ns
+// 使用示例 timer.get_exec_hist().print("exec(us)", 1000);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+const zf_common_histogram& timer_fd::get_exec_hist() const
+{
+    return exec_hist;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取错过的周期数
+// 参数说明 无
+// 返回参数 uint64_t 错过的周期数累计
+// 使用示例 uint64_t missed = timer.get_missed_count();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t timer_fd::get_missed_count() const
+{
+    return missed_count.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取回调超时次数
+// 参数说明 无
+// 返回参数 uint64_t 回调执行耗时超过定时间隔的次数
+// 使用示例 uint64_t overrun = timer.get_overrun_count();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+uint64_t timer_fd::get_overrun_count() const
+{
+    return overrun_count.load(std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 清空所有统计
+// 参数说明 无
+// 返回参数 无
+// 使用示例 timer.reset_stat();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::reset_stat()
+{
+    latency_hist.reset();
+    exec_hist.reset();
+    missed_count = 0;
+    overrun_count = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 打印定时统计
+// 参数说明 无
+// 返回参数 无
+// 使用示例 timer.print_stat();
+// 备注信息 时间单位换算为us输出
+//-------------------------------------------------------------------------------------------------------------------
+void timer_fd::print_stat() const
+{
+    printf("timer_fd interval %.3f ms, %s, missed %" PRIu64 ", overrun %" PRIu64 "\r\n", interval_ns / 1000000.0,
+           (wait_mode == PIT_WAIT_HYBRID) ? "hybrid" : "sleep", get_missed_count(), get_overrun_count());
+    latency_hist.print("timer_fd wake latency(us)", 1000);
+    exec_hist.print("timer_fd callback exec(us)", 1000);
 }
\ No newline at end of file
@@ -11,6 +11,10 @@
 #include <chrono>
 
 #include "zf_common_typedef.hpp"
+#include "zf_common_histogram.hpp"
+#include "zf_common_rt.hpp"
+#include "zf_common_time.hpp"
+#include "zf_driver_pit.hpp"
 
 class timer_fd 
 {
@@ -25,6 +29,36 @@ public:
 //-------------------------------------------------------------------------------------------------------------------
     timer_fd(int interval, const std::function<void()>& func);
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数 回调带错过周期数
+// 参数说明 interval 定时触发间隔，单位毫秒
+// 参数说明 func     定时触发的回调函数，参数为本次唤醒前错过的周期数
+// 返回参数 无
+// 使用示例 timer_fd timer(1, [](uint32 missed){ control(missed + 1); });
+// 备注信息 溢出策略默认为PIT_OVERRUN_ONCE
+//-------------------------------------------------------------------------------------------------------------------
+    timer_fd(int interval, const std::function<void(uint32)>& func);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数 纳秒分辨率间隔
+// 参数说明 interval 定时触发间隔，std::chrono时长，不小于PIT_MIN_PERIOD_NS
+// 参数说明 func     定时触发的回调函数
+// 返回参数 无
+// 使用示例 timer_fd timer(std::chrono::microseconds(250), callback_func);
+// 备注信息 到期时刻为绝对时间 不随回调耗时累积漂移 间隔过短时start打印错误且不启动
+//-------------------------------------------------------------------------------------------------------------------
+    timer_fd(std::chrono::nanoseconds interval, const std::function<void()>& func);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数 纳秒分辨率间隔 回调带错过周期数
+// 参数说明 interval 定时触发间隔，std::chrono时长，不小于PIT_MIN_PERIOD_NS
+// 参数说明 func     定时触发的回调函数，参数为本次唤醒前错过的周期数
+// 返回参数 无
+// 使用示例 timer_fd timer(std::chrono::microseconds(250), [](uint32 missed){ control(missed + 1); });
+// 备注信息 溢出策略默认为PIT_OVERRUN_ONCE
+//-------------------------------------------------------------------------------------------------------------------
+    timer_fd(std::chrono::nanoseconds interval, const std::function<void(uint32)>& func);
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介 析构函数
 // 参数说明 无
@@ -52,12 +86,107 @@ public:
 //-------------------------------------------------------------------------------------------------------------------
     void stop();
 
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置定时器溢出处理策略
+// 参数说明 policy 溢出策略，见pit_overrun_policy_enum
+// 返回参数 无
+// 使用示例 timer.set_overrun_policy(PIT_OVERRUN_SKIP);
+// 备注信息 无参数回调默认PIT_OVERRUN_BURST 运行中可随时修改
+//-------------------------------------------------------------------------------------------------------------------
+    void set_overrun_policy(pit_overrun_policy_enum policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置等待到期的方式
+// 参数说明 mode        等待方式，见pit_wait_mode_enum
+// 参数说明 spin_margin 混合等待时timerfd提前唤醒的时间，应略大于实测唤醒延迟的p99，且小于间隔
+// 返回参数 无
+// 使用示例 timer.set_wait_mode(PIT_WAIT_HYBRID, std::chrono::microseconds(30));
+// 备注信息 必须在start之前调用 默认PIT_WAIT_SLEEP
+//-------------------------------------------------------------------------------------------------------------------
+    void set_wait_mode(pit_wait_mode_enum mode, std::chrono::nanoseconds spin_margin = std::chrono::nanoseconds(PIT_SPIN_MARGIN_NS));
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 设置定时器线程的实时配置
+// 参数说明 policy 线程配置，见rt_thread_policy_struct
+// 返回参数 无
+// 使用示例 timer.set_rt_policy(&policy);
+// 备注信息 必须在start之前调用 默认SCHED_FIFO 10 不绑定CPU 预触碰RT_STACK_PREFAULT_DEFAULT字节栈
+//-------------------------------------------------------------------------------------------------------------------
+    void set_rt_policy(const rt_thread_policy_struct *policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取唤醒延迟直方图 实际唤醒时刻减去计划到期时刻
+// 参数说明 无
+// 返回参数 const zf_common_histogram& 单位ns
+// 使用示例 uint64_t p99 = timer.get_latency_hist().get_percentile(99);
+// 备注信息 任意线程均可查询
+//-------------------------------------------------------------------------------------------------------------------
+    const zf_common_histogram& get_latency_hist() const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取回调执行耗时直方图
+// 参数说明 无
+// 返回参数 const zf_common_histogram& 单位ns
+// 使用示例 uint64_t max = timer.get_exec_hist().get_max();
+// 备注信息 任意线程均可查询
+//-------------------------------------------------------------------------------------------------------------------
+    const zf_common_histogram& get_exec_hist() const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取错过的周期数
+// 参数说明 无
+// 返回参数 uint64_t 一次唤醒对应多次到期时多出的次数累计
+// 使用示例 uint64_t missed = timer.get_missed_count();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    uint64_t get_missed_count() const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 获取回调超时次数
+// 参数说明 无
+// 返回参数 uint64_t 回调执行耗时超过定时间隔的次数
+// 使用示例 uint64_t overrun = timer.get_overrun_count();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    uint64_t get_overrun_count() const;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 清空所有统计
+// 参数说明 无
+// 返回参数 无
+// 使用示例 timer.reset_stat();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    void reset_stat();
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 打印定时统计
+// 参数说明 无
+// 返回参数 无
+// 使用示例 timer.print_stat();
+// 备注信息 使用printf输出 不要在回调中调用
+//-------------------------------------------------------------------------------------------------------------------
+    void print_stat() const;
+
 private:
-    int interval;
+    uint64_t interval_ns;
     std::function<void()> func;
+    std::function<void(uint32)> missed_func;
     std::thread timerThread;
     bool running;
 
+    std::atomic<pit_overrun_policy_enum> overrun_policy;
+    uint64_t start_ns;                          // 第一次到期的计划时刻 CLOCK_MONOTONIC
+    pit_wait_mode_enum wait_mode;
+    uint64_t spin_margin_ns;                    // 混合等待时timerfd提前到期的时间
+    rt_thread_policy_struct rt_policy;          // 定时器线程的实时配置
+    uint64_t expire_total;                      // 累计到期次数 用于推算每次到期的计划时刻
+    int sim_timer;                              // 仿真时钟下注册的仿真定时器编号 -1表示未注册
+    zf_common_histogram latency_hist;           // 唤醒延迟
+    zf_common_histogram exec_hist;              // 回调执行耗时
+    std::atomic<uint64_t> missed_count;         // 错过的周期数
+    std::atomic<uint64_t> overrun_count;        // 回调执行耗时超过定时间隔的次数
+
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介 初始化内核timerfd定时器句柄
 // 参数说明 无
@@ -72,9 +201,36 @@ private:
 // 参数说明 无
 // 返回参数 无
 // 使用示例 内部调用，无需外部调用
-// 备注信息 设置线程为FIFO高优先级调度，保证定时精度，支持处理定时器溢出补触发
+// 备注信息 设置线程为FIFO高优先级调度，保证定时精度，按溢出策略处理错过的周期
 //-------------------------------------------------------------------------------------------------------------------
     void timer_loop();
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 执行一次回调并记录耗时
+// 参数说明 missed 传给带错过周期数回调的参数
+// 返回参数 无
+// 使用示例 内部调用，无需外部调用
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    void invoke(uint32 missed);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 处理一次定时器唤醒
+// 参数说明 expirations 本次唤醒对应的到期次数
+// 返回参数 无
+// 使用示例 内部调用，无需外部调用
+// 备注信息 记录唤醒延迟和错过的周期 按溢出策略执行回调
+//-------------------------------------------------------------------------------------------------------------------
+    void expire(uint64_t expirations);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 仿真定时器回调
+// 参数说明 arg 类对象指针
+// 返回参数 无
+// 使用示例 内部调用，无需外部调用
+// 备注信息 仿真时钟下由time_sim_advance_ns调用 每次对应一次到期
+//-------------------------------------------------------------------------------------------------------------------
+    static void sim_expire(void *arg);
 };
 
 #endif
\ No newline at end of file
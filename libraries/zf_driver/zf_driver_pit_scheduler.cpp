@@ -0,0 +1,585 @@
+#include "zf_driver_pit_scheduler.hpp"
+#include "zf_common_function.hpp"
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  计算tick对应的释放序号
+// 参数说明  tick tick序号
+// 参数说明  period_tick 任务周期
+// 参数说明  phase_tick 任务相位
+// 返回参数  int64_t 释放序号 第一次释放之前返回-1
+// 使用示例  内部调用，无需外部调用
+//-------------------------------------------------------------------------------------------------------------------
+static int64_t scheduler_release_index(uint64_t tick, uint32 period_tick, uint32 phase_tick)
+{
+    if(tick < phase_tick)
+    {
+        return -1;
+    }
+    return (int64_t)((tick - phase_tick) / period_tick);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  类的无参构造函数
+// 参数说明  无
+// 返回参数  无
+// 使用示例  zf_driver_pit_scheduler scheduler;
+// 备注信息  不创建任何线程和句柄
+//-------------------------------------------------------------------------------------------------------------------
+zf_driver_pit_scheduler::zf_driver_pit_scheduler(void)
+    : stat_sequence(0)
+{
+    memset(task, 0, sizeof(task));
+    memset(task_order, 0, sizeof(task_order));
+    task_count          = 0;
+    exit_flag           = 0;
+    timer_fd            = -1;
+    thread_id           = 0;
+    sim_timer           = -1;
+    thread_policy.sched_policy      = SCHED_FIFO;
+    thread_policy.sched_priority    = 99;
+    thread_policy.cpu               = RT_CPU_ANY;
+    thread_policy.stack_prefault    = RT_STACK_PREFAULT_DEFAULT;
+    tick_ms             = PIT_MIN_PERIOD_MS;
+    tick_ns             = (uint64_t)PIT_MIN_PERIOD_MS * 1000000;
+    start_ns            = 0;
+    next_tick           = 0;
+    tick_count          = 0;
+    tick_missed_count   = 0;
+    tick_overrun_count  = 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  类的析构函数
+// 参数说明  无
+// 返回参数  无
+// 使用示例  对象生命周期结束自动调用
+// 备注信息  自动停止调度线程并释放句柄
+//-------------------------------------------------------------------------------------------------------------------
+zf_driver_pit_scheduler::~zf_driver_pit_scheduler(void)
+{
+    stop();
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置调度节拍
+// 参数说明  tick_ms 节拍周期，单位ms，通常等于最短任务周期
+// 参数说明  priority 调度线程SCHED_FIFO优先级 1~99
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  scheduler.init_ms(1);
+// 备注信息  必须在add_task之前调用 调度器运行中不可修改
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit_scheduler::init_ms(uint32 tick_ms, int priority)
+{
+    if(is_running() || 0 != task_count)
+    {
+        printf("pit_scheduler error: init_ms must be called before add_task/start\r\n");
+        return -1;
+    }
+    if(PIT_MIN_PERIOD_MS > tick_ms || PIT_MAX_PERIOD_MS < tick_ms || 1 > priority || 99 < priority)
+    {
+        printf("pit_scheduler error: tick %d ms or priority %d out of range\r\n", tick_ms, priority);
+        return -1;
+    }
+
+    this->tick_ms   = tick_ms;
+    tick_ns         = (uint64_t)tick_ms * 1000000;
+    thread_policy.sched_priority = priority;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置调度线程的实时配置
+// 参数说明  policy 线程配置
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  scheduler.set_rt_policy(&policy);
+// 备注信息  调度器运行中不可修改
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit_scheduler::set_rt_policy(const rt_thread_policy_struct *policy)
+{
+    if(is_running() || NULL == policy)
+    {
+        printf("pit_scheduler error: set_rt_policy must be called before start\r\n");
+        return -1;
+    }
+    thread_policy = *policy;
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  为新任务选择相位
+// 参数说明  period_tick 新任务周期 单位tick
+// 返回参数  uint32 相位 单位tick
+// 使用示例  内部调用，无需外部调用
+// 备注信息  在超周期内统计每个tick已有的释放数量 选择使最繁忙tick释放数量最小的相位
+//           相同时选择总释放数量更少的相位 超周期超过上限时只统计前 PIT_SCHEDULER_HYPERPERIOD_MAX 个tick
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_driver_pit_scheduler::select_phase(uint32 period_tick)
+{
+    uint8  load[PIT_SCHEDULER_HYPERPERIOD_MAX];
+    uint32 hyperperiod = period_tick;
+    uint32 best_phase = 0;
+    uint32 best_peak = UINT32_MAX;
+    uint32 best_sum = UINT32_MAX;
+    uint32 phase, peak, sum, i, t;
+
+    for(i = 0; i < task_count; i ++)
+    {
+        hyperperiod = hyperperiod / func_get_greatest_common_divisor(hyperperiod, task[i].period_tick) * task[i].period_tick;
+        if(PIT_SCHEDULER_HYPERPERIOD_MAX < hyperperiod)
+        {
+            hyperperiod = PIT_SCHEDULER_HYPERPERIOD_MAX;
+            break;
+        }
+    }
+
+    memset(load, 0, sizeof(load));
+    for(i = 0; i < task_count; i ++)
+    {
+        for(t = task[i].phase_tick; t < hyperperiod; t += task[i].period_tick)
+        {
+            load[t] ++;
+        }
+    }
+
+    for(phase = 0; phase < period_tick && phase < hyperperiod; phase ++)
+    {
+        peak = 0;
+        sum = 0;
+        for(t = phase; t < hyperperiod; t += period_tick)
+        {
+            sum += load[t];
+            if(peak < load[t])
+            {
+                peak = load[t];
+            }
+        }
+        if(peak < best_peak || (peak == best_peak && sum < best_sum))
+        {
+            best_peak = peak;
+            best_sum = sum;
+            best_phase = phase;
+        }
+    }
+    return best_phase;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  注册周期任务
+// 参数说明  callback 任务函数，不能为空
+// 参数说明  period_ms 任务周期，单位ms，必须是tick的整数倍
+// 参数说明  phase_ms 任务相位，单位ms，必须是tick的整数倍且小于周期，PIT_SCHEDULER_PHASE_AUTO表示自动分配
+// 参数说明  name 任务名称，用于统计输出，可以为NULL
+// 返回参数  int 成功返回任务编号 失败返回-1
+// 使用示例  scheduler.add_task(current_loop, 1);
+// 备注信息  执行顺序按周期插入排序 周期相同时先注册的先执行
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit_scheduler::add_task(pit_callback_fun callback, uint32 period_ms, int32 phase_ms, const char *name)
+{
+    pit_scheduler_task_struct *item;
+    uint32 period_tick;
+    uint8 index, position;
+
+    if(is_running())
+    {
+        printf("pit_scheduler error: add_task must be called before start\r\n");
+        return -1;
+    }
+    if(NULL == callback || PIT_SCHEDULER_TASK_MAX <= task_count)
+    {
+        printf("pit_scheduler error: callback is null or too many tasks\r\n");
+        return -1;
+    }
+    if(0 == period_ms || 0 != period_ms % tick_ms)
+    {
+        printf("pit_scheduler error: period %d ms is not a multiple of tick %d ms\r\n", period_ms, tick_ms);
+        return -1;
+    }
+    period_tick = period_ms / tick_ms;
+    if(PIT_SCHEDULER_PHASE_AUTO != phase_ms && (0 > phase_ms || (uint32)phase_ms >= period_ms || 0 != (uint32)phase_ms % tick_ms))
+    {
+        printf("pit_scheduler error: phase %d ms invalid for period %d ms\r\n", phase_ms, period_ms);
+        return -1;
+    }
+
+    index = task_count;
+    item = &task[index];
+    memset(item, 0, sizeof(pit_scheduler_task_struct));
+    item->callback      = callback;
+    item->name          = (NULL != name) ? name : "task";
+    item->period_tick   = period_tick;
+    item->phase_tick    = (PIT_SCHEDULER_PHASE_AUTO == phase_ms) ? select_phase(period_tick) : (uint32)phase_ms / tick_ms;
+    item->last_release  = -1;
+    item->stat.name         = item->name;
+    item->stat.period_ms    = period_ms;
+    item->stat.phase_ms     = item->phase_tick * tick_ms;
+    item->stat.exec_min_ns  = UINT64_MAX;
+
+    // 速率单调 周期越短越先执行
+    for(position = task_count; 0 < position && task[task_order[position - 1]].period_tick > period_tick; position --)
+    {
+        task_order[position] = task_order[position - 1];
+    }
+    task_order[position] = index;
+    task_count ++;
+
+    printf("pit_scheduler add task %s, period = %d ms, phase = %d ms\r\n", item->name, period_ms, item->stat.phase_ms);
+    return index;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  处理一个tick
+// 参数说明  tick 本次处理的tick序号，必须大于上一次处理的序号
+// 参数说明  release_ns 该tick的计划释放时刻，CLOCK_MONOTONIC纳秒，用于计算响应时间
+// 返回参数  void
+// 使用示例  scheduler.dispatch(tick, release_ns);
+// 备注信息  每个任务最多执行一次 跨越多个释放点时只执行一次并累计missed_count 保持控制周期不突发
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit_scheduler::dispatch(uint64_t tick, uint64_t release_ns)
+{
+    pit_scheduler_task_struct *item;
+    uint64_t begin_ns, end_ns, exec_ns, response_ns;
+    int64_t release;
+    uint32 sequence;
+
+    if(tick < next_tick)
+    {
+        return;
+    }
+
+    for(uint8 i = 0; i < task_count; i ++)
+    {
+        item = &task[task_order[i]];
+        release = scheduler_release_index(tick, item->period_tick, item->phase_tick);
+        if(release <= item->last_release)
+        {
+            continue;
+        }
+
+        begin_ns = time_now_ns();
+        rt_section_enter();
+        item->callback();
+        rt_section_exit();
+        end_ns = time_now_ns();
+        exec_ns = end_ns - begin_ns;
+        response_ns = (end_ns > release_ns) ? (end_ns - release_ns) : 0;
+
+        sequence = stat_sequence.load(std::memory_order_relaxed);
+        stat_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        item->stat.missed_count += (uint64_t)(release - item->last_release - 1);
+        item->last_release = release;
+        item->stat.run_count ++;
+        item->exec_sum_ns += exec_ns;
+        item->stat.exec_last_ns = exec_ns;
+        item->stat.exec_avg_ns  = item->exec_sum_ns / item->stat.run_count;
+        if(item->stat.exec_min_ns > exec_ns)
+        {
+            item->stat.exec_min_ns = exec_ns;
+        }
+        if(item->stat.exec_max_ns < exec_ns)
+        {
+            item->stat.exec_max_ns = exec_ns;
+        }
+        if(item->stat.response_max_ns < response_ns)
+        {
+            item->stat.response_max_ns = response_ns;
+        }
+        if(response_ns > (uint64_t)item->period_tick * tick_ns)
+        {
+            item->stat.overrun_count ++;
+        }
+
+        stat_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    sequence = stat_sequence.load(std::memory_order_relaxed);
+    stat_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    tick_missed_count += tick - next_tick;
+    tick_count ++;
+    if(time_now_ns() > release_ns + tick_ns)
+    {
+        tick_overrun_count ++;                                                  // 本tick的任务拖到了下一个tick
+    }
+    stat_sequence.store(sequence + 2, std::memory_order_release);
+
+    next_tick = tick + 1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  调度线程
+// 参数说明  arg 类对象指针
+// 返回参数  void* 固定返回NULL
+// 使用示例  内部调用，无需外部调用
+// 备注信息  timerfd使用绝对时间 tick序号由到期次数累加得到 与实际时间严格对应
+//-------------------------------------------------------------------------------------------------------------------
+void *zf_driver_pit_scheduler::scheduler_thread(void *arg)
+{
+    zf_driver_pit_scheduler *scheduler = (zf_driver_pit_scheduler *)arg;
+    uint64_t expire_count = 0;
+    uint64_t tick = 0;
+
+    prctl(PR_SET_NAME, "pit_scheduler");
+    rt_thread_setup(&scheduler->thread_policy);                                 // 失败时已打印警告 以当前调度策略继续运行
+
+    while(!scheduler->exit_flag)
+    {
+        if(sizeof(expire_count) != read(scheduler->timer_fd, &expire_count, sizeof(expire_count)))
+        {
+            if(EINTR == errno)
+            {
+                continue;
+            }
+            perror("pit_scheduler read timerfd error");
+            break;
+        }
+        if(scheduler->exit_flag)
+        {
+            break;
+        }
+
+        tick = scheduler->next_tick + expire_count - 1;                         // 到期多次说明上一tick超时 跳到最新的tick
+        scheduler->dispatch(tick, scheduler->start_ns + tick * scheduler->tick_ns);
+    }
+
+    return NULL;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  仿真定时器回调
+// 参数说明  arg 类对象指针
+// 返回参数  void
+// 使用示例  内部调用，无需外部调用
+// 备注信息  仿真定时器每个tick到期一次 虚拟时间恰好等于该tick的计划释放时刻
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit_scheduler::scheduler_sim_tick(void *arg)
+{
+    zf_driver_pit_scheduler *scheduler = (zf_driver_pit_scheduler *)arg;
+    uint64_t tick = (time_now_ns() - scheduler->start_ns) / scheduler->tick_ns;
+
+    scheduler->dispatch(tick, scheduler->start_ns + tick * scheduler->tick_ns);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  启动调度线程
+// 参数说明  无
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  scheduler.start();
+// 备注信息  第0个tick在调用后一个tick周期处释放 实时优先级设置失败时打印警告并继续运行
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit_scheduler::start(void)
+{
+    struct itimerspec timer_spec;
+    int return_state = -1;
+
+    do
+    {
+        if(is_running())
+        {
+            printf("pit_scheduler error: already running\r\n");
+            break;
+        }
+        if(0 == task_count)
+        {
+            printf("pit_scheduler error: no task registered\r\n");
+            break;
+        }
+
+        if(TIME_SOURCE_SIM == time_get_source())
+        {
+            // 仿真时钟 不创建timerfd和线程 由time_sim_advance_ns推进虚拟时间时逐tick调用dispatch
+            exit_flag = 0;
+            next_tick = 0;
+            for(uint8 i = 0; i < task_count; i ++)
+            {
+                task[i].last_release = -1;
+            }
+            start_ns = time_now_ns() + tick_ns;
+            sim_timer = time_sim_timer_add(scheduler_sim_tick, this, start_ns, tick_ns);
+            if(0 > sim_timer)
+            {
+                break;
+            }
+            printf("pit_scheduler start, tick = %d ms, task = %d, simulated clock\r\n", tick_ms, task_count);
+            return_state = 0;
+            break;
+        }
+
+        timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if(0 > timer_fd)
+        {
+            perror("pit_scheduler timerfd_create error");
+            break;
+        }
+
+        exit_flag = 0;
+        next_tick = 0;
+        for(uint8 i = 0; i < task_count; i ++)
+        {
+            task[i].last_release = -1;
+        }
+        start_ns = time_now_ns() + tick_ns;
+
+        memset(&timer_spec, 0, sizeof(timer_spec));
+        timer_spec.it_value.tv_sec      = start_ns / 1000000000ULL;
+        timer_spec.it_value.tv_nsec     = start_ns % 1000000000ULL;
+        timer_spec.it_interval.tv_sec   = tick_ns / 1000000000ULL;
+        timer_spec.it_interval.tv_nsec  = tick_ns % 1000000000ULL;
+        if(0 > timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &timer_spec, NULL))
+        {
+            perror("pit_scheduler timerfd_settime error");
+            close(timer_fd);
+            timer_fd = -1;
+            break;
+        }
+
+        if(0 != pthread_create(&thread_id, NULL, scheduler_thread, this))
+        {
+            perror("pit_scheduler pthread_create error");
+            thread_id = 0;
+            close(timer_fd);
+            timer_fd = -1;
+            break;
+        }
+
+        printf("pit_scheduler start, tick = %d ms, task = %d\r\n", tick_ms, task_count);
+        return_state = 0;
+    }while(0);
+
+    return return_state;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  停止调度线程并释放句柄
+// 参数说明  无
+// 返回参数  void
+// 使用示例  scheduler.stop();
+// 备注信息  线程阻塞在timerfd上 置退出标志后最多一个tick退出
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit_scheduler::stop(void)
+{
+    if(0 <= sim_timer)
+    {
+        time_sim_timer_remove(sim_timer);
+        sim_timer = -1;
+    }
+    if(0 == thread_id)
+    {
+        return;
+    }
+
+    exit_flag = 1;
+    pthread_join(thread_id, NULL);
+    thread_id = 0;
+
+    if(0 <= timer_fd)
+    {
+        close(timer_fd);
+        timer_fd = -1;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取任务数量
+// 参数说明  无
+// 返回参数  uint8 已注册的任务数量
+// 使用示例  uint8 count = scheduler.get_task_count();
+//-------------------------------------------------------------------------------------------------------------------
+uint8 zf_driver_pit_scheduler::get_task_count(void)
+{
+    return task_count;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取任务运行统计
+// 参数说明  index 任务编号，add_task的返回值
+// 参数说明  stat 统计数据输出
+// 返回参数  int 成功返回0 编号无效返回-1
+// 使用示例  scheduler.get_task_stat(0, &stat);
+// 备注信息  顺序锁读取 数据更新过程中读取时自动重试
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_pit_scheduler::get_task_stat(uint8 index, pit_scheduler_task_stat_struct *stat)
+{
+    uint32 begin, end;
+
+    if(task_count <= index || NULL == stat)
+    {
+        return -1;
+    }
+
+    do
+    {
+        begin = stat_sequence.load(std::memory_order_acquire);
+        memcpy(stat, &task[index].stat, sizeof(pit_scheduler_task_stat_struct));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        end = stat_sequence.load(std::memory_order_relaxed);
+    }while((begin & 1) || begin != end);
+
+    if(0 == stat->run_count)
+    {
+        stat->exec_min_ns = 0;
+    }
+    return 0;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取调度器tick统计
+// 参数说明  tick 已处理的tick数量输出，可以为NULL
+// 参数说明  missed 被跳过的tick数量输出，可以为NULL
+// 参数说明  overrun tick内执行超时的次数输出，可以为NULL
+// 返回参数  void
+// 使用示例  scheduler.get_tick_stat(&tick, &missed, &overrun);
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit_scheduler::get_tick_stat(uint64_t *tick, uint64_t *missed, uint64_t *overrun)
+{
+    uint64_t tick_value, missed_value, overrun_value;
+    uint32 begin, end;
+
+    do
+    {
+        begin = stat_sequence.load(std::memory_order_acquire);
+        tick_value      = tick_count;
+        missed_value    = tick_missed_count;
+        overrun_value   = tick_overrun_count;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        end = stat_sequence.load(std::memory_order_relaxed);
+    }while((begin & 1) || begin != end);
+
+    if(NULL != tick)
+    {
+        *tick = tick_value;
+    }
+    if(NULL != missed)
+    {
+        *missed = missed_value;
+    }
+    if(NULL != overrun)
+    {
+        *overrun = overrun_value;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  打印所有任务统计
+// 参数说明  无
+// 返回参数  void
+// 使用示例  scheduler.print_stat();
+// 备注信息  按执行顺序输出 时间单位为微秒
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_pit_scheduler::print_stat(void)
+{
+    pit_scheduler_task_stat_struct stat;
+    uint64_t tick, missed, overrun;
+
+    get_tick_stat(&tick, &missed, &overrun);
+    printf("pit_scheduler tick = %" PRIu64 ", missed = %" PRIu64 ", overrun = %" PRIu64 "\r\n", tick, missed, overrun);
+    printf("%-12s %6s %6s %10s %8s %8s %9s %9s %9s %9s\r\n", "task", "period", "phase", "run", "missed", "overrun", "avg(us)", "max(us)", "last(us)", "resp(us)");
+    for(uint8 i = 0; i < task_count; i ++)
+    {
+        get_task_stat(task_order[i], &stat);
+        printf("%-12s %6u %6u %10" PRIu64 " %8" PRIu64 " %8" PRIu64 " %9.1f %9.1f %9.1f %9.1f\r\n",
+               stat.name, stat.period_ms, stat.phase_ms, stat.run_count, stat.missed_count, stat.overrun_count,
+               stat.exec_avg_ns / 1000.0, stat.exec_max_ns / 1000.0, stat.exec_last_ns / 1000.0, stat.response_max_ns / 1000.0);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,224 @@
+#ifndef __zf_driver_pit_scheduler_HPP__
+#define __zf_driver_pit_scheduler_HPP__
+
+#include "zf_common_typedef.hpp"
+#include "zf_driver_pit.hpp"
+#include "zf_common_rt.hpp"
+#include "zf_common_time.hpp"
+
+#define PIT_SCHEDULER_TASK_MAX          16                                      // 最多注册的周期任务数量
+#define PIT_SCHEDULER_HYPERPERIOD_MAX   1000                                    // 自动分配相位时参与计算的最大超周期 单位tick
+#define PIT_SCHEDULER_PHASE_AUTO        (-1)                                    // 由调度器自动选择相位
+
+// 单个任务的运行统计 时间单位均为纳秒
+typedef struct
+{
+    const char  *name;                                                          // 任务名称
+    uint32      period_ms;                                                      // 任务周期
+    uint32      phase_ms;                                                       // 任务相位 相对调度器启动时刻的偏移
+    uint64_t    run_count;                                                      // 执行次数
+    uint64_t    missed_count;                                                   // 因调度线程被阻塞而合并掉的释放次数
+    uint64_t    overrun_count;                                                  // 完成时间超过自身周期的次数
+    uint64_t    exec_last_ns;                                                   // 最近一次执行耗时
+    uint64_t    exec_min_ns;                                                    // 最短执行耗时
+    uint64_t    exec_max_ns;                                                    // 最长执行耗时
+    uint64_t    exec_avg_ns;                                                    // 平均执行耗时
+    uint64_t    response_max_ns;                                                // 最长响应时间 从计划释放时刻到执行完成
+}pit_scheduler_task_stat_struct;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 类名         zf_driver_pit_scheduler
+// 说明         单线程单timerfd的速率单调循环执行器 替代每个周期一个 zf_driver_pit 实时线程的用法
+//              以最小周期 tick 为节拍 注册的任务周期必须是 tick 的整数倍
+//              同一 tick 内按周期从短到长依次执行 周期越短优先级越高 (速率单调)
+//              每个任务可以指定相位 把不同任务分散到不同 tick 上 避免所有任务在同一 tick 集中释放
+//              单核下各控制环不再互相抢占 执行顺序确定 且只占用一个实时线程
+//-------------------------------------------------------------------------------------------------------------------
+class zf_driver_pit_scheduler
+{
+private:
+    typedef struct
+    {
+        pit_callback_fun    callback;
+        const char          *name;
+        uint32              period_tick;
+        uint32              phase_tick;
+        int64_t             last_release;                                       // 最近一次已处理的释放序号
+        uint64_t            exec_sum_ns;
+        pit_scheduler_task_stat_struct stat;
+    }pit_scheduler_task_struct;
+
+    pit_scheduler_task_struct   task[PIT_SCHEDULER_TASK_MAX];
+    uint8                       task_order[PIT_SCHEDULER_TASK_MAX];             // 按周期从短到长排列的任务编号 即执行顺序
+    uint8                       task_count;
+
+    volatile sig_atomic_t       exit_flag;
+    int                         timer_fd;
+    pthread_t                   thread_id;
+    int                         sim_timer;                                      // 仿真时钟下注册的仿真定时器编号 -1表示未注册
+    rt_thread_policy_struct     thread_policy;                                  // 调度线程的实时配置 在线程入口处应用
+    uint32                      tick_ms;
+    uint64_t                    start_ns;                                       // 第0个tick的计划时刻
+    uint64_t                    next_tick;                                      // 下一个待处理的tick序号
+    uint64_t                    tick_ns;
+    std::atomic<uint32>         stat_sequence;                                  // 统计数据顺序锁 奇数表示正在更新
+    uint64_t                    tick_count;                                     // 已处理的tick数量
+    uint64_t                    tick_missed_count;                              // 因上一tick超时而被跳过的tick数量
+    uint64_t                    tick_overrun_count;                             // 单个tick内全部任务执行时间超过tick周期的次数
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  调度线程
+// 参数说明  arg 类对象指针
+// 返回参数  void* 固定返回NULL
+// 使用示例  内部调用，无需外部调用
+// 备注信息  阻塞读取timerfd 每个tick调用一次dispatch
+//-------------------------------------------------------------------------------------------------------------------
+    static void *scheduler_thread(void *arg);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  仿真定时器回调
+// 参数说明  arg 类对象指针
+// 返回参数  void
+// 使用示例  内部调用，无需外部调用
+// 备注信息  仿真时钟下由time_sim_advance_ns调用 按虚拟时间计算tick序号后调用dispatch
+//-------------------------------------------------------------------------------------------------------------------
+    static void scheduler_sim_tick(void *arg);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  调度器是否在运行
+// 参数说明  无
+// 返回参数  bool 调度线程或仿真定时器存在时返回true
+// 使用示例  内部调用，无需外部调用
+//-------------------------------------------------------------------------------------------------------------------
+    bool is_running(void) { return 0 != thread_id || 0 <= sim_timer; }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  为新任务选择相位
+// 参数说明  period_tick 新任务周期 单位tick
+// 返回参数  uint32 相位 单位tick
+// 使用示例  内部调用，无需外部调用
+// 备注信息  在超周期内统计每个tick已有的释放数量 选择使最繁忙tick释放数量最小的相位
+//-------------------------------------------------------------------------------------------------------------------
+    uint32 select_phase(uint32 period_tick);
+
+public:
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  类的无参构造函数
+// 参数说明  无
+// 返回参数  无
+// 使用示例  zf_driver_pit_scheduler scheduler;
+// 备注信息  不创建任何线程和句柄
+//-------------------------------------------------------------------------------------------------------------------
+    zf_driver_pit_scheduler(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  类的析构函数
+// 参数说明  无
+// 返回参数  无
+// 使用示例  对象生命周期结束自动调用
+// 备注信息  自动停止调度线程并释放句柄
+//-------------------------------------------------------------------------------------------------------------------
+    ~zf_driver_pit_scheduler(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置调度节拍
+// 参数说明  tick_ms 节拍周期，单位ms，通常等于最短任务周期
+// 参数说明  priority 调度线程SCHED_FIFO优先级 1~99
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  scheduler.init_ms(1);
+// 备注信息  必须在add_task之前调用 调度器运行中不可修改
+//-------------------------------------------------------------------------------------------------------------------
+    int init_ms(uint32 tick_ms, int priority = 99);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  设置调度线程的实时配置
+// 参数说明  policy 线程配置，见rt_thread_policy_struct
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  scheduler.set_rt_policy(&policy);
+// 备注信息  必须在start之前调用 默认SCHED_FIFO 不绑定CPU 优先级由init_ms设置
+//           任务执行期间处于实时区间 定义ZF_RT_DEBUG时检查任务中的内存分配与阻塞调用
+//-------------------------------------------------------------------------------------------------------------------
+    int set_rt_policy(const rt_thread_policy_struct *policy);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  注册周期任务
+// 参数说明  callback 任务函数，不能为空
+// 参数说明  period_ms 任务周期，单位ms，必须是tick的整数倍
+// 参数说明  phase_ms 任务相位，单位ms，必须是tick的整数倍且小于周期，PIT_SCHEDULER_PHASE_AUTO表示自动分配
+// 参数说明  name 任务名称，用于统计输出，可以为NULL
+// 返回参数  int 成功返回任务编号 失败返回-1
+// 使用示例  scheduler.add_task(current_loop, 1);
+// 使用示例  scheduler.add_task(speed_loop, 5, PIT_SCHEDULER_PHASE_AUTO, "speed");
+// 备注信息  只能在start之前调用
+//-------------------------------------------------------------------------------------------------------------------
+    int add_task(pit_callback_fun callback, uint32 period_ms, int32 phase_ms = PIT_SCHEDULER_PHASE_AUTO, const char *name = NULL);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  启动调度线程
+// 参数说明  无
+// 返回参数  int 成功返回0 失败返回-1
+// 使用示例  scheduler.start();
+// 备注信息  第0个tick在调用后一个tick周期处释放 实时优先级设置失败时打印警告并继续运行
+//-------------------------------------------------------------------------------------------------------------------
+    int start(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  停止调度线程并释放句柄
+// 参数说明  无
+// 返回参数  void
+// 使用示例  scheduler.stop();
+// 备注信息  最多等待一个tick 可重复调用 停止后可以再次start 统计数据保留
+//-------------------------------------------------------------------------------------------------------------------
+    void stop(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  处理一个tick
+// 参数说明  tick 本次处理的tick序号，必须大于上一次处理的序号
+// 参数说明  release_ns 该tick的计划释放时刻，time_now_ns时间基准，用于计算响应时间
+// 返回参数  void
+// 使用示例  scheduler.dispatch(tick, release_ns);
+// 备注信息  调度线程内部调用 不启动线程时也可由测试程序或仿真时钟直接驱动
+//           若与上一次处理的序号不连续 期间每个任务的多次释放合并为一次执行 并计入missed_count
+//-------------------------------------------------------------------------------------------------------------------
+    void dispatch(uint64_t tick, uint64_t release_ns);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取任务数量
+// 参数说明  无
+// 返回参数  uint8 已注册的任务数量
+// 使用示例  uint8 count = scheduler.get_task_count();
+//-------------------------------------------------------------------------------------------------------------------
+    uint8 get_task_count(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取任务运行统计
+// 参数说明  index 任务编号，add_task的返回值
+// 参数说明  stat 统计数据输出
+// 返回参数  int 成功返回0 编号无效返回-1
+// 使用示例  scheduler.get_task_stat(0, &stat);
+// 备注信息  任意线程均可调用 通过顺序锁读取一致的快照
+//-------------------------------------------------------------------------------------------------------------------
+    int get_task_stat(uint8 index, pit_scheduler_task_stat_struct *stat);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  获取调度器tick统计
+// 参数说明  tick 已处理的tick数量输出，可以为NULL
+// 参数说明  missed 被跳过的tick数量输出，可以为NULL
+// 参数说明  overrun tick内执行超时的次数输出，可以为NULL
+// 返回参数  void
+// 使用示例  scheduler.get_tick_stat(&tick, &missed, &overrun);
+//-------------------------------------------------------------------------------------------------------------------
+    void get_tick_stat(uint64_t *tick, uint64_t *missed, uint64_t *overrun);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介  打印所有任务统计
+// 参数说明  无
+// 返回参数  void
+// 使用示例  scheduler.print_stat();
+// 备注信息  使用printf输出 不要在实时任务中调用
+//-------------------------------------------------------------------------------------------------------------------
+    void print_stat(void);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "zf_driver_sysfs_attr.hpp"
+#include "zf_common_function.hpp"
+
+// 10的整数次方 定点解析时补齐小数位
+static const int64_t sysfs_attr_pow10[SYSFS_ATTR_FRACTION_MAX + 1] =
+{
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL, 100000000LL, 1000000000LL
+};
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 path  属性文件路径
+// 返回参数 无
+// 使用示例 zf_driver_sysfs_attr attr(ADC_CH0_PATH);
+// 备注信息 路径为空则不执行文件打开操作
+//-------------------------------------------------------------------------------------------------------------------
+zf_driver_sysfs_attr::zf_driver_sysfs_attr(const char *path)
+    : fd(-1), seekable(1)
+{
+    if(NULL != path)
+    {
+        open_path(path);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 析构函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 自动调用，无需手动调用
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+zf_driver_sysfs_attr::~zf_driver_sysfs_attr(void)
+{
+    close_path();
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 打开属性文件
+// 参数说明 path  属性文件路径
+// 返回参数 int8  0-成功 -1-失败
+// 使用示例 attr.open_path(IMU_ACC_X_PATH);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::open_path(const char *path)
+{
+    close_path();
+    if(NULL == path) return -1;
+    fd = open(path, O_RDONLY);
+    seekable = 1;
+    return (fd >= 0) ? 0 : -1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 关闭属性文件
+// 参数说明 无
+// 返回参数 无
+// 使用示例 attr.close_path();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+void zf_driver_sysfs_attr::close_path(void)
+{
+    if(fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取属性文件原始内容
+// 参数说明 buf  接收缓冲区
+// 参数说明 size 缓冲区大小
+// 返回参数 int  读到的字节数 失败返回-1
+// 使用示例 内部调用，无需外部调用
+// 备注信息 不可定位的字符设备第一次pread返回ESPIPE 之后固定改用read
+//          解析函数都按长度工作 缓冲区不需要清零 也不补结束符
+//-------------------------------------------------------------------------------------------------------------------
+int zf_driver_sysfs_attr::read_text(char *buf, uint32 size)
+{
+    ssize_t len = -1;
+
+    if(fd < 0) return -1;
+    if(seekable)
+    {
+        len = pread(fd, buf, size, 0);
+        if(len < 0 && ESPIPE == errno)
+        {
+            seekable = 0;
+        }
+    }
+    if(!seekable)
+    {
+        len = read(fd, buf, size);
+    }
+    if(len <= 0) return -1;
+    return (int)len;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 解析整数字符串
+// 参数说明 str    以'\0'结尾的字符串
+// 参数说明 value  解析结果
+// 返回参数 int8   0-成功 -1-没有数字
+// 使用示例 zf_driver_sysfs_attr::parse_int("-123\n", &value);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::parse_int(const char *str, int32 *value)
+{
+    return parse_int(str, (uint32)strlen(str), value);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 按长度解析整数
+// 参数说明 str    起始位置
+// 参数说明 length 字节数
+// 参数说明 value  解析结果
+// 返回参数 int8   0-成功 -1-失败
+// 使用示例 zf_driver_sysfs_attr::parse_int(buf, len, &value);
+// 备注信息 失败时 value 写0
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::parse_int(const char *str, uint32 length, int32 *value)
+{
+    const char *end = str + length;
+
+    while(str < end && (' ' == *str || '\t' == *str)) str ++;
+    *value = 0;
+    return (FUNC_PARSE_OK == func_parse_int(str, (size_t)(end - str), value).error) ? 0 : -1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 解析定点小数字符串
+// 参数说明 str             以'\0'结尾的字符串
+// 参数说明 value           解析结果
+// 参数说明 fraction_digits 保留的小数位数
+// 返回参数 int8            0-成功 -1-没有数字
+// 使用示例 zf_driver_sysfs_attr::parse_fixed("1.5", &value, 3);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::parse_fixed(const char *str, int64_t *value, uint8 fraction_digits)
+{
+    return parse_fixed(str, (uint32)strlen(str), value, fraction_digits);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 按长度解析定点小数
+// 参数说明 str             起始位置
+// 参数说明 length          字节数
+// 参数说明 value           解析结果
+// 参数说明 fraction_digits 保留的小数位数
+// 返回参数 int8            0-成功 -1-没有数字
+// 使用示例 zf_driver_sysfs_attr::parse_fixed(buf, len, &value, 9);
+// 备注信息 无符号减法把非数字字符映射到大于9的值 每个字符只有一次比较
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::parse_fixed(const char *str, uint32 length, int64_t *value, uint8 fraction_digits)
+{
+    const uint8 *p = (const uint8 *)str;
+    const uint8 *end = p + length;
+    uint64_t integer = 0;
+    uint64_t fraction = 0;
+    uint8 digits = 0;
+    uint8 negative = 0;
+    uint8 found = 0;
+    uint32 d = 0;
+
+    if(fraction_digits > SYSFS_ATTR_FRACTION_MAX) fraction_digits = SYSFS_ATTR_FRACTION_MAX;
+
+    while(p < end && (' ' == *p || '\t' == *p)) p ++;
+    negative = (p < end && '-' == *p);
+    if(p < end && ('-' == *p || '+' == *p)) p ++;
+
+    while(p < end && (d = (uint32)(*p - '0')) < 10)
+    {
+        integer = integer * 10 + d;
+        found = 1;
+        p ++;
+    }
+    if(p < end && '.' == *p)
+    {
+        p ++;
+        while(p < end && (d = (uint32)(*p - '0')) < 10)
+        {
+            if(digits < fraction_digits)
+            {
+                fraction = fraction * 10 + d;
+                digits ++;
+            }
+            found = 1;
+            p ++;
+        }
+    }
+
+    *value = (int64_t)(integer * (uint64_t)sysfs_attr_pow10[fraction_digits] + fraction * (uint64_t)sysfs_attr_pow10[fraction_digits - digits]);
+    if(negative) *value = -*value;
+    return found ? 0 : -1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取整数属性
+// 参数说明 value  读取结果
+// 返回参数 int8   0-成功 -1-失败
+// 使用示例 attr.read_int(&raw);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::read_int(int32 *value)
+{
+    char buf[SYSFS_ATTR_BUFFER_SIZE];
+    int len = read_text(buf, sizeof(buf));
+    if(0 > len) return -1;
+    return parse_int(buf, (uint32)len, value);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取定点小数属性
+// 参数说明 value           读取结果
+// 参数说明 fraction_digits 保留的小数位数
+// 返回参数 int8            0-成功 -1-失败
+// 使用示例 attr.read_fixed(&scale_nano, 9);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::read_fixed(int64_t *value, uint8 fraction_digits)
+{
+    char buf[SYSFS_ATTR_BUFFER_SIZE];
+    int len = read_text(buf, sizeof(buf));
+    if(0 > len) return -1;
+    return parse_fixed(buf, (uint32)len, value, fraction_digits);
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取浮点属性
+// 参数说明 value  读取结果
+// 返回参数 int8   0-成功 -1-失败
+// 使用示例 attr.read_float(&scale);
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+int8 zf_driver_sysfs_attr::read_float(float *value)
+{
+    char buf[SYSFS_ATTR_BUFFER_SIZE];
+    const char *p = buf;
+    int len = read_text(buf, sizeof(buf));
+
+    if(0 > len) return -1;
+    while(p < buf + len && (' ' == *p || '\t' == *p)) p ++;
+    return (FUNC_PARSE_OK == func_parse_float(p, (size_t)(buf + len - p), value).error) ? 0 : -1;
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 连续读取多个整数属性
+// 参数说明 attr   属性对象指针数组
+// 参数说明 value  读取结果数组
+// 参数说明 count  属性个数
+// 返回参数 uint32 读取成功的个数
+// 使用示例 zf_driver_sysfs_attr::read_int_batch(axis, acc, 3);
+// 备注信息 通道之间只有一次整数解析 第一个与最后一个通道的采样间隔接近连续pread的耗时
+//-------------------------------------------------------------------------------------------------------------------
+uint32 zf_driver_sysfs_attr::read_int_batch(zf_driver_sysfs_attr *const *attr, int32 *value, uint32 count)
+{
+    char buf[SYSFS_ATTR_BUFFER_SIZE];
+    uint32 success = 0;
+    int len = 0;
+
+    for(uint32 i = 0; i < count; i ++)
+    {
+        value[i] = 0;
+        if(NULL == attr[i] || 0 > (len = attr[i]->read_text(buf, sizeof(buf)))) continue;
+        if(0 == parse_int(buf, (uint32)len, &value[i])) success ++;
+    }
+    return success;
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef __ZF_DRIVER_SYSFS_ATTR_HPP__
+#define __ZF_DRIVER_SYSFS_ATTR_HPP__
+
+#include "zf_common_typedef.hpp"
+
+#define SYSFS_ATTR_BUFFER_SIZE         ( 32 )                                   // 单次读取的最大字节数 数值属性足够使用
+#define SYSFS_ATTR_FRACTION_MAX        ( 9 )                                    // 小数解析的最大位数
+
+// sysfs数值属性读取类 供ADC/IMU/DL1X等驱动共用
+// 打开一次后每次读取只有一次pread系统调用 在栈上解析 不申请内存
+class zf_driver_sysfs_attr
+{
+private:
+    int     fd;                                 // 属性文件句柄
+    uint8   seekable;                           // 0-设备不支持pread(字符设备) 改用read
+
+    zf_driver_sysfs_attr(const zf_driver_sysfs_attr&) = delete;
+    zf_driver_sysfs_attr& operator=(const zf_driver_sysfs_attr&) = delete;
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取属性文件原始内容
+// 参数说明 buf  接收缓冲区 不写入'\0' 按返回的长度解析
+// 参数说明 size 缓冲区大小
+// 返回参数 int  读到的字节数 失败返回-1
+// 使用示例 内部调用，无需外部调用
+// 备注信息 sysfs属性每次从偏移0读取即可得到最新值 无需lseek
+//-------------------------------------------------------------------------------------------------------------------
+    int read_text(char *buf, uint32 size);
+
+public:
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 构造函数
+// 参数说明 path  属性文件路径 NULL表示稍后调用open_path
+// 返回参数 无
+// 使用示例 zf_driver_sysfs_attr attr("/sys/bus/iio/devices/iio:device0/in_voltage0_raw");
+// 备注信息 只读方式打开
+//-------------------------------------------------------------------------------------------------------------------
+    zf_driver_sysfs_attr(const char *path = NULL);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 析构函数
+// 参数说明 无
+// 返回参数 无
+// 使用示例 自动调用，无需手动调用
+// 备注信息 自动关闭文件句柄
+//-------------------------------------------------------------------------------------------------------------------
+    ~zf_driver_sysfs_attr(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 打开属性文件
+// 参数说明 path  属性文件路径
+// 返回参数 int8  0-成功 -1-失败
+// 使用示例 attr.open_path(IMU_ACC_X_PATH);
+// 备注信息 已打开的文件先关闭
+//-------------------------------------------------------------------------------------------------------------------
+    int8 open_path(const char *path);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 关闭属性文件
+// 参数说明 无
+// 返回参数 无
+// 使用示例 attr.close_path();
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    void close_path(void);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 属性文件是否已打开
+// 参数说明 无
+// 返回参数 bool  true-已打开
+// 使用示例 if(!attr.is_open()) { ... }
+// 备注信息 无
+//-------------------------------------------------------------------------------------------------------------------
+    bool is_open(void) const { return fd >= 0; }
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取整数属性
+// 参数说明 value  读取结果
+// 返回参数 int8   0-成功 -1-失败(未打开/读取失败/内容不是整数)
+// 使用示例 int32 raw; if(0 == attr.read_int(&raw)) { ... }
+// 备注信息 允许前导空白和正负号
+//-------------------------------------------------------------------------------------------------------------------
+    int8 read_int(int32 *value);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取定点小数属性
+// 参数说明 value           读取结果 等于属性值乘以10的fraction_digits次方 多余的小数位直接截断
+// 参数说明 fraction_digits 保留的小数位数 最大SYSFS_ATTR_FRACTION_MAX
+// 返回参数 int8            0-成功 -1-失败
+// 使用示例 int64_t scale_nano; attr.read_fixed(&scale_nano, 9);        // "0.805664062" -> 805664062
+// 备注信息 全程整数运算 不经过浮点
+//-------------------------------------------------------------------------------------------------------------------
+    int8 read_fixed(int64_t *value, uint8 fraction_digits);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 读取浮点属性
+// 参数说明 value  读取结果
+// 返回参数 int8   0-成功 -1-失败
+// 使用示例 float scale; attr.read_float(&scale);
+// 备注信息 func_parse_float 解析 结果为正确舍入 支持指数形式
+//-------------------------------------------------------------------------------------------------------------------
+    int8 read_float(float *value);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 连续读取多个整数属性
+// 参数说明 attr   属性对象指针数组 元素可以为NULL
+// 参数说明 value  读取结果数组 读取失败的项写0
+// 参数说明 count  属性个数
+// 返回参数 uint32 读取成功的个数
+// 使用示例 zf_driver_sysfs_attr *axis[3] = {&acc_x, &acc_y, &acc_z}; int32 acc[3];
+//          zf_driver_sysfs_attr::read_int_batch(axis, acc, 3);
+// 备注信息 用于同一时刻附近依次采样多个通道 各通道间只有pread本身的间隔
+//-------------------------------------------------------------------------------------------------------------------
+    static uint32 read_int_batch(zf_driver_sysfs_attr *const *attr, int32 *value, uint32 count);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 解析整数字符串
+// 参数说明 str    以'\0'结尾的字符串
+// 参数说明 value  解析结果
+// 返回参数 int8   0-成功 -1-没有数字
+// 使用示例 zf_driver_sysfs_attr::parse_int("-123\n", &value);
+// 备注信息 数字之后的内容(换行等)被忽略
+//-------------------------------------------------------------------------------------------------------------------
+    static int8 parse_int(const char *str, int32 *value);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 按长度解析整数
+// 参数说明 str    起始位置 不要求以'\0'结尾
+// 参数说明 length 字节数
+// 参数说明 value  解析结果
+// 返回参数 int8   0-成功 -1-没有数字或超出int32范围
+// 使用示例 zf_driver_sysfs_attr::parse_int(buf, len, &value);
+// 备注信息 跳过前导空格与制表符 数字之后的内容被忽略 用于直接解析pread读到的缓冲区
+//-------------------------------------------------------------------------------------------------------------------
+    static int8 parse_int(const char *str, uint32 length, int32 *value);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 解析定点小数字符串
+// 参数说明 str             以'\0'结尾的字符串
+// 参数说明 value           解析结果 放大10的fraction_digits次方
+// 参数说明 fraction_digits 保留的小数位数 最大SYSFS_ATTR_FRACTION_MAX
+// 返回参数 int8            0-成功 -1-没有数字
+// 使用示例 zf_driver_sysfs_attr::parse_fixed("1.5", &value, 3);       // value = 1500
+// 备注信息 数字之后的内容被忽略
+//-------------------------------------------------------------------------------------------------------------------
+    static int8 parse_fixed(const char *str, int64_t *value, uint8 fraction_digits);
+
+//-------------------------------------------------------------------------------------------------------------------
+// 函数简介 按长度解析定点小数
+// 参数说明 str             起始位置 不要求以'\0'结尾
+// 参数说明 length          字节数
+// 参数说明 value           解析结果 放大10的fraction_digits次方
+// 参数说明 fraction_digits 保留的小数位数 最大SYSFS_ATTR_FRACTION_MAX
+// 返回参数 int8            0-成功 -1-没有数字
+// 使用示例 zf_driver_sysfs_attr::parse_fixed(buf, len, &value, 9);
+// 备注信息 跳过前导空格与制表符 数字之后的内容被忽略
+//-------------------------------------------------------------------------------------------------------------------
+    static int8 parse_fixed(const char *str, uint32 length, int64_t *value, uint8 fraction_digits);
+};
+
+#endif
\ No newline at end of file
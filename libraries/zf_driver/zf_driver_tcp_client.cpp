@@ -1,4 +1,5 @@
 #include "zf_driver_tcp_client.hpp"
+#include <poll.h>
 
 //-------------------------------------------------------------------------------------------------------------------
 // 函数简介 设置文件句柄为非阻塞模式
@@ -97,19 +98,42 @@ int8 zf_driver_tcp_client::init(const char *ip_addr, uint32 port)
 // 参数说明 length  待发送数据的字节长度
 // 返回参数 uint32  成功返回实际发送字节数  失败返回0
 // 使用示例 tcp_client.send_data(send_buf, sizeof(send_buf));
-// 备注信息 
+// 备注信息 非阻塞套接字可能只写入一部分 循环发送剩余数据 缓冲区满(EAGAIN)时最多等待TCP_CLIENT_SEND_TIMEOUT_MS
+//          返回值小于length说明超时或连接出错 剩余数据未发送
 //-------------------------------------------------------------------------------------------------------------------
 uint32 zf_driver_tcp_client::send_data(const uint8 *buff, uint32 length)
 {
-    int32 str_len;
-    str_len = send(m_socket, buff, length, 0);
-    
-    if (str_len == -1)
+    uint32 sent_length = 0;
+    ssize_t str_len;
+    struct pollfd pfd;
+
+    while (sent_length < length)
     {
-        printf("send() error");
-        return 0; 
+        str_len = send(m_socket, buff + sent_length, length - sent_length, MSG_NOSIGNAL);
+        if (str_len > 0)
+        {
+            sent_length += str_len;
+            continue;
+        }
+        if (str_len == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (str_len == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {   // 发送缓冲区已满 等待套接字可写
+            pfd.fd = m_socket;
+            pfd.events = POLLOUT;
+            pfd.revents = 0;
+            if (poll(&pfd, 1, TCP_CLIENT_SEND_TIMEOUT_MS) > 0)
+            {
+                continue;
+            }
+            break;
+        }
+        printf("send() error\r\n");
+        break;
     }
-    return str_len;
+    return sent_length;
 }
 
 //-------------------------------------------------------------------------------------------------------------------
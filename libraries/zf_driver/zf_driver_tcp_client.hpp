@@ -3,6 +3,8 @@
 
 #include "zf_common_typedef.hpp"
 
+#define TCP_CLIENT_SEND_TIMEOUT_MS      ( 20 )      // 发送缓冲区满时单次等待可写的最长时间
+
 class zf_driver_tcp_client
 {
 private:
@@ -48,7 +50,7 @@ public:
 // 参数说明 length  待发送数据的字节长度
 // 返回参数 uint32  成功返回实际发送字节数  失败返回0
 // 使用示例 tcp_client.send_data(send_buf, sizeof(send_buf));
-// 备注信息 基于非阻塞套接字发送数据
+// 备注信息 基于非阻塞套接字发送数据 处理部分写入与EAGAIN 返回值小于length说明剩余数据未发送
 //-------------------------------------------------------------------------------------------------------------------
     uint32 send_data(const uint8 *buff, uint32 length);
 
@@ -0,0 +1,315 @@
+/*---------------------------------------------------------------------
+ * @file     ahrs_replay.cpp
+ * @brief    姿态解算离线回放程序
+ * @details  用法  zf_ahrs_replay --log <文件> [选项]
+ *             --algorithm <mahony|madgwick>  解算算法 默认 mahony
+ *             --no-mag                       不使用磁力计
+ *             --print-every <n>              每 n 个样本输出一行姿态 默认 0 只输出最终结果
+ *             --expect <roll,pitch,yaw>      期望的最终欧拉角 单位°
+ *             --tolerance <度>               与期望值的允许误差 默认 2
+ *           日志为逐行CSV  timestamp_ns,ax,ay,az,gx,gy,gz,mx,my,mz  均为 imu_sample_struct 中的原始值
+ *           以'#'开头的行与无法解析的行(表头)被跳过
+ *           指定 --expect 时最终姿态超出误差返回1 可以把录制的日志作为回归测试
+ *
+ *           用法  zf_ahrs_replay --synthesize <文件>
+ *           按已知的运动过程生成日志 用于没有板子时的回归测试 见 project/benchmark/data/ahrs_tilt_turn.csv
+ *           静止1.5s -> 2s内平滑转到 roll 20 pitch -10 yaw 30 -> 保持2.5s 共6s 200Hz
+ *           含陀螺仪零偏 各轴噪声 时间戳抖动 噪声由固定种子生成 每次输出相同
+ *---------------------------------------------------------------------*/
+#include "zf_components_ahrs.hpp"
+
+#include <cmath>
+
+#define SYNTH_RATE_HZ               ( 200 )
+#define SYNTH_STILL_S               ( 1.5 )
+#define SYNTH_MOVE_S                ( 2.0 )
+#define SYNTH_HOLD_S                ( 2.5 )
+#define SYNTH_DEG_TO_RAD            ( 3.14159265358979323846 / 180.0 )
+
+static const char           *option_log         = NULL;
+static const char           *option_synthesize  = NULL;
+static ahrs_algorithm_enum  option_algorithm    = AHRS_MAHONY;
+static uint8                option_use_mag      = 1;
+static uint32               option_print_every  = 0;
+static uint8                option_expect       = 0;
+static double               option_expect_euler[3];
+static double               option_tolerance    = 2.0;
+
+static int replay_parse_option(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(0 == strcmp(arg, "--log") && NULL != value)
+        {
+            option_log = value;
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--synthesize") && NULL != value)
+        {
+            option_synthesize = value;
+            return 0;
+        }
+        else if(0 == strcmp(arg, "--algorithm") && NULL != value && (0 == strcmp(value, "mahony") || 0 == strcmp(value, "madgwick")))
+        {
+            option_algorithm = (0 == strcmp(value, "mahony")) ? AHRS_MAHONY : AHRS_MADGWICK;
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--no-mag"))
+        {
+            option_use_mag = 0;
+        }
+        else if(0 == strcmp(arg, "--print-every") && NULL != value)
+        {
+            option_print_every = (uint32)strtoul(value, NULL, 10);
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--expect") && NULL != value &&
+                3 == sscanf(value, "%lf,%lf,%lf", &option_expect_euler[0], &option_expect_euler[1], &option_expect_euler[2]))
+        {
+            option_expect = 1;
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--tolerance") && NULL != value)
+        {
+            option_tolerance = strtod(value, NULL);
+            i ++;
+        }
+        else
+        {
+            option_log = NULL;
+            break;
+        }
+    }
+    if(NULL == option_log)
+    {
+        fprintf(stderr, "usage: %s --log file [--algorithm mahony|madgwick] [--no-mag] [--print-every n] [--expect roll,pitch,yaw] [--tolerance deg]\r\n"
+                        "       %s --synthesize file\r\n", argv[0], argv[0]);
+        return -1;
+    }
+    return 0;
+}
+
+// 解析一行日志 成功返回0
+static int replay_parse_line(const char *line, imu_sample_struct *sample)
+{
+    long long timestamp_ns = 0;
+    int value[9];
+
+    if('#' == line[0])
+    {
+        return -1;
+    }
+    if(10 != sscanf(line, "%lld,%d,%d,%d,%d,%d,%d,%d,%d,%d", &timestamp_ns,
+                    &value[0], &value[1], &value[2], &value[3], &value[4], &value[5], &value[6], &value[7], &value[8]))
+    {
+        return -1;
+    }
+    for(int i = 0; i < 3; i ++)
+    {
+        sample->acc[i]  = (int16)value[i];
+        sample->gyro[i] = (int16)value[3 + i];
+        sample->mag[i]  = (int16)value[6 + i];
+    }
+    sample->timestamp_ns = (int64_t)timestamp_ns;
+    return 0;
+}
+
+// 角度差 折算到 ±180
+static double replay_angle_error(double a, double b)
+{
+    double error = fmod(a - b, 360.0);
+    if(error > 180.0)   error -= 360.0;
+    if(error < -180.0)  error += 360.0;
+    return error;
+}
+
+// 固定种子的近似正态噪声 12个均匀分布之和
+static double synth_noise(uint32 *seed)
+{
+    double sum = 0;
+    for(int i = 0; i < 12; i ++)
+    {
+        *seed = *seed * 1664525u + 1013904223u;
+        sum += (double)(*seed >> 8) / 16777216.0;
+    }
+    return sum - 6.0;
+}
+
+// 世界系向量转到机体系 R^T * v  R 为 ZYX 欧拉角对应的机体到世界旋转
+static void synth_to_body(const double euler[3], const double world[3], double body[3])
+{
+    double cr = cos(euler[0]), sr = sin(euler[0]);
+    double cp = cos(euler[1]), sp = sin(euler[1]);
+    double cy = cos(euler[2]), sy = sin(euler[2]);
+    double r[3][3] =
+    {
+        {cp * cy, sr * sp * cy - cr * sy, cr * sp * cy + sr * sy},
+        {cp * sy, sr * sp * sy + cr * cy, cr * sp * sy - sr * cy},
+        {-sp,     sr * cp,                cr * cp},
+    };
+    for(int i = 0; i < 3; i ++)
+    {
+        body[i] = r[0][i] * world[0] + r[1][i] * world[1] + r[2][i] * world[2];
+    }
+}
+
+static int16 synth_raw(double value)
+{
+    long raw = lround(value);
+    return (int16)((raw < -32768) ? -32768 : ((raw > 32767) ? 32767 : raw));
+}
+
+// 生成合成日志 世界系z轴向上 x轴指向磁北 与 zf_components_ahrs 的约定一致
+static int replay_synthesize(const char *path)
+{
+    const double target[3]  = {20.0 * SYNTH_DEG_TO_RAD, -10.0 * SYNTH_DEG_TO_RAD, 30.0 * SYNTH_DEG_TO_RAD};
+    const double gravity[3] = {0, 0, 1.0};                                      // g
+    const double field[3]   = {0.25, 0, -0.40};                                 // Gauss 北半球磁倾角约58°
+    const double gyro_bias[3] = {12, -8, 5};                                    // LSB 约 0.7 / -0.5 / 0.3 °/s
+    const uint32 total = (uint32)((SYNTH_STILL_S + SYNTH_MOVE_S + SYNTH_HOLD_S) * SYNTH_RATE_HZ);
+    uint32 seed = 20261018;
+    FILE *fp = fopen(path, "w");
+
+    if(NULL == fp)
+    {
+        perror(path);
+        return 1;
+    }
+
+    fprintf(fp, "# zf_ahrs_replay --synthesize 生成的合成日志 非实车录制\n");
+    fprintf(fp, "# 静止%.1fs -> %.1fs内平滑转到 roll 20 pitch -10 yaw 30 -> 保持%.1fs %dHz\n", SYNTH_STILL_S, SYNTH_MOVE_S, SYNTH_HOLD_S, SYNTH_RATE_HZ);
+    fprintf(fp, "# 陀螺仪零偏 %.0f,%.0f,%.0f LSB 噪声 acc 8 gyro 3 mag 6 LSB(1σ) 时间戳抖动 0.07ms(1σ)\n", gyro_bias[0], gyro_bias[1], gyro_bias[2]);
+    fprintf(fp, "# zf_ahrs_replay --log ahrs_tilt_turn.csv --algorithm mahony   --expect 20,-10,30 --tolerance 1\n");
+    fprintf(fp, "# zf_ahrs_replay --log ahrs_tilt_turn.csv --algorithm madgwick --expect 20,-10,30 --tolerance 1\n");
+    fprintf(fp, "# zf_ahrs_replay --log ahrs_tilt_turn.csv --algorithm mahony   --no-mag --expect 20,-10,30 --tolerance 1\n");
+    fprintf(fp, "# zf_ahrs_replay --log ahrs_tilt_turn.csv --algorithm madgwick --no-mag --expect 20,-10,30 --tolerance 1\n");
+    fprintf(fp, "timestamp_ns,ax,ay,az,gx,gy,gz,mx,my,mz\n");
+
+    for(uint32 n = 0; n < total; n ++)
+    {
+        double t = (double)n / SYNTH_RATE_HZ;
+        double s = 0, ds = 0;                                                   // 运动进度 0~1 与其导数
+        double euler[3], rate[3], omega[3], acc[3], mag[3];
+        int64_t timestamp_ns = 0;
+
+        if(t >= SYNTH_STILL_S + SYNTH_MOVE_S)
+        {
+            s = 1.0;
+        }
+        else if(t > SYNTH_STILL_S)
+        {
+            double u = (t - SYNTH_STILL_S) / SYNTH_MOVE_S;
+            s  = 0.5 - 0.5 * cos(M_PI * u);
+            ds = 0.5 * M_PI * sin(M_PI * u) / SYNTH_MOVE_S;
+        }
+        for(int i = 0; i < 3; i ++)
+        {
+            euler[i] = target[i] * s;
+            rate[i]  = target[i] * ds;
+        }
+
+        // ZYX 欧拉角速率换算为机体角速度
+        omega[0] = rate[0] - rate[2] * sin(euler[1]);
+        omega[1] = rate[1] * cos(euler[0]) + rate[2] * cos(euler[1]) * sin(euler[0]);
+        omega[2] = -rate[1] * sin(euler[0]) + rate[2] * cos(euler[1]) * cos(euler[0]);
+        synth_to_body(euler, gravity, acc);
+        synth_to_body(euler, field, mag);
+
+        timestamp_ns = (int64_t)1000000000 + (int64_t)n * (1000000000 / SYNTH_RATE_HZ) + (int64_t)(synth_noise(&seed) * 70000);
+        fprintf(fp, "%lld", (long long)timestamp_ns);
+        for(int i = 0; i < 3; i ++)
+        {
+            fprintf(fp, ",%d", synth_raw(acc[i] / AHRS_ACC_SCALE_DEFAULT + 8 * synth_noise(&seed)));
+        }
+        for(int i = 0; i < 3; i ++)
+        {
+            fprintf(fp, ",%d", synth_raw(omega[i] / SYNTH_DEG_TO_RAD / AHRS_GYRO_SCALE_DEFAULT + gyro_bias[i] + 3 * synth_noise(&seed)));
+        }
+        for(int i = 0; i < 3; i ++)
+        {
+            fprintf(fp, ",%d", synth_raw(mag[i] / AHRS_MAG_SCALE_DEFAULT + 6 * synth_noise(&seed)));
+        }
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    ahrs_config_struct config;
+    ahrs_struct ahrs;
+    ahrs_euler_struct euler;
+    imu_sample_struct sample;
+    char line[256];
+    uint32 count = 0;
+
+    if(0 != replay_parse_option(argc, argv))
+    {
+        return 1;
+    }
+    if(NULL != option_synthesize)
+    {
+        return replay_synthesize(option_synthesize);
+    }
+
+    FILE *fp = fopen(option_log, "r");
+    if(NULL == fp)
+    {
+        perror(option_log);
+        return 1;
+    }
+
+    ahrs_config_default(&config);
+    config.algorithm = option_algorithm;
+    config.use_mag   = option_use_mag;
+    ahrs_init(&ahrs, &config);
+
+    while(NULL != fgets(line, sizeof(line), fp))
+    {
+        if(0 != replay_parse_line(line, &sample))
+        {
+            continue;
+        }
+        ahrs_update(&ahrs, &sample);
+        count ++;
+        if(option_print_every && 0 == count % option_print_every)
+        {
+            ahrs_get_euler(&ahrs, &euler);
+            printf("%lld,%.3f,%.3f,%.3f,%.3f\r\n", (long long)sample.timestamp_ns,
+                   (double)euler.roll, (double)euler.pitch, (double)euler.yaw, (double)ahrs_get_yaw_rate(&ahrs));
+        }
+    }
+    fclose(fp);
+
+    if(0 == count)
+    {
+        fprintf(stderr, "ahrs_replay: no sample in %s\r\n", option_log);
+        return 1;
+    }
+
+    ahrs_get_euler(&ahrs, &euler);
+    printf("samples %u  roll %.3f  pitch %.3f  yaw %.3f  yaw_rate %.3f  gyro_bias %s (%.2f %.2f %.2f)\r\n",
+           count, (double)euler.roll, (double)euler.pitch, (double)euler.yaw, (double)ahrs_get_yaw_rate(&ahrs),
+           ahrs_gyro_bias_ready(&ahrs) ? "ready" : "pending",
+           (double)ahrs.config.calibration.gyro_bias[0], (double)ahrs.config.calibration.gyro_bias[1], (double)ahrs.config.calibration.gyro_bias[2]);
+
+    if(option_expect)
+    {
+        double result[3] = {(double)euler.roll, (double)euler.pitch, (double)euler.yaw};
+        for(int i = 0; i < 3; i ++)
+        {
+            if(fabs(replay_angle_error(result[i], option_expect_euler[i])) > option_tolerance)
+            {
+                fprintf(stderr, "ahrs_replay: FAIL expect %.3f,%.3f,%.3f tolerance %.3f\r\n",
+                        option_expect_euler[0], option_expect_euler[1], option_expect_euler[2], option_tolerance);
+                return 1;
+            }
+        }
+        printf("PASS\r\n");
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*---------------------------------------------------------------------
+ * @file     bench_ahrs.cpp
+ * @brief    姿态解算性能测试项
+ * @details  预先生成一段绕各轴摆动的样本 循环输入 ahrs_update
+ *           每次操作为一次完整更新(校准 + 静止检测 + 融合 + 航向角速度)
+ *           euler 项单独测量 ahrs_get_euler 的三角函数开销
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+#include "zf_components_ahrs.hpp"
+
+#include <cmath>
+
+#define BENCH_AHRS_SAMPLES          ( 256 )                 // 2的整数次方 取模用与运算
+
+static imu_sample_struct    bench_ahrs_sample[BENCH_AHRS_SAMPLES];
+static ahrs_struct          bench_ahrs;
+static ahrs_euler_struct    bench_ahrs_euler;
+
+// 1kHz 采样 三轴不同频率摆动 磁力计按固定方向给出
+static void bench_ahrs_generate(void)
+{
+    for(int i = 0; i < BENCH_AHRS_SAMPLES; i ++)
+    {
+        double phase = 2.0 * M_PI * i / BENCH_AHRS_SAMPLES;
+        bench_ahrs_sample[i].acc[0]  = (int16)(600 * sin(phase));
+        bench_ahrs_sample[i].acc[1]  = (int16)(400 * cos(phase * 2));
+        bench_ahrs_sample[i].acc[2]  = 4096;
+        bench_ahrs_sample[i].gyro[0] = (int16)(500 * cos(phase));
+        bench_ahrs_sample[i].gyro[1] = (int16)(-300 * sin(phase * 2));
+        bench_ahrs_sample[i].gyro[2] = (int16)(800 * sin(phase * 3));
+        bench_ahrs_sample[i].mag[0]  = (int16)(1500 * cos(phase));
+        bench_ahrs_sample[i].mag[1]  = (int16)(1500 * sin(phase));
+        bench_ahrs_sample[i].mag[2]  = -2400;
+        bench_ahrs_sample[i].timestamp_ns = 0;              // 时间戳不连续 按 sample_period 计算
+    }
+}
+
+static void bench_ahrs_setup(ahrs_algorithm_enum algorithm, uint8 use_mag)
+{
+    ahrs_config_struct config;
+
+    bench_ahrs_generate();
+    ahrs_config_default(&config);
+    config.algorithm = algorithm;
+    config.use_mag   = use_mag;
+    ahrs_init(&bench_ahrs, &config);
+    ahrs_update(&bench_ahrs, &bench_ahrs_sample[0]);        // 第一次更新只确定初始姿态 不计入
+}
+
+static void bench_ahrs_setup_mahony_6axis(void)     { bench_ahrs_setup(AHRS_MAHONY, 0); }
+static void bench_ahrs_setup_mahony_9axis(void)     { bench_ahrs_setup(AHRS_MAHONY, 1); }
+static void bench_ahrs_setup_madgwick_6axis(void)   { bench_ahrs_setup(AHRS_MADGWICK, 0); }
+static void bench_ahrs_setup_madgwick_9axis(void)   { bench_ahrs_setup(AHRS_MADGWICK, 1); }
+
+static void bench_ahrs_update(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        ahrs_update(&bench_ahrs, &bench_ahrs_sample[i & (BENCH_AHRS_SAMPLES - 1)]);
+    }
+    benchmark_keep(bench_ahrs.q);
+}
+
+static void bench_ahrs_get_euler(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        ahrs_get_euler(&bench_ahrs, &bench_ahrs_euler);
+        benchmark_keep(&bench_ahrs_euler);
+    }
+}
+
+void bench_ahrs_register(void)
+{
+    benchmark_register("ahrs/mahony_6axis",     bench_ahrs_update,      bench_ahrs_setup_mahony_6axis);
+    benchmark_register("ahrs/mahony_9axis",     bench_ahrs_update,      bench_ahrs_setup_mahony_9axis);
+    benchmark_register("ahrs/madgwick_6axis",   bench_ahrs_update,      bench_ahrs_setup_madgwick_6axis);
+    benchmark_register("ahrs/madgwick_9axis",   bench_ahrs_update,      bench_ahrs_setup_madgwick_9axis);
+    benchmark_register("ahrs/euler",            bench_ahrs_get_euler,   bench_ahrs_setup_mahony_9axis);
+}
@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------
+ * @file     bench_assistant.cpp
+ * @brief    逐飞助手协议组包/解析性能测试项
+ * @details  发送回调只把数据拷贝到内存 模拟写入发送缓冲区 不经过网络
+ *           接收回调每次返回固定的参数包 测量解析开销
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+#include "seekfree_assistant.hpp"
+#include "seekfree_assistant_interface.hpp"
+
+#define BENCH_CAMERA_WIDTH          ( 160 )
+#define BENCH_CAMERA_HEIGHT         ( 120 )
+#define BENCH_SINK_SIZE             ( 0x10000 )
+#define BENCH_PARAMETER_PACKET      ( 4 )       // 每次接收回调返回的参数包数量
+
+static uint8    bench_sink[BENCH_SINK_SIZE];
+static uint32   bench_sink_offset = 0;
+static uint8    bench_camera_image[BENCH_CAMERA_WIDTH * BENCH_CAMERA_HEIGHT];
+static uint8    bench_boundary[3][BENCH_CAMERA_HEIGHT];
+static uint8    bench_receive_data[BENCH_PARAMETER_PACKET * sizeof(seekfree_assistant_parameter_struct)];
+
+static uint32 bench_assistant_transfer(const uint8 *buff, uint32 length)
+{
+    if(BENCH_SINK_SIZE < bench_sink_offset + length)
+    {
+        bench_sink_offset = 0;
+    }
+    if(BENCH_SINK_SIZE >= length)
+    {
+        memcpy(bench_sink + bench_sink_offset, buff, length);
+        bench_sink_offset += length;
+    }
+    return 0;
+}
+
+static uint32 bench_assistant_receive(uint8 *buff, uint32 length)
+{
+    uint32 copy_length = sizeof(bench_receive_data) < length ? sizeof(bench_receive_data) : length;
+    memcpy(buff, bench_receive_data, copy_length);
+    return copy_length;
+}
+
+static void bench_assistant_setup(void)
+{
+    seekfree_assistant_parameter_struct packet;
+    uint8 sum;
+
+    seekfree_assistant_interface_init(bench_assistant_transfer, bench_assistant_receive);
+
+    for(uint32 i = 0; i < sizeof(bench_camera_image); i ++)
+    {
+        bench_camera_image[i] = (uint8)i;
+    }
+    for(uint32 i = 0; i < BENCH_CAMERA_HEIGHT; i ++)
+    {
+        bench_boundary[0][i] = (uint8)(20 + i / 4);
+        bench_boundary[1][i] = (uint8)(BENCH_CAMERA_WIDTH / 2);
+        bench_boundary[2][i] = (uint8)(BENCH_CAMERA_WIDTH - 20 - i / 4);
+    }
+    seekfree_assistant_camera_information_config(SEEKFREE_ASSISTANT_GRAY, bench_camera_image, BENCH_CAMERA_WIDTH, BENCH_CAMERA_HEIGHT);
+    seekfree_assistant_camera_boundary_config(X_BOUNDARY, BENCH_CAMERA_HEIGHT, bench_boundary[0], bench_boundary[1], bench_boundary[2], NULL, NULL, NULL);
+
+    // 构造合法的参数包 和校验与上位机一致 为校验和字段置0后全部字节求和
+    for(uint32 i = 0; i < BENCH_PARAMETER_PACKET; i ++)
+    {
+        memset(&packet, 0, sizeof(packet));
+        packet.head     = SEEKFREE_ASSISTANT_RECEIVE_HEAD;
+        packet.function = SEEKFREE_ASSISTANT_RECEIVE_SET_PARAMETER;
+        packet.channel  = (uint8)(i + 1);
+        packet.data     = 1.5f * (float)i;
+        sum = 0;
+        for(uint32 j = 0; j < sizeof(packet); j ++)
+        {
+            sum += ((uint8 *)&packet)[j];
+        }
+        packet.check_sum = sum;
+        memcpy(bench_receive_data + i * sizeof(packet), &packet, sizeof(packet));
+    }
+}
+
+static void bench_assistant_oscilloscope(uint32 ops)
+{
+    seekfree_assistant_oscilloscope_struct data;
+    memset(&data, 0, sizeof(data));
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        data.channel_num = SEEKFREE_ASSISTANT_SET_OSCILLOSCOPE_COUNT;
+        for(uint32 j = 0; j < SEEKFREE_ASSISTANT_SET_OSCILLOSCOPE_COUNT; j ++)
+        {
+            data.data[j] = (float)(i + j);
+        }
+        seekfree_assistant_oscilloscope_send(&data);
+    }
+    benchmark_keep(bench_sink);
+}
+
+static void bench_assistant_camera(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        seekfree_assistant_camera_send();
+    }
+    benchmark_keep(bench_sink);
+}
+
+static void bench_assistant_parameter(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        seekfree_assistant_data_analysis();
+    }
+    benchmark_keep(seekfree_assistant_parameter);
+}
+
+void bench_assistant_register(void)
+{
+    benchmark_register("assistant/oscilloscope_8ch",    bench_assistant_oscilloscope,   bench_assistant_setup);
+    benchmark_register("assistant/camera_gray_160x120", bench_assistant_camera,         bench_assistant_setup);
+    benchmark_register("assistant/parameter_parse_4",   bench_assistant_parameter,      bench_assistant_setup);
+}
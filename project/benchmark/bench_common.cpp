@@ -0,0 +1,402 @@
+/*---------------------------------------------------------------------
+ * @file     bench_common.cpp
+ * @brief    zf_common 性能测试项 FIFO 读写与数字/字符串转换
+ * @details  字符串转换同时给出 libc snprintf 作为对照 解析给出 atoi/strtol/strtof/strtod 作为对照
+ *           准备数据时逐个比对 func_*_to_str 与 snprintf 的输出 不一致时退出 完整的比对见 format_check.cpp
+ *           解析准备数据时另外生成随机文本 比对 func_parse_* 与 libc 的结果和结束位置 不一致时退出
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+#include "zf_common_fifo.hpp"
+#include "zf_common_function.hpp"
+
+#include <cmath>
+
+#define BENCH_FIFO_SIZE             ( 4096 )
+#define BENCH_VALUE_COUNT           ( 256 )     // 轮流转换的数值个数 避免分支预测记住单一输入
+#define BENCH_PARSE_TEXT_SIZE       ( 24 )
+#define BENCH_PARSE_FUZZ_COUNT      ( 200000 )  // 解析随机比对的次数
+
+static fifo_struct  bench_fifo;
+static uint8        bench_fifo_buffer[BENCH_FIFO_SIZE];
+static uint8        bench_fifo_data[BENCH_FIFO_SIZE];
+static uint8        bench_fifo_out[BENCH_FIFO_SIZE];
+
+static int32        bench_int_value[BENCH_VALUE_COUNT];
+static float        bench_float_value[BENCH_VALUE_COUNT];
+static char         bench_text[64];
+
+// 解析输入 与sysfs属性相同带换行 不含结束符的长度另存
+static char         bench_parse_int_text[BENCH_VALUE_COUNT][BENCH_PARSE_TEXT_SIZE];
+static char         bench_parse_float_text[BENCH_VALUE_COUNT][BENCH_PARSE_TEXT_SIZE];
+static uint8        bench_parse_int_length[BENCH_VALUE_COUNT];
+static uint8        bench_parse_float_length[BENCH_VALUE_COUNT];
+
+static void bench_fifo_setup(void)
+{
+    fifo_init(&bench_fifo, FIFO_DATA_8BIT, bench_fifo_buffer, BENCH_FIFO_SIZE);
+    for(uint32 i = 0; i < BENCH_FIFO_SIZE; i ++)
+    {
+        bench_fifo_data[i] = (uint8)i;
+    }
+}
+
+// 写入后立即读出同样长度 读写位置持续前进 覆盖回绕分段拷贝
+static inline void bench_fifo_write_read(uint32 ops, uint32 length)
+{
+    uint32 read_length;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        read_length = length;
+        fifo_write_buffer(&bench_fifo, bench_fifo_data, length);
+        fifo_read_buffer(&bench_fifo, bench_fifo_out, &read_length, FIFO_READ_AND_CLEAN);
+    }
+    benchmark_keep(bench_fifo_out);
+}
+
+static void bench_fifo_8(uint32 ops)    { bench_fifo_write_read(ops, 8); }
+static void bench_fifo_64(uint32 ops)   { bench_fifo_write_read(ops, 64); }
+static void bench_fifo_1024(uint32 ops) { bench_fifo_write_read(ops, 1024); }
+
+static void bench_fifo_element(uint32 ops)
+{
+    uint8 value;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        fifo_write_element(&bench_fifo, (uint8)i);
+        fifo_read_element(&bench_fifo, &value, FIFO_READ_AND_CLEAN);
+    }
+    benchmark_keep(&value);
+}
+
+static void bench_value_setup(void)
+{
+    uint32 seed = 12345;
+    for(uint32 i = 0; i < BENCH_VALUE_COUNT; i ++)
+    {
+        seed = seed * 1103515245 + 12345;
+        // 覆盖 1~7 位数及正负号 接近控制参数与传感器数据的取值范围
+        bench_int_value[i]   = (int32)(seed >> 8) % 2000000 - 1000000;
+        bench_int_value[i]  /= (int32)(1 + (seed & 0xFF) * 40);
+        bench_float_value[i] = (float)bench_int_value[i] / 97.0f;
+    }
+
+    for(uint32 i = 0; i < BENCH_VALUE_COUNT; i ++)
+    {
+        char expect[64];
+        memset(bench_text, 0, sizeof(bench_text));
+        func_int_to_str(bench_text, bench_int_value[i]);
+        snprintf(expect, sizeof(expect), "%d", (int)bench_int_value[i]);
+        if(0 != strcmp(bench_text, expect))
+        {
+            fprintf(stderr, "format: func_int_to_str(%d) = \"%s\"\r\n", (int)bench_int_value[i], bench_text);
+            exit(EXIT_FAILURE);
+        }
+        memset(bench_text, 0, sizeof(bench_text));
+        func_float_to_str(bench_text, bench_float_value[i], 3);
+        snprintf(expect, sizeof(expect), "%.3f", (double)bench_float_value[i]);
+        if(0 != strcmp(bench_text, expect))
+        {
+            fprintf(stderr, "format: func_float_to_str(%.9g) = \"%s\" expect \"%s\"\r\n", (double)bench_float_value[i], bench_text, expect);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void bench_int_to_str(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        func_int_to_str(bench_text, bench_int_value[i & (BENCH_VALUE_COUNT - 1)]);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_float_to_str(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        func_float_to_str(bench_text, bench_float_value[i & (BENCH_VALUE_COUNT - 1)], 3);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_double_to_str(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        func_double_to_str(bench_text, (double)bench_float_value[i & (BENCH_VALUE_COUNT - 1)], 6);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_zf_sprintf_int(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        zf_sprintf((int8 *)bench_text, (const int8 *)"%d", bench_int_value[i & (BENCH_VALUE_COUNT - 1)]);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_zf_sprintf_float(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        zf_sprintf((int8 *)bench_text, (const int8 *)"%f", (double)bench_float_value[i & (BENCH_VALUE_COUNT - 1)]);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_zf_sprintf_hud(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        uint32 index = i & (BENCH_VALUE_COUNT - 1);
+        zf_sprintf((int8 *)bench_text, (const int8 *)"v=%.2f e=%d", (double)bench_float_value[index], bench_int_value[index]);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_snprintf_int(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        snprintf(bench_text, sizeof(bench_text), "%d", (int)bench_int_value[i & (BENCH_VALUE_COUNT - 1)]);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_snprintf_float(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        snprintf(bench_text, sizeof(bench_text), "%.3f", (double)bench_float_value[i & (BENCH_VALUE_COUNT - 1)]);
+        benchmark_keep(bench_text);
+    }
+}
+
+static void bench_snprintf_hud(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        uint32 index = i & (BENCH_VALUE_COUNT - 1);
+        snprintf(bench_text, sizeof(bench_text), "v=%.2f e=%d", (double)bench_float_value[index], (int)bench_int_value[index]);
+        benchmark_keep(bench_text);
+    }
+}
+
+// 比对 func_parse_* 与 libc 的结果 libc 没有解析出字符时应为 INVALID 且 ptr 不动 超出范围时应为 RANGE
+static uint8 bench_parse_match(const char *text, func_parse_result_struct result, const char *end, int range, uint8 value_equal)
+{
+    if(end == text)     return (FUNC_PARSE_INVALID == result.error && text == result.ptr);
+    if(end != result.ptr) return 0;
+    if(range)           return (FUNC_PARSE_RANGE == result.error);
+    return (FUNC_PARSE_OK == result.error && value_equal);
+}
+
+// 由可能构成数字的字符随机组成的文本 覆盖前导0 多个小数点 孤立的e 符号 inf/nan 片段等情况
+// 不含空白(libc会跳过) 'x'(strtod会按十六进制浮点解析) '('(strtod会解析nan(...))
+// 十六进制另用一组字符 覆盖 0x 前缀 大小写字母 "0x" 后没有数字等情况
+static void bench_parse_fuzz(void)
+{
+    static const char alphabet[] = "00123456789.eE+-infaINFA9\n";
+    static const char hex_alphabet[] = "000x0X123456789abcdefABCDEFgG+-\n";
+    uint32 seed = 54321;
+    char text[BENCH_PARSE_TEXT_SIZE + 1];
+    char hex_text[BENCH_PARSE_TEXT_SIZE + 1];
+    char *end = NULL;
+    int range = 0;
+
+    for(uint32 i = 0; i < BENCH_PARSE_FUZZ_COUNT; i ++)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint32 length = 1 + (seed >> 16) % BENCH_PARSE_TEXT_SIZE;
+        for(uint32 k = 0; k < length; k ++)
+        {
+            seed = seed * 1103515245 + 12345;
+            text[k] = alphabet[(seed >> 16) % (sizeof(alphabet) - 1)];
+        }
+        text[length] = '\0';
+        if('\n' == text[0]) text[0] = '1';
+
+        double double_value = 0;
+        errno = 0;
+        double double_expect = strtod(text, &end);
+        range = (ERANGE == errno) && (0 == double_expect || std::isinf(double_expect));
+        func_parse_result_struct result = func_parse_double(text, length, &double_value);
+        if(!bench_parse_match(text, result, end, range, 0 == memcmp(&double_value, &double_expect, sizeof(double)) ||
+                                                       (std::isnan(double_value) && std::isnan(double_expect))))
+        {
+            fprintf(stderr, "parse: func_parse_double(\"%s\") = %.17g error %d\r\n", text, double_value, (int)result.error);
+            exit(EXIT_FAILURE);
+        }
+
+        float float_value = 0;
+        errno = 0;
+        float float_expect = strtof(text, &end);
+        range = (ERANGE == errno) && (0 == float_expect || std::isinf(float_expect));
+        result = func_parse_float(text, length, &float_value);
+        if(!bench_parse_match(text, result, end, range, 0 == memcmp(&float_value, &float_expect, sizeof(float)) ||
+                                                       (std::isnan(float_value) && std::isnan(float_expect))))
+        {
+            fprintf(stderr, "parse: func_parse_float(\"%s\") = %.9g error %d\r\n", text, (double)float_value, (int)result.error);
+            exit(EXIT_FAILURE);
+        }
+
+        int32 int_value = 0;
+        errno = 0;
+        long long int_expect = strtoll(text, &end, 10);
+        range = (ERANGE == errno) || INT32_MAX < int_expect || INT32_MIN > int_expect;
+        result = func_parse_int(text, length, &int_value);
+        if(!bench_parse_match(text, result, end, range, int_value == int_expect))
+        {
+            fprintf(stderr, "parse: func_parse_int(\"%s\") = %d error %d\r\n", text, (int)int_value, (int)result.error);
+            exit(EXIT_FAILURE);
+        }
+
+        // strtoull 接受负号并取反 func_parse_uint 视负号为无效
+        uint32 uint_value = 0;
+        errno = 0;
+        unsigned long long uint_expect = strtoull(text, &end, 10);
+        if('-' == text[0]) end = text;
+        range = (ERANGE == errno) || UINT32_MAX < uint_expect;
+        result = func_parse_uint(text, length, &uint_value);
+        if(!bench_parse_match(text, result, end, range, uint_value == uint_expect))
+        {
+            fprintf(stderr, "parse: func_parse_uint(\"%s\") = %u error %d\r\n", text, (unsigned)uint_value, (int)result.error);
+            exit(EXIT_FAILURE);
+        }
+
+        for(uint32 k = 0; k < length; k ++)
+        {
+            seed = seed * 1103515245 + 12345;
+            hex_text[k] = hex_alphabet[(seed >> 16) % (sizeof(hex_alphabet) - 1)];
+        }
+        hex_text[length] = '\0';
+        if('\n' == hex_text[0]) hex_text[0] = 'a';
+
+        // func_parse_hex 不接受符号
+        uint32 hex_value = 0;
+        errno = 0;
+        unsigned long long hex_expect = strtoull(hex_text, &end, 16);
+        if('-' == hex_text[0] || '+' == hex_text[0]) end = hex_text;
+        range = (ERANGE == errno) || UINT32_MAX < hex_expect;
+        result = func_parse_hex(hex_text, length, &hex_value);
+        if(!bench_parse_match(hex_text, result, end, range, hex_value == hex_expect))
+        {
+            fprintf(stderr, "parse: func_parse_hex(\"%s\") = 0x%X error %d\r\n", hex_text, (unsigned)hex_value, (int)result.error);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+static void bench_parse_setup(void)
+{
+    bench_value_setup();
+    for(uint32 i = 0; i < BENCH_VALUE_COUNT; i ++)
+    {
+        // sysfs 属性的典型写法 整数带换行 小数为 0~9 位定点
+        bench_parse_int_length[i] = (uint8)snprintf(bench_parse_int_text[i], BENCH_PARSE_TEXT_SIZE, "%d\n", (int)bench_int_value[i]);
+        bench_parse_float_length[i] = (uint8)snprintf(bench_parse_float_text[i], BENCH_PARSE_TEXT_SIZE, "%.*f\n", (int)(i % 10), (double)bench_float_value[i]);
+    }
+    bench_parse_fuzz();
+}
+
+static void bench_parse_int(uint32 ops)
+{
+    int32 value = 0;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        uint32 index = i & (BENCH_VALUE_COUNT - 1);
+        func_parse_int(bench_parse_int_text[index], bench_parse_int_length[index], &value);
+        benchmark_keep(&value);
+    }
+}
+
+static void bench_atoi(uint32 ops)
+{
+    int32 value = 0;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        value = atoi(bench_parse_int_text[i & (BENCH_VALUE_COUNT - 1)]);
+        benchmark_keep(&value);
+    }
+}
+
+static void bench_strtol(uint32 ops)
+{
+    long value = 0;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        value = strtol(bench_parse_int_text[i & (BENCH_VALUE_COUNT - 1)], NULL, 10);
+        benchmark_keep(&value);
+    }
+}
+
+static void bench_parse_float(uint32 ops)
+{
+    float value = 0;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        uint32 index = i & (BENCH_VALUE_COUNT - 1);
+        func_parse_float(bench_parse_float_text[index], bench_parse_float_length[index], &value);
+        benchmark_keep(&value);
+    }
+}
+
+static void bench_strtof(uint32 ops)
+{
+    float value = 0;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        value = strtof(bench_parse_float_text[i & (BENCH_VALUE_COUNT - 1)], NULL);
+        benchmark_keep(&value);
+    }
+}
+
+static void bench_parse_double(uint32 ops)
+{
+    double value = 0;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        uint32 index = i & (BENCH_VALUE_COUNT - 1);
+        func_parse_double(bench_parse_float_text[index], bench_parse_float_length[index], &value);
+        benchmark_keep(&value);
+    }
+}
+
+static void bench_strtod(uint32 ops)
+{
+    double value = 0;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        value = strtod(bench_parse_float_text[i & (BENCH_VALUE_COUNT - 1)], NULL);
+        benchmark_keep(&value);
+    }
+}
+
+void bench_common_register(void)
+{
+    benchmark_register("fifo/write_read_8",         bench_fifo_8,           bench_fifo_setup);
+    benchmark_register("fifo/write_read_64",        bench_fifo_64,          bench_fifo_setup);
+    benchmark_register("fifo/write_read_1024",      bench_fifo_1024,        bench_fifo_setup);
+    benchmark_register("fifo/element",              bench_fifo_element,     bench_fifo_setup);
+
+    benchmark_register("format/func_int_to_str",    bench_int_to_str,       bench_value_setup);
+    benchmark_register("format/func_float_to_str",  bench_float_to_str,     bench_value_setup);
+    benchmark_register("format/zf_sprintf_int",     bench_zf_sprintf_int,   bench_value_setup);
+    benchmark_register("format/zf_sprintf_float",   bench_zf_sprintf_float, bench_value_setup);
+    benchmark_register("format/snprintf_int",       bench_snprintf_int,     bench_value_setup);
+    benchmark_register("format/snprintf_float",     bench_snprintf_float,   bench_value_setup);
+    benchmark_register("format/func_double_to_str_6", bench_double_to_str,  bench_value_setup);
+    benchmark_register("format/zf_sprintf_hud",     bench_zf_sprintf_hud,   bench_value_setup);
+    benchmark_register("format/snprintf_hud",       bench_snprintf_hud,     bench_value_setup);
+
+    benchmark_register("parse/func_parse_int",      bench_parse_int,        bench_parse_setup);
+    benchmark_register("parse/atoi",                bench_atoi,             bench_parse_setup);
+    benchmark_register("parse/strtol",              bench_strtol,           bench_parse_setup);
+    benchmark_register("parse/func_parse_float",    bench_parse_float,      bench_parse_setup);
+    benchmark_register("parse/strtof",              bench_strtof,           bench_parse_setup);
+    benchmark_register("parse/func_parse_double",   bench_parse_double,     bench_parse_setup);
+    benchmark_register("parse/strtod",              bench_strtod,           bench_parse_setup);
+}
@@ -0,0 +1,330 @@
+/*---------------------------------------------------------------------
+ * @file     bench_display.cpp
+ * @brief    DisplayIps200 绘图性能测试项
+ * @details  通过 DisplayIps200::attach 绑定内存显存 不需要 /dev/fb0
+ *           统计的是写入显存的CPU开销 不包含 SPI 刷屏时间
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+#include "zf_common_font.hpp"
+#include "zf_device_ips200_fb.hpp"
+#include "zf_components_display.hpp"
+
+#define BENCH_SCREEN_WIDTH          ( 240 )
+#define BENCH_SCREEN_HEIGHT         ( 320 )
+#define BENCH_IMAGE_WIDTH           ( 160 )
+#define BENCH_IMAGE_HEIGHT          ( 120 )
+
+static uint16 bench_screen[BENCH_SCREEN_WIDTH * BENCH_SCREEN_HEIGHT];
+static uint8  bench_gray_image[BENCH_IMAGE_WIDTH * BENCH_IMAGE_HEIGHT];
+static uint16 bench_rgb_image[BENCH_IMAGE_WIDTH * BENCH_IMAGE_HEIGHT];
+static uint8  bench_bgr_image[BENCH_IMAGE_WIDTH * BENCH_IMAGE_HEIGHT * 3];
+static uint8  bench_boundary[3][BENCH_IMAGE_HEIGHT];                   // 左 中 右三条边线 下标为行号
+
+static void bench_display_setup(void)
+{
+    DisplayIps200::attach(bench_screen, BENCH_SCREEN_WIDTH, BENCH_SCREEN_HEIGHT);
+    for(uint32 i = 0; i < BENCH_IMAGE_WIDTH * BENCH_IMAGE_HEIGHT; i ++)
+    {
+        bench_gray_image[i] = (uint8)(i * 7);
+        bench_rgb_image[i]  = (uint16)(i * 131);
+    }
+    for(uint32 i = 0; i < sizeof(bench_bgr_image); i ++)
+    {
+        bench_bgr_image[i] = (uint8)(i * 13);
+    }
+    for(uint32 i = 0; i < BENCH_IMAGE_HEIGHT; i ++)
+    {
+        bench_boundary[0][i] = (uint8)(20 + i / 3);
+        bench_boundary[2][i] = (uint8)(BENCH_IMAGE_WIDTH - 20 - i / 3);
+        bench_boundary[1][i] = (uint8)((bench_boundary[0][i] + bench_boundary[2][i]) / 2);
+    }
+}
+
+static void bench_display_back_buffer_setup(void)
+{
+    bench_display_setup();
+    DisplayIps200::enableBackBuffer();
+    DisplayIps200::showRgbImage(0, 0, bench_rgb_image, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT);
+    DisplayIps200::present();
+}
+
+static void bench_display_back_buffer_teardown(void)
+{
+    DisplayIps200::disableBackBuffer();
+}
+
+static void bench_display_full(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::full((i & 1) ? RGB565_BLACK : RGB565_WHITE);
+    }
+    benchmark_keep(bench_screen);
+}
+
+// 改动前 full 的写法 按列逐点调用 drawPoint
+static void bench_display_full_legacy(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        uint16 color = (i & 1) ? RGB565_BLACK : RGB565_WHITE;
+        for(uint16 x = 0; x < BENCH_SCREEN_WIDTH; x ++)
+        {
+            for(uint16 y = 0; y < BENCH_SCREEN_HEIGHT; y ++)
+            {
+                DisplayIps200::drawPoint(x, y, color);
+            }
+        }
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_fill_rect(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::fillRect((int)(i & 63) + 1, (int)(i & 127), 100, 50, (i & 1) ? RGB565_BLACK : RGB565_WHITE);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_point(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::drawPoint((uint16)(i % BENCH_SCREEN_WIDTH), (uint16)((i >> 3) % BENCH_SCREEN_HEIGHT), RGB565_RED);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_line(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::drawLine(0, (uint16)(i % BENCH_SCREEN_HEIGHT), BENCH_SCREEN_WIDTH - 1, (uint16)(BENCH_SCREEN_HEIGHT - 1 - i % BENCH_SCREEN_HEIGHT), RGB565_BLUE);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_line_clipped(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::drawLine(-1000, -500 + (int)(i % 64), 1000, 700 - (int)(i % 64), RGB565_BLUE);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_polyline(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        for(uint8 j = 0; j < 3; j ++)
+        {
+            DisplayIps200::drawPolyline(0, 0, bench_boundary[j], NULL, BENCH_IMAGE_HEIGHT, RGB565_RED);
+        }
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_circle(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::drawCircle(120, 160, 50, RGB565_GREEN);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_fill_circle(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::fillCircle(120, 160, 50, RGB565_GREEN);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_string(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::showString(0, (uint16)((i & 15) * 16), "speed: 1.234 m/s");
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_int(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::showInt(0, 0, (int32)(i * 37) - 50000, 6);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_float(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::showFloat(0, 16, (double)i * 0.013 - 100.0, 4, 3);
+    }
+    benchmark_keep(bench_screen);
+}
+
+// 数值控件 相邻两帧的数值通常只有末尾几位变化
+static void bench_display_field_float(uint32 ops)
+{
+    static DisplayIps200Field field(0, 16, 9);
+
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        field.showFloat((double)i * 0.013 - 100.0, 4, 3);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_string_6x8(uint32 ops)
+{
+    DisplayIps200::setFont(IPS200_6X8_FONT);
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::showString(0, (uint16)((i & 15) * 8), "speed: 1.234 m/s");
+    }
+    DisplayIps200::setFont(IPS200_8X16_FONT);
+    benchmark_keep(bench_screen);
+}
+
+// 典型的调试界面 每帧更新三个字段 启用后台缓冲时再加一次present
+static void bench_display_hud(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::showFloat(56, 130, (double)i * 0.37, 3, 2);
+        DisplayIps200::showInt(56, 146, (int32)i - 50, 4);
+        DisplayIps200::showString(56, 162, (i & 1) ? "RUN " : "STOP");
+        DisplayIps200::present();
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_gray_image(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::showGrayImage(0, 0, bench_gray_image, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_bgr_image(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::blitBgr(0, 0, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT, bench_bgr_image, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT);
+    }
+    benchmark_keep(bench_screen);
+}
+
+// 160x120 放大到整屏宽度 240x180
+static void bench_display_gray_nearest(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::blitGray(0, 0, 240, 180, bench_gray_image, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT, 0, IPS200_SCALE_NEAREST);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_bgr_nearest(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::blitBgr(0, 0, 240, 180, bench_bgr_image, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT, 0, IPS200_SCALE_NEAREST);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_bgr_bilinear(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::blitBgr(0, 0, 240, 180, bench_bgr_image, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT, 0, IPS200_SCALE_BILINEAR);
+    }
+    benchmark_keep(bench_screen);
+}
+
+static void bench_display_rgb_image(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        DisplayIps200::showRgbImage(0, 0, bench_rgb_image, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT);
+    }
+    benchmark_keep(bench_screen);
+}
+
+// 视觉循环一帧的显示工作 图像 三条边线 目标框 三个字段 生产者只填写帧描述并提交
+static zf_components_display bench_display_service;
+
+static void bench_display_service_fill(uint32 i)
+{
+    bench_display_service.begin_frame();
+    bench_display_service.set_image(bench_gray_image, DISPLAY_IMAGE_GRAY, BENCH_IMAGE_WIDTH, BENCH_IMAGE_HEIGHT, 0, 0);
+    bench_display_service.add_polyline(0, 0, bench_boundary[0], NULL, BENCH_IMAGE_HEIGHT, RGB565_RED);
+    bench_display_service.add_polyline(0, 0, bench_boundary[1], NULL, BENCH_IMAGE_HEIGHT, RGB565_GREEN);
+    bench_display_service.add_polyline(0, 0, bench_boundary[2], NULL, BENCH_IMAGE_HEIGHT, RGB565_BLUE);
+    bench_display_service.add_rect(60 + (i & 15), 40, 32, 24, RGB565_YELLOW);
+    bench_display_service.add_float(56, 130, (double)i * 0.37, 2);
+    bench_display_service.add_int(56, 146, (int32)i - 50);
+    bench_display_service.add_text(56, 162, (i & 1) ? "RUN " : "STOP");
+}
+
+static void bench_display_service_submit(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_display_service_fill(i);
+        bench_display_service.submit();
+    }
+    benchmark_keep(bench_display_service.begin_frame());
+}
+
+// 同样的帧由渲染一侧合成并写入显存 即渲染线程每帧的开销
+static void bench_display_service_render(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_display_service_fill(i);
+        bench_display_service.submit();
+        bench_display_service.render();
+    }
+    benchmark_keep(bench_screen);
+}
+
+void bench_display_register(void)
+{
+    benchmark_register("ips200/full_legacy_240x320", bench_display_full_legacy, bench_display_setup);
+    benchmark_register("ips200/full_240x320",       bench_display_full,         bench_display_setup);
+    benchmark_register("ips200/fill_rect_100x50",   bench_display_fill_rect,    bench_display_setup);
+    benchmark_register("ips200/draw_point",         bench_display_point,        bench_display_setup);
+    benchmark_register("ips200/draw_line_240",      bench_display_line,         bench_display_setup);
+    benchmark_register("ips200/draw_line_clipped",  bench_display_line_clipped, bench_display_setup);
+    benchmark_register("ips200/polyline_3x120",     bench_display_polyline,     bench_display_setup);
+    benchmark_register("ips200/draw_circle_r50",    bench_display_circle,       bench_display_setup);
+    benchmark_register("ips200/fill_circle_r50",    bench_display_fill_circle,  bench_display_setup);
+    benchmark_register("ips200/show_string_16",     bench_display_string,       bench_display_setup);
+    benchmark_register("ips200/show_int_6",         bench_display_int,          bench_display_setup);
+    benchmark_register("ips200/show_float_4_3",     bench_display_float,        bench_display_setup);
+    benchmark_register("ips200/field_float_4_3",    bench_display_field_float,  bench_display_setup);
+    benchmark_register("ips200/show_string_6x8_16", bench_display_string_6x8,   bench_display_setup);
+    benchmark_register("ips200/hud_direct",         bench_display_hud,          bench_display_setup);
+    benchmark_register("ips200/hud_back_buffer",    bench_display_hud,          bench_display_back_buffer_setup, bench_display_back_buffer_teardown);
+    benchmark_register("ips200/gray_image_160x120", bench_display_gray_image,   bench_display_setup);
+    benchmark_register("ips200/rgb_image_160x120",  bench_display_rgb_image,    bench_display_setup);
+    benchmark_register("ips200/bgr_image_160x120",  bench_display_bgr_image,    bench_display_setup);
+    benchmark_register("ips200/gray_nearest_240x180",   bench_display_gray_nearest, bench_display_setup);
+    benchmark_register("ips200/bgr_nearest_240x180",    bench_display_bgr_nearest,  bench_display_setup);
+    benchmark_register("ips200/bgr_bilinear_240x180",   bench_display_bgr_bilinear, bench_display_setup);
+    benchmark_register("display/service_submit",    bench_display_service_submit, bench_display_setup);
+    benchmark_register("display/service_render",    bench_display_service_render, bench_display_back_buffer_setup, bench_display_back_buffer_teardown);
+}
@@ -0,0 +1,313 @@
+/*---------------------------------------------------------------------
+ * @file     bench_imu.cpp
+ * @brief    IMU IIO缓冲模式读取测试项
+ * @details  在tmpfs下建立与IIO相同文件名的sysfs替身目录 字符设备用FIFO代替
+ *           准备时按替身声明的scan_elements布局写入样本 分段写入并逐项比对
+ *           覆盖 按scan_index排序 对齐 大小端 有符号/无符号 移位 不完整样本拼接 时间戳
+ *           以及启用失败后通道被关闭 比对失败时打印后退出
+ *           测试项统计 read_samples 一次取16个样本的耗时 不包含内核生成样本的时间
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+#include "zf_device_imu.hpp"
+
+#include <sys/stat.h>
+
+#define BENCH_IMU_BATCH             ( 16 )
+#define BENCH_IMU_SCAN_SIZE         ( 32 )                                      // 9个16位通道18字节 时间戳按8字节对齐到24 再补齐到32
+#define BENCH_IMU_TIMESTAMP_OFFSET  ( 24 )
+
+typedef struct
+{
+    const char  *name;                                                          // scan_elements 下的通道名
+    const char  *type;                                                          // _type 文件内容
+    int         index;                                                          // _index 文件内容
+}bench_imu_channel_struct;
+
+// 陀螺仪排在加速度前 磁力计为12位有符号左对齐 in_temp 应被驱动关闭
+static const bench_imu_channel_struct bench_imu_channel[] =
+{
+    {"in_anglvel_x", "be:s16/16>>0",  0},
+    {"in_anglvel_y", "be:s16/16>>0",  1},
+    {"in_anglvel_z", "be:s16/16>>0",  2},
+    {"in_accel_x",   "le:s16/16>>0",  3},
+    {"in_accel_y",   "le:s16/16>>0",  4},
+    {"in_accel_z",   "le:u16/16>>0",  5},
+    {"in_magn_x",    "le:s12/16>>4",  6},
+    {"in_magn_y",    "le:s12/16>>4",  7},
+    {"in_magn_z",    "le:s12/16>>4",  8},
+    {"in_temp",      "le:s16/16>>0",  9},
+    {"in_timestamp", "le:s64/64>>0", 10},
+};
+#define BENCH_IMU_CHANNEL_NUM       ( sizeof(bench_imu_channel) / sizeof(bench_imu_channel[0]) )
+
+static char                 bench_imu_dir[64];
+static char                 bench_imu_fifo[96];
+static int                  bench_imu_writer = -1;                              // FIFO写端 O_RDWR 打开 不依赖读端先打开
+static zf_device_imu        *bench_imu = NULL;
+static imu_sample_struct    bench_imu_result[BENCH_IMU_BATCH];
+static uint8                bench_imu_batch[BENCH_IMU_BATCH * BENCH_IMU_SCAN_SIZE];
+
+static void bench_imu_path(char *path, uint32 size, const char *name)
+{
+    snprintf(path, size, "%s/%s", bench_imu_dir, name);
+}
+
+static void bench_imu_write_file(const char *name, const char *text)
+{
+    char path[160];
+    FILE *fp = NULL;
+
+    bench_imu_path(path, sizeof(path), name);
+    fp = fopen(path, "w");
+    if(NULL == fp)
+    {
+        fprintf(stderr, "imu: create %s failed\r\n", path);
+        exit(EXIT_FAILURE);
+    }
+    fputs(text, fp);
+    fclose(fp);
+}
+
+static char bench_imu_read_flag(const char *name)
+{
+    char path[160];
+    char value = 0;
+    FILE *fp = NULL;
+
+    bench_imu_path(path, sizeof(path), name);
+    fp = fopen(path, "r");
+    if(NULL != fp)
+    {
+        value = (char)fgetc(fp);
+        fclose(fp);
+    }
+    return value;
+}
+
+// 按替身声明的布局生成一个样本 acc/gyro/mag 取值覆盖正负边界
+static void bench_imu_encode(uint32 n, uint8 *scan, imu_sample_struct *expect)
+{
+    memset(scan, 0, BENCH_IMU_SCAN_SIZE);
+    memset(expect, 0, sizeof(imu_sample_struct));
+    for(int axis = 0; axis < 3; axis ++)
+    {
+        uint16 gyro = (uint16)(n * 977 + axis * 30001);
+        uint16 acc  = (uint16)(n * 1231 + axis * 12345);
+        int16  mag  = (int16)((int32)((n * 37 + axis * 1500) % 4096) - 2048);    // 12位有符号 -2048~2047
+        uint16 mag_raw = (uint16)(((uint16)mag << 4) | 0x000F);                  // 低4位为填充 应被移出
+
+        scan[axis * 2]          = (uint8)(gyro >> 8);                           // 大端
+        scan[axis * 2 + 1]      = (uint8)gyro;
+        scan[6 + axis * 2]      = (uint8)acc;                                   // 小端
+        scan[6 + axis * 2 + 1]  = (uint8)(acc >> 8);
+        scan[12 + axis * 2]     = (uint8)mag_raw;
+        scan[12 + axis * 2 + 1] = (uint8)(mag_raw >> 8);
+
+        expect->gyro[axis] = (int16)gyro;
+        expect->acc[axis]  = (int16)acc;                                        // Z轴声明为无符号 截断为int16后与有符号相同
+        expect->mag[axis]  = mag;
+    }
+    expect->timestamp_ns = (int64_t)1700000000000000000LL + (int64_t)n * 2500000;
+    for(int b = 0; b < 8; b ++)
+    {
+        scan[BENCH_IMU_TIMESTAMP_OFFSET + b] = (uint8)((uint64_t)expect->timestamp_ns >> (8 * b));
+    }
+}
+
+static void bench_imu_write_fifo(const uint8 *data, uint32 length)
+{
+    if((ssize_t)length != write(bench_imu_writer, data, length))
+    {
+        fprintf(stderr, "imu: fifo write failed, errno %d\r\n", errno);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void bench_imu_expect_samples(const imu_sample_struct *expect, uint32 count, const char *step)
+{
+    imu_sample_struct sample[IMU_BATCH_MAX];
+    int num = bench_imu->read_samples(sample, IMU_BATCH_MAX, 100);
+
+    if(num != (int)count)
+    {
+        fprintf(stderr, "imu: %s read %d samples, expect %u\r\n", step, num, count);
+        exit(EXIT_FAILURE);
+    }
+    for(uint32 i = 0; i < count; i ++)
+    {
+        if(0 != memcmp(&sample[i], &expect[i], sizeof(imu_sample_struct)))
+        {
+            fprintf(stderr, "imu: %s sample %u mismatch: acc %d %d %d gyro %d %d %d mag %d %d %d ts %lld, "
+                            "expect acc %d %d %d gyro %d %d %d mag %d %d %d ts %lld\r\n", step, i,
+                    sample[i].acc[0], sample[i].acc[1], sample[i].acc[2],
+                    sample[i].gyro[0], sample[i].gyro[1], sample[i].gyro[2],
+                    sample[i].mag[0], sample[i].mag[1], sample[i].mag[2], (long long)sample[i].timestamp_ns,
+                    expect[i].acc[0], expect[i].acc[1], expect[i].acc[2],
+                    expect[i].gyro[0], expect[i].gyro[1], expect[i].gyro[2],
+                    expect[i].mag[0], expect[i].mag[1], expect[i].mag[2], (long long)expect[i].timestamp_ns);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// 分段写入 检查不完整样本留到下一次读取拼接
+static void bench_imu_check(void)
+{
+    uint8 scan[8 * BENCH_IMU_SCAN_SIZE];
+    imu_sample_struct expect[8];
+    const uint32 half = BENCH_IMU_SCAN_SIZE / 2 + 3;                            // 切在时间戳中间
+
+    for(uint32 i = 0; i < 8; i ++)
+    {
+        bench_imu_encode(i, scan + i * BENCH_IMU_SCAN_SIZE, &expect[i]);
+    }
+
+    // 2个半样本 -> 2个 余下半个
+    bench_imu_write_fifo(scan, 2 * BENCH_IMU_SCAN_SIZE + half);
+    bench_imu_expect_samples(&expect[0], 2, "partial write");
+
+    // 只补几个字节 仍不足一个样本
+    bench_imu_write_fifo(scan + 2 * BENCH_IMU_SCAN_SIZE + half, 5);
+    bench_imu_expect_samples(NULL, 0, "short write");
+
+    // 补齐剩余部分并再写5个样本 -> 6个
+    bench_imu_write_fifo(scan + 2 * BENCH_IMU_SCAN_SIZE + half + 5, 6 * BENCH_IMU_SCAN_SIZE - half - 5);
+    bench_imu_expect_samples(&expect[2], 6, "carry over");
+
+    if(bench_imu->get_acc_x() != expect[7].acc[0] || bench_imu->get_gyro_z() != expect[7].gyro[2])
+    {
+        fprintf(stderr, "imu: get_acc_x/get_gyro_z do not return the last buffered sample\r\n");
+        exit(EXIT_FAILURE);
+    }
+    if('0' != bench_imu_read_flag("scan_elements/in_temp_en"))
+    {
+        fprintf(stderr, "imu: in_temp channel left enabled\r\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// 字符设备打开失败时 缓冲区与全部通道应被关闭
+static void bench_imu_check_failure(void)
+{
+    char path[160];
+    zf_device_imu imu;
+
+    bench_imu_path(path, sizeof(path), "missing_dev");
+    if(0 == imu.init_buffer(NULL, 64, bench_imu_dir, path))
+    {
+        fprintf(stderr, "imu: init_buffer succeeded without a data device\r\n");
+        exit(EXIT_FAILURE);
+    }
+    if('0' != bench_imu_read_flag("buffer/enable"))
+    {
+        fprintf(stderr, "imu: buffer left enabled after failed init_buffer\r\n");
+        exit(EXIT_FAILURE);
+    }
+    for(uint32 i = 0; i < BENCH_IMU_CHANNEL_NUM; i ++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "scan_elements/%s_en", bench_imu_channel[i].name);
+        if('0' != bench_imu_read_flag(name))
+        {
+            fprintf(stderr, "imu: %s left enabled after failed init_buffer\r\n", bench_imu_channel[i].name);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// 进程退出时删除替身目录
+static void bench_imu_cleanup(void)
+{
+    char path[160];
+
+    delete bench_imu;
+    bench_imu = NULL;
+    if(0 <= bench_imu_writer) close(bench_imu_writer);
+    unlink(bench_imu_fifo);
+    for(uint32 i = 0; i < BENCH_IMU_CHANNEL_NUM; i ++)
+    {
+        const char *suffix[3] = {"_en", "_index", "_type"};
+        for(int s = 0; s < 3; s ++)
+        {
+            snprintf(path, sizeof(path), "%s/scan_elements/%s%s", bench_imu_dir, bench_imu_channel[i].name, suffix[s]);
+            unlink(path);
+        }
+    }
+    bench_imu_path(path, sizeof(path), "buffer/enable");            unlink(path);
+    bench_imu_path(path, sizeof(path), "buffer/length");            unlink(path);
+    bench_imu_path(path, sizeof(path), "current_timestamp_clock");  unlink(path);
+    bench_imu_path(path, sizeof(path), "scan_elements");            rmdir(path);
+    bench_imu_path(path, sizeof(path), "buffer");                   rmdir(path);
+    rmdir(bench_imu_dir);
+}
+
+static void bench_imu_setup(void)
+{
+    char path[160];
+    char name[64];
+    char value[16];
+    imu_sample_struct expect;
+
+    if(NULL != bench_imu)
+    {
+        return;
+    }
+
+    snprintf(bench_imu_dir, sizeof(bench_imu_dir), "%s/zf_bench_imu_%d",
+             (0 == access("/dev/shm", W_OK)) ? "/dev/shm" : "/tmp", (int)getpid());
+    mkdir(bench_imu_dir, 0755);
+    bench_imu_path(path, sizeof(path), "scan_elements");    mkdir(path, 0755);
+    bench_imu_path(path, sizeof(path), "buffer");           mkdir(path, 0755);
+    atexit(bench_imu_cleanup);
+
+    for(uint32 i = 0; i < BENCH_IMU_CHANNEL_NUM; i ++)
+    {
+        snprintf(name, sizeof(name), "scan_elements/%s_en", bench_imu_channel[i].name);
+        bench_imu_write_file(name, "1");
+        snprintf(name, sizeof(name), "scan_elements/%s_index", bench_imu_channel[i].name);
+        snprintf(value, sizeof(value), "%d\n", bench_imu_channel[i].index);
+        bench_imu_write_file(name, value);
+        snprintf(name, sizeof(name), "scan_elements/%s_type", bench_imu_channel[i].name);
+        snprintf(value, sizeof(value), "%s\n", bench_imu_channel[i].type);
+        bench_imu_write_file(name, value);
+    }
+    bench_imu_write_file("buffer/enable", "0");
+    bench_imu_write_file("buffer/length", "");
+    bench_imu_write_file("current_timestamp_clock", "realtime");
+
+    bench_imu_check_failure();
+
+    bench_imu_path(bench_imu_fifo, sizeof(bench_imu_fifo), "iio_device");
+    if(0 != mkfifo(bench_imu_fifo, 0600) || 0 > (bench_imu_writer = open(bench_imu_fifo, O_RDWR)))
+    {
+        fprintf(stderr, "imu: create fifo %s failed, errno %d\r\n", bench_imu_fifo, errno);
+        exit(EXIT_FAILURE);
+    }
+    bench_imu = new zf_device_imu;
+    if(0 != bench_imu->init_buffer(NULL, 64, bench_imu_dir, bench_imu_fifo))
+    {
+        fprintf(stderr, "imu: init_buffer on stand-in failed\r\n");
+        exit(EXIT_FAILURE);
+    }
+    bench_imu_check();
+
+    for(uint32 i = 0; i < BENCH_IMU_BATCH; i ++)
+    {
+        bench_imu_encode(i, bench_imu_batch + i * BENCH_IMU_SCAN_SIZE, &expect);
+    }
+}
+
+static void bench_imu_read_samples(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_imu_write_fifo(bench_imu_batch, sizeof(bench_imu_batch));
+        bench_imu->read_samples(bench_imu_result, BENCH_IMU_BATCH, 0);
+    }
+    benchmark_keep(bench_imu_result);
+}
+
+void bench_imu_register(void)
+{
+    benchmark_register("imu/read_samples_16", bench_imu_read_samples, bench_imu_setup);
+}
@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------
+ * @file     bench_jpeg.cpp
+ * @brief    JPEG 编解码性能测试项
+ * @details  解码对应 UVC 摄像头 MJPEG 取帧 (zf_device_uvc)
+ *           编码对应图传服务质量60的压缩 (ww_camera_server)
+ *           需要 OpenCV 主机上找不到 OpenCV 时本文件不注册任何测试项
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+
+#if defined(BENCHMARK_WITH_OPENCV)
+#include <opencv2/opencv.hpp>
+
+#define BENCH_JPEG_QUALITY          ( 60 )
+
+typedef struct
+{
+    int width;
+    int height;
+}bench_jpeg_size_struct;
+
+static const bench_jpeg_size_struct bench_jpeg_size[] = {{160, 120}, {320, 240}, {640, 480}};
+#define BENCH_JPEG_SIZE_COUNT       ( sizeof(bench_jpeg_size) / sizeof(bench_jpeg_size[0]) )
+
+static cv::Mat                      bench_jpeg_frame[BENCH_JPEG_SIZE_COUNT];
+static std::vector<unsigned char>   bench_jpeg_data[BENCH_JPEG_SIZE_COUNT];
+static std::vector<int>             bench_jpeg_param = {cv::IMWRITE_JPEG_QUALITY, BENCH_JPEG_QUALITY};
+
+// 带渐变和噪声的测试图 压缩率接近真实赛道画面 纯色图会让编码耗时偏低
+static void bench_jpeg_setup(void)
+{
+    cv::RNG rng(2026);
+    for(uint32 i = 0; i < BENCH_JPEG_SIZE_COUNT; i ++)
+    {
+        cv::Mat noise(bench_jpeg_size[i].height, bench_jpeg_size[i].width, CV_8UC3);
+        bench_jpeg_frame[i].create(bench_jpeg_size[i].height, bench_jpeg_size[i].width, CV_8UC3);
+        for(int y = 0; y < bench_jpeg_frame[i].rows; y ++)
+        {
+            for(int x = 0; x < bench_jpeg_frame[i].cols; x ++)
+            {
+                bench_jpeg_frame[i].at<cv::Vec3b>(y, x) = cv::Vec3b((uchar)(x * 255 / bench_jpeg_frame[i].cols), (uchar)(y * 255 / bench_jpeg_frame[i].rows), 128);
+            }
+        }
+        rng.fill(noise, cv::RNG::NORMAL, 0, 12);
+        bench_jpeg_frame[i] += noise;
+        cv::imencode(".jpg", bench_jpeg_frame[i], bench_jpeg_data[i], bench_jpeg_param);
+    }
+}
+
+template <uint32 index>
+static void bench_jpeg_encode(uint32 ops)
+{
+    std::vector<unsigned char> buffer;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        cv::imencode(".jpg", bench_jpeg_frame[index], buffer, bench_jpeg_param);
+        benchmark_keep(buffer.data());
+    }
+}
+
+template <uint32 index>
+static void bench_jpeg_decode(uint32 ops)
+{
+    cv::Mat frame;
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        frame = cv::imdecode(bench_jpeg_data[index], cv::IMREAD_COLOR);
+        benchmark_keep(frame.data);
+    }
+}
+
+void bench_jpeg_register(void)
+{
+    cv::setNumThreads(1);                       // 与采集线程中单帧处理一致 避免OpenCV内部线程池影响结果
+    benchmark_register("jpeg/encode_160x120",   bench_jpeg_encode<0>,   bench_jpeg_setup);
+    benchmark_register("jpeg/decode_160x120",   bench_jpeg_decode<0>,   bench_jpeg_setup);
+    benchmark_register("jpeg/encode_320x240",   bench_jpeg_encode<1>,   bench_jpeg_setup);
+    benchmark_register("jpeg/decode_320x240",   bench_jpeg_decode<1>,   bench_jpeg_setup);
+    benchmark_register("jpeg/encode_640x480",   bench_jpeg_encode<2>,   bench_jpeg_setup);
+    benchmark_register("jpeg/decode_640x480",   bench_jpeg_decode<2>,   bench_jpeg_setup);
+}
+
+#else
+
+void bench_jpeg_register(void)
+{
+}
+
+#endif
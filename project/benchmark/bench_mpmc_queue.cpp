@@ -0,0 +1,143 @@
+/*---------------------------------------------------------------------
+ * @file     bench_mpmc_queue.cpp
+ * @brief    MpmcQueue 与 std::mutex + std::deque 竞争性能对比
+ * @details  每个样本创建 生产者/消费者 线程 共传递 ops 个元素 结果为每个元素的平均耗时
+ *           队列满/空时两种实现都只做 yield 重试 对比的是纯粹的同步开销
+ *           样本内包含线程创建开销 只适合两种实现之间横向对比
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+#include "zf_common_mpmc_queue.hpp"
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#define BENCH_QUEUE_SIZE            ( 1024 )
+
+// 加锁队列基线 容量与 MpmcQueue 相同 满时拒绝写入
+class MutexQueue
+{
+public:
+    bool try_push (const uint32 &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(BENCH_QUEUE_SIZE <= queue.size())
+        {
+            return false;
+        }
+        queue.push_back(value);
+        return true;
+    }
+
+    bool try_pop (uint32 &value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(queue.empty())
+        {
+            return false;
+        }
+        value = queue.front();
+        queue.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex          mutex;
+    std::deque<uint32>  queue;
+};
+
+static MpmcQueue<uint32, BENCH_QUEUE_SIZE>  bench_mpmc_queue;
+static MutexQueue                           bench_mutex_queue;
+
+/*---------------------------------------------------------------------
+ * @brief    运行一个竞争样本
+ * @param    queue      被测队列
+ * @param    ops        传递的元素总数 平均分给各生产者
+ * @details  校验每个元素恰好被取出一次 失败时直接退出 避免输出错误的测试结果
+ *---------------------------------------------------------------------*/
+template <typename Queue, int producers, int consumers>
+static void bench_queue_run (Queue &queue, uint32 ops)
+{
+    const uint64_t per_producer = (ops + producers - 1) / producers;
+    const uint64_t total        = per_producer * producers;
+    std::atomic<uint64_t>       popped(0);
+    std::atomic<uint64_t>       checksum(0);
+    std::atomic<bool>           start(false);
+    std::vector<std::thread>    threads;
+
+    for(int p = 0; p < producers; p ++)
+    {
+        threads.emplace_back([&, p]()
+        {
+            while(!start.load(std::memory_order_acquire)) {}
+            for(uint64_t i = 0; i < per_producer; i ++)
+            {
+                const uint32 value = (uint32)(p * per_producer + i);
+                while(!queue.try_push(value))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(int c = 0; c < consumers; c ++)
+    {
+        threads.emplace_back([&]()
+        {
+            uint32 value;
+            uint64_t sum = 0;
+            while(!start.load(std::memory_order_acquire)) {}
+            while(popped.load(std::memory_order_relaxed) < total)
+            {
+                if(queue.try_pop(value))
+                {
+                    sum += value;
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    for(auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    if(checksum.load() != total * (total - 1) / 2)
+    {
+        fprintf(stderr, "mpmc_queue: checksum mismatch (%d producers, %d consumers)\r\n", producers, consumers);
+        exit(EXIT_FAILURE);
+    }
+}
+
+template <int producers, int consumers>
+static void bench_mpmc(uint32 ops)
+{
+    bench_queue_run<MpmcQueue<uint32, BENCH_QUEUE_SIZE>, producers, consumers>(bench_mpmc_queue, ops);
+}
+
+template <int producers, int consumers>
+static void bench_mutex(uint32 ops)
+{
+    bench_queue_run<MutexQueue, producers, consumers>(bench_mutex_queue, ops);
+}
+
+void bench_mpmc_queue_register(void)
+{
+    benchmark_register("mpmc_queue/1p1c",       bench_mpmc<1, 1>);
+    benchmark_register("mutex_deque/1p1c",      bench_mutex<1, 1>);
+    benchmark_register("mpmc_queue/2p2c",       bench_mpmc<2, 2>);
+    benchmark_register("mutex_deque/2p2c",      bench_mutex<2, 2>);
+    benchmark_register("mpmc_queue/4p1c",       bench_mpmc<4, 1>);
+    benchmark_register("mutex_deque/4p1c",      bench_mutex<4, 1>);
+    benchmark_register("mpmc_queue/1p4c",       bench_mpmc<1, 4>);
+    benchmark_register("mutex_deque/1p4c",      bench_mutex<1, 4>);
+    benchmark_register("mpmc_queue/4p4c",       bench_mpmc<4, 4>);
+    benchmark_register("mutex_deque/4p4c",      bench_mutex<4, 4>);
+}
@@ -0,0 +1,236 @@
+/*---------------------------------------------------------------------
+ * @file     bench_sysfs.cpp
+ * @brief    sysfs数值属性读取性能测试项
+ * @details  在tmpfs(/dev/shm 不存在时用/tmp)下建立与IIO相同文件名的替身目录
+ *           legacy 为改动前驱动的写法 lseek + read + atoi/atof (ADC另有每次读取后的memset)
+ *           attr   为 zf_driver_sysfs_attr 一次pread + 栈上解析
+ *           替身是普通文件 不包含驱动端生成数值的耗时 结果只反映用户态与系统调用开销
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+#include "zf_driver_sysfs_attr.hpp"
+#include "zf_driver_adc.hpp"
+
+#include <sys/stat.h>
+
+#define BENCH_SYSFS_AXIS            ( 6 )
+
+static const char *bench_sysfs_axis_name[BENCH_SYSFS_AXIS] =
+{
+    "in_accel_x_raw", "in_accel_y_raw", "in_accel_z_raw",
+    "in_anglvel_x_raw", "in_anglvel_y_raw", "in_anglvel_z_raw",
+};
+static const char *bench_sysfs_axis_value[BENCH_SYSFS_AXIS] =
+{
+    "-123\n", "4567\n", "-16384\n", "12\n", "-3\n", "32767\n",
+};
+
+static char                     bench_sysfs_dir[64];
+static char                     bench_sysfs_axis_path[BENCH_SYSFS_AXIS][128];
+static char                     bench_sysfs_scale_path[128];
+static int                      bench_legacy_fd[BENCH_SYSFS_AXIS] = {-1, -1, -1, -1, -1, -1};
+static int                      bench_legacy_scale_fd = -1;
+static char                     bench_legacy_buf[64];
+static zf_driver_sysfs_attr     bench_attr[BENCH_SYSFS_AXIS];
+static zf_driver_sysfs_attr     bench_attr_scale;
+static zf_driver_adc           *bench_adc = NULL;
+static int32                    bench_result[BENCH_SYSFS_AXIS];
+static float                    bench_scale_result;
+
+static void bench_sysfs_write_file(const char *path, const char *text)
+{
+    FILE *fp = fopen(path, "w");
+    if(NULL == fp)
+    {
+        fprintf(stderr, "sysfs: create %s failed\r\n", path);
+        exit(EXIT_FAILURE);
+    }
+    fputs(text, fp);
+    fclose(fp);
+}
+
+// 进程退出时删除替身目录
+static void bench_sysfs_cleanup(void)
+{
+    for(int i = 0; i < BENCH_SYSFS_AXIS; i ++)
+    {
+        unlink(bench_sysfs_axis_path[i]);
+    }
+    unlink(bench_sysfs_scale_path);
+    rmdir(bench_sysfs_dir);
+}
+
+static void bench_sysfs_setup(void)
+{
+    if(0 != bench_sysfs_dir[0])
+    {
+        return;
+    }
+
+    snprintf(bench_sysfs_dir, sizeof(bench_sysfs_dir), "%s/zf_bench_sysfs_%d",
+             (0 == access("/dev/shm", W_OK)) ? "/dev/shm" : "/tmp", (int)getpid());
+    mkdir(bench_sysfs_dir, 0755);
+    for(int i = 0; i < BENCH_SYSFS_AXIS; i ++)
+    {
+        snprintf(bench_sysfs_axis_path[i], sizeof(bench_sysfs_axis_path[i]), "%s/%s", bench_sysfs_dir, bench_sysfs_axis_name[i]);
+        bench_sysfs_write_file(bench_sysfs_axis_path[i], bench_sysfs_axis_value[i]);
+        bench_legacy_fd[i] = open(bench_sysfs_axis_path[i], O_RDONLY);
+        bench_attr[i].open_path(bench_sysfs_axis_path[i]);
+    }
+    snprintf(bench_sysfs_scale_path, sizeof(bench_sysfs_scale_path), "%s/in_voltage_scale", bench_sysfs_dir);
+    bench_sysfs_write_file(bench_sysfs_scale_path, "0.805664062\n");
+    bench_legacy_scale_fd = open(bench_sysfs_scale_path, O_RDONLY);
+    bench_attr_scale.open_path(bench_sysfs_scale_path);
+    bench_adc = new zf_driver_adc(bench_sysfs_axis_path[0]);
+    atexit(bench_sysfs_cleanup);
+}
+
+// 改动前 zf_device_imu::imu_read_fd_data 的写法
+static int16 bench_legacy_read_int(int fd)
+{
+    char str[20] = {0};
+    lseek(fd, 0, SEEK_SET);
+    if(read(fd, str, sizeof(str) - 1) <= 0) return 0;
+    return atoi(str);
+}
+
+// 改动前 zf_driver_adc::convert 的写法
+static uint16 bench_legacy_adc_convert(int fd)
+{
+    uint16 adc_reg = 0;
+    lseek(fd, 0, SEEK_SET);
+    ssize_t read_len = read(fd, bench_legacy_buf, sizeof(bench_legacy_buf) - 1);
+    if(read_len > 0)
+    {
+        bench_legacy_buf[read_len] = '\0';
+        adc_reg = (uint16)atoi(bench_legacy_buf);
+    }
+    memset(bench_legacy_buf, 0x00, sizeof(bench_legacy_buf));
+    return adc_reg;
+}
+
+// 改动前 zf_driver_adc::get_scale 的写法
+static float bench_legacy_adc_scale(int fd)
+{
+    float scale = 0.0f;
+    lseek(fd, 0, SEEK_SET);
+    ssize_t read_len = read(fd, bench_legacy_buf, sizeof(bench_legacy_buf) - 1);
+    if(read_len > 0)
+    {
+        bench_legacy_buf[read_len] = '\0';
+        scale = atof(bench_legacy_buf);
+    }
+    memset(bench_legacy_buf, 0x00, sizeof(bench_legacy_buf));
+    return scale;
+}
+
+static void bench_sysfs_legacy_int(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_result[0] = bench_legacy_read_int(bench_legacy_fd[0]);
+    }
+    benchmark_keep(bench_result);
+}
+
+static void bench_sysfs_attr_int(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_attr[0].read_int(&bench_result[0]);
+    }
+    benchmark_keep(bench_result);
+}
+
+static void bench_sysfs_legacy_adc(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_result[0] = bench_legacy_adc_convert(bench_legacy_fd[0]);
+    }
+    benchmark_keep(bench_result);
+}
+
+static void bench_sysfs_adc_convert(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_result[0] = bench_adc->convert();
+    }
+    benchmark_keep(bench_result);
+}
+
+static void bench_sysfs_legacy_scale(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_scale_result = bench_legacy_adc_scale(bench_legacy_scale_fd);
+    }
+    benchmark_keep(&bench_scale_result);
+}
+
+static void bench_sysfs_attr_scale(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_attr_scale.read_float(&bench_scale_result);
+    }
+    benchmark_keep(&bench_scale_result);
+}
+
+static void bench_sysfs_legacy_6axis(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        for(int axis = 0; axis < BENCH_SYSFS_AXIS; axis ++)
+        {
+            bench_result[axis] = bench_legacy_read_int(bench_legacy_fd[axis]);
+        }
+    }
+    benchmark_keep(bench_result);
+}
+
+static void bench_sysfs_attr_6axis(uint32 ops)
+{
+    static zf_driver_sysfs_attr *const axis[BENCH_SYSFS_AXIS] =
+    {
+        &bench_attr[0], &bench_attr[1], &bench_attr[2], &bench_attr[3], &bench_attr[4], &bench_attr[5],
+    };
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        zf_driver_sysfs_attr::read_int_batch(axis, bench_result, BENCH_SYSFS_AXIS);
+    }
+    benchmark_keep(bench_result);
+}
+
+// 只比较解析 不含系统调用
+static void bench_sysfs_parse_atoi(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        bench_result[0] = atoi(bench_sysfs_axis_value[i % BENCH_SYSFS_AXIS]);
+        benchmark_keep(bench_result);
+    }
+}
+
+static void bench_sysfs_parse_attr(uint32 ops)
+{
+    for(uint32 i = 0; i < ops; i ++)
+    {
+        zf_driver_sysfs_attr::parse_int(bench_sysfs_axis_value[i % BENCH_SYSFS_AXIS], &bench_result[0]);
+        benchmark_keep(bench_result);
+    }
+}
+
+void bench_sysfs_register(void)
+{
+    benchmark_register("sysfs/legacy_read_int",     bench_sysfs_legacy_int,     bench_sysfs_setup);
+    benchmark_register("sysfs/attr_read_int",       bench_sysfs_attr_int,       bench_sysfs_setup);
+    benchmark_register("sysfs/legacy_adc_convert",  bench_sysfs_legacy_adc,     bench_sysfs_setup);
+    benchmark_register("sysfs/adc_convert",         bench_sysfs_adc_convert,    bench_sysfs_setup);
+    benchmark_register("sysfs/legacy_adc_scale",    bench_sysfs_legacy_scale,   bench_sysfs_setup);
+    benchmark_register("sysfs/attr_read_float",     bench_sysfs_attr_scale,     bench_sysfs_setup);
+    benchmark_register("sysfs/legacy_6axis",        bench_sysfs_legacy_6axis,   bench_sysfs_setup);
+    benchmark_register("sysfs/attr_batch_6axis",    bench_sysfs_attr_6axis,     bench_sysfs_setup);
+    benchmark_register("sysfs/parse_atoi",          bench_sysfs_parse_atoi);
+    benchmark_register("sysfs/parse_attr",          bench_sysfs_parse_attr);
+}
@@ -0,0 +1,246 @@
+/*---------------------------------------------------------------------
+ * @file     bringup_check.cpp
+ * @brief    设备并行启动 zf_components_bringup 的调度检查程序
+ * @details  用法  zf_bringup_check [--timeline]
+ *           以 sleep 代替设备初始化 逐项检查
+ *             失败传递   失败任务的直接与间接依赖者被跳过 无关任务照常完成 返回值为未成功的任务数
+ *             超时       超时任务记为 TIMEOUT 依赖者被跳过 run 不等待超时线程返回 其结果被忽略
+ *             循环依赖   互相依赖的任务记为 FAILED 无关任务照常完成 run 不会卡住
+ *             依赖顺序   依赖者在被依赖任务结束后才开始
+ *             并行上限   同时执行的任务数不超过 max_parallel 超时但未返回的线程同样计入
+ *           全部通过时输出 PASS 返回0 否则输出不通过的项目并返回1
+ *           --timeline 每项检查后打印启动时间线
+ *---------------------------------------------------------------------*/
+#include "zf_components_bringup.hpp"
+
+#include <thread>
+
+#define CHECK_SLEEP_MS              ( 30 )      // 普通任务的耗时
+#define CHECK_HANG_MS               ( 300 )     // 超时任务的实际耗时
+#define CHECK_TIMEOUT_MS            ( 60 )      // 超时任务的超时时间
+
+static uint8                option_timeline = 0;
+static uint32               check_fail      = 0;
+
+// 超时的任务线程会在 run 返回后继续运行 计数器使用静态对象
+static std::atomic<uint32>  check_active(0);                                    // 正在执行的任务函数数量
+static std::atomic<uint32>  check_active_max(0);                                // 同时执行的最大数量
+static std::atomic<uint32>  check_hang_return(0);                               // 已返回的超时任务数量
+
+// 模拟一次设备初始化 记录同时执行的任务数
+static int check_task(uint32 sleep_ms, int result)
+{
+    uint32 active = ++ check_active;
+    uint32 max = check_active_max.load();
+    while(active > max && !check_active_max.compare_exchange_weak(max, active))
+    {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms));
+    check_active --;
+    return result;
+}
+
+static int check_hang_task(void)
+{
+    int result = check_task(CHECK_HANG_MS, 0);
+    check_hang_return ++;
+    return result;
+}
+
+static void check_expect(const char *name, bool condition, const char *message)
+{
+    if(!condition)
+    {
+        printf("FAIL  %s: %s\r\n", name, message);
+        check_fail ++;
+    }
+}
+
+static void check_begin(void)
+{
+    check_active = 0;
+    check_active_max = 0;
+}
+
+static void check_end(const char *name, zf_components_bringup *bringup, uint32 fail_start)
+{
+    if(option_timeline)
+    {
+        bringup->print_timeline();
+    }
+    if(fail_start == check_fail)
+    {
+        printf("pass  %s\r\n", name);
+    }
+}
+
+// 等待超时任务的线程返回 避免影响下一项检查的并行计数
+static void check_wait_hang(uint32 count)
+{
+    while(check_hang_return.load() < count)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+// a 失败 -> b 跳过 -> c 跳过  d 与之无关
+static void check_failure_propagation(void)
+{
+    static const char *name = "failure propagation";
+    uint32 fail_start = check_fail;
+    zf_components_bringup bringup;
+
+    check_begin();
+    int a = bringup.add_task("a", [](){ return check_task(CHECK_SLEEP_MS, -5); });
+    int b = bringup.add_task("b", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    int c = bringup.add_task("c", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    int d = bringup.add_task("d", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    bringup.add_dependency(b, a);
+    bringup.add_dependency(c, b);
+
+    int result = bringup.run();
+    check_expect(name, 3 == result, "run should report 3 unsuccessful tasks");
+    check_expect(name, BRINGUP_STATE_FAILED == bringup.get_state(a) && -5 == bringup.get_record(a)->result, "a should fail with its own result");
+    check_expect(name, BRINGUP_STATE_SKIPPED == bringup.get_state(b), "b should be skipped");
+    check_expect(name, BRINGUP_STATE_SKIPPED == bringup.get_state(c), "c should be skipped through b");
+    check_expect(name, BRINGUP_STATE_DONE == bringup.get_state(d), "d should not be affected");
+    check_expect(name, 2 == check_active_max.load(), "a and d should run in parallel");
+    check_end(name, &bringup, fail_start);
+}
+
+// hang 超时 -> after 跳过  other 与之无关
+static void check_timeout(void)
+{
+    static const char *name = "timeout";
+    uint32 fail_start = check_fail;
+    zf_components_bringup bringup;
+
+    check_begin();
+    int hang  = bringup.add_task("hang",  [](){ return check_hang_task(); }, CHECK_TIMEOUT_MS);
+    int after = bringup.add_task("after", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    int other = bringup.add_task("other", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    bringup.add_dependency(after, hang);
+
+    int result = bringup.run();
+    const bringup_record_struct *record = bringup.get_record(hang);
+    check_expect(name, 2 == result, "run should report 2 unsuccessful tasks");
+    check_expect(name, BRINGUP_STATE_TIMEOUT == record->state, "hang should time out");
+    check_expect(name, record->end_ns >= (uint64_t)CHECK_TIMEOUT_MS * 1000000 && record->end_ns < (uint64_t)CHECK_HANG_MS * 1000000,
+                 "timeout should be decided after timeout_ms and before the task returns");
+    check_expect(name, BRINGUP_STATE_SKIPPED == bringup.get_state(after), "after should be skipped");
+    check_expect(name, BRINGUP_STATE_DONE == bringup.get_state(other), "other should not be affected");
+    check_expect(name, 0 == check_hang_return.load(), "run should return before the hung thread");
+    check_wait_hang(1);
+    check_expect(name, BRINGUP_STATE_TIMEOUT == bringup.get_state(hang), "late return should not change the record");
+    check_end(name, &bringup, fail_start);
+}
+
+// x <-> y 循环 z 与之无关
+static void check_cycle(void)
+{
+    static const char *name = "circular dependency";
+    uint32 fail_start = check_fail;
+    zf_components_bringup bringup;
+
+    check_begin();
+    int x = bringup.add_task("x", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    int y = bringup.add_task("y", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    int z = bringup.add_task("z", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    bringup.add_dependency(x, y);
+    bringup.add_dependency(y, x);
+
+    int result = bringup.run();
+    check_expect(name, 2 == result, "run should report 2 unsuccessful tasks");
+    check_expect(name, BRINGUP_STATE_FAILED == bringup.get_state(x) && BRINGUP_STATE_FAILED == bringup.get_state(y), "x and y should fail");
+    check_expect(name, BRINGUP_STATE_DONE == bringup.get_state(z), "z should not be affected");
+    check_end(name, &bringup, fail_start);
+}
+
+// camera -> server  display 与之并行
+static void check_order(void)
+{
+    static const char *name = "dependency order";
+    uint32 fail_start = check_fail;
+    zf_components_bringup bringup;
+
+    check_begin();
+    int camera  = bringup.add_task("camera",  [](){ return check_task(CHECK_SLEEP_MS * 2, 0); });
+    int server  = bringup.add_task("server",  [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    int display = bringup.add_task("display", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    bringup.add_dependency(server, camera);
+
+    int result = bringup.run();
+    check_expect(name, 0 == result, "all tasks should succeed");
+    check_expect(name, bringup.get_record(server)->start_ns >= bringup.get_record(camera)->end_ns, "server should start after camera ends");
+    check_expect(name, bringup.get_record(display)->start_ns < bringup.get_record(camera)->end_ns, "display should run alongside camera");
+    check_expect(name, bringup.get_total_ns() < (uint64_t)CHECK_SLEEP_MS * 4 * 1000000, "total should follow the longest chain");
+    check_end(name, &bringup, fail_start);
+}
+
+// 6 个独立任务 max_parallel 为 2
+static void check_parallel(void)
+{
+    static const char *name = "max_parallel";
+    uint32 fail_start = check_fail;
+    zf_components_bringup bringup;
+
+    check_begin();
+    for(uint8 i = 0; i < 6; i ++)
+    {
+        char task_name[8];
+        snprintf(task_name, sizeof(task_name), "t%u", (unsigned)i);
+        bringup.add_task(task_name, [](){ return check_task(CHECK_SLEEP_MS, 0); });
+    }
+
+    int result = bringup.run(2);
+    check_expect(name, 0 == result, "all tasks should succeed");
+    check_expect(name, 2 == check_active_max.load(), "at most 2 tasks should run at once");
+    check_end(name, &bringup, fail_start);
+}
+
+// max_parallel 为 1 时 超时的 hang 线程返回前 next 不能开始
+static void check_parallel_timeout(void)
+{
+    static const char *name = "max_parallel with timeout";
+    uint32 fail_start = check_fail;
+    zf_components_bringup bringup;
+
+    check_begin();
+    int hang = bringup.add_task("hang", [](){ return check_hang_task(); }, CHECK_TIMEOUT_MS);
+    int next = bringup.add_task("next", [](){ return check_task(CHECK_SLEEP_MS, 0); });
+
+    int result = bringup.run(1);
+    check_expect(name, 1 == result, "run should report 1 unsuccessful task");
+    check_expect(name, BRINGUP_STATE_TIMEOUT == bringup.get_state(hang), "hang should time out");
+    check_expect(name, BRINGUP_STATE_DONE == bringup.get_state(next), "next should still run");
+    check_expect(name, 1 == check_active_max.load(), "the hung thread should keep its slot");
+    check_expect(name, bringup.get_record(next)->start_ns >= (uint64_t)CHECK_HANG_MS * 1000000, "next should wait for the hung thread to return");
+    check_end(name, &bringup, fail_start);
+}
+
+int main(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        if(0 == strcmp(argv[i], "--timeline"))
+        {
+            option_timeline = 1;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--timeline]\r\n", argv[0]);
+            return 2;
+        }
+    }
+
+    check_failure_propagation();
+    check_timeout();
+    check_cycle();
+    check_order();
+    check_parallel();
+    check_parallel_timeout();
+    check_wait_hang(2);
+
+    printf("%s\r\n", (0 == check_fail) ? "PASS" : "FAIL");
+    return (0 == check_fail) ? 0 : 1;
+}
@@ -0,0 +1,490 @@
+/*---------------------------------------------------------------------
+ * @file     format_check.cpp
+ * @brief    数字转字符串与 zf_sprintf 的穷举比对程序
+ * @details  用法  zf_format_check [选项]
+ *             --count <n>     每组随机比对的次数 默认 1000000
+ *             --seed <n>      随机数种子 默认 20261018
+ *             --full          额外遍历全部 uint32 int32 与 float 位模式 单核约需三小时
+ *           逐字符比对以下函数与 snprintf 的输出 另外比对 zf_sprintf 的返回值与 strlen
+ *             func_uint_to_str    zf_sprintf %u %x %X %o       对照 %u %x %X %o
+ *             func_int_to_str     zf_sprintf %d %i             对照 %d
+ *             func_double_to_str  zf_sprintf %.Nf %f           对照 %.Nf  N 为 0~9
+ *             func_float_to_str                                对照 (double) 后的 %.Nf
+ *             zf_sprintf %p                                    对照 %0<指针宽度>PRIXPTR
+ *           绝对值不小于 1e19 的浮点数按函数说明对照 %.Ne
+ *           默认合计约一亿二千万次比对 主机上约一分钟 出现不一致时输出前 20 条 返回1
+ *---------------------------------------------------------------------*/
+#include "zf_common_function.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+#define CHECK_TEXT_SIZE             ( 96 )
+#define CHECK_REPORT_MAX            ( 20 )      // 最多输出的不一致条数
+#define CHECK_POINT_MAX             ( 9 )       // 与 FUNC_POINT_BIT_MAX 相同
+
+static uint64_t     option_count        = 1000000;
+static uint64_t     option_seed         = 20261018;
+static uint8        option_full         = 0;
+
+static uint64_t     check_state         = 0;
+static const char   *check_name         = NULL;
+static uint64_t     check_case          = 0;
+static uint64_t     check_fail          = 0;
+
+static const char   *check_point_format[CHECK_POINT_MAX + 1] =
+{
+    "%.0f", "%.1f", "%.2f", "%.3f", "%.4f", "%.5f", "%.6f", "%.7f", "%.8f", "%.9f",
+};
+
+static int check_parse_option(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(0 == strcmp(arg, "--count") && NULL != value)
+        {
+            option_count = strtoull(value, NULL, 10);
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--seed") && NULL != value)
+        {
+            option_seed = strtoull(value, NULL, 10);
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--full"))
+        {
+            option_full = 1;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--count n] [--seed n] [--full]\r\n", argv[0]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// xorshift64* 种子固定时每次生成相同的序列
+static inline uint64_t check_random(void)
+{
+    check_state ^= check_state >> 12;
+    check_state ^= check_state << 25;
+    check_state ^= check_state >> 27;
+    return check_state * 0x2545F4914F6CDD1DULL;
+}
+
+// 比对一条结果 被测函数不写结束符 调用前输出缓冲区已清零
+static inline void check_compare(const char *name, const char *input, const char *result, const char *expect)
+{
+    check_case ++;
+    if(0 == strcmp(result, expect))
+    {
+        return;
+    }
+    check_fail ++;
+    if(CHECK_REPORT_MAX >= check_fail)
+    {
+        fprintf(stderr, "mismatch: %s(%s) = \"%s\" expect \"%s\"\r\n", name, input, result, expect);
+    }
+}
+
+// zf_sprintf 的返回值应为写入的长度
+static inline void check_length(const char *name, const char *input, uint32 length, const char *result)
+{
+    char text[32];
+    char expect[32];
+
+    snprintf(text, sizeof(text), "%u", (unsigned)length);
+    snprintf(expect, sizeof(expect), "%u", (unsigned)strlen(result));
+    check_compare(name, input, text, expect);
+}
+
+static void check_uint(uint32 value)
+{
+    static const char *format[4] = {"%u", "%x", "%X", "%o"};
+    char input[16];
+    char result[CHECK_TEXT_SIZE];
+    char expect[CHECK_TEXT_SIZE];
+
+    snprintf(input, sizeof(input), "%u", (unsigned)value);
+    snprintf(expect, sizeof(expect), "%u", (unsigned)value);
+    memset(result, 0, sizeof(result));
+    func_uint_to_str(result, value);
+    check_compare("func_uint_to_str", input, result, expect);
+
+    for(uint8 i = 0; i < 4; i ++)
+    {
+        snprintf(expect, sizeof(expect), format[i], (unsigned)value);
+        uint32 length = zf_sprintf((int8 *)result, (const int8 *)format[i], value);
+        check_compare(format[i], input, result, expect);
+        check_length(format[i], input, length, result);
+    }
+}
+
+static void check_int(int32 value)
+{
+    char input[16];
+    char result[CHECK_TEXT_SIZE];
+    char expect[CHECK_TEXT_SIZE];
+
+    snprintf(input, sizeof(input), "%d", (int)value);
+    snprintf(expect, sizeof(expect), "%d", (int)value);
+    memset(result, 0, sizeof(result));
+    func_int_to_str(result, value);
+    check_compare("func_int_to_str", input, result, expect);
+
+    zf_sprintf((int8 *)result, (const int8 *)"%d", value);
+    check_compare("%d", input, result, expect);
+    uint32 length = zf_sprintf((int8 *)result, (const int8 *)"%i", value);
+    check_compare("%i", input, result, expect);
+    check_length("%i", input, length, result);
+}
+
+// 期望输出 有限且绝对值不小于 1e19 时为 %.Ne 否则为 %.Nf
+static inline void check_expect_double(char *expect, double value, uint8 point_bit)
+{
+    if(std::isfinite(value) && 1e19 <= std::fabs(value))
+    {
+        snprintf(expect, CHECK_TEXT_SIZE, "%.*e", (int)point_bit, value);
+    }
+    else
+    {
+        snprintf(expect, CHECK_TEXT_SIZE, "%.*f", (int)point_bit, value);
+    }
+}
+
+static void check_double(double value, uint8 point_bit)
+{
+    char input[48];
+    char result[CHECK_TEXT_SIZE];
+    char expect[CHECK_TEXT_SIZE];
+
+    snprintf(input, sizeof(input), "%a, %u", value, (unsigned)point_bit);
+    check_expect_double(expect, value, point_bit);
+    memset(result, 0, sizeof(result));
+    func_double_to_str(result, value, point_bit);
+    check_compare("func_double_to_str", input, result, expect);
+
+    uint32 length = zf_sprintf((int8 *)result, (const int8 *)check_point_format[point_bit], value);
+    check_compare(check_point_format[point_bit], input, result, expect);
+    check_length(check_point_format[point_bit], input, length, result);
+    if(6 == point_bit)
+    {
+        zf_sprintf((int8 *)result, (const int8 *)"%f", value);
+        check_compare("%f", input, result, expect);
+    }
+}
+
+static void check_float(float value, uint8 point_bit)
+{
+    char input[48];
+    char result[CHECK_TEXT_SIZE];
+    char expect[CHECK_TEXT_SIZE];
+
+    snprintf(input, sizeof(input), "%a, %u", (double)value, (unsigned)point_bit);
+    check_expect_double(expect, (double)value, point_bit);
+    memset(result, 0, sizeof(result));
+    func_float_to_str(result, value, point_bit);
+    check_compare("func_float_to_str", input, result, expect);
+}
+
+static void check_pointer(uintptr_t value)
+{
+    char input[32];
+    char result[CHECK_TEXT_SIZE];
+    char expect[CHECK_TEXT_SIZE];
+
+    snprintf(input, sizeof(input), "0x%" PRIxPTR, value);
+    snprintf(expect, sizeof(expect), "%0*" PRIXPTR, (int)(sizeof(void *) * 2), value);
+    uint32 length = zf_sprintf((int8 *)result, (const int8 *)"%p", (void *)value);
+    check_compare("%p", input, result, expect);
+    check_length("%p", input, length, result);
+}
+
+static inline double check_bits_to_double(uint64_t bits)
+{
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static inline float check_bits_to_float(uint32 bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 各组开始前重置种子 单独修改某一组时其余组的输入不变
+static void check_begin(const char *name)
+{
+    check_state = option_seed ^ (uint64_t)strlen(name) * 0x9E3779B97F4A7C15ULL;
+    if(0 == check_state)
+    {
+        check_state = 1;
+    }
+    check_name = name;
+}
+
+static void check_end(uint64_t case_start, uint64_t fail_start)
+{
+    printf("%-24s%12llu cases %8llu mismatch\r\n", check_name, (unsigned long long)(check_case - case_start), (unsigned long long)(check_fail - fail_start));
+    fflush(stdout);                                                             // 输出重定向到文件时也能看到进度
+}
+
+// 连续区间 全部边界附近 位数与进制位数变化处 随机值
+static void check_uint_group(void)
+{
+    uint64_t case_start = check_case;
+    uint64_t fail_start = check_fail;
+    uint64_t power = 1;
+
+    check_begin("uint / %u %x %X %o");
+    for(uint32 i = 0; i < (1u << 22); i ++)
+    {
+        check_uint(i);
+    }
+    for(uint32 i = 0; i < (1u << 16); i ++)
+    {
+        check_uint(UINT32_MAX - i);
+    }
+    for(uint8 k = 1; k <= 9; k ++)
+    {
+        power *= 10;
+        for(int32 d = -2048; d < 2048; d ++)
+        {
+            check_uint((uint32)(power + d));
+        }
+    }
+    for(uint8 shift = 3; shift < 32; shift ++)
+    {
+        for(int32 d = -64; d < 64; d ++)
+        {
+            check_uint((uint32)((1ULL << shift) + d));
+        }
+    }
+    for(uint64_t i = 0; i < option_count; i ++)
+    {
+        uint64_t r = check_random();
+        check_uint((uint32)(r >> (32 + (r & 31))));                             // 位数均匀分布
+    }
+    check_end(case_start, fail_start);
+}
+
+static void check_int_group(void)
+{
+    uint64_t case_start = check_case;
+    uint64_t fail_start = check_fail;
+    int64_t power = 1;
+
+    check_begin("int / %d %i");
+    for(int32 i = -(1 << 21); i < (1 << 21); i ++)
+    {
+        check_int(i);
+    }
+    for(int32 i = 0; i < (1 << 16); i ++)
+    {
+        check_int(INT32_MIN + i);
+        check_int(INT32_MAX - i);
+    }
+    for(uint8 k = 1; k <= 9; k ++)
+    {
+        power *= 10;
+        for(int32 d = -2048; d < 2048; d ++)
+        {
+            check_int((int32)(power + d));
+            check_int((int32)(-power + d));
+        }
+    }
+    for(uint64_t i = 0; i < option_count; i ++)
+    {
+        uint64_t r = check_random();
+        int32 value = (int32)((r >> 32) >> (r & 31));
+        check_int((r & 0x20) ? value : (int32)(0u - (uint32)value));
+    }
+    check_end(case_start, fail_start);
+}
+
+// 对每个小数位数分别生成
+//   随机位模式 覆盖 nan inf 非规格化数 不小于 1e19 的大数
+//   十进制尺度均匀分布的数
+//   接近 .5 舍入边界的数 及其前后相邻的 double
+//   二进制可精确表示的 .5 舍入边界 按五成双处理
+static void check_double_group(void)
+{
+    static const double special[] =
+    {
+        0.0, 0.5, 1.5, 2.5, 0.125, 0.375, 9.5, 99.995, 99.996, 0.0049999999999999, 1e-10,
+        9999999999999999999.0, 1e19, 1.8446744073709552e19, 4503599627370495.5, 9007199254740993.0,
+        DBL_MAX, DBL_MIN, DBL_TRUE_MIN, (double)INFINITY, (double)NAN,
+    };
+    uint64_t case_start = check_case;
+    uint64_t fail_start = check_fail;
+
+    check_begin("double / %.Nf");
+    for(uint8 p = 0; p <= CHECK_POINT_MAX; p ++)
+    {
+        double scale = 1;
+        for(uint8 k = 0; k < p; k ++)
+        {
+            scale *= 10;
+        }
+
+        for(uint32 i = 0; i < sizeof(special) / sizeof(special[0]); i ++)
+        {
+            check_double(special[i], p);
+            check_double(-special[i], p);
+            check_double(std::nextafter(special[i], 0.0), p);
+            check_double(std::nextafter(special[i], (double)INFINITY), p);
+        }
+
+        for(uint64_t i = 0; i < option_count / 4; i ++)
+        {
+            check_double(check_bits_to_double(check_random()), p);
+        }
+        for(uint64_t i = 0; i < option_count / 4; i ++)
+        {
+            uint64_t r = check_random();
+            double mantissa = (double)(r >> 11) / (double)(1ULL << 53);
+            double value = mantissa * std::pow(10.0, (double)((int)(r & 31) - 11));
+            check_double((r & 0x400) ? -value : value, p);
+        }
+        for(uint64_t i = 0; i < option_count / 4; i ++)
+        {
+            uint64_t r = check_random();
+            double integer = (double)((r >> 34) >> (r & 31));
+            double fraction = (double)((r >> 8) % (uint64_t)scale);
+            double value = integer + (2 * fraction + 1) / (2 * scale);
+            value = (0 == (r & 0x60)) ? value : std::nextafter(value, (r & 0x20) ? 0.0 : (double)INFINITY);
+            check_double((r & 0x80) ? -value : value, p);
+        }
+        for(uint64_t i = 0; i < option_count / 4; i ++)
+        {
+            uint64_t r = check_random();
+            double value = std::ldexp((double)((r >> 24) | 1), -(int)(1 + (r & 15) % (p + 1 + 3)));
+            check_double((r & 0x10) ? -value : value, p);
+        }
+    }
+    check_end(case_start, fail_start);
+}
+
+// float 只有 2^32 个取值 默认遍历 [1,2) 全部取值(小数位数轮流取 0~9) 另加随机位模式与随机十进制尺度
+static void check_float_group(void)
+{
+    uint64_t case_start = check_case;
+    uint64_t fail_start = check_fail;
+
+    check_begin("float / %.Nf");
+    for(uint32 bits = 0x3F800000; bits < 0x40000000; bits ++)
+    {
+        check_float(check_bits_to_float(bits), (uint8)(bits % (CHECK_POINT_MAX + 1)));
+    }
+    for(uint8 p = 0; p <= CHECK_POINT_MAX; p ++)
+    {
+        for(uint64_t i = 0; i < option_count / 2; i ++)
+        {
+            check_float(check_bits_to_float((uint32)check_random()), p);
+        }
+        for(uint64_t i = 0; i < option_count / 2; i ++)
+        {
+            uint64_t r = check_random();
+            float value = (float)((double)(r >> 40) * std::pow(10.0, (double)((int)(r & 15) - 12)));
+            check_float((r & 0x10) ? -value : value, p);
+        }
+    }
+    check_end(case_start, fail_start);
+}
+
+// %p 以及多个转换混合的格式串 超出上限的小数位数按 9 位处理
+static void check_sprintf_group(void)
+{
+    uint64_t case_start = check_case;
+    uint64_t fail_start = check_fail;
+    char input[64];
+    char result[CHECK_TEXT_SIZE * 2];
+    char expect[CHECK_TEXT_SIZE * 2];
+
+    check_begin("sprintf / %p mixed");
+    check_pointer(0);
+    check_pointer(UINTPTR_MAX);
+    for(uint64_t i = 0; i < option_count; i ++)
+    {
+        uint64_t r = check_random();
+        check_pointer((uintptr_t)(r >> (r & 63)));
+    }
+    for(uint64_t i = 0; i < option_count; i ++)
+    {
+        uint64_t r = check_random();
+        uint64_t s = check_random();
+        int32 ivalue = (int32)(r >> 32);
+        uint32 uvalue = (uint32)r;
+        double fvalue = (double)(int64_t)s / 1e9;
+        char c = (char)('!' + (s % 90));
+
+        snprintf(input, sizeof(input), "%d %u %a", (int)ivalue, (unsigned)uvalue, fvalue);
+        snprintf(expect, sizeof(expect), "[%d|%u|%x|%X|%o|%c|%s|%.3f|%%|%.9f|%.0f]end",
+                 (int)ivalue, (unsigned)uvalue, (unsigned)uvalue, (unsigned)uvalue, (unsigned)uvalue, c, "text", fvalue, fvalue, fvalue);
+        uint32 length = zf_sprintf((int8 *)result, (const int8 *)"[%d|%u|%x|%X|%o|%c|%s|%.3f|%%|%.12f|%.0f]end",
+                                   ivalue, uvalue, uvalue, uvalue, uvalue, c, "text", fvalue, fvalue, fvalue);
+        check_compare("mixed", input, result, expect);
+        check_length("mixed", input, length, result);
+    }
+    check_end(case_start, fail_start);
+}
+
+// 遍历全部取值 每组约 2^32 次
+static void check_full_group(void)
+{
+    uint64_t case_start = check_case;
+    uint64_t fail_start = check_fail;
+
+    check_begin("full uint");
+    for(uint64_t i = 0; i <= UINT32_MAX; i ++)
+    {
+        check_uint((uint32)i);
+    }
+    check_end(case_start, fail_start);
+
+    case_start = check_case;
+    fail_start = check_fail;
+    check_begin("full int");
+    for(int64_t i = INT32_MIN; i <= INT32_MAX; i ++)
+    {
+        check_int((int32)i);
+    }
+    check_end(case_start, fail_start);
+
+    case_start = check_case;
+    fail_start = check_fail;
+    check_begin("full float");
+    for(uint64_t i = 0; i <= UINT32_MAX; i ++)
+    {
+        check_float(check_bits_to_float((uint32)i), (uint8)(i % (CHECK_POINT_MAX + 1)));
+    }
+    check_end(case_start, fail_start);
+}
+
+int main(int argc, char **argv)
+{
+    if(0 != check_parse_option(argc, argv))
+    {
+        return 2;
+    }
+
+    check_uint_group();
+    check_int_group();
+    check_double_group();
+    check_float_group();
+    check_sprintf_group();
+    if(option_full)
+    {
+        check_full_group();
+    }
+
+    printf("total %llu cases %llu mismatch %s\r\n", (unsigned long long)check_case, (unsigned long long)check_fail,
+           (0 == check_fail) ? "PASS" : "FAIL");
+    return (0 == check_fail) ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+/*---------------------------------------------------------------------
+ * @file     timer_jitter.cpp
+ * @brief    周期定时器唤醒抖动测试程序
+ * @details  用法  zf_timer_jitter [选项]
+ *             --period-us <微秒>   定时周期 默认 250
+ *             --seconds <秒>       每种等待方式的测试时长 默认 5
+ *             --margin-us <微秒>   混合等待的提前唤醒量 默认 50
+ *             --work-us <微秒>     回调内模拟的控制律耗时 默认 0
+ *           依次以 PIT_WAIT_SLEEP 与 PIT_WAIT_HYBRID 运行 zf_driver_pit
+ *           输出唤醒延迟(实际唤醒时刻 - 计划到期时刻)的分布与错过周期数
+ *           需要 sudo 运行才能获得 SCHED_FIFO 实时优先级 否则结果没有参考意义
+ *---------------------------------------------------------------------*/
+#include "zf_driver_pit.hpp"
+
+#include <chrono>
+
+typedef struct
+{
+    const char  *name;
+    uint64_t    count;
+    double      min;                            // 以下单位均为 us
+    double      mean;
+    double      p50;
+    double      p99;
+    double      p999;
+    double      max;
+    uint64_t    missed;
+    uint64_t    overrun;
+}jitter_result_struct;
+
+static uint32 option_period_us  = 250;
+static uint32 option_seconds    = 5;
+static uint32 option_margin_us  = 50;
+static uint32 option_work_us    = 0;
+
+static uint64_t jitter_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+// 忙等模拟控制律计算 不让出CPU
+static void jitter_callback(void)
+{
+    uint64_t end_ns = jitter_now_ns() + (uint64_t)option_work_us * 1000;
+    while(option_work_us && jitter_now_ns() < end_ns);
+}
+
+static int jitter_run(const char *name, pit_wait_mode_enum mode, jitter_result_struct *result)
+{
+    zf_driver_pit pit;
+
+    pit.set_wait_mode(mode, std::chrono::microseconds(option_margin_us));
+    if(0 != pit.init_ns(std::chrono::microseconds(option_period_us), jitter_callback))
+    {
+        return -1;
+    }
+    usleep(100 * 1000);                         // 丢弃启动阶段的样本
+    pit.reset_stat();
+    sleep(option_seconds);
+    pit.stop();
+
+    const zf_common_histogram &latency = pit.get_latency_hist();
+    result->name    = name;
+    result->count   = latency.get_count();
+    result->min     = latency.get_min() / 1000.0;
+    result->mean    = latency.get_mean() / 1000.0;
+    result->p50     = latency.get_percentile(50) / 1000.0;
+    result->p99     = latency.get_percentile(99) / 1000.0;
+    result->p999    = latency.get_percentile(99.9) / 1000.0;
+    result->max     = latency.get_max() / 1000.0;
+    result->missed  = pit.get_missed_count();
+    result->overrun = pit.get_overrun_count();
+    return 0;
+}
+
+static uint8 jitter_parse_uint(const char *text, uint32 *value)
+{
+    char *end = NULL;
+    unsigned long number = strtoul(text, &end, 10);
+    if(NULL == end || '\0' != *end)
+    {
+        return 1;
+    }
+    *value = (uint32)number;
+    return 0;
+}
+
+static int jitter_parse_option(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(0 == strcmp(arg, "--period-us") && NULL != value && 0 == jitter_parse_uint(value, &option_period_us))
+        {
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--seconds") && NULL != value && 0 == jitter_parse_uint(value, &option_seconds))
+        {
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--margin-us") && NULL != value && 0 == jitter_parse_uint(value, &option_margin_us))
+        {
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--work-us") && NULL != value && 0 == jitter_parse_uint(value, &option_work_us))
+        {
+            i ++;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--period-us n] [--seconds n] [--margin-us n] [--work-us n]\r\n", argv[0]);
+            return -1;
+        }
+    }
+    if(0 == option_seconds || option_margin_us >= option_period_us || option_work_us >= option_period_us)
+    {
+        fprintf(stderr, "timer_jitter: seconds must be > 0, margin and work must be shorter than period\r\n");
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    jitter_result_struct result[2];
+
+    if(0 != jitter_parse_option(argc, argv))
+    {
+        return 1;
+    }
+
+    if(0 != jitter_run("sleep", PIT_WAIT_SLEEP, &result[0]) ||
+       0 != jitter_run("hybrid", PIT_WAIT_HYBRID, &result[1]))
+    {
+        return 1;
+    }
+
+    printf("\r\nperiod %u us, margin %u us, work %u us, %u s per mode, latency in us\r\n",
+           option_period_us, option_margin_us, option_work_us, option_seconds);
+    printf("%-8s %10s %8s %8s %8s %8s %8s %8s %8s %8s\r\n",
+           "mode", "count", "min", "mean", "p50", "p99", "p99.9", "max", "missed", "overrun");
+    for(uint32 i = 0; i < 2; i ++)
+    {
+        printf("%-8s %10" PRIu64 " %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %8" PRIu64 " %8" PRIu64 "\r\n",
+               result[i].name, result[i].count, result[i].min, result[i].mean, result[i].p50,
+               result[i].p99, result[i].p999, result[i].max, result[i].missed, result[i].overrun);
+    }
+    return 0;
+}
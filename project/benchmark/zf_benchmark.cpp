@@ -0,0 +1,300 @@
+/*---------------------------------------------------------------------
+ * @file     zf_benchmark.cpp
+ * @brief    性能测试框架实现与程序入口
+ * @details  用法  zf_benchmark [选项]
+ *             --list               只列出测试项
+ *             --filter <文本>      只运行名称包含该文本的测试项
+ *             --repeat <次数>      每项采样次数 默认 30
+ *             --warmup-ms <毫秒>   每项预热时间 默认 50
+ *             --min-time-us <微秒> 单个样本最短耗时 默认 2000
+ *             --json               以JSON格式输出 便于不同提交之间对比
+ *---------------------------------------------------------------------*/
+#include "zf_benchmark.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#define BENCHMARK_CASE_MAX          ( 128 )
+#define BENCHMARK_OPS_MAX           ( 1u << 30 )
+
+#ifndef BENCHMARK_GIT_REVISION
+#define BENCHMARK_GIT_REVISION      "unknown"
+#endif
+
+typedef struct
+{
+    const char  *name;
+    uint32      ops;                            // 每个样本的操作次数
+    uint32      samples;                        // 样本数
+    double      min;                            // 以下单位均为 ns/op
+    double      mean;
+    double      p50;
+    double      p90;
+    double      p99;
+    double      max;
+}benchmark_result_struct;
+
+static benchmark_case_struct benchmark_case[BENCHMARK_CASE_MAX];
+static uint32 benchmark_case_count = 0;
+
+static const char *option_filter    = NULL;
+static uint32 option_repeat         = 30;
+static uint32 option_warmup_ms      = 50;
+static uint32 option_min_time_us    = 2000;
+static uint8  option_json           = 0;
+static uint8  option_list           = 0;
+
+void benchmark_register(const char *name, benchmark_run_fun run, benchmark_setup_fun setup, benchmark_setup_fun teardown)
+{
+    if(BENCHMARK_CASE_MAX <= benchmark_case_count)
+    {
+        fprintf(stderr, "benchmark: too many cases, %s ignored\r\n", name);
+        return;
+    }
+    benchmark_case[benchmark_case_count ++] = {name, run, setup, teardown};
+}
+
+/*---------------------------------------------------------------------
+ * @brief    读取单调时钟
+ * @return   uint64_t  纳秒
+ *---------------------------------------------------------------------*/
+static uint64_t benchmark_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    执行一个样本
+ * @param    item      测试项
+ * @param    ops       操作次数
+ * @return   uint64_t  耗时 纳秒
+ *---------------------------------------------------------------------*/
+static uint64_t benchmark_sample(const benchmark_case_struct *item, uint32 ops)
+{
+    const uint64_t start = benchmark_now_ns();
+    item->run(ops);
+    return benchmark_now_ns() - start;
+}
+
+/*---------------------------------------------------------------------
+ * @brief    取已排序数组的百分位数 (最近秩法)
+ *---------------------------------------------------------------------*/
+static double benchmark_percentile(const std::vector<double> &sorted, double percent)
+{
+    size_t rank = (size_t)(percent / 100.0 * sorted.size() + 0.5);
+    if(0 < rank)
+    {
+        rank --;
+    }
+    if(sorted.size() <= rank)
+    {
+        rank = sorted.size() - 1;
+    }
+    return sorted[rank];
+}
+
+/*---------------------------------------------------------------------
+ * @brief    运行一个测试项
+ * @details  1. 预热 反复执行直到超过预热时间 同时让CPU频率和缓存稳定
+ *           2. 操作次数从1开始倍增 直到单个样本耗时不低于 min_time
+ *           3. 采样 repeat 次 统计每个样本的 ns/op
+ *---------------------------------------------------------------------*/
+static benchmark_result_struct benchmark_run_case(const benchmark_case_struct *item)
+{
+    benchmark_result_struct result;
+    std::vector<double> sample_ns;
+    const uint64_t min_time_ns = (uint64_t)option_min_time_us * 1000;
+    const uint64_t warmup_end  = benchmark_now_ns() + (uint64_t)option_warmup_ms * 1000000;
+    uint32 ops = 1;
+    uint64_t elapsed;
+
+    if(NULL != item->setup)
+    {
+        item->setup();
+    }
+
+    do
+    {
+        benchmark_sample(item, ops);
+    }while(benchmark_now_ns() < warmup_end);
+
+    while(1)
+    {
+        elapsed = benchmark_sample(item, ops);
+        if(min_time_ns <= elapsed || BENCHMARK_OPS_MAX <= ops)
+        {
+            break;
+        }
+        // 按本次耗时估算 留 20% 余量 至少翻倍 避免计时粒度导致的反复试探
+        if(0 < elapsed && elapsed * 2 < min_time_ns)
+        {
+            ops = (uint32)std::min<uint64_t>((uint64_t)ops * min_time_ns * 12 / 10 / elapsed, BENCHMARK_OPS_MAX);
+        }
+        else
+        {
+            ops = (uint32)std::min<uint64_t>((uint64_t)ops * 2, BENCHMARK_OPS_MAX);
+        }
+    }
+
+    sample_ns.reserve(option_repeat);
+    for(uint32 i = 0; i < option_repeat; i ++)
+    {
+        sample_ns.push_back((double)benchmark_sample(item, ops) / ops);
+    }
+
+    if(NULL != item->teardown)
+    {
+        item->teardown();
+    }
+
+    std::sort(sample_ns.begin(), sample_ns.end());
+    result.name     = item->name;
+    result.ops      = ops;
+    result.samples  = option_repeat;
+    result.min      = sample_ns.front();
+    result.max      = sample_ns.back();
+    result.p50      = benchmark_percentile(sample_ns, 50);
+    result.p90      = benchmark_percentile(sample_ns, 90);
+    result.p99      = benchmark_percentile(sample_ns, 99);
+    result.mean     = 0;
+    for(double value : sample_ns)
+    {
+        result.mean += value;
+    }
+    result.mean /= sample_ns.size();
+    return result;
+}
+
+static void benchmark_print_text(const benchmark_result_struct *result)
+{
+    printf("%-36s %10u %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\r\n",
+           result->name, result->ops, result->min, result->mean, result->p50, result->p90, result->p99, result->max);
+}
+
+static void benchmark_print_json(const benchmark_result_struct *result, uint8 first)
+{
+    printf("%s\n    {\"name\": \"%s\", \"ops_per_sample\": %u, \"samples\": %u, "
+           "\"ns_per_op\": {\"min\": %.3f, \"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}}",
+           first ? "" : ",", result->name, result->ops, result->samples,
+           result->min, result->mean, result->p50, result->p90, result->p99, result->max);
+}
+
+static uint8 benchmark_parse_uint(const char *text, uint32 *value)
+{
+    char *end = NULL;
+    unsigned long number = strtoul(text, &end, 10);
+    if(NULL == end || '\0' != *end || 0 == number)
+    {
+        return 1;
+    }
+    *value = (uint32)number;
+    return 0;
+}
+
+static int benchmark_parse_option(int argc, char **argv)
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if(0 == strcmp(arg, "--json"))
+        {
+            option_json = 1;
+        }
+        else if(0 == strcmp(arg, "--list"))
+        {
+            option_list = 1;
+        }
+        else if(0 == strcmp(arg, "--filter") && NULL != value)
+        {
+            option_filter = value;
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--repeat") && NULL != value && 0 == benchmark_parse_uint(value, &option_repeat))
+        {
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--warmup-ms") && NULL != value && 0 == benchmark_parse_uint(value, &option_warmup_ms))
+        {
+            i ++;
+        }
+        else if(0 == strcmp(arg, "--min-time-us") && NULL != value && 0 == benchmark_parse_uint(value, &option_min_time_us))
+        {
+            i ++;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--list] [--json] [--filter text] [--repeat n] [--warmup-ms n] [--min-time-us n]\r\n", argv[0]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint8 first = 1;
+
+    if(0 != benchmark_parse_option(argc, argv))
+    {
+        return 1;
+    }
+
+    bench_common_register();
+    bench_display_register();
+    bench_assistant_register();
+    bench_jpeg_register();
+    bench_mpmc_queue_register();
+    bench_sysfs_register();
+    bench_imu_register();
+    bench_ahrs_register();
+
+    if(option_list)
+    {
+        for(uint32 i = 0; i < benchmark_case_count; i ++)
+        {
+            printf("%s\r\n", benchmark_case[i].name);
+        }
+        return 0;
+    }
+
+    if(option_json)
+    {
+        printf("{\n  \"revision\": \"%s\",\n  \"compiler\": \"%s\",\n  \"repeat\": %u,\n  \"min_time_us\": %u,\n  \"results\": [",
+               BENCHMARK_GIT_REVISION, __VERSION__, option_repeat, option_min_time_us);
+    }
+    else
+    {
+        printf("revision %s, %u samples per case, >= %u us per sample, unit ns/op\r\n", BENCHMARK_GIT_REVISION, option_repeat, option_min_time_us);
+        printf("%-36s %10s %10s %10s %10s %10s %10s %10s\r\n", "case", "ops", "min", "mean", "p50", "p90", "p99", "max");
+    }
+
+    for(uint32 i = 0; i < benchmark_case_count; i ++)
+    {
+        if(NULL != option_filter && NULL == strstr(benchmark_case[i].name, option_filter))
+        {
+            continue;
+        }
+
+        benchmark_result_struct result = benchmark_run_case(&benchmark_case[i]);
+        if(option_json)
+        {
+            benchmark_print_json(&result, first);
+        }
+        else
+        {
+            benchmark_print_text(&result);
+        }
+        fflush(stdout);
+        first = 0;
+    }
+
+    if(option_json)
+    {
+        printf("\n  ]\n}\n");
+    }
+    return 0;
+}
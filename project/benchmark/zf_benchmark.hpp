@@ -0,0 +1,57 @@
+/*---------------------------------------------------------------------
+ * @file     zf_benchmark.hpp
+ * @brief    库热点函数性能测试框架
+ * @details  不依赖硬件 主机(CROSS_COMPILE=0)与板端均可编译运行
+ *           每个测试项提供一个 run(ops) 函数 执行 ops 次被测操作
+ *           框架先预热 再自动确定每个样本的操作次数 使单个样本耗时不低于设定值
+ *           最后重复采样 统计 ns/op 的最小值/平均值/百分位数
+ *---------------------------------------------------------------------*/
+#ifndef _zf_benchmark_h_
+#define _zf_benchmark_h_
+
+#include "zf_common_typedef.hpp"
+
+typedef void (*benchmark_run_fun)(uint32 ops);
+typedef void (*benchmark_setup_fun)(void);
+
+typedef struct
+{
+    const char          *name;                  // 测试项名称 格式为 分组/项目
+    benchmark_run_fun   run;                    // 执行 ops 次被测操作
+    benchmark_setup_fun setup;                  // 采样前调用一次 可以为NULL
+    benchmark_setup_fun teardown;               // 采样后调用一次 可以为NULL
+}benchmark_case_struct;
+
+/*---------------------------------------------------------------------
+ * @brief    注册测试项
+ * @param    name      测试项名称 必须为常量字符串
+ * @param    run       被测函数
+ * @param    setup     准备函数 可以为NULL
+ * @param    teardown  清理函数 可以为NULL
+ * @return   无
+ * @example  benchmark_register("fifo/write_read_64", bench_fifo_64, bench_fifo_setup, NULL);
+ *---------------------------------------------------------------------*/
+void benchmark_register(const char *name, benchmark_run_fun run, benchmark_setup_fun setup = NULL, benchmark_setup_fun teardown = NULL);
+
+/*---------------------------------------------------------------------
+ * @brief    阻止编译器把被测结果当作无用代码删除
+ * @param    p         结果地址
+ * @return   无
+ * @example  benchmark_keep(buffer);
+ *---------------------------------------------------------------------*/
+static inline void benchmark_keep(const void *p)
+{
+    __asm__ __volatile__("" : : "g"(p) : "memory");
+}
+
+// 各测试文件的注册入口 由 main 依次调用
+void bench_common_register(void);
+void bench_display_register(void);
+void bench_assistant_register(void);
+void bench_jpeg_register(void);
+void bench_mpmc_queue_register(void);
+void bench_sysfs_register(void);
+void bench_imu_register(void);
+void bench_ahrs_register(void);
+
+#endif
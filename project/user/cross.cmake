@@ -1,6 +1,9 @@
 # cross.cmake文件
 # 设置为1则表示交叉编译，设置为0则表示x86 gcc编译
+# 也可以不修改本文件，在命令行通过 cmake -DCROSS_COMPILE=0 指定
+IF(NOT DEFINED CROSS_COMPILE)
 SET(CROSS_COMPILE 1)
+ENDIF()
 
 IF(CROSS_COMPILE)
 SET(CMAKE_SYSTEM_NAME Linux)